@@ -0,0 +1,193 @@
+# SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+# SPDX-License-Identifier: GPL-2.0-or-later
+#
+# Audio benchmark: plays notes on the OPL, sweeps the PC speaker, and streams
+# a waveform through the Sound Blaster direct DAC command (if a Sound Blaster
+# is present at port 220h). Runs until a key is pressed.
+
+	.code16
+	.intel_syntax noprefix
+	.text
+	.globl _start
+
+SbBase     = 0x220
+OplBase    = 0x388
+DacSamples = 2000
+
+_start:
+	mov dx, offset banner
+	mov ah, 0x09
+	int 0x21
+	cld
+
+	call sb_reset
+	jc no_sb
+	mov byte ptr [has_sb], 1
+	mov al, 0xd1 # speaker on
+	call dsp_write
+no_sb:
+
+	# Set up a simple OPL instrument on channel 0
+	mov si, offset opl_setup
+	mov cx, (opl_setup_end - opl_setup) / 2
+setup:
+	lodsw
+	call opl_write
+	loop setup
+
+	# PC speaker tone on PIT channel 2
+	mov al, 0xb6
+	out 0x43, al
+	in al, 0x61
+	or al, 0x03
+	out 0x61, al
+
+main_loop:
+	# OPL note on with a new frequency, key on (bit 5) and block 4
+	inc word ptr [note]
+	mov ax, word ptr [note]
+	and ax, 0x01ff
+	add ax, 0x0100
+	mov bx, ax
+	mov al, 0xa0
+	mov ah, bl
+	call opl_write
+	mov al, 0xb0
+	mov ah, bh
+	or ah, 0x30
+	call opl_write
+
+	# PC speaker frequency sweep
+	mov ax, bx
+	shl ax, 2
+	out 0x42, al
+	mov al, ah
+	out 0x42, al
+
+	# Sawtooth through the Sound Blaster direct DAC
+	cmp byte ptr [has_sb], 0
+	je check_key
+	mov cx, DacSamples
+	xor bl, bl
+dac:
+	mov al, 0x10
+	call dsp_write
+	mov al, bl
+	call dsp_write
+	add bl, 7
+	loop dac
+
+check_key:
+	# OPL key off
+	mov al, 0xb0
+	mov ah, bh
+	call opl_write
+
+	mov ah, 0x01
+	int 0x16
+	jz main_loop
+
+	xor ah, ah
+	int 0x16
+
+	in al, 0x61
+	and al, 0xfc
+	out 0x61, al
+	cmp byte ptr [has_sb], 0
+	je exit
+	mov al, 0xd3 # speaker off
+	call dsp_write
+exit:
+	mov ax, 0x4c00
+	int 0x21
+
+# Resets the DSP; sets the carry flag if no Sound Blaster was found
+sb_reset:
+	mov dx, SbBase + 0x6
+	mov al, 1
+	out dx, al
+	mov cx, 32
+reset_delay:
+	in al, dx
+	loop reset_delay
+	xor al, al
+	out dx, al
+
+	mov cx, 1000
+wait_data:
+	mov dx, SbBase + 0xe
+	in al, dx
+	test al, 0x80
+	jnz read_data
+	loop wait_data
+	stc
+	ret
+read_data:
+	mov dx, SbBase + 0xa
+	in al, dx
+	cmp al, 0xaa
+	jne not_found
+	clc
+	ret
+not_found:
+	stc
+	ret
+
+# Writes AL to the DSP
+dsp_write:
+	push cx
+	mov ah, al
+	mov dx, SbBase + 0xc
+	mov cx, 1000
+dsp_wait:
+	in al, dx
+	test al, 0x80
+	jz dsp_ready
+	loop dsp_wait
+dsp_ready:
+	mov al, ah
+	out dx, al
+	pop cx
+	ret
+
+# Writes AH to OPL register AL
+opl_write:
+	push cx
+	mov dx, OplBase
+	out dx, al
+	mov cx, 6
+opl_index_delay:
+	in al, dx
+	loop opl_index_delay
+	inc dx
+	mov al, ah
+	out dx, al
+	dec dx
+	mov cx, 35
+opl_data_delay:
+	in al, dx
+	loop opl_data_delay
+	pop cx
+	ret
+
+banner:
+	.ascii "Audio benchmark, press any key to exit.\r\n$"
+
+has_sb:
+	.byte 0
+note:
+	.word 0
+
+# Register, value pairs
+opl_setup:
+	.byte 0x01, 0x20 # enable waveform select
+	.byte 0x20, 0x01 # modulator multiplier
+	.byte 0x23, 0x01 # carrier multiplier
+	.byte 0x40, 0x10 # modulator level
+	.byte 0x43, 0x00 # carrier level
+	.byte 0x60, 0xf0 # modulator attack/decay
+	.byte 0x63, 0xf0 # carrier attack/decay
+	.byte 0x80, 0x77 # modulator sustain/release
+	.byte 0x83, 0x77 # carrier sustain/release
+	.byte 0xc0, 0x06 # feedback/connection
+opl_setup_end:
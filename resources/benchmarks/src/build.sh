@@ -0,0 +1,16 @@
+#!/bin/sh
+# SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+# SPDX-License-Identifier: GPL-2.0-or-later
+#
+# Assembles the benchmark programs into DOS .COM files with GNU binutils.
+
+set -e
+
+cd "$(dirname "$0")"
+
+for name in realmode pmode vga audio; do
+	as --32 -o "$name.o" "$name.s"
+	ld -m elf_i386 -Ttext 0x100 -e _start --oformat binary \
+		-o "../$(echo "$name" | tr '[:lower:]' '[:upper:]').COM" "$name.o"
+	rm "$name.o"
+done
@@ -0,0 +1,187 @@
+# SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+# SPDX-License-Identifier: GPL-2.0-or-later
+#
+# Protected mode CPU benchmark: repeatedly switches from real mode to 32-bit
+# protected mode, runs integer arithmetic and 32-bit string instructions, and
+# switches back. Requires a 386 or later and a CPU in real mode (i.e., no
+# EMM386 or other V86 mode memory managers). Runs until a key is pressed.
+
+	.code16
+	.intel_syntax noprefix
+	.text
+	.globl _start
+
+SelCode32 = 0x08
+SelData32 = 0x10
+SelCode16 = 0x18
+SelData16 = 0x20
+
+BufferA = 0x4000
+BufferB = 0x8000
+
+_start:
+	mov dx, offset banner
+	mov ah, 0x09
+	int 0x21
+	cld
+
+	# Check for a 386: FLAGS bits 12-15 are always set on the 8086, and
+	# bits 12-14 are always clear in real mode on the 286
+	pushf
+	pop ax
+	and ax, 0x0fff
+	push ax
+	popf
+	pushf
+	pop ax
+	and ax, 0xf000
+	cmp ax, 0xf000
+	je no_386
+	or ax, 0x7000
+	push ax
+	popf
+	pushf
+	pop ax
+	test ax, 0x7000
+	jz no_386
+
+	smsw ax
+	test al, 1
+	jnz in_v86_mode
+
+	# All the descriptors have the base of our segment
+	mov word ptr [real_cs], cs
+	xor eax, eax
+	mov ax, cs
+	shl eax, 4
+	mov word ptr [code32_desc + 2], ax
+	mov word ptr [data32_desc + 2], ax
+	mov word ptr [code16_desc + 2], ax
+	mov word ptr [data16_desc + 2], ax
+	mov ebx, eax
+	shr ebx, 16
+	mov byte ptr [code32_desc + 4], bl
+	mov byte ptr [data32_desc + 4], bl
+	mov byte ptr [code16_desc + 4], bl
+	mov byte ptr [data16_desc + 4], bl
+	add eax, offset gdt
+	mov dword ptr [gdt_ptr + 2], eax
+
+main_loop:
+	cli
+	lgdt [gdt_ptr]
+	mov eax, cr0
+	or al, 1
+	mov cr0, eax
+
+	# jmp SelCode32:pm32
+	.byte 0xea
+	.word pm32
+	.word SelCode32
+
+	.code32
+pm32:
+	mov ax, SelData32
+	mov ds, ax
+	mov es, ax
+	mov ss, ax
+	movzx esp, sp
+
+	# Keep the work short as interrupts are disabled
+	mov ecx, 5000
+	mov eax, 1
+	mov ebx, 0x12345
+loop32:
+	add eax, ebx
+	imul eax, eax, 3
+	rol ebx, 3
+	xor edx, edx
+	mov edi, 13
+	div edi
+	add ebx, edx
+	dec ecx
+	jnz loop32
+
+	mov esi, BufferA
+	mov edi, BufferB
+	mov ecx, 0x1000
+	rep movsd
+
+	# jmp SelCode16:pm16
+	.byte 0xea
+	.long pm16
+	.word SelCode16
+
+	.code16
+pm16:
+	# Reload the segments with 64 KB limits before leaving protected mode
+	mov ax, SelData16
+	mov ds, ax
+	mov es, ax
+	mov ss, ax
+
+	mov eax, cr0
+	and al, 0xfe
+	mov cr0, eax
+
+	push word ptr [real_cs]
+	push offset real_mode
+	retf
+
+real_mode:
+	mov ax, cs
+	mov ds, ax
+	mov es, ax
+	mov ss, ax
+	sti
+
+	mov ah, 0x01
+	int 0x16
+	jz main_loop
+
+	xor ah, ah
+	int 0x16
+	mov ax, 0x4c00
+	int 0x21
+
+no_386:
+	mov dx, offset no_386_msg
+	jmp error_exit
+in_v86_mode:
+	mov dx, offset v86_msg
+error_exit:
+	mov ah, 0x09
+	int 0x21
+	mov ax, 0x4c01
+	int 0x21
+
+banner:
+	.ascii "Protected mode CPU benchmark, press any key to exit.\r\n$"
+no_386_msg:
+	.ascii "This benchmark requires a 386 or later CPU.\r\n$"
+v86_msg:
+	.ascii "This benchmark cannot run in V86 mode, disable EMM386.\r\n$"
+
+real_cs:
+	.word 0
+
+	.balign 8
+gdt:
+	.quad 0
+code32_desc:
+	.word 0xffff, 0
+	.byte 0, 0x9a, 0xcf, 0
+data32_desc:
+	.word 0xffff, 0
+	.byte 0, 0x92, 0xcf, 0
+code16_desc:
+	.word 0xffff, 0
+	.byte 0, 0x9a, 0x00, 0
+data16_desc:
+	.word 0xffff, 0
+	.byte 0, 0x92, 0x00, 0
+gdt_end:
+
+gdt_ptr:
+	.word gdt_end - gdt - 1
+	.long 0
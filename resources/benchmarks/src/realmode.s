@@ -0,0 +1,76 @@
+# SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+# SPDX-License-Identifier: GPL-2.0-or-later
+#
+# Real mode CPU benchmark: integer arithmetic, string instructions, near calls
+# and memory table lookups. Runs until a key is pressed.
+
+	.code16
+	.intel_syntax noprefix
+	.text
+	.globl _start
+
+BufferA = 0x4000
+BufferB = 0x8000
+
+_start:
+	mov dx, offset banner
+	mov ah, 0x09
+	int 0x21
+	cld
+
+main_loop:
+	# Integer arithmetic
+	mov cx, 20000
+	mov ax, 1
+	mov bx, 3
+	xor si, si
+arith:
+	add ax, bx
+	imul ax, ax, 5
+	xor dx, dx
+	mov di, 7
+	div di
+	add si, dx
+	rol bx, 1
+	xor bx, si
+	loop arith
+
+	# Block copy and compare
+	mov si, BufferA
+	mov di, BufferB
+	mov cx, 0x2000
+	rep movsw
+	mov si, BufferA
+	mov di, BufferB
+	mov cx, 0x2000
+	repe cmpsw
+
+	# Near calls with stack traffic and table lookups
+	mov cx, 4000
+calls:
+	call leaf
+	loop calls
+
+	mov ah, 0x01
+	int 0x16
+	jz main_loop
+
+	xor ah, ah
+	int 0x16
+	mov ax, 0x4c00
+	int 0x21
+
+leaf:
+	push bx
+	push cx
+	mov bx, cx
+	and bx, 0x00ff
+	mov al, byte ptr [bx + BufferA]
+	add al, cl
+	mov byte ptr [bx + BufferB], al
+	pop cx
+	pop bx
+	ret
+
+banner:
+	.ascii "Real mode CPU benchmark, press any key to exit.\r\n$"
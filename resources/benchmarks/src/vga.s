@@ -0,0 +1,97 @@
+# SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+# SPDX-License-Identifier: GPL-2.0-or-later
+#
+# VGA benchmark: alternates between chunky mode 13h drawing with palette
+# updates and planar mode 12h drawing through the map mask register. Runs
+# until a key is pressed.
+
+	.code16
+	.intel_syntax noprefix
+	.text
+	.globl _start
+
+FramesPerMode = 30
+
+_start:
+	cld
+
+main_loop:
+	mov ax, 0x0013
+	int 0x10
+	mov ax, 0xa000
+	mov es, ax
+
+	mov bp, FramesPerMode
+frame_13h:
+	xor di, di
+	mov ax, bp
+	mov ah, al
+	mov cx, 32000
+fill_13h:
+	stosw
+	add ax, 0x0301
+	loop fill_13h
+
+	# Rotate the palette
+	mov dx, 0x3c8
+	xor al, al
+	out dx, al
+	inc dx
+	mov cx, 256
+	mov bl, byte ptr [phase]
+palette:
+	mov al, bl
+	and al, 0x3f
+	out dx, al
+	shr al, 1
+	out dx, al
+	not al
+	and al, 0x3f
+	out dx, al
+	inc bl
+	loop palette
+	inc byte ptr [phase]
+
+	dec bp
+	jnz frame_13h
+
+	mov ax, 0x0012
+	int 0x10
+	mov ax, 0xa000
+	mov es, ax
+
+	mov bp, FramesPerMode
+frame_12h:
+	mov bl, 0x01
+plane:
+	# Select the plane in the sequencer map mask register
+	mov dx, 0x3c4
+	mov al, 0x02
+	mov ah, bl
+	out dx, ax
+	xor di, di
+	mov ax, bp
+	xor al, bl
+	mov ah, al
+	mov cx, 19200
+	rep stosw
+	shl bl, 1
+	cmp bl, 0x10
+	jb plane
+
+	dec bp
+	jnz frame_12h
+
+	mov ah, 0x01
+	int 0x16
+	jz main_loop
+
+	xor ah, ah
+	int 0x16
+	mov ax, 0x0003
+	int 0x10
+	mov ax, 0x4c00
+	int 0x21
+
+phase:
+	.byte 0
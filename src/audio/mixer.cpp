@@ -32,11 +32,12 @@
 #include "midi/midi.h"
 #include "misc/cross.h"
 #include "misc/notifications.h"
+#include "misc/perf_counters.h"
 #include "misc/tracy.h"
 #include "misc/video.h"
 #include "utils/checks.h"
 #include "utils/math_utils.h"
-#include "utils/rwqueue.h"
+#include "utils/spsc_queue.h"
 #include "utils/string_utils.h"
 
 CHECK_NARROWING();
@@ -146,8 +147,11 @@ struct ChorusSettings {
 constexpr auto Minus6db = 0.501f;
 
 struct MixerSettings {
-	RWQueue<AudioFrame> final_output{1};
-	RWQueue<int16_t> capture_queue{1};
+	// Mixer thread -> SDL audio callback
+	SpscQueue<AudioFrame> final_output{1};
+
+	// Mixer thread -> audio capture in the main thread
+	SpscQueue<int16_t> capture_queue{1};
 
 	std::thread thread = {};
 
@@ -221,14 +225,12 @@ static struct MixerSettings mixer = {};
 
 void MixerChannel::SetLineoutMap(const StereoLine map)
 {
-	std::lock_guard lock(mutex);
-	output_map = map;
+	output_map.store(map, std::memory_order_relaxed);
 }
 
 StereoLine MixerChannel::GetLineoutMap()
 {
-	std::lock_guard lock(mutex);
-	return output_map;
+	return output_map.load(std::memory_order_relaxed);
 }
 
 int MIXER_GetPreBufferMs()
@@ -298,22 +300,20 @@ MixerChannel::MixerChannel(MIXER_Handler _handler, const char* _name,
                            const std::set<ChannelFeature>& _features)
         : sleeper(*this),
           name(_name),
-          envelope(_name),
+          features(_features),
           handler(_handler),
-          features(_features)
+          envelope(_name)
 {
 	do_sleep = HasFeature(ChannelFeature::Sleep);
 }
 
 bool MixerChannel::HasFeature(const ChannelFeature feature)
 {
-	std::lock_guard lock(mutex);
 	return features.contains(feature);
 }
 
 std::set<ChannelFeature> MixerChannel::GetFeatures()
 {
-	std::lock_guard lock(mutex);
 	return features;
 }
 
@@ -771,60 +771,66 @@ void MixerChannel::Set0dbScalar(const float scalar)
 	// a unity float [-1.0f, +1.0f] to  16-bit int [-32k,+32k] range.
 	assert(scalar >= 0.0f && scalar <= static_cast<int16_t>(Max16BitSampleValue));
 
-	std::lock_guard lock(mutex);
-
-	db0_volume_gain = scalar;
+	std::lock_guard lock(volume_mutex);
+	db0_volume_gain.store(scalar, std::memory_order_relaxed);
 	UpdateCombinedVolume();
 }
 
+// Expects the volume mutex to be held. The setters are serialised by it, so
+// the last one to finish combines the latest values; without it, a setter
+// could store a product computed from another setter's outdated gain. The
+// mixer thread only loads the combined gain and never takes the lock.
 void MixerChannel::UpdateCombinedVolume()
 {
-	std::lock_guard lock(mutex);
-	combined_volume_gain = user_volume_gain * app_volume_gain * db0_volume_gain;
+	combined_volume_gain.store(user_volume_gain.load(std::memory_order_relaxed) *
+	                                   app_volume_gain.load(std::memory_order_relaxed) *
+	                                   db0_volume_gain.load(std::memory_order_relaxed),
+	                           std::memory_order_relaxed);
 }
 
 const AudioFrame MixerChannel::GetUserVolume()
 {
-	std::lock_guard lock(mutex);
-	return user_volume_gain;
+	return user_volume_gain.load(std::memory_order_relaxed);
 }
 
 void MixerChannel::SetUserVolume(const AudioFrame gain)
 {
-	std::lock_guard lock(mutex);
-
 	// Allow unconstrained user-defined values
-	user_volume_gain = gain;
+	std::lock_guard lock(volume_mutex);
+	user_volume_gain.store(gain, std::memory_order_relaxed);
 	UpdateCombinedVolume();
 }
 
 const AudioFrame MixerChannel::GetAppVolume()
 {
-	std::lock_guard lock(mutex);
-	return app_volume_gain;
+	return app_volume_gain.load(std::memory_order_relaxed);
 }
 
 void MixerChannel::SetAppVolume(const AudioFrame gain)
 {
-	std::lock_guard lock(mutex);
-
 	// Constrain application-defined volume between 0% and 100%
 	auto clamp_to_unity = [](const float vol) {
 		constexpr auto MinUnityVolume = 0.0f;
 		constexpr auto MaxUnityVolume = 1.0f;
 		return clamp(vol, MinUnityVolume, MaxUnityVolume);
 	};
-	app_volume_gain = {clamp_to_unity(gain.left), clamp_to_unity(gain.right)};
-	UpdateCombinedVolume();
+	const AudioFrame clamped_gain = {clamp_to_unity(gain.left),
+	                                 clamp_to_unity(gain.right)};
+
+	{
+		std::lock_guard lock(volume_mutex);
+		app_volume_gain.store(clamped_gain, std::memory_order_relaxed);
+		UpdateCombinedVolume();
+	}
 
 #ifdef DEBUG
 	LOG_MSG("MIXER: %-7s channel: application requested volume "
 	        "{%3.0f%%, %3.0f%%}, and was set to {%3.0f%%, %3.0f%%}",
-	        name,
-	        static_cast<double>(left),
-	        static_cast<double>(right),
-	        static_cast<double>(app_volume_gain.left * 100.0f),
-	        static_cast<double>(app_volume_gain.right * 100.0f));
+	        name.c_str(),
+	        static_cast<double>(gain.left * 100.0f),
+	        static_cast<double>(gain.right * 100.0f),
+	        static_cast<double>(clamped_gain.left * 100.0f),
+	        static_cast<double>(clamped_gain.right * 100.0f));
 #endif
 }
 
@@ -843,15 +849,13 @@ void MixerChannel::SetChannelMap(const StereoLine map)
 	assert(map.left == Left || map.left == Right);
 	assert(map.right == Left || map.right == Right);
 
-	std::lock_guard lock(mutex);
-
-	channel_map = map;
+	channel_map.store(map, std::memory_order_relaxed);
 
 #ifdef DEBUG
 	LOG_MSG("MIXER: %-7s channel: application changed audio channel mapping to left=>%s and right=>%s",
-	        name,
-	        channel_map.left == Left ? "left" : "right",
-	        channel_map.right == Left ? "left" : "right");
+	        name.c_str(),
+	        map.left == Left ? "left" : "right",
+	        map.right == Left ? "left" : "right");
 #endif
 }
 
@@ -1113,14 +1117,12 @@ void MixerChannel::SetSampleRate(const int new_sample_rate_hz)
 
 const std::string& MixerChannel::GetName()
 {
-	std::lock_guard lock(mutex);
 	return name;
 }
 
 int MixerChannel::GetSampleRate()
 {
-	std::lock_guard lock(mutex);
-	return sample_rate_hz;
+	return sample_rate_hz.load(std::memory_order_relaxed);
 }
 
 static float get_mixer_frames_per_tick()
@@ -1128,34 +1130,31 @@ static float get_mixer_frames_per_tick()
 	return static_cast<float>(mixer.sample_rate_hz) / 1000.0f;
 }
 
-float MixerChannel::GetFramesPerTick()
+// The channel and mixer rates are loaded once each, so these are safe to call
+// from any thread while the mixer thread is running.
+static float get_stretch_factor(const int channel_rate_hz)
 {
-	std::lock_guard lock(mutex);
-
-	const float stretch_factor = static_cast<float>(sample_rate_hz) /
-	                             static_cast<float>(mixer.sample_rate_hz);
+	return static_cast<float>(channel_rate_hz) /
+	       static_cast<float>(mixer.sample_rate_hz.load());
+}
 
-	return get_mixer_frames_per_tick() * stretch_factor;
+float MixerChannel::GetFramesPerTick()
+{
+	return get_mixer_frames_per_tick() * get_stretch_factor(GetSampleRate());
 }
 
 float MixerChannel::GetFramesPerBlock()
 {
-	std::lock_guard lock(mutex);
-
-	const float stretch_factor = static_cast<float>(sample_rate_hz) /
-	                             static_cast<float>(mixer.sample_rate_hz);
-
-	return static_cast<float>(mixer.blocksize) * stretch_factor;
+	return static_cast<float>(mixer.blocksize) *
+	       get_stretch_factor(GetSampleRate());
 }
 
 double MixerChannel::GetMillisPerFrame()
 {
-	std::lock_guard lock(mutex);
-
 	// Note: the double return value is used for PIC timing (which uses
 	// doubles)
 
-	return MillisInSecond / sample_rate_hz;
+	return MillisInSecond / GetSampleRate();
 }
 
 void MixerChannel::SetPeakAmplitude(const int peak)
@@ -1179,13 +1178,13 @@ void MixerChannel::Mix(const int frames_requested)
 
 	frames_needed = frames_requested;
 
+	// The stretch factor only depends on the lock-free sample rates, so the
+	// channel's lock isn't needed here; the handler takes it when adding
+	// the rendered frames.
 	while (frames_needed > audio_frames.size()) {
-		std::unique_lock lock(mutex);
-
-		auto stretch_factor = static_cast<float>(sample_rate_hz) /
-		                      static_cast<float>(mixer.sample_rate_hz);
+		const auto stretch_factor = get_stretch_factor(GetSampleRate());
 
-		auto frames_remaining = iceil(
+		const auto frames_remaining = iceil(
 		        static_cast<float>(frames_needed - audio_frames.size()) *
 		        stretch_factor);
 
@@ -1194,7 +1193,6 @@ void MixerChannel::Mix(const int frames_requested)
 			break;
 		}
 
-		lock.unlock();
 		handler(frames_remaining);
 	}
 }
@@ -1216,8 +1214,12 @@ void MixerChannel::AddSilence()
 		} else {
 			bool stereo = last_samples_were_stereo;
 
-			const auto mapped_output_left  = output_map.left;
-			const auto mapped_output_right = output_map.right;
+			const auto mapped_output = GetLineoutMap();
+			const auto mapped_output_left  = mapped_output.left;
+			const auto mapped_output_right = mapped_output.right;
+
+			const auto volume_gain = combined_volume_gain.load(
+			        std::memory_order_relaxed);
 
 			while (audio_frames.size() < frames_needed) {
 				// Fade gradually to silence to avoid clicks.
@@ -1238,7 +1240,7 @@ void MixerChannel::AddSilence()
 				const auto frame_with_gain =
 				        (stereo ? prev_frame
 				                : AudioFrame{prev_frame.left}) *
-				        combined_volume_gain;
+				        volume_gain;
 
 				AudioFrame out_frame = {};
 				out_frame[mapped_output_left] = frame_with_gain.left;
@@ -1863,11 +1865,16 @@ void MixerChannel::ConvertSamplesAndMaybeZohUpsample(const Type* data,
 	assert(num_frames > 0);
 	convert_buffer.clear();
 
-	const auto mapped_output_left  = output_map.left;
-	const auto mapped_output_right = output_map.right;
+	// Sample the lock-free parameters once per batch of frames
+	const auto mapped_output  = output_map.load(std::memory_order_relaxed);
+	const auto mapped_channel = channel_map.load(std::memory_order_relaxed);
+	const auto volume_gain = combined_volume_gain.load(std::memory_order_relaxed);
 
-	const auto mapped_channel_left  = channel_map.left;
-	const auto mapped_channel_right = channel_map.right;
+	const auto mapped_output_left  = mapped_output.left;
+	const auto mapped_output_right = mapped_output.right;
+
+	const auto mapped_channel_left  = mapped_channel.left;
+	const auto mapped_channel_right = mapped_channel.right;
 
 	auto pos = 0;
 
@@ -1896,7 +1903,7 @@ void MixerChannel::ConvertSamplesAndMaybeZohUpsample(const Type* data,
 		} else {
 			frame_with_gain = {prev_frame[mapped_channel_left]};
 		}
-		frame_with_gain *= combined_volume_gain;
+		frame_with_gain *= volume_gain;
 
 		// Process initial samples through an expanding envelope to
 		// prevent severe clicks and pops. Becomes a no-op when done.
@@ -2061,6 +2068,13 @@ AudioFrame MixerChannel::Sleeper::MaybeFadeOrListen(const AudioFrame& frame)
 
 void MixerChannel::Sleeper::MaybeSleep()
 {
+	// The channel was woken up while awake; start another round of
+	// awakeness
+	if (wake_requested.exchange(false)) {
+		RestartCountdown();
+		return;
+	}
+
 	// A signed integer can a durration of ~24 days in milliseconds, which
 	// is surely more than enough.
 	const auto awake_for_ms = check_cast<int>(GetTicksSince(woken_at_ms));
@@ -2083,16 +2097,27 @@ void MixerChannel::Sleeper::MaybeSleep()
 	if (channel.is_enabled) {
 		channel.Enable(false);
 		// LOG_INFO("MIXER: %s fell asleep", channel.name.c_str());
+
+		// A wake-up that came in after the check above still saw the
+		// channel enabled and only left its request, so honour it now
+		if (wake_requested.exchange(false)) {
+			WakeUp();
+		}
 	}
 }
 
-// Returns true when actually awoken otherwise false if already awake.
-bool MixerChannel::Sleeper::WakeUp()
+void MixerChannel::Sleeper::RestartCountdown()
 {
-	// Always reset for another round of awakeness
 	woken_at_ms   = GetTicks();
 	fadeout_level = 1.0f;
 	had_signal    = false;
+}
+
+// Returns true when actually awoken otherwise false if already awake.
+bool MixerChannel::Sleeper::WakeUp()
+{
+	// Always reset for another round of awakeness
+	RestartCountdown();
 
 	const auto was_sleeping = !channel.is_enabled;
 	if (was_sleeping) {
@@ -2105,9 +2130,24 @@ bool MixerChannel::Sleeper::WakeUp()
 // Audio devices that use the sleep feature need to wake up the channel whenever
 // they might prepare new samples for it. Typically this is on IO port
 // writes into the card.
+//
+// This is called on every port write, so in the common case of the channel
+// being awake we only flag the wake-up for the mixer thread instead of taking
+// the channel's lock. We raise the flag and then re-check the enabled state,
+// while the mixer thread disables the channel and then re-checks the flag.
+// Both are sequentially consistent, so at least one side sees the other's
+// write and the wake-up can't get lost.
 bool MixerChannel::WakeUp()
 {
 	assert(do_sleep);
+
+	if (is_enabled) {
+		sleeper.wake_requested = true;
+		if (is_enabled) {
+			return false;
+		}
+	}
+
 	std::lock_guard lock(mutex);
 	return sleeper.WakeUp();
 }
@@ -2314,10 +2354,12 @@ std::string MixerChannel::DescribeLineout()
 	if (!HasFeature(ChannelFeature::Stereo)) {
 		return MSG_Get("SHELL_CMD_MIXER_CHANNEL_MONO");
 	}
-	if (output_map == StereoMap) {
+	const auto lineout_map = GetLineoutMap();
+
+	if (lineout_map == StereoMap) {
 		return MSG_Get("SHELL_CMD_MIXER_CHANNEL_STEREO");
 	}
-	if (output_map == ReverseMap) {
+	if (lineout_map == ReverseMap) {
 		return MSG_Get("SHELL_CMD_MIXER_CHANNEL_REVERSE");
 	}
 
@@ -2516,9 +2558,16 @@ static void mix_samples(const int frames_requested)
 			// Without this, it's a complete stuttery mess though so
 			// it's the lesser of two evils.
 			//
+			// The cleared samples are only dropped by the consumer,
+			// so this block might not fit in entirely either.
+			//
 			mixer.capture_queue.Clear();
 		}
 		mixer.capture_queue.NonblockingBulkEnqueue(mixer.capture_buffer);
+
+		perf_counters.capture_queue_depth.store(
+		        check_cast<uint32_t>(mixer.capture_queue.Size()),
+		        std::memory_order_relaxed);
 	}
 
 	// Normalize the final output before sending to SDL
@@ -2549,19 +2598,15 @@ static void capture_callback()
 	// Some mixer channels block waiting on the main thread and this would
 	// deadlock
 	static std::vector<int16_t> frames = {};
-	frames.clear();
-
-	const int samples_available = check_cast<int>(mixer.capture_queue.Size());
-	const int samples_requested = std::min(num_samples, samples_available);
+	frames.resize(num_samples);
 
-	if (samples_requested > 0) {
-		mixer.capture_queue.BulkDequeue(frames,
-		                                std::min(num_samples,
-		                                         samples_available));
-	}
+	const auto samples_received = mixer.capture_queue.NonblockingBulkDequeue(
+	        frames);
 
 	// Fill with silence if needed
-	frames.resize(num_samples);
+	std::fill(frames.begin() + static_cast<std::ptrdiff_t>(samples_received),
+	          frames.end(),
+	          0);
 
 	CAPTURE_AddAudioData(mixer.sample_rate_hz, num_frames, frames.data());
 }
@@ -2582,13 +2627,10 @@ static void SDLCALL mixer_callback([[maybe_unused]] void* userdata,
 	// SDL's callback. This ensures that we do not block waiting for more
 	// audio. In the queue has run dry, we write what we have available and
 	// the rest of the request is silence.
-	const auto frames_to_dequeue = std::min(mixer.final_output.Size(),
-	                                        frames_requested);
-
 	const auto frame_stream = reinterpret_cast<AudioFrame*>(stream);
 
-	const auto frames_received = mixer.final_output.BulkDequeue(frame_stream,
-	                                                            frames_to_dequeue);
+	const auto frames_received = mixer.final_output.NonblockingBulkDequeue(
+	        {frame_stream, frames_requested});
 	// Satisfy any shortfall with silence
 	std::fill(frame_stream + frames_received,
 	          frame_stream + frames_requested,
@@ -2626,7 +2668,14 @@ static void mixer_thread_loop()
 			        ifloor(actual_time * get_mixer_frames_per_tick()));
 		}
 
+		const auto mix_start_us = GetTicksUs();
 		mix_samples(frames_requested);
+
+		perf_counters.mixer_callbacks.fetch_add(1, std::memory_order_relaxed);
+		perf_counters.mixer_callback_time_us.fetch_add(
+		        static_cast<uint64_t>(GetTicksUsSince(mix_start_us)),
+		        std::memory_order_relaxed);
+
 		assert(mixer.output_buffer.size() ==
 		       check_cast<size_t>(frames_requested));
 
@@ -2924,18 +2973,16 @@ void MIXER_Init(Section* sec)
 		mixer.sample_rate_hz = secprop->GetInt("rate");
 		mixer.blocksize      = secprop->GetInt("blocksize");
 
+		bool sound_on = false;
+
 		if (mixer_state == MixerState::NoSound) {
 			set_no_sound();
 
 		} else {
-			if (init_sdl_sound(secprop->GetInt("rate"),
-			                   secprop->GetInt("blocksize"),
-			                   secprop->GetBool("negotiate"))) {
-
-				// This also unpauses the audio device which is
-				// opened in paused mode by SDL.
-				set_mixer_state(MixerState::On);
-			} else {
+			sound_on = init_sdl_sound(secprop->GetInt("rate"),
+			                          secprop->GetInt("blocksize"),
+			                          secprop->GetBool("negotiate"));
+			if (!sound_on) {
 				set_no_sound();
 			}
 		}
@@ -2954,6 +3001,13 @@ void MIXER_Init(Section* sec)
 		// One second of audio
 		mixer.capture_queue.Resize(mixer.sample_rate_hz * 2);
 
+		if (sound_on) {
+			// This also unpauses the audio device which is opened in
+			// paused mode by SDL. The SDL callback starts consuming
+			// the output queue then, so it has to be sized by now.
+			set_mixer_state(MixerState::On);
+		}
+
 		mixer.thread = std::thread(mixer_thread_loop);
 		set_thread_name(mixer.thread, "dosbox:mixer");
 
@@ -155,6 +155,15 @@ constexpr auto DefaultChorusPreset = ChorusPreset::Normal;
 struct SpeexResamplerState_;
 typedef SpeexResamplerState_ SpeexResamplerState;
 
+// Thread-safety
+// ~~~~~~~~~~~~~
+// The channel's render state (resampler, filters, sample buffers, etc.) is
+// owned by the mixer thread and guarded by the channel's mutex. The
+// parameters that emulated devices query or update on every tick (sample
+// rate, volumes, channel mappings) and the immutable name and feature set can
+// be accessed from any thread without taking the mutex, so the emulation
+// thread never has to wait for a device callback to finish rendering.
+//
 class MixerChannel {
 public:
 	MixerChannel(MIXER_Handler _handler, const char* name,
@@ -170,7 +179,6 @@ public:
 	double GetMillisPerFrame();
 
 	void Set0dbScalar(const float f);
-	void UpdateCombinedVolume();
 
 	// The "user volume" is the volume level of the built-in DOSBox mixer
 	// (MIXER command)
@@ -280,8 +288,13 @@ public:
 		void MaybeSleep();
 		bool WakeUp();
 
+		// Set by MixerChannel::WakeUp() when the channel is already
+		// awake; the mixer thread restarts the countdown in MaybeSleep()
+		std::atomic<bool> wake_requested = false;
+
 	private:
 		void DecrementFadeLevel(const int awake_for_ms);
+		void RestartCountdown();
 
 		MixerChannel& channel;
 
@@ -326,33 +339,33 @@ private:
 
 	AudioFrame ApplyCrossfeed(const AudioFrame frame);
 
-	std::string name = {};
-	Envelope envelope;
-	MIXER_Handler handler = nullptr;
+	void UpdateCombinedVolume();
 
-	std::vector<AudioFrame> convert_buffer = {};
+	static constexpr size_t CacheLineSize = 64;
 
-	std::set<ChannelFeature> features = {};
+	// Immutable after construction
+	const std::string name                  = {};
+	const std::set<ChannelFeature> features = {};
+	const MIXER_Handler handler             = nullptr;
 
-	// Timing on how many samples were needed by the mixer
-	size_t frames_needed = 0;
-
-	// Previous and next sample fames
-	AudioFrame prev_frame = {};
-	AudioFrame next_frame = {};
-
-	std::atomic<int> sample_rate_hz = 0;
+	// Lock-free parameters
+	// ~~~~~~~~~~~~~~~~~~~~
+	// These are written by the emulation thread (or the main thread) and
+	// read by the mixer thread once per AddSamples() call. They live on
+	// their own cache line so that updating them doesn't invalidate the
+	// render state below.
+	alignas(CacheLineSize) std::atomic<int> sample_rate_hz = 0;
 
 	// Volume gains
 	// ~~~~~~~~~~~~
 	// The user sets this via the MIXER command, which lets them magnify or
 	// diminish the channel's volume relative to other adjustments, such as
 	// any adjustments done by the application at runtime.
-	AudioFrame user_volume_gain = {1.0f, 1.0f};
+	std::atomic<AudioFrame> user_volume_gain = AudioFrame{1.0f, 1.0f};
 
 	// The application (might) adjust a channel's volume programmatically at
 	// runtime (e.g., via the Sound Blaster or ReelMagic control interfaces).
-	AudioFrame app_volume_gain = {1.0f, 1.0f};
+	std::atomic<AudioFrame> app_volume_gain = AudioFrame{1.0f, 1.0f};
 
 	// The 0 dB volume gain is used to bring a channel to 0 dB in the
 	// signed 16-bit [-32k, +32k] range.
@@ -365,27 +378,44 @@ private:
 	//  2. The GUS's simultaneous voices can accumulate to ~100%+RMS
 	//     above 0 dB, so for that channel we set this to RMS (sqrt of half).
 	//
-	float db0_volume_gain = 1.0f;
+	std::atomic<float> db0_volume_gain = 1.0f;
 
 	// All three of these volume gains are multiplied together to form the
 	// combined volume gain. This means we can apply one float-multiply per
 	// sample and perform all three adjustments at once.
 	//
-	AudioFrame combined_volume_gain = {1.0f, 1.0f};
+	std::atomic<AudioFrame> combined_volume_gain = AudioFrame{1.0f, 1.0f};
 
-	// Defines the peak sample amplitude we can expect in this channel.
-	// Default to signed 16bit max, however channel's that know their own
-	// peak, like the PCSpeaker, should update it with: SetPeakAmplitude()
-	//
-	int peak_amplitude = Max16BitSampleValue;
+	// Serialises the volume setters; see UpdateCombinedVolume()
+	std::mutex volume_mutex = {};
 
 	// User-configurable that defines how the channel's Stereo line maps
 	// into the mixer.
-	StereoLine output_map = StereoMap;
+	std::atomic<StereoLine> output_map = StereoMap;
 
 	// DOS application-configurable that maps the channels own "left" or
 	// "right" as themselves or vice-versa.
-	StereoLine channel_map = StereoMap;
+	std::atomic<StereoLine> channel_map = StereoMap;
+
+	// Render state
+	// ~~~~~~~~~~~~
+	// Owned by the mixer thread; guarded by the mutex.
+	alignas(CacheLineSize) Envelope envelope;
+
+	std::vector<AudioFrame> convert_buffer = {};
+
+	// Timing on how many samples were needed by the mixer
+	size_t frames_needed = 0;
+
+	// Previous and next sample fames
+	AudioFrame prev_frame = {};
+	AudioFrame next_frame = {};
+
+	// Defines the peak sample amplitude we can expect in this channel.
+	// Default to signed 16bit max, however channel's that know their own
+	// peak, like the PCSpeaker, should update it with: SetPeakAmplitude()
+	//
+	int peak_amplitude = Max16BitSampleValue;
 
 	bool last_samples_were_stereo  = false;
 	bool last_samples_were_silence = true;
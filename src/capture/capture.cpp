@@ -30,6 +30,8 @@ static struct {
 	std_fs::path path     = {};
 	bool path_initialised = false;
 
+	ImageFileFormat image_file_format = ImageFileFormat::Png;
+
 	struct {
 		std::atomic<CaptureState> audio = {};
 		std::atomic<CaptureState> midi  = {};
@@ -142,7 +144,9 @@ static const char* capture_type_to_extension(const CaptureType type)
 
 	case CaptureType::RawImage:
 	case CaptureType::UpscaledImage:
-	case CaptureType::RenderedImage: return ".png";
+	case CaptureType::RenderedImage:
+		return (capture.image_file_format == ImageFileFormat::Qoi) ? ".qoi"
+		                                                           : ".png";
 
 	case CaptureType::SerialLog: return ".serlog";
 
@@ -596,7 +600,37 @@ static void capture_init(Section* sec)
 
 	const std::string prefs = secprop->GetString("default_image_capture_formats");
 
-	image_capturer = std::make_unique<ImageCapturer>(prefs);
+	ImageSaverSettings saver_settings = {};
+
+	saver_settings.file_format = (secprop->GetString("image_file_format") == "qoi")
+	                                   ? ImageFileFormat::Qoi
+	                                   : ImageFileFormat::Png;
+
+	saver_settings.png_compression_level = secprop->GetInt("png_compression_level");
+
+	capture.image_file_format = saver_settings.file_format;
+
+	ImageCheckSettings check_settings = {};
+
+	check_settings.skip_duplicates = secprop->GetBool("skip_duplicate_images");
+
+	const std::string golden_mode = secprop->GetString("golden_images");
+	if (golden_mode == "record") {
+		check_settings.golden_mode = GoldenImageMode::Record;
+	} else if (golden_mode == "compare") {
+		check_settings.golden_mode = GoldenImageMode::Compare;
+	}
+
+	PropPath* golden_dir = secprop->GetPath("golden_images_dir");
+	assert(golden_dir);
+	check_settings.golden_dir = golden_dir->realpath.empty() ? "golden"
+	                                                         : golden_dir->realpath;
+
+	check_settings.report_path = capture.path / "golden-report.json";
+
+	image_capturer = std::make_unique<ImageCapturer>(prefs,
+	                                                 saver_settings,
+	                                                 check_settings);
 
 	constexpr auto changeable_at_runtime = true;
 	sec->AddDestroyFunction(&capture_destroy, changeable_at_runtime);
@@ -683,6 +717,50 @@ static void init_capture_dosbox_settings(SectionProp& secprop)
 	        "Keybindings for taking single screenshots in specific formats are also\n"
 	        "available.");
 	assert(str_prop);
+
+	str_prop = secprop.AddString("image_file_format", when_idle, "png");
+	str_prop->SetValues({"png", "qoi"});
+	str_prop->SetHelp(
+	        "File format of the screenshots ('png' by default):\n"
+	        "  png:  Portable Network Graphics; the compression level is set with\n"
+	        "        'png_compression_level'.\n"
+	        "  qoi:  Quite OK Image format; saves several times faster than PNG at\n"
+	        "        the expense of larger files. Useful when taking lots of\n"
+	        "        screenshots for automated comparisons. QOI files don't store the\n"
+	        "        pixel aspect ratio of raw screenshots.");
+
+	auto* int_prop = secprop.AddInt("png_compression_level", when_idle, 6);
+	int_prop->SetMinMax(0, 9);
+	int_prop->SetHelp(
+	        "Compression level of PNG screenshots, from 0 (uncompressed, fastest) to 9\n"
+	        "(smallest files, slowest); 6 by default. Levels above 6 rarely produce\n"
+	        "noticeably smaller files, but take considerably longer to save.");
+
+	auto* bool_prop = secprop.AddBool("skip_duplicate_images", when_idle, false);
+	bool_prop->SetHelp(
+	        "Don't save a screenshot if the raw emulated image is identical to that of\n"
+	        "the previous screenshot (disabled by default).");
+
+	str_prop = secprop.AddString("golden_images", when_idle, "off");
+	str_prop->SetValues({"off", "record", "compare"});
+	str_prop->SetHelp(
+	        "Visual regression testing of automated screenshot runs ('off' by default):\n"
+	        "  off:      Screenshots are saved as usual.\n"
+	        "  record:   Screenshots are saved as usual, and the hashes of their raw\n"
+	        "            images are written to 'hashes.txt' in 'golden_images_dir' on\n"
+	        "            exit.\n"
+	        "  compare:  The hash of each screenshot is compared against the recorded\n"
+	        "            hash of the screenshot with the same sequence number. Only\n"
+	        "            the non-matching screenshots are saved, and a JSON report with\n"
+	        "            the results is written to 'golden-report.json' in the capture\n"
+	        "            directory on exit.\n"
+	        "Note: The hashes don't depend on the output resolution, the shaders in use,\n"
+	        "      or the image file format.");
+
+	path_prop = secprop.AddPath("golden_images_dir", when_idle, "golden");
+	path_prop->SetHelp(
+	        "Directory of the golden image hashes used by the 'golden_images' setting\n"
+	        "('golden' in the current working directory by default).");
 }
 
 void CAPTURE_AddConfigSection(const ConfigPtr& conf)
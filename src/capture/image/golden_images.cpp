@@ -0,0 +1,231 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "golden_images.h"
+
+#include <cassert>
+#include <fstream>
+
+#include "image_hash.h"
+#include "misc/support.h"
+#include "utils/checks.h"
+#include "utils/string_utils.h"
+
+CHECK_NARROWING();
+
+constexpr auto HashesFilename = "hashes.txt";
+
+GoldenImages::~GoldenImages()
+{
+	switch (mode) {
+	case GoldenImageMode::Off: break;
+	case GoldenImageMode::Record: SaveHashes(); break;
+	case GoldenImageMode::Compare: WriteReport(); break;
+	}
+}
+
+void GoldenImages::Init(const GoldenImageMode _mode, const std_fs::path& golden_dir,
+                        const std_fs::path& _report_path)
+{
+	mode        = _mode;
+	hashes_path = golden_dir / HashesFilename;
+	report_path = _report_path;
+
+	golden_hashes.clear();
+	results.clear();
+
+	if (mode == GoldenImageMode::Compare && !LoadHashes()) {
+		LOG_WARNING("CAPTURE: Could not read golden image hashes from '%s', "
+		            "all screenshots will be reported as missing",
+		            hashes_path.string().c_str());
+	}
+}
+
+// The hashes file contains one "<screenshot number> <hash>" pair per line;
+// empty lines and lines starting with '#' are ignored
+bool GoldenImages::LoadHashes()
+{
+	std::ifstream in(hashes_path);
+	if (!in) {
+		return false;
+	}
+
+	std::string line = {};
+	while (std::getline(in, line)) {
+		trim(line);
+		if (line.empty() || line.starts_with('#')) {
+			continue;
+		}
+
+		const auto fields = split(line);
+		if (fields.size() != 2) {
+			LOG_WARNING("CAPTURE: Invalid line in '%s': %s",
+			            hashes_path.string().c_str(),
+			            line.c_str());
+			continue;
+		}
+
+		const auto number = parse_int(fields[0]);
+		if (!number || *number < 1) {
+			continue;
+		}
+
+		uint64_t hash = 0;
+		try {
+			hash = std::stoull(fields[1], nullptr, 16);
+		} catch (...) {
+			continue;
+		}
+
+		const auto index = static_cast<size_t>(*number - 1);
+		if (golden_hashes.size() <= index) {
+			golden_hashes.resize(index + 1);
+		}
+		golden_hashes[index] = hash;
+	}
+	return true;
+}
+
+void GoldenImages::SaveHashes() const
+{
+	std::error_code ec = {};
+	std_fs::create_directories(hashes_path.parent_path(), ec);
+
+	std::ofstream out(hashes_path, std::ios::trunc);
+	if (!out) {
+		LOG_ERR("CAPTURE: Could not write golden image hashes to '%s'",
+		        hashes_path.string().c_str());
+		return;
+	}
+
+	out << "# Screenshot number and hash of the raw image\n";
+	for (size_t i = 0; i < results.size(); ++i) {
+		out << format_str("%zu %s\n",
+		                  i + 1,
+		                  image_hash_to_string(results[i].actual).c_str());
+	}
+
+	LOG_MSG("CAPTURE: Recorded %zu golden image hashes to '%s'",
+	        results.size(),
+	        hashes_path.string().c_str());
+}
+
+GoldenImages::Status GoldenImages::AddImage(const uint64_t hash)
+{
+	assert(mode != GoldenImageMode::Off);
+
+	Result result = {};
+	result.actual = hash;
+
+	const auto index = results.size();
+	if (mode == GoldenImageMode::Compare && index < golden_hashes.size()) {
+		result.expected = golden_hashes[index];
+	}
+	results.emplace_back(std::move(result));
+
+	if (!results.back().expected) {
+		return Status::Missing;
+	}
+	return (*results.back().expected == hash) ? Status::Pass : Status::Fail;
+}
+
+void GoldenImages::SetLastImageFilename(const std::string& filename)
+{
+	if (!results.empty()) {
+		results.back().filename = filename;
+	}
+}
+
+static std::string escape_json(const std::string& str)
+{
+	std::string escaped = {};
+	for (const auto c : str) {
+		if (c == '"' || c == '\\') {
+			escaped += '\\';
+		}
+		escaped += c;
+	}
+	return escaped;
+}
+
+void GoldenImages::WriteReport() const
+{
+	size_t num_passed  = 0;
+	size_t num_failed  = 0;
+	size_t num_missing = 0;
+
+	std::string images = {};
+
+	for (size_t i = 0; i < results.size(); ++i) {
+		const auto& result = results[i];
+
+		const char* status = "missing";
+		if (result.expected) {
+			if (*result.expected == result.actual) {
+				status = "pass";
+				++num_passed;
+			} else {
+				status = "fail";
+				++num_failed;
+			}
+		} else {
+			++num_missing;
+		}
+
+		if (!images.empty()) {
+			images += ",";
+		}
+		images += format_str("{\"number\":%zu,\"status\":\"%s\",\"actual\":\"%s\"",
+		                     i + 1,
+		                     status,
+		                     image_hash_to_string(result.actual).c_str());
+		if (result.expected) {
+			images += format_str(",\"expected\":\"%s\"",
+			                     image_hash_to_string(*result.expected).c_str());
+		}
+		if (!result.filename.empty()) {
+			images += format_str(",\"file\":\"%s\"",
+			                     escape_json(result.filename).c_str());
+		}
+		images += "}";
+	}
+
+	// Golden images that were never captured count as failures too
+	const auto num_not_captured = (golden_hashes.size() > results.size())
+	                                    ? golden_hashes.size() - results.size()
+	                                    : 0;
+
+	const auto passed = (num_failed == 0 && num_missing == 0 &&
+	                     num_not_captured == 0);
+
+	std::string report = "{";
+	report += format_str("\"result\":\"%s\",", passed ? "pass" : "fail");
+	report += format_str("\"golden_hashes\":\"%s\",",
+	                     escape_json(hashes_path.generic_string()).c_str());
+	report += format_str("\"passed\":%zu,", num_passed);
+	report += format_str("\"failed\":%zu,", num_failed);
+	report += format_str("\"missing\":%zu,", num_missing);
+	report += format_str("\"not_captured\":%zu,", num_not_captured);
+	report += format_str("\"images\":[%s]", images.c_str());
+	report += "}\n";
+
+	std::error_code ec = {};
+	std_fs::create_directories(report_path.parent_path(), ec);
+
+	std::ofstream out(report_path, std::ios::trunc);
+	if (!out) {
+		LOG_ERR("CAPTURE: Could not write golden image report to '%s'",
+		        report_path.string().c_str());
+		return;
+	}
+	out << report;
+
+	LOG_MSG("CAPTURE: Golden image comparison %s: %zu passed, %zu failed, "
+	        "%zu missing, %zu not captured; report written to '%s'",
+	        passed ? "passed" : "failed",
+	        num_passed,
+	        num_failed,
+	        num_missing,
+	        num_not_captured,
+	        report_path.string().c_str());
+}
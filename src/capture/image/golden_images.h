@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_GOLDEN_IMAGES_H
+#define DOSBOX_GOLDEN_IMAGES_H
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "misc/std_filesystem.h"
+
+enum class GoldenImageMode { Off, Record, Compare };
+
+// Visual regression testing support for automated screenshot test runs.
+//
+// In record mode, the hashes of all screenshots taken during the session are
+// written to the golden hashes file when the image capturer shuts down. In
+// compare mode, the hash of the Nth screenshot is compared against the Nth
+// golden hash; only mismatching screenshots need to be saved, and a JSON
+// report with the results is written at shutdown.
+//
+// The hashes are calculated from the raw images (see hash_rendered_image()),
+// so they don't depend on the output resolution, shaders, or image format.
+//
+class GoldenImages {
+public:
+	enum class Status { Pass, Fail, Missing };
+
+	GoldenImages() = default;
+	~GoldenImages();
+
+	void Init(const GoldenImageMode mode, const std_fs::path& golden_dir,
+	          const std_fs::path& report_path);
+
+	GoldenImageMode GetMode() const
+	{
+		return mode;
+	}
+
+	// Registers the next screenshot. In compare mode, the result of the
+	// comparison is returned; in record mode the result is always
+	// Status::Missing.
+	Status AddImage(const uint64_t hash);
+
+	// Stores the name of the file the last screenshot was saved to, so it
+	// can be referenced in the report
+	void SetLastImageFilename(const std::string& filename);
+
+	// prevent copying
+	GoldenImages(const GoldenImages&) = delete;
+	// prevent assignment
+	GoldenImages& operator=(const GoldenImages&) = delete;
+
+private:
+	struct Result {
+		uint64_t actual                  = 0;
+		std::optional<uint64_t> expected = {};
+		std::string filename             = {};
+	};
+
+	bool LoadHashes();
+	void SaveHashes() const;
+	void WriteReport() const;
+
+	GoldenImageMode mode     = GoldenImageMode::Off;
+	std_fs::path hashes_path = {};
+	std_fs::path report_path = {};
+
+	// Screenshots without a valid line in the hashes file have no hash
+	std::vector<std::optional<uint64_t>> golden_hashes = {};
+	std::vector<Result> results                        = {};
+};
+
+#endif // DOSBOX_GOLDEN_IMAGES_H
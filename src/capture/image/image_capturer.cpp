@@ -7,18 +7,27 @@
 #include <string>
 
 #include "config/setup.h"
+#include "image_hash.h"
 #include "misc/std_filesystem.h"
 #include "utils/checks.h"
 #include "utils/string_utils.h"
 
 CHECK_NARROWING();
 
-ImageCapturer::ImageCapturer(const std::string& grouped_mode_prefs)
+ImageCapturer::ImageCapturer(const std::string& grouped_mode_prefs,
+                             const ImageSaverSettings& saver_settings,
+                             const ImageCheckSettings& check_settings)
 {
 	ConfigureGroupedMode(grouped_mode_prefs);
 
+	skip_duplicates = check_settings.skip_duplicates;
+
+	golden_images.Init(check_settings.golden_mode,
+	                   check_settings.golden_dir,
+	                   check_settings.report_path);
+
 	for (auto& image_saver : image_savers) {
-		image_saver.Open();
+		image_saver.Open(saver_settings);
 	}
 
 	LOG_MSG("CAPTURE: Image capturer started");
@@ -152,11 +161,27 @@ void ImageCapturer::MaybeCaptureImage(const RenderedImage& image)
 		return;
 	}
 
+	if (IsImageToBeSkipped(image)) {
+		// Cancel the pending post-render capture too
+		state.rendered = CaptureState::Off;
+		state.grouped  = CaptureState::Off;
+		return;
+	}
+
 	// We can pass in any of the image types, it doesn't matter which
 	const auto index = get_next_capture_index(CaptureType::RawImage);
 	if (!index) {
 		return;
 	}
+
+	if (golden_images.GetMode() != GoldenImageMode::Off) {
+		const auto type = do_raw ? CaptureType::RawImage
+		                : do_upscaled ? CaptureType::UpscaledImage
+		                              : CaptureType::RenderedImage;
+
+		golden_images.SetLastImageFilename(
+		        generate_capture_filename(type, index).filename().string());
+	}
 	if (do_raw) {
 		GetNextImageSaver().QueueImage(
 		        image.deep_copy(),
@@ -176,6 +201,35 @@ void ImageCapturer::MaybeCaptureImage(const RenderedImage& image)
 	}
 }
 
+// Hashing the raw image is cheap compared to upscaling and encoding it, so
+// duplicate and golden images are filtered out before queuing them
+bool ImageCapturer::IsImageToBeSkipped(const RenderedImage& image)
+{
+	if (!skip_duplicates && golden_images.GetMode() == GoldenImageMode::Off) {
+		return false;
+	}
+
+	const auto hash = hash_rendered_image(image);
+
+	if (skip_duplicates) {
+		if (last_image_hash == hash) {
+			LOG_MSG("CAPTURE: Skipped screenshot identical to the previous one");
+			return true;
+		}
+		last_image_hash = hash;
+	}
+
+	if (golden_images.GetMode() == GoldenImageMode::Compare) {
+		// Only the screenshots that don't match their golden images
+		// need to be saved
+		return golden_images.AddImage(hash) == GoldenImages::Status::Pass;
+	}
+	if (golden_images.GetMode() == GoldenImageMode::Record) {
+		golden_images.AddImage(hash);
+	}
+	return false;
+}
+
 void ImageCapturer::CapturePostRenderImage(const RenderedImage& image)
 {
 	GetNextImageSaver().QueueImage(image, CapturedImageType::Rendered, rendered_path);
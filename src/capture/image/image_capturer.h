@@ -5,13 +5,25 @@
 #define DOSBOX_IMAGE_CAPTURER_H
 
 #include <array>
+#include <optional>
 #include <string>
 
 #include "capture/capture.h"
+#include "golden_images.h"
 #include "gui/render.h"
 #include "image_saver.h"
 #include "misc/std_filesystem.h"
 
+struct ImageCheckSettings {
+	// Don't save a screenshot if its raw image is identical to that of the
+	// previous screenshot
+	bool skip_duplicates = false;
+
+	GoldenImageMode golden_mode = GoldenImageMode::Off;
+	std_fs::path golden_dir     = {};
+	std_fs::path report_path    = {};
+};
+
 // Image capturing works in a rather roundabout fashion... If capturing the
 // next frame has been requested (e.g. by pressing one of the capture
 // shortcuts), first we store the request. Then the renderer that generates
@@ -40,7 +52,9 @@
 class ImageCapturer {
 public:
 	ImageCapturer() = default;
-	ImageCapturer(const std::string& grouped_mode_prefs);
+	ImageCapturer(const std::string& grouped_mode_prefs,
+	              const ImageSaverSettings& saver_settings,
+	              const ImageCheckSettings& check_settings);
 
 	~ImageCapturer();
 
@@ -78,12 +92,19 @@ private:
 
 	std_fs::path rendered_path    = {};
 
+	bool skip_duplicates                    = false;
+	std::optional<uint64_t> last_image_hash = {};
+
+	GoldenImages golden_images = {};
+
 	static constexpr auto NumImageSavers                = 3;
 	size_t current_image_saver_index                    = 0;
 	std::array<ImageSaver, NumImageSavers> image_savers = {};
 
 	void ConfigureGroupedMode(const std::string& prefs);
 
+	bool IsImageToBeSkipped(const RenderedImage& image);
+
 	ImageSaver& GetNextImageSaver();
 };
 
@@ -0,0 +1,121 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "image_hash.h"
+
+#include <cstring>
+
+#include "utils/checks.h"
+#include "utils/string_utils.h"
+
+CHECK_NARROWING();
+
+namespace {
+
+// A MurmurHash3-style hash processing 8 bytes at a time; easily fast enough
+// to hash every frame at high resolutions.
+class Hasher {
+public:
+	void Add(const uint8_t* data, size_t size)
+	{
+		length += size;
+
+		while (size >= sizeof(uint64_t)) {
+			uint64_t block = 0;
+			std::memcpy(&block, data, sizeof(block));
+			MixBlock(block);
+
+			data += sizeof(uint64_t);
+			size -= sizeof(uint64_t);
+		}
+		if (size > 0) {
+			uint64_t block = 0;
+			std::memcpy(&block, data, size);
+			MixBlock(block);
+		}
+	}
+
+	void Add(const uint64_t value)
+	{
+		MixBlock(value);
+	}
+
+	uint64_t Finish() const
+	{
+		// MurmurHash3 64-bit finaliser
+		auto h = state ^ length;
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdULL;
+		h ^= h >> 33;
+		h *= 0xc4ceb9fe1a85ec53ULL;
+		h ^= h >> 33;
+		return h;
+	}
+
+private:
+	static constexpr uint64_t rotl(const uint64_t x, const int r)
+	{
+		return (x << r) | (x >> (64 - r));
+	}
+
+	void MixBlock(uint64_t k)
+	{
+		k *= 0x87c37b91114253d5ULL;
+		k = rotl(k, 31);
+		k *= 0x4cf5ad432745937fULL;
+
+		state ^= k;
+		state = rotl(state, 27) * 5 + 0x52dce729;
+	}
+
+	uint64_t state  = 0x9e3779b97f4a7c15ULL;
+	uint64_t length = 0;
+};
+
+} // namespace
+
+uint64_t hash_rendered_image(const RenderedImage& image)
+{
+	const auto& params = image.params;
+
+	Hasher hasher = {};
+	hasher.Add(static_cast<uint64_t>(params.width));
+	hasher.Add(static_cast<uint64_t>(params.height));
+	hasher.Add(static_cast<uint64_t>(params.pixel_format));
+
+	if (!image.image_data) {
+		return hasher.Finish();
+	}
+
+	const auto bits_per_pixel = get_bits_per_pixel(params.pixel_format);
+	const auto row_size = static_cast<size_t>(params.width) * bits_per_pixel / 8;
+
+	// Hash the rows in top-to-bottom order regardless of how the image is
+	// stored
+	for (auto y = 0; y < params.height; ++y) {
+		const auto row = image.is_flipped_vertically ? (params.height - 1 - y)
+		                                             : y;
+		hasher.Add(image.image_data + static_cast<size_t>(row) * image.pitch,
+		           row_size);
+	}
+
+	if (image.is_paletted() && image.palette_data) {
+		constexpr auto PaletteNumBytes = 256 * 4;
+
+		// Skip the padding bytes, they're not guaranteed to be zero
+		uint8_t palette[256 * 3] = {};
+		for (auto i = 0, j = 0; i < PaletteNumBytes; i += 4, j += 3) {
+			palette[j + 0] = image.palette_data[i + 0];
+			palette[j + 1] = image.palette_data[i + 1];
+			palette[j + 2] = image.palette_data[i + 2];
+		}
+		hasher.Add(palette, sizeof(palette));
+	}
+
+	return hasher.Finish();
+}
+
+std::string image_hash_to_string(const uint64_t hash)
+{
+	return format_str("%016llx", static_cast<unsigned long long>(hash));
+}
@@ -0,0 +1,21 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_IMAGE_HASH_H
+#define DOSBOX_IMAGE_HASH_H
+
+#include <cstdint>
+#include <string>
+
+#include "gui/render.h"
+
+// Fast non-cryptographic 64-bit hash of a rendered image as it comes out of
+// the emulated video card (i.e., before any scaling). Only the visible pixels
+// are hashed (the padding at the end of the rows is ignored), plus the
+// dimensions, the pixel format, and the palette of paletted images, so two
+// images with the same hash look identical.
+uint64_t hash_rendered_image(const RenderedImage& image);
+
+std::string image_hash_to_string(const uint64_t hash);
+
+#endif // DOSBOX_IMAGE_HASH_H
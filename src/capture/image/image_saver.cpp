@@ -11,6 +11,7 @@
 #include "capture/capture.h"
 #include "misc/support.h"
 #include "png_writer.h"
+#include "qoi_writer.h"
 #include "utils/checks.h"
 
 CHECK_NARROWING();
@@ -20,12 +21,14 @@ ImageSaver::~ImageSaver()
 	Close();
 }
 
-void ImageSaver::Open()
+void ImageSaver::Open(const ImageSaverSettings& _settings)
 {
 	if (is_open) {
 		Close();
 	}
 
+	settings = _settings;
+
 	const auto worker_function = std::bind(&ImageSaver::SaveQueuedImages, this);
 	renderer = std::thread(worker_function);
 	set_thread_name(renderer, "dosbox:imgcap");
@@ -90,36 +93,59 @@ void ImageSaver::SaveImage(const SaveImageTask& task)
 		return;
 	}
 
-	switch (task.image_type) {
-	case CapturedImageType::Raw: SaveRawImage(task.image); break;
-	case CapturedImageType::Upscaled: SaveUpscaledImage(task.image); break;
-	case CapturedImageType::Rendered: SaveRenderedImage(task.image); break;
+	// The writers finish writing the image when they go out of scope, so
+	// they must be destroyed before closing the file
+	switch (settings.file_format) {
+	case ImageFileFormat::Png: {
+		PngWriter png_writer(settings.png_compression_level);
+		SaveImageAs(png_writer, task);
+	} break;
+
+	case ImageFileFormat::Qoi: {
+		QoiWriter qoi_writer = {};
+		SaveImageAs(qoi_writer, task);
+	} break;
 	}
 
 	CloseOutFile();
 }
 
-static void write_upscaled_png(FILE* outfile, PngWriter& png_writer,
-                               ImageScaler& image_scaler, const uint16_t width,
-                               const uint16_t height,
-                               const Fraction& pixel_aspect_ratio,
-                               const VideoMode& video_mode,
-                               const uint8_t* palette_data)
+template <typename ImageWriter>
+void ImageSaver::SaveImageAs(ImageWriter& writer, const SaveImageTask& task)
+{
+	switch (task.image_type) {
+	case CapturedImageType::Raw: SaveRawImage(writer, task.image); break;
+	case CapturedImageType::Upscaled:
+		SaveUpscaledImage(writer, task.image);
+		break;
+	case CapturedImageType::Rendered:
+		SaveRenderedImage(writer, task.image);
+		break;
+	}
+}
+
+template <typename ImageWriter>
+static void write_upscaled_image(FILE* outfile, ImageWriter& image_writer,
+                                 ImageScaler& image_scaler, const uint16_t width,
+                                 const uint16_t height,
+                                 const Fraction& pixel_aspect_ratio,
+                                 const VideoMode& video_mode,
+                                 const uint8_t* palette_data)
 {
 	switch (image_scaler.GetOutputPixelFormat()) {
 	case OutputPixelFormat::Indexed8:
-		if (!png_writer.InitIndexed8(outfile,
-		                             width,
-		                             height,
-		                             pixel_aspect_ratio,
-		                             video_mode,
-		                             palette_data)) {
+		if (!image_writer.InitIndexed8(outfile,
+		                               width,
+		                               height,
+		                               pixel_aspect_ratio,
+		                               video_mode,
+		                               palette_data)) {
 			return;
 		}
 		break;
 
 	case OutputPixelFormat::Rgb888:
-		if (!png_writer.InitRgb888(
+		if (!image_writer.InitRgb888(
 		            outfile, width, height, pixel_aspect_ratio, video_mode)) {
 			return;
 		}
@@ -129,14 +155,13 @@ static void write_upscaled_png(FILE* outfile, PngWriter& png_writer,
 	auto rows_to_write = image_scaler.GetOutputHeight();
 	while (rows_to_write--) {
 		auto row = image_scaler.GetNextOutputRow();
-		png_writer.WriteRow(row);
+		image_writer.WriteRow(row);
 	}
 }
 
-void ImageSaver::SaveRawImage(const RenderedImage& image)
+template <typename ImageWriter>
+void ImageSaver::SaveRawImage(ImageWriter& image_writer, const RenderedImage& image)
 {
-	PngWriter png_writer = {};
-
 	const auto& src = image.params;
 
 	// To reconstruct the raw image, we must skip every second row when
@@ -160,20 +185,20 @@ void ImageSaver::SaveRawImage(const RenderedImage& image)
 	const auto pixel_aspect_ratio = src.video_mode.pixel_aspect_ratio;
 
 	if (image.is_paletted()) {
-		if (!png_writer.InitIndexed8(outfile,
-		                             output_width,
-		                             output_height,
-		                             pixel_aspect_ratio,
-		                             src.video_mode,
-		                             image.palette_data)) {
+		if (!image_writer.InitIndexed8(outfile,
+		                               output_width,
+		                               output_height,
+		                               pixel_aspect_ratio,
+		                               src.video_mode,
+		                               image.palette_data)) {
 			return;
 		}
 	} else {
-		if (!png_writer.InitRgb888(outfile,
-		                           output_width,
-		                           output_height,
-		                           pixel_aspect_ratio,
-		                           src.video_mode)) {
+		if (!image_writer.InitRgb888(outfile,
+		                             output_width,
+		                             output_height,
+		                             pixel_aspect_ratio,
+		                             src.video_mode)) {
 			return;
 		}
 	}
@@ -202,46 +227,46 @@ void ImageSaver::SaveRawImage(const RenderedImage& image)
 				*out++ = pixel.blue;
 			}
 		}
-		png_writer.WriteRow(row_buf.begin());
+		image_writer.WriteRow(row_buf.begin());
 		image_decoder.AdvanceRow();
 	}
 }
 
 static constexpr auto square_pixel_aspect_ratio = Fraction{1};
 
-void ImageSaver::SaveUpscaledImage(const RenderedImage& image)
+template <typename ImageWriter>
+void ImageSaver::SaveUpscaledImage(ImageWriter& image_writer,
+                                   const RenderedImage& image)
 {
-	PngWriter png_writer = {};
-
 	image_scaler.Init(image);
 
 	// Always write 1:1 pixel aspect ratio into the PNG pHYs chunk for
 	// upscaled images as the "non-squaredness" is "baked into" the image
 	// data.
-	write_upscaled_png(outfile,
-	                   png_writer,
-	                   image_scaler,
-	                   image_scaler.GetOutputWidth(),
-	                   image_scaler.GetOutputHeight(),
-	                   square_pixel_aspect_ratio,
-	                   image.params.video_mode,
-	                   image.palette_data);
+	write_upscaled_image(outfile,
+	                     image_writer,
+	                     image_scaler,
+	                     image_scaler.GetOutputWidth(),
+	                     image_scaler.GetOutputHeight(),
+	                     square_pixel_aspect_ratio,
+	                     image.params.video_mode,
+	                     image.palette_data);
 }
 
-void ImageSaver::SaveRenderedImage(const RenderedImage& image)
+template <typename ImageWriter>
+void ImageSaver::SaveRenderedImage(ImageWriter& image_writer,
+                                   const RenderedImage& image)
 {
-	PngWriter png_writer = {};
-
 	const auto& src = image.params;
 
 	// Always write 1:1 pixel aspect ratio into the PNG pHYs chunk for
 	// rendered images as the "non-squaredness" is "baked into" the image
 	// data.
-	if (!png_writer.InitRgb888(outfile,
-	                           check_cast<uint16_t>(src.width),
-	                           check_cast<uint16_t>(src.height),
-	                           square_pixel_aspect_ratio,
-	                           src.video_mode)) {
+	if (!image_writer.InitRgb888(outfile,
+	                             check_cast<uint16_t>(src.width),
+	                             check_cast<uint16_t>(src.height),
+	                             square_pixel_aspect_ratio,
+	                             src.video_mode)) {
 		return;
 	}
 
@@ -267,7 +292,7 @@ void ImageSaver::SaveRenderedImage(const RenderedImage& image)
 			*out++ = pixel.green;
 			*out++ = pixel.blue;
 		}
-		png_writer.WriteRow(row_buf.begin());
+		image_writer.WriteRow(row_buf.begin());
 		image_decoder.AdvanceRow();
 	}
 }
@@ -17,6 +17,15 @@
 
 enum class CapturedImageType { Raw, Upscaled, Rendered };
 
+enum class ImageFileFormat { Png, Qoi };
+
+struct ImageSaverSettings {
+	ImageFileFormat file_format = ImageFileFormat::Png;
+
+	// zlib compression level; 0 writes uncompressed PNG files
+	int png_compression_level = 6;
+};
+
 struct SaveImageTask {
 	RenderedImage image              = {};
 	CapturedImageType image_type     = {};
@@ -58,7 +67,7 @@ public:
 	ImageSaver() = default;
 	~ImageSaver();
 
-	void Open();
+	void Open(const ImageSaverSettings& settings);
 	void Close();
 
 	// IMPORTANT: The capturer _frees_ the passed in RenderedImage after the
@@ -80,9 +89,17 @@ private:
 	void SaveQueuedImages();
 	void SaveImage(const SaveImageTask& task);
 
-	void SaveRawImage(const RenderedImage& image);
-	void SaveUpscaledImage(const RenderedImage& image);
-	void SaveRenderedImage(const RenderedImage& image);
+	template <typename ImageWriter>
+	void SaveImageAs(ImageWriter& writer, const SaveImageTask& task);
+
+	template <typename ImageWriter>
+	void SaveRawImage(ImageWriter& writer, const RenderedImage& image);
+
+	template <typename ImageWriter>
+	void SaveUpscaledImage(ImageWriter& writer, const RenderedImage& image);
+
+	template <typename ImageWriter>
+	void SaveRenderedImage(ImageWriter& writer, const RenderedImage& image);
 
 	void CloseOutFile();
 
@@ -90,6 +107,8 @@ private:
 	std::thread renderer = {};
 	bool is_open         = false;
 
+	ImageSaverSettings settings = {};
+
 	ImageScaler image_scaler = {};
 
 	ImageDecoder image_decoder   = {};
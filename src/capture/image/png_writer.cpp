@@ -3,9 +3,9 @@
 
 #include "png_writer.h"
 
+#include <algorithm>
 #include <cassert>
-
-#include <zlib.h>
+#include <thread>
 
 #include "dosbox_config.h"
 #include "misc/support.h"
@@ -14,11 +14,14 @@
 
 CHECK_NARROWING();
 
+PngWriter::PngWriter(const int compression_level)
+        : compression_level(compression_level)
+{}
+
 PngWriter::~PngWriter()
 {
-	FinalisePng();
-
 	if (png_ptr && png_info_ptr) {
+		FinalisePng();
 		png_destroy_write_struct(&png_ptr, &png_info_ptr);
 	}
 	png_ptr      = nullptr;
@@ -67,8 +70,6 @@ bool PngWriter::Init(FILE* fp)
 		return false;
 	}
 
-	SetPngCompressionsParams();
-
 	png_init_io(png_ptr, fp);
 
 	// Write headers and extra metadata
@@ -82,39 +83,6 @@ bool PngWriter::Init(FILE* fp)
 	return true;
 }
 
-void PngWriter::SetPngCompressionsParams()
-{
-	assert(png_ptr);
-
-	// Default compression (equal to level 6) is the sweet spot between
-	// speed and compression. Z_BEST_COMPRESSION (level 9) rarely results in
-	// smaller file sizes, but makes the compression significantly slower
-	// (by several folds).
-	png_set_compression_level(png_ptr, Z_DEFAULT_COMPRESSION);
-
-	// Larger buffer sizes (e.g. 64K or 128K) could significantly speed up
-	// decompression, but not compression.
-	constexpr auto default_buffer_size = 8192;
-	png_set_compression_buffer_size(png_ptr, default_buffer_size);
-
-	// The "fast" filters are not only the fastest, but also result in the
-	// best compression ratios on average.
-	constexpr auto default_filter_method = 0;
-	png_set_filter(png_ptr, default_filter_method, PNG_ALL_FILTERS);
-
-	// Do not change the below settings; they are parameters for the zlib
-	// compression library and changing them might result in invalid PNG
-	// files.
-	constexpr auto default_mem_level = 8;
-	png_set_compression_mem_level(png_ptr, default_mem_level);
-
-	constexpr auto default_window_bits = 15;
-	png_set_compression_window_bits(png_ptr, default_window_bits);
-
-	png_set_compression_strategy(png_ptr, Z_DEFAULT_STRATEGY);
-	png_set_compression_method(png_ptr, Z_DEFLATED);
-}
-
 void PngWriter::WritePngInfo(const uint16_t width, const uint16_t height,
                              const Fraction& pixel_aspect_ratio,
                              const VideoMode& video_mode,
@@ -126,6 +94,14 @@ void PngWriter::WritePngInfo(const uint16_t width, const uint16_t height,
 	constexpr auto png_bit_depth = 8;
 	const auto png_color_type    = is_paletted ? PNG_COLOR_TYPE_PALETTE
 	                                           : PNG_COLOR_TYPE_RGB;
+	this->is_paletted = is_paletted;
+	bytes_per_pixel   = is_paletted ? 1 : 3;
+	row_size          = static_cast<size_t>(width) * bytes_per_pixel;
+
+	filtered_data.clear();
+	filtered_data.reserve((row_size + 1) * height);
+	prev_row.assign(row_size, 0);
+
 	png_set_IHDR(png_ptr,
 	             png_info_ptr,
 	             width,
@@ -225,14 +201,270 @@ void PngWriter::WritePngInfo(const uint16_t width, const uint16_t height,
 void PngWriter::WriteRow(std::vector<uint8_t>::const_iterator row)
 {
 	assert(png_ptr);
-	png_write_row(png_ptr, const_cast<png_bytep>(&*row));
+	FilterRow(&*row);
+}
+
+// PNG filter types
+constexpr uint8_t FilterNone  = 0;
+constexpr uint8_t FilterSub   = 1;
+constexpr uint8_t FilterUp    = 2;
+constexpr uint8_t FilterPaeth = 4;
+
+static uint8_t paeth_predictor(const uint8_t a, const uint8_t b, const uint8_t c)
+{
+	const auto p  = static_cast<int>(a) + b - c;
+	const auto pa = std::abs(p - a);
+	const auto pb = std::abs(p - b);
+	const auto pc = std::abs(p - c);
+
+	if (pa <= pb && pa <= pc) {
+		return a;
+	}
+	return (pb <= pc) ? b : c;
+}
+
+// Filtering doesn't help with paletted images as the index values don't
+// correlate with their neighbours (that's also what the PNG specification
+// recommends), and it's pointless when not compressing. For true-colour
+// images, the filter giving the smallest sum of absolute differences is picked
+// for each row.
+void PngWriter::FilterRow(const uint8_t* row)
+{
+	if (is_paletted || compression_level == Z_NO_COMPRESSION) {
+		filtered_data.push_back(FilterNone);
+		filtered_data.insert(filtered_data.end(), row, row + row_size);
+		return;
+	}
+
+	const auto bpp = bytes_per_pixel;
+	const auto up  = prev_row.data();
+
+	filter_buf.resize(row_size * 3);
+	auto sub   = filter_buf.data();
+	auto upf   = sub + row_size;
+	auto paeth = upf + row_size;
+
+	auto cost = [](const uint8_t value) {
+		return std::abs(static_cast<int8_t>(value));
+	};
+
+	uint32_t none_cost  = 0;
+	uint32_t sub_cost   = 0;
+	uint32_t up_cost    = 0;
+	uint32_t paeth_cost = 0;
+
+	for (size_t i = 0; i < row_size; ++i) {
+		const uint8_t left     = (i >= bpp) ? row[i - bpp] : 0;
+		const uint8_t up_left  = (i >= bpp) ? up[i - bpp] : 0;
+
+		sub[i]   = static_cast<uint8_t>(row[i] - left);
+		upf[i]   = static_cast<uint8_t>(row[i] - up[i]);
+		paeth[i] = static_cast<uint8_t>(
+		        row[i] - paeth_predictor(left, up[i], up_left));
+
+		none_cost += cost(row[i]);
+		sub_cost += cost(sub[i]);
+		up_cost += cost(upf[i]);
+		paeth_cost += cost(paeth[i]);
+	}
+
+	uint8_t filter       = FilterNone;
+	const uint8_t* data  = row;
+	uint32_t lowest_cost = none_cost;
+
+	auto consider = [&](const uint8_t type, const uint8_t* filtered, const uint32_t c) {
+		if (c < lowest_cost) {
+			filter      = type;
+			data        = filtered;
+			lowest_cost = c;
+		}
+	};
+	consider(FilterSub, sub, sub_cost);
+	consider(FilterUp, upf, up_cost);
+	consider(FilterPaeth, paeth, paeth_cost);
+
+	filtered_data.push_back(filter);
+	filtered_data.insert(filtered_data.end(), data, data + row_size);
+
+	std::copy_n(row, row_size, prev_row.begin());
+}
+
+namespace {
+
+struct DeflateStripe {
+	size_t begin                = 0;
+	size_t end                  = 0;
+	std::vector<uint8_t> output = {};
+	uLong adler                 = 0;
+	bool success                = false;
+};
+
+} // namespace
+
+static void deflate_stripe(const std::vector<uint8_t>& data, DeflateStripe& stripe,
+                           const int level, const int strategy, const bool is_last)
+{
+	constexpr auto WindowSize = 32768;
+
+	stripe.adler = adler32(adler32(0, nullptr, 0),
+	                       data.data() + stripe.begin,
+	                       static_cast<uInt>(stripe.end - stripe.begin));
+
+	// Raw deflate streams, so they can be concatenated
+	constexpr auto RawWindowBits = -15;
+	constexpr auto MemLevel      = 8;
+
+	z_stream stream = {};
+	if (deflateInit2(&stream, level, Z_DEFLATED, RawWindowBits, MemLevel, strategy) != Z_OK) {
+		return;
+	}
+
+	// Prime the stripe with the end of the previous one, so matches across
+	// the stripe boundary are still found
+	if (stripe.begin > 0) {
+		const auto dict_size = std::min(stripe.begin, static_cast<size_t>(WindowSize));
+		deflateSetDictionary(&stream,
+		                     data.data() + stripe.begin - dict_size,
+		                     static_cast<uInt>(dict_size));
+	}
+
+	const auto input_size = stripe.end - stripe.begin;
+
+	// A sync flush appends an empty stored block of at most 5 bytes
+	constexpr auto FlushMargin = 16;
+	stripe.output.resize(deflateBound(&stream, static_cast<uLong>(input_size)) +
+	                     FlushMargin);
+
+	stream.next_in   = const_cast<Bytef*>(data.data() + stripe.begin);
+	stream.avail_in  = static_cast<uInt>(input_size);
+	stream.next_out  = stripe.output.data();
+	stream.avail_out = static_cast<uInt>(stripe.output.size());
+
+	// All but the last stripe end on a byte boundary without closing the
+	// stream
+	const auto result = deflate(&stream, is_last ? Z_FINISH : Z_SYNC_FLUSH);
+
+	stripe.success = is_last ? (result == Z_STREAM_END)
+	                         : (result == Z_OK && stream.avail_in == 0 &&
+	                            stream.avail_out > 0);
+	stripe.output.resize(stream.total_out);
+
+	deflateEnd(&stream);
+}
+
+static uint8_t zlib_header_flags(const int level)
+{
+	// The FLEVEL field is informational only; the values satisfy the
+	// header checksum with the CMF byte 0x78 (deflate, 32K window)
+	if (level == Z_NO_COMPRESSION || level == Z_BEST_SPEED) {
+		return 0x01;
+	}
+	if (level == Z_DEFAULT_COMPRESSION || level == 6) {
+		return 0x9c;
+	}
+	return (level < 6) ? 0x5e : 0xda;
 }
 
 void PngWriter::FinalisePng()
 {
 	assert(png_ptr);
 
-	const png_infop end_info_ptr = nullptr;
-	png_write_end(png_ptr, end_info_ptr);
-}
+	// Stripes below this size are not worth a thread
+	constexpr size_t MinStripeBytes = 128 * 1024;
+	constexpr size_t MaxStripes     = 8;
+
+	const auto stride   = row_size + 1;
+	const auto num_rows = stride ? filtered_data.size() / stride : 0;
+
+	// The stripes only depend on the image size, so the output is the same
+	// regardless of the number of host threads
+	const auto num_stripes = std::clamp(filtered_data.size() / MinStripeBytes,
+	                                    static_cast<size_t>(1),
+	                                    MaxStripes);
+
+	const auto max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+	// Split the image at row boundaries
+	std::vector<DeflateStripe> stripes(num_stripes);
+	size_t row = 0;
+	for (size_t i = 0; i < num_stripes; ++i) {
+		const auto end_row = num_rows * (i + 1) / num_stripes;
+		stripes[i].begin   = row * stride;
+		stripes[i].end     = end_row * stride;
+		row                = end_row;
+	}
+
+	const auto strategy = (is_paletted || compression_level == Z_NO_COMPRESSION)
+	                            ? Z_DEFAULT_STRATEGY
+	                            : Z_FILTERED;
 
+	// Each thread deflates every n-th stripe
+	const auto num_threads = std::min(num_stripes, static_cast<size_t>(max_threads));
+
+	auto deflate_stripes = [&](const size_t first_stripe) {
+		for (auto i = first_stripe; i < num_stripes; i += num_threads) {
+			deflate_stripe(filtered_data,
+			               stripes[i],
+			               compression_level,
+			               strategy,
+			               i == num_stripes - 1);
+		}
+	};
+
+	std::vector<std::thread> workers = {};
+	for (size_t i = 1; i < num_threads; ++i) {
+		workers.emplace_back(deflate_stripes, i);
+	}
+	deflate_stripes(0);
+
+	for (auto& worker : workers) {
+		worker.join();
+	}
+
+	const auto stripe_failed = std::any_of(stripes.begin(),
+	                                       stripes.end(),
+	                                       [](const DeflateStripe& stripe) {
+		                                       return !stripe.success;
+	                                       });
+
+	// The header chunks have already been written, so try again as a
+	// single stream rather than leave a truncated file behind
+	if (stripe_failed) {
+		stripes.assign(1, {});
+		stripes[0].end = filtered_data.size();
+
+		constexpr auto is_last = true;
+		deflate_stripe(filtered_data, stripes[0], compression_level, strategy, is_last);
+	}
+
+	// Assemble the zlib stream
+	std::vector<uint8_t> idat = {0x78, zlib_header_flags(compression_level)};
+
+	uLong adler = adler32(0, nullptr, 0);
+	for (const auto& stripe : stripes) {
+		if (!stripe.success) {
+			LOG_ERR("PNG: Error compressing image data");
+			return;
+		}
+		idat.insert(idat.end(), stripe.output.begin(), stripe.output.end());
+		adler = adler32_combine(adler,
+		                        stripe.adler,
+		                        static_cast<z_off_t>(stripe.end - stripe.begin));
+	}
+	idat.push_back(static_cast<uint8_t>(adler >> 24));
+	idat.push_back(static_cast<uint8_t>(adler >> 16));
+	idat.push_back(static_cast<uint8_t>(adler >> 8));
+	idat.push_back(static_cast<uint8_t>(adler));
+
+	// Keep the IDAT chunks at a size every decoder is happy with
+	constexpr size_t MaxChunkSize = 1024 * 1024;
+
+	const png_byte idat_name[] = {'I', 'D', 'A', 'T', '\0'};
+	const png_byte iend_name[] = {'I', 'E', 'N', 'D', '\0'};
+
+	for (size_t pos = 0; pos < idat.size(); pos += MaxChunkSize) {
+		const auto chunk_size = std::min(MaxChunkSize, idat.size() - pos);
+		png_write_chunk(png_ptr, idat_name, idat.data() + pos, chunk_size);
+	}
+	png_write_chunk(png_ptr, iend_name, nullptr, 0);
+}
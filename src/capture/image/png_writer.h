@@ -9,6 +9,7 @@
 #include <vector>
 
 #include <png.h>
+#include <zlib.h>
 
 #include "gui/render.h"
 #include "image_saver.h"
@@ -16,9 +17,15 @@
 
 // A row-based PNG writer that also writes the pixel aspect ratio of the image
 // into the standard pHYs PNG chunk.
+//
+// libpng only writes the header chunks; the rows are filtered as they come in,
+// then the image data is deflated in horizontal stripes in parallel when the
+// writer is destroyed. The stripes are concatenated into a single zlib stream,
+// each primed with the end of the previous stripe as its dictionary, so the
+// compression ratio stays close to that of a single-threaded encoder.
 class PngWriter {
 public:
-	PngWriter() = default;
+	explicit PngWriter(const int compression_level = Z_DEFAULT_COMPRESSION);
 	~PngWriter();
 
 	bool InitRgb888(FILE* fp, const uint16_t width, const uint16_t height,
@@ -38,17 +45,29 @@ public:
 
 private:
 	bool Init(FILE* fp);
-	void SetPngCompressionsParams();
 
 	void WritePngInfo(const uint16_t width, const uint16_t height,
 	                  const Fraction& pixel_aspect_ratio,
 	                  const VideoMode& video_mode, const bool is_paletted,
 	                  const uint8_t* palette_data);
 
+	void FilterRow(const uint8_t* row);
 	void FinalisePng();
 
 	png_structp png_ptr    = nullptr;
 	png_infop png_info_ptr = nullptr;
+
+	int compression_level = Z_DEFAULT_COMPRESSION;
+
+	size_t row_size         = 0; // in bytes, without the filter type byte
+	uint8_t bytes_per_pixel = 0;
+	bool is_paletted        = false;
+
+	// Each filtered row is prefixed by its filter type
+	std::vector<uint8_t> filtered_data = {};
+
+	std::vector<uint8_t> prev_row = {};
+	std::vector<uint8_t> filter_buf = {};
 };
 
 #endif
@@ -0,0 +1,171 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "qoi_writer.h"
+
+#include <cassert>
+
+#include "utils/checks.h"
+
+CHECK_NARROWING();
+
+// QOI opcodes
+constexpr uint8_t OpIndex = 0x00;
+constexpr uint8_t OpDiff  = 0x40;
+constexpr uint8_t OpLuma  = 0x80;
+constexpr uint8_t OpRun   = 0xc0;
+constexpr uint8_t OpRgb   = 0xfe;
+
+constexpr uint8_t MaxRunLength = 62;
+
+QoiWriter::~QoiWriter()
+{
+	if (!outfile) {
+		return;
+	}
+
+	FlushRun();
+
+	// End marker
+	constexpr uint8_t EndMarker[] = {0, 0, 0, 0, 0, 0, 0, 1};
+	out_buf.insert(out_buf.end(), std::begin(EndMarker), std::end(EndMarker));
+
+	fwrite(out_buf.data(), 1, out_buf.size(), outfile);
+	outfile = nullptr;
+}
+
+bool QoiWriter::InitRgb888(FILE* fp, const uint16_t _width,
+                           const uint16_t height,
+                           [[maybe_unused]] const Fraction& pixel_aspect_ratio,
+                           [[maybe_unused]] const VideoMode& video_mode)
+{
+	is_paletted = false;
+	return Init(fp, _width, height);
+}
+
+bool QoiWriter::InitIndexed8(FILE* fp, const uint16_t _width,
+                             const uint16_t height,
+                             [[maybe_unused]] const Fraction& pixel_aspect_ratio,
+                             [[maybe_unused]] const VideoMode& video_mode,
+                             const uint8_t* palette_data)
+{
+	assert(palette_data);
+
+	is_paletted = true;
+
+	for (size_t i = 0; i < palette.size(); ++i) {
+		palette[i] = {palette_data[i * 4 + 0],
+		              palette_data[i * 4 + 1],
+		              palette_data[i * 4 + 2],
+		              255};
+	}
+	return Init(fp, _width, height);
+}
+
+bool QoiWriter::Init(FILE* fp, const uint16_t _width, const uint16_t height)
+{
+	assert(fp);
+
+	outfile = fp;
+	width   = _width;
+
+	// The decoder starts with a transparent black index, so an opaque black
+	// pixel must not be found in it
+	seen_pixels.fill({0, 0, 0, 0});
+	prev_pixel = {};
+	run_length = 0;
+
+	out_buf.clear();
+
+	auto write_u32_be = [&](const uint32_t value) {
+		out_buf.push_back(static_cast<uint8_t>(value >> 24));
+		out_buf.push_back(static_cast<uint8_t>(value >> 16));
+		out_buf.push_back(static_cast<uint8_t>(value >> 8));
+		out_buf.push_back(static_cast<uint8_t>(value));
+	};
+
+	out_buf.insert(out_buf.end(), {'q', 'o', 'i', 'f'});
+	write_u32_be(width);
+	write_u32_be(height);
+
+	constexpr uint8_t NumChannels = 3;
+	constexpr uint8_t ColourSpace = 0; // sRGB with linear alpha
+	out_buf.push_back(NumChannels);
+	out_buf.push_back(ColourSpace);
+
+	return true;
+}
+
+void QoiWriter::FlushRun()
+{
+	if (run_length > 0) {
+		out_buf.push_back(static_cast<uint8_t>(OpRun | (run_length - 1)));
+		run_length = 0;
+	}
+}
+
+void QoiWriter::EncodePixel(const Pixel pixel)
+{
+	if (pixel == prev_pixel) {
+		if (++run_length == MaxRunLength) {
+			FlushRun();
+		}
+		return;
+	}
+	FlushRun();
+
+	const auto hash = (pixel.r * 3 + pixel.g * 5 + pixel.b * 7 + pixel.a * 11) % 64;
+
+	if (seen_pixels[hash] == pixel) {
+		out_buf.push_back(static_cast<uint8_t>(OpIndex | hash));
+
+	} else {
+		seen_pixels[hash] = pixel;
+
+		const auto dr = static_cast<int8_t>(pixel.r - prev_pixel.r);
+		const auto dg = static_cast<int8_t>(pixel.g - prev_pixel.g);
+		const auto db = static_cast<int8_t>(pixel.b - prev_pixel.b);
+
+		const auto dr_dg = dr - dg;
+		const auto db_dg = db - dg;
+
+		if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+			out_buf.push_back(static_cast<uint8_t>(
+			        OpDiff | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));
+
+		} else if (dg >= -32 && dg <= 31 && dr_dg >= -8 && dr_dg <= 7 &&
+		           db_dg >= -8 && db_dg <= 7) {
+			out_buf.push_back(static_cast<uint8_t>(OpLuma | (dg + 32)));
+			out_buf.push_back(
+			        static_cast<uint8_t>((dr_dg + 8) << 4 | (db_dg + 8)));
+
+		} else {
+			out_buf.insert(out_buf.end(), {OpRgb, pixel.r, pixel.g, pixel.b});
+		}
+	}
+	prev_pixel = pixel;
+}
+
+void QoiWriter::WriteRow(std::vector<uint8_t>::const_iterator row)
+{
+	assert(outfile);
+
+	if (is_paletted) {
+		for (auto x = 0; x < width; ++x) {
+			EncodePixel(palette[*row++]);
+		}
+	} else {
+		for (auto x = 0; x < width; ++x) {
+			const Pixel pixel = {row[0], row[1], row[2], 255};
+			EncodePixel(pixel);
+			row += 3;
+		}
+	}
+
+	// Write the encoded data out in larger blocks
+	constexpr size_t FlushThreshold = 64 * 1024;
+	if (out_buf.size() >= FlushThreshold) {
+		fwrite(out_buf.data(), 1, out_buf.size(), outfile);
+		out_buf.clear();
+	}
+}
@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_QOI_WRITER_H
+#define DOSBOX_QOI_WRITER_H
+
+#include <array>
+#include <cstdio>
+#include <vector>
+
+#include "gui/render.h"
+
+// A row-based writer for the "Quite OK Image" format. QOI encodes several
+// times faster than PNG at a somewhat worse compression ratio, which makes it
+// a good fit for bulk image comparison workflows.
+//
+// QOI has no way to store the pixel aspect ratio or any other metadata, and
+// paletted images are always written as RGB888.
+//
+// Format specification:
+//   https://qoiformat.org/qoi-specification.pdf
+//
+class QoiWriter {
+public:
+	QoiWriter() = default;
+	~QoiWriter();
+
+	bool InitRgb888(FILE* fp, const uint16_t width, const uint16_t height,
+	                const Fraction& pixel_aspect_ratio,
+	                const VideoMode& video_mode);
+
+	bool InitIndexed8(FILE* fp, const uint16_t width, const uint16_t height,
+	                  const Fraction& pixel_aspect_ratio,
+	                  const VideoMode& video_mode, const uint8_t* palette_data);
+
+	void WriteRow(std::vector<uint8_t>::const_iterator row);
+
+	// prevent copying
+	QoiWriter(const QoiWriter&) = delete;
+	// prevent assignment
+	QoiWriter& operator=(const QoiWriter&) = delete;
+
+private:
+	struct Pixel {
+		uint8_t r = 0;
+		uint8_t g = 0;
+		uint8_t b = 0;
+
+		// Only needed to match the decoder's initial state
+		uint8_t a = 255;
+
+		bool operator==(const Pixel&) const = default;
+	};
+
+	bool Init(FILE* fp, const uint16_t width, const uint16_t height);
+
+	void EncodePixel(const Pixel pixel);
+	void FlushRun();
+
+	FILE* outfile    = nullptr;
+	uint16_t width   = 0;
+	bool is_paletted = false;
+
+	std::array<Pixel, 256> palette = {};
+
+	// Encoder state
+	std::array<Pixel, 64> seen_pixels = {};
+	Pixel prev_pixel                  = {};
+	uint8_t run_length                = 0;
+
+	std::vector<uint8_t> out_buf = {};
+};
+
+#endif // DOSBOX_QOI_WRITER_H
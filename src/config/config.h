@@ -52,6 +52,8 @@ struct CommandLineArguments {
 	std::optional<std::vector<std::string>> editconf;
 	std::optional<int> socket;
 	std::optional<int> wait_pid;
+	std::optional<int> benchmark;
+	std::string benchmark_output;
 };
 
 class Config {
@@ -1994,6 +1994,10 @@ void Config::ParseArguments()
 	arguments.socket   = cmdline->FindRemoveIntArgument("socket");
 	arguments.wait_pid = cmdline->FindRemoveIntArgument("waitpid");
 
+	arguments.benchmark = cmdline->FindRemoveIntArgument("benchmark");
+	arguments.benchmark_output = cmdline->FindRemoveStringArgument(
+	        "benchmark-output");
+
 	arguments.conf = cmdline->FindRemoveVectorArgument("conf");
 	arguments.set  = cmdline->FindRemoveVectorArgument("set");
 
@@ -15,6 +15,7 @@
 #include <cstring>
 
 #include <type_traits>
+#include <unordered_set>
 
 #if defined (WIN32)
 // clang-format off
@@ -172,6 +173,10 @@ static_assert(offsetof(core_dynrec_t, readdata) % sizeof(uint32_t) == 0,
 #define gen_mov_LE_word_to_reg gen_mov_word_to_reg
 #endif
 
+// translate superblocks that continue across direct jumps, calls and
+// forward conditional branches (see decoder_opcodes.h)
+static bool dynrec_traces = true;
+
 #include "core_dynrec/decoder.h"
 
 CacheBlock *LinkBlocks(BlockReturn ret)
@@ -206,6 +211,36 @@ CacheBlock *LinkBlocks(BlockReturn ret)
 	return cache_block;
 }
 
+static CodePageHandler* code_page_at(const PhysPt lin_addr)
+{
+	const auto read_handler = get_tlb_readhandler(lin_addr);
+	if (!read_handler ||
+	    !(read_handler->flags & (PFLAG_HASCODE16 | PFLAG_HASCODE32))) {
+		return nullptr;
+	}
+	return reinterpret_cast<CodePageHandler*>(read_handler);
+}
+
+// the instruction at lin_addr might not have been translated because it's
+// modified too often, give its code page the chance to cool down
+static void decay_smc_counters_at(const PhysPt lin_addr)
+{
+	const auto code_page = code_page_at(lin_addr);
+	if (!code_page) {
+		return;
+	}
+	code_page->DecaySmcCounters();
+
+	// a block that stops in front of the first instruction of a page
+	// belongs to the page before, which doesn't see this page cool down
+	if ((lin_addr & 4095) == 0 &&
+	    !smc_is_hot(code_page->invalidation_map, 0)) {
+		if (const auto prev_page = code_page_at(lin_addr - 1)) {
+			prev_page->ClearHotStopsAt(4096);
+		}
+	}
+}
+
 /*
 	The core tries to find the block that should be executed next.
 	If such a block is found, it is run, otherwise the instruction
@@ -247,10 +282,12 @@ Bits CPU_Core_Dynrec_Run() noexcept
 		if (!block) {
 			// no block found, thus translate the instruction stream
 			// unless the instruction is known to be modified
-			if (!chandler->invalidation_map || (chandler->invalidation_map[ip_point&4095]<4)) {
+			chandler->DecaySmcCounters();
+			if (!smc_is_hot(chandler->invalidation_map, ip_point & 4095)) {
 				// translate up to 32 instructions
 				block=CreateCacheBlock(chandler,ip_point,32);
 			} else {
+				chandler->CountSmcFallback();
 				// let the normal core handle this instruction to avoid zero-sized blocks
 				Bitu old_cycles=CPU_Cycles;
 				CPU_Cycles=1;
@@ -268,6 +305,7 @@ run_block:
 		cache.block.running=nullptr;
 		// now we're ready to run the dynamic code block
 //		BlockReturn ret=((BlockReturn (*)(void))(block->cache.start))();
+		++perf_counters.dyn_dispatches;
 		BlockReturn ret=core_dynrec.runcode(block->cache.start);
 
 		switch (ret) {
@@ -322,6 +360,7 @@ run_block:
 			// some instruction has been encountered that could not be translated
 			// (thus it is not part of the code block), the normal core will
 			// handle this instruction
+			decay_smc_counters_at(SegPhys(cs) + reg_eip);
 			CPU_CycleLeft+=CPU_Cycles;
 			CPU_Cycles=1;
 			return CPU_Core_Normal_Run();
@@ -369,6 +408,11 @@ Bits CPU_Core_Dynrec_Trap_Run() noexcept
 void CPU_Core_Dynrec_Init(void) {
 }
 
+void CPU_Core_Dynrec_SetTraces(const bool enabled)
+{
+	dynrec_traces = enabled;
+}
+
 void CPU_Core_Dynrec_Cache_Init(bool enable_cache) {
 	// Initialize code cache and dynamic blocks
 	cache_init(enable_cache);
@@ -1,6 +1,7 @@
 // SPDX-FileCopyrightText:  2002-2021 The DOSBox Team
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include "dyn_flags.h"
 #include "decoder_basic.h"
 #include "operators.h"
 #include "decoder_opcodes.h"
@@ -8,6 +9,56 @@
 #include "dyn_fpu.h"
 #include "dyn_mmx.h"
 
+#ifdef CPU_FPU
+// FPU instructions whose block was entered with another stack top than it
+// was translated for, by physical address; these read TOP at runtime
+static std::unordered_set<PhysPt> fpu_top_mismatches = {};
+
+static void dyn_fpu_top_mismatch() {
+	const auto phys_addr=PAGING_GetPhysicalAddress(SegPhys(cs)+reg_eip);
+	fpu_top_mismatches.insert(phys_addr);
+
+	// clear the running block so it gets translated again
+	auto handler=static_cast<CodePageHandler*>(MEM_GetPageHandler(phys_addr>>12));
+	handler->InvalidateRange(phys_addr&4095,phys_addr&4095);
+}
+
+// before the first FPU instruction of a block, check that TOP still has the
+// value it had during translation, so the stack registers can be addressed
+// directly; otherwise the instruction is left to the normal core
+static void dyn_fpu_check_top() {
+	if (decode.fpu_top!=FpuTopUnchecked) return;
+	if (fpu_top_mismatches.count(PAGING_GetPhysicalAddress(decode.op_start))) {
+		decode.fpu_top=FpuTopUnknown;
+		return;
+	}
+	// the exit leaves with all flags produced so far
+	AcquireFlags(FMASK_TEST);
+
+	gen_mov_word_to_reg(FC_OP1,(void*)(&TOP),true);
+	gen_add_imm(FC_OP1,(uint32_t)(-(int32_t)TOP));
+	const uint8_t* matches=gen_create_branch_on_zero(FC_OP1,true);
+	dyn_set_eip_last();
+	gen_call_function_raw((void*)&dyn_fpu_top_mismatch);
+	dyn_reduce_cycles();
+	dyn_return(BR_Opcode);
+	gen_fill_branch(matches);
+
+	decode.fpu_top=(int)TOP;
+}
+#endif
+
+// the page no longer holds translated code, so whatever gets loaded there
+// next starts out with the stack top checked again
+static void dyn_code_page_released([[maybe_unused]] Bitu phys_page) {
+#ifdef CPU_FPU
+	const auto page_start=static_cast<PhysPt>(phys_page<<12);
+	std::erase_if(fpu_top_mismatches,[page_start](const PhysPt phys_addr) {
+		return (phys_addr&~PhysPt{4095})==page_start;
+	});
+#endif
+}
+
 /*
 	The function CreateCacheBlock translates the instruction stream
 	until either an unhandled instruction is found, the maximum
@@ -19,14 +70,20 @@ static CacheBlock *CreateCacheBlock(CodePageHandler *codepage, PhysPt start, Bit
 {
 	// initialize a load of variables
 	decode.code_start=start;
+	decode.eip_start=reg_eip;
 	decode.code=start;
 	decode.page.code=codepage;
 	decode.page.index=start&4095;
 	decode.page.wmap=codepage->write_map;
 	decode.page.invmap=codepage->invalidation_map;
 	decode.page.first=start >> 12;
+	decode.side_exit=false;
+#ifdef CPU_FPU
+	decode.fpu_top=FpuTopUnchecked;
+#endif
 	decode.active_block=decode.block=cache_openblock();
 	decode.block->page.start=(uint16_t)decode.page.index;
+	decode.block->page.stops_at_hot=false;
 	codepage->AddCacheBlock(decode.block);
 
 	auto cache_addr = static_cast<void *>(
@@ -50,6 +107,10 @@ static CacheBlock *CreateCacheBlock(CodePageHandler *codepage, PhysPt start, Bit
 	decode.cycles=0;
 	uint_fast8_t opcode;
 	while (max_opcodes--) {
+		// a trace has a single link for taken branches, so it ends
+		// before the next branch that needs it once a side exit uses it
+		if (decode.side_exit && decode_peek_conditional_branch()) break;
+
 		// Init prefixes
 		decode.big_addr=cpu.code.big;
 		decode.big_op=cpu.code.big;
@@ -59,24 +120,11 @@ static CacheBlock *CreateCacheBlock(CodePageHandler *codepage, PhysPt start, Bit
 		decode.cycles++;
 		decode.op_start=decode.code;
 	restart_prefix:
-		if (!decode.page.invmap) opcode=decode_fetchb();
-		else {
-			// some entries in the invalidation map, see if the next
-			// instruction is known to be modified a lot
-			if (decode.page.index<4096) {
-				if (decode.page.invmap[decode.page.index] >= 4) {
-					goto illegalopcode;
-				}
-				opcode = decode_fetchb();
-			} else {
-				// switch to the next page
-				opcode=decode_fetchb();
-				if (decode.page.invmap &&
-				    (decode.page.invmap[decode.page.index - 1] >= 4)) {
-					goto illegalopcode;
-				}
-			}
-		}
+		// see if the next instruction is known to be modified a lot
+		if (decode.page.index<4096) {
+			if (smc_is_hot(decode.page.invmap, decode.page.index)) goto hot_instruction;
+		} else if (decode_next_page_is_hot()) goto hot_instruction;
+		opcode=decode_fetchb();
 		switch (opcode) {
 		// instructions 'op reg8,reg8' and 'op [],reg8'
 		case 0x00:dyn_dop_ebgb(DOP_ADD);break;
@@ -189,9 +237,9 @@ static CacheBlock *CreateCacheBlock(CodePageHandler *codepage, PhysPt start, Bit
 				// short conditional jumps
 				case 0x80:case 0x81:case 0x82:case 0x83:case 0x84:case 0x85:case 0x86:case 0x87:	
 				case 0x88:case 0x89:case 0x8a:case 0x8b:case 0x8c:case 0x8d:case 0x8e:case 0x8f:	
-					dyn_branched_exit((BranchTypes)(dual_code&0xf),
-						decode.big_op ? (int32_t)decode_fetchd() : (int16_t)decode_fetchw());
-					goto finish_block;
+					if (dyn_branch((BranchTypes)(dual_code&0xf),
+						decode.big_op ? (int32_t)decode_fetchd() : (int16_t)decode_fetchw())) goto finish_block;
+					break;
 
 				// conditional byte set instructions
 /*				case 0x90:case 0x91:case 0x92:case 0x93:case 0x94:case 0x95:case 0x96:case 0x97:	
@@ -661,8 +709,8 @@ static CacheBlock *CreateCacheBlock(CodePageHandler *codepage, PhysPt start, Bit
 		// short conditional jumps
 		case 0x70:case 0x71:case 0x72:case 0x73:case 0x74:case 0x75:case 0x76:case 0x77:	
 		case 0x78:case 0x79:case 0x7a:case 0x7b:case 0x7c:case 0x7d:case 0x7e:case 0x7f:	
-			dyn_branched_exit((BranchTypes)(opcode&0xf),(int8_t)decode_fetchb());	
-			goto finish_block;
+			if (dyn_branch((BranchTypes)(opcode&0xf),(int8_t)decode_fetchb())) goto finish_block;
+			break;
 
 		// 'op []/reg8,imm8'
 		case 0x80:
@@ -836,27 +884,35 @@ static CacheBlock *CreateCacheBlock(CodePageHandler *codepage, PhysPt start, Bit
 #ifdef CPU_FPU
 		// floating point instructions
 		case 0xd8:
+			dyn_fpu_check_top();
 			dyn_fpu_esc0();
 			break;
 		case 0xd9:
+			dyn_fpu_check_top();
 			dyn_fpu_esc1();
 			break;
 		case 0xda:
+			dyn_fpu_check_top();
 			dyn_fpu_esc2();
 			break;
 		case 0xdb:
+			dyn_fpu_check_top();
 			dyn_fpu_esc3();
 			break;
 		case 0xdc:
+			dyn_fpu_check_top();
 			dyn_fpu_esc4();
 			break;
 		case 0xdd:
+			dyn_fpu_check_top();
 			dyn_fpu_esc5();
 			break;
 		case 0xde:
+			dyn_fpu_check_top();
 			dyn_fpu_esc6();
 			break;
 		case 0xdf:
+			dyn_fpu_check_top();
 			dyn_fpu_esc7();
 			break;
 #endif
@@ -886,20 +942,20 @@ static CacheBlock *CreateCacheBlock(CodePageHandler *codepage, PhysPt start, Bit
 
 		// 'call near imm16/32'
 		case 0xe8:
-			dyn_call_near_imm();
-			goto finish_block;
+			if (dyn_call_near_imm()) goto finish_block;
+			break;
 		// 'jmp near imm16/32'
 		case 0xe9:
-			dyn_exit_link(decode.big_op ? (int32_t)decode_fetchd() : (int16_t)decode_fetchw());
-			goto finish_block;
+			if (dyn_jmp_imm(decode.big_op ? (int32_t)decode_fetchd() : (int16_t)decode_fetchw())) goto finish_block;
+			break;
 		// 'jmp far'
 		case 0xea:
 			dyn_jmp_far_imm();
 			goto finish_block;
 		// 'jmp short imm8'
 		case 0xeb:
-			dyn_exit_link((int8_t)decode_fetchb());
-			goto finish_block;
+			if (dyn_jmp_imm((int8_t)decode_fetchb())) goto finish_block;
+			break;
 
 
 		// repeat prefixes
@@ -974,6 +1030,12 @@ core_close_block:
 	dyn_return(BR_Normal);
 	dyn_closeblock();
 	goto finish_block;
+hot_instruction:
+	// end the block in front of the instruction without fetching any of
+	// it, so the writes to it don't clear this block over and over; the
+	// code page clears the block once the writes have cooled down
+	decode.active_block->page.stops_at_hot=true;
+	goto illegalopcode;
 illegalopcode:
 	// some unhandled opcode has been encountered
 	dyn_set_eip_last();
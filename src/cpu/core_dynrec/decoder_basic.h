@@ -70,6 +70,7 @@ static DualOps grp1_table[8]={
 static struct DynDecode {
 	PhysPt code;			// pointer to next byte in the instruction stream
 	PhysPt code_start;		// pointer to the start of the current code block
+	uint32_t eip_start;		// emulated eip at code_start
 	PhysPt op_start;		// pointer to the start of the current instruction
 	bool big_op;			// operand modifier
 	bool big_addr;			// address modifier
@@ -77,6 +78,8 @@ static struct DynDecode {
 	Bitu cycles;			// number cycles used by currently translated code
 	bool seg_prefix_used;	// segment overridden
 	uint8_t seg_prefix;		// segment prefix (if seg_prefix_used==true)
+	bool side_exit;			// the link for taken branches is used by a side exit
+	int fpu_top;			// FPU stack top at the current instruction (see dyn_fpu.h)
 
 	// block that contains the first instruction translated
 	CacheBlock *block;
@@ -192,12 +195,21 @@ static void decode_advancepage(void) {
 	newblock->crossblock=decode.active_block;
 	decode.active_block=newblock;
 	decode.active_block->page.start=0;
+	decode.active_block->page.stops_at_hot=false;
 	decode.page.code->AddCrossBlock(decode.active_block);
 	decode.page.wmap=decode.page.code->write_map;
 	decode.page.invmap=decode.page.code->invalidation_map;
 	decode.page.index=0;
 }
 
+// see if the instruction at the start of the next page is known to be
+// modified a lot, without making it a code page
+static bool decode_next_page_is_hot(void) {
+	PageHandler * handler=get_tlb_readhandler(decode.code);
+	if (!(handler->flags & PFLAG_HASCODE)) return false;
+	return smc_is_hot(static_cast<CodePageHandler *>(handler)->invalidation_map,0);
+}
+
 // fetch the next byte of the instruction stream
 static uint8_t decode_fetchb(void) {
 	if (decode.page.index >= 4096) {
@@ -208,6 +220,30 @@ static uint8_t decode_fetchb(void) {
 	++decode.code;
 	return mem_readb(decode.code-1);
 }
+
+// see if the next instruction is a branch that needs the link for taken
+// branches, without marking its bytes in the write map; instructions that
+// don't start in the current page are treated as such branches
+static bool decode_peek_conditional_branch(void) {
+	PhysPt code=decode.code;
+	for (Bitu index=decode.page.index; index<4096; ++index, ++code) {
+		const uint8_t opcode=mem_readb(code);
+		switch (opcode) {
+		case 0x26:case 0x2e:case 0x36:case 0x3e:
+		case 0x64:case 0x65:case 0x66:case 0x67:
+		case 0xf0:case 0xf2:case 0xf3:
+			// skip the prefixes
+			continue;
+		case 0x0f:
+			if (index+1>=4096) return true;
+			return (mem_readb(code+1)&0xf0)==0x80;
+		default:
+			// jcc, loop and jcxz
+			return ((opcode&0xf0)==0x70) || (opcode>=0xe0 && opcode<=0xe3);
+		}
+	}
+	return true;
+}
 // fetch the next word of the instruction stream
 static uint16_t decode_fetchw(void) {
 	if (decode.page.index >= 4095) {
@@ -885,7 +921,14 @@ static void dyn_fill_ea(HostReg ea_reg,bool addseg=true) {
 			break;
 		case 6:// imm/BP
 			if (!decode.modrm.mod) {
-				imm=decode_fetchw();
+				Bitu val;
+				// try to get a pointer to the next word code position
+				if (decode_fetchw_imm(val)) {
+					// succeeded, use the pointer to avoid code invalidation
+					gen_mov_LE_word_to_reg(ea_reg,(void*)val,false);
+					break;
+				}
+				imm=(Bits)val;
 				gen_mov_dword_to_reg_imm(ea_reg,(uint32_t)imm);
 				goto skip_extend_word;
 			} else {
@@ -1128,78 +1171,3 @@ static void gen_restore_reg(HostReg reg) {
 static void gen_restore_reg(HostReg reg,HostReg dest_reg) {
 	gen_mov_word_to_reg(dest_reg,&core_dynrec.protected_regs[reg],true);
 }
-
-
-
-// flags optimization functions
-// they try to find out if a function can be replaced by another
-// one that does not generate any flags at all
-
-static Bitu mf_functions_num=0;
-static struct {
-	const uint8_t* pos;
-	void* fct_ptr;
-	Bitu ftype;
-} mf_functions[64];
-
-static void InitFlagsOptimization(void) {
-	mf_functions_num=0;
-}
-
-// replace all queued functions with their simpler variants
-// because the current instruction destroys all condition flags and
-// the flags are not required before
-static void InvalidateFlags(void) {
-#ifdef DRC_FLAGS_INVALIDATION
-	for (Bitu ct=0; ct<mf_functions_num; ct++) {
-		gen_fill_function_ptr(mf_functions[ct].pos,mf_functions[ct].fct_ptr,mf_functions[ct].ftype);
-	}
-	mf_functions_num=0;
-#endif
-}
-
-// replace all queued functions with their simpler variants
-// because the current instruction destroys all condition flags and
-// the flags are not required before
-static void InvalidateFlags(void* current_simple_function,Bitu flags_type) {
-#ifdef DRC_FLAGS_INVALIDATION
-	for (Bitu ct=0; ct<mf_functions_num; ct++) {
-		gen_fill_function_ptr(mf_functions[ct].pos,mf_functions[ct].fct_ptr,mf_functions[ct].ftype);
-	}
-	mf_functions_num=1;
-	mf_functions[0].pos=cache.pos;
-	mf_functions[0].fct_ptr=current_simple_function;
-	mf_functions[0].ftype=flags_type;
-#endif
-}
-
-// enqueue this instruction, if later an instruction is encountered that
-// destroys all condition flags and the flags weren't needed in-between
-// this function can be replaced by a simpler one as well
-static void InvalidateFlagsPartially(void* current_simple_function,Bitu flags_type) {
-#ifdef DRC_FLAGS_INVALIDATION
-	mf_functions[mf_functions_num].pos=cache.pos;
-	mf_functions[mf_functions_num].fct_ptr=current_simple_function;
-	mf_functions[mf_functions_num].ftype=flags_type;
-	++mf_functions_num;
-#endif
-}
-
-// enqueue this instruction, if later an instruction is encountered that
-// destroys all condition flags and the flags weren't needed in-between
-// this function can be replaced by a simpler one as well
-static void InvalidateFlagsPartially(void* current_simple_function,const uint8_t* cpos,Bitu flags_type) {
-#ifdef DRC_FLAGS_INVALIDATION
-	mf_functions[mf_functions_num].pos=cpos;
-	mf_functions[mf_functions_num].fct_ptr=current_simple_function;
-	mf_functions[mf_functions_num].ftype=flags_type;
-	++mf_functions_num;
-#endif
-}
-
-// the current function needs the condition flags thus reset the queue
-static void AcquireFlags([[maybe_unused]] Bitu flags_mask) {
-#ifdef DRC_FLAGS_INVALIDATION
-	mf_functions_num=0;
-#endif
-}
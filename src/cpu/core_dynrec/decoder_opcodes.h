@@ -1077,6 +1077,8 @@ static void dyn_cwd(void) {
 }
 
 static void dyn_sahf(void) {
+	// sahf keeps the overflow flag
+	AcquireFlags(FLAG_OF);
 	MOV_REG_WORD16_TO_HOST_REG(FC_OP1,DRC_REG_EAX);
 	gen_call_function_raw((void *)&dynrec_sahf);
 	InvalidateFlags();
@@ -1091,6 +1093,47 @@ static void dyn_exit_link(Bits eip_change) {
 }
 
 
+// superblock traces: instead of closing the block at a direct jump or call,
+// the translation continues at the target if it lies ahead in the current
+// page. Only forward targets are followed, so the block still starts at the
+// lowest address it covers and is found by the page hash. The skipped bytes
+// are often data, they're masked out of the block's write map range so
+// writing to them doesn't invalidate the block. A 16-bit ip wraps around at
+// the end of the segment, such targets aren't ahead in the page.
+static bool dyn_trace_can_follow(Bits eip_change) {
+	if (!dynrec_traces || eip_change<0) return false;
+	if (!decode.big_op) {
+		const uint32_t ip_end=decode.eip_start+(decode.code-decode.code_start);
+		if (ip_end+(Bitu)eip_change>0xffff) return false;
+	}
+	return decode.page.index+(Bitu)eip_change<4096;
+}
+
+// continue the translation at the target of a followed branch, the
+// emulated eip must already point to the target
+static void dyn_trace_continue_at(Bits eip_change) {
+	for (Bitu ct=0; ct<(Bitu)eip_change; ct++) {
+		decode.active_block->cache.AddByteToWriteMaskAt(decode.page.index+ct);
+	}
+	decode.code+=(PhysPt)eip_change;
+	decode.page.index+=(Bitu)eip_change;
+	decode.eip_start+=decode.code-decode.code_start;
+	decode.code_start=decode.code;
+	++perf_counters.dyn_trace_branches;
+}
+
+// 'jmp short/near imm', returns true if the block was closed
+static bool dyn_jmp_imm(Bits eip_change) {
+	if (!dyn_trace_can_follow(eip_change)) {
+		dyn_exit_link(eip_change);
+		return true;
+	}
+	gen_add_direct_word(&reg_eip,(decode.code-decode.code_start)+eip_change,decode.big_op);
+	dyn_trace_continue_at(eip_change);
+	return false;
+}
+
+
 static void dyn_branched_exit(BranchTypes btype,int32_t eip_add) {
 	Bitu eip_base=decode.code-decode.code_start;
 	dyn_reduce_cycles();
@@ -1109,6 +1152,32 @@ static void dyn_branched_exit(BranchTypes btype,int32_t eip_add) {
 	dyn_closeblock();
 }
 
+// conditional jump, returns true if the block was closed. Forward branches
+// are expected not to be taken, so if the link for taken branches is still
+// free the trace continues with the next instruction and the taken branch
+// becomes a side exit.
+static bool dyn_branch(BranchTypes btype,int32_t eip_add) {
+	if (!dynrec_traces || decode.side_exit || eip_add<0) {
+		dyn_branched_exit(btype,eip_add);
+		return true;
+	}
+	// the side exit leaves with all flags the trace has produced so far
+	AcquireFlags(FMASK_TEST);
+
+	dyn_branchflag_to_reg(btype);
+	const uint8_t* data=gen_create_branch_on_zero(FC_RETOP,true);
+
+	// Branch taken
+	gen_add_direct_word(&reg_eip,(decode.code-decode.code_start)+eip_add,decode.big_op);
+	dyn_reduce_cycles();
+	gen_jmp_ptr(&decode.block->link[1].to, offsetof(CacheBlock, cache.start));
+	gen_fill_branch(data);
+
+	decode.side_exit=true;
+	++perf_counters.dyn_trace_branches;
+	return false;
+}
+
 /*
 static void dyn_set_byte_on_condition(BranchTypes btype) {
 	dyn_get_modrm();
@@ -1184,7 +1253,8 @@ static void dyn_ret_near(Bitu bytes) {
 	dyn_closeblock();
 }
 
-static void dyn_call_near_imm(void) {
+// returns true if the block was closed
+static bool dyn_call_near_imm(void) {
 	Bits imm;
 	if (decode.big_op) imm=(int32_t)decode_fetchd();
 	else imm=(int16_t)decode_fetchw();
@@ -1195,9 +1265,14 @@ static void dyn_call_near_imm(void) {
 	dyn_set_eip_end(FC_OP1,imm);
 	gen_mov_word_from_reg(FC_OP1,decode.big_op?(void*)(&reg_eip):(void*)(&reg_ip),decode.big_op);
 
+	if (dyn_trace_can_follow(imm)) {
+		dyn_trace_continue_at(imm);
+		return false;
+	}
 	dyn_reduce_cycles();
 	gen_jmp_ptr(&decode.block->link[0].to, offsetof(CacheBlock, cache.start));
 	dyn_closeblock();
+	return true;
 }
 
 static void dyn_ret_far(Bitu bytes) {
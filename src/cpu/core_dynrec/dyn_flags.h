@@ -0,0 +1,146 @@
+// SPDX-FileCopyrightText:  2002-2021 The DOSBox Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "misc/perf_counters.h"
+
+// flags optimization functions
+// they try to find out if a function can be replaced by another
+// one that does not generate any flags at all
+//
+// every queued function keeps track of which of the condition flags it
+// produces are still live, meaning they haven't been overwritten by a later
+// instruction in the block; a function is replaced as soon as none of its
+// flags are live anymore, and an instruction reading flags only keeps the
+// functions that produce one of the flags it reads.
+// block exits conservatively treat all flags as live.
+
+static Bitu mf_functions_num=0;
+static struct {
+	const uint8_t* pos;
+	void* fct_ptr;
+	Bitu ftype;
+	Bitu live_flags;
+} mf_functions[64];
+
+static void InitFlagsOptimization(void) {
+	mf_functions_num=0;
+}
+
+#ifdef DRC_FLAGS_INVALIDATION
+// the condition flags an instruction of the given type can produce
+static Bitu mf_produced_flags(Bitu flags_type) {
+	switch (flags_type) {
+		case t_INCb:case t_INCw:case t_INCd:
+		case t_DECb:case t_DECw:case t_DECd:
+			return FMASK_TEST & ~FLAG_CF;
+		case t_ROLb:case t_ROLw:case t_ROLd:
+		case t_RORb:case t_RORw:case t_RORd:
+			return FLAG_CF | FLAG_OF;
+		default:
+			return FMASK_TEST;
+	}
+}
+
+// the condition flags an instruction of the given type always overwrites;
+// shifts and rotates leave all flags untouched if the count is zero
+static Bitu mf_overwritten_flags(Bitu flags_type) {
+	switch (flags_type) {
+		case t_INCb:case t_INCw:case t_INCd:
+		case t_DECb:case t_DECw:case t_DECd:
+			return FMASK_TEST & ~FLAG_CF;
+		case t_ADCb:case t_ADCw:case t_ADCd:
+		case t_SBBb:case t_SBBw:case t_SBBd:
+			return FMASK_TEST;
+		default:
+			return 0;
+	}
+}
+
+// mark the flags as overwritten and replace the queued functions
+// that don't produce any live flags anymore
+static void mf_overwrite_flags(Bitu flags_mask) {
+	Bitu kept=0;
+	for (Bitu ct=0; ct<mf_functions_num; ct++) {
+		mf_functions[ct].live_flags&=~flags_mask;
+		if (mf_functions[ct].live_flags) {
+			mf_functions[kept++]=mf_functions[ct];
+		} else {
+			gen_fill_function_ptr(mf_functions[ct].pos,mf_functions[ct].fct_ptr,mf_functions[ct].ftype);
+			++perf_counters.dyn_flag_helpers_skipped;
+		}
+	}
+	mf_functions_num=kept;
+}
+
+static void mf_enqueue_function(const uint8_t* pos,void* current_simple_function,Bitu flags_type) {
+	// make room by keeping the oldest function as it is, producing all its
+	// flags
+	if (mf_functions_num==sizeof(mf_functions)/sizeof(mf_functions[0])) {
+		for (Bitu ct=1; ct<mf_functions_num; ct++) {
+			mf_functions[ct-1]=mf_functions[ct];
+		}
+		mf_functions_num--;
+	}
+	mf_functions[mf_functions_num].pos=pos;
+	mf_functions[mf_functions_num].fct_ptr=current_simple_function;
+	mf_functions[mf_functions_num].ftype=flags_type;
+	mf_functions[mf_functions_num].live_flags=mf_produced_flags(flags_type);
+	++mf_functions_num;
+	++perf_counters.dyn_flag_helpers;
+}
+#endif
+
+// replace all queued functions with their simpler variants
+// because the current instruction destroys all condition flags and
+// the flags are not required before
+static void InvalidateFlags(void) {
+#ifdef DRC_FLAGS_INVALIDATION
+	mf_overwrite_flags(FMASK_TEST);
+#endif
+}
+
+// replace all queued functions with their simpler variants
+// because the current instruction destroys all condition flags and
+// the flags are not required before
+static void InvalidateFlags(void* current_simple_function,Bitu flags_type) {
+#ifdef DRC_FLAGS_INVALIDATION
+	mf_overwrite_flags(FMASK_TEST);
+	mf_enqueue_function(cache.pos,current_simple_function,flags_type);
+#endif
+}
+
+// enqueue this instruction, if later an instruction is encountered that
+// destroys the condition flags it produces and the flags weren't needed
+// in-between this function can be replaced by a simpler one as well;
+// queued functions whose flags are all overwritten by this instruction
+// are replaced right away
+static void InvalidateFlagsPartially(void* current_simple_function,Bitu flags_type) {
+#ifdef DRC_FLAGS_INVALIDATION
+	mf_overwrite_flags(mf_overwritten_flags(flags_type));
+	mf_enqueue_function(cache.pos,current_simple_function,flags_type);
+#endif
+}
+
+// enqueue this instruction, if later an instruction is encountered that
+// destroys the condition flags it produces and the flags weren't needed
+// in-between this function can be replaced by a simpler one as well
+static void InvalidateFlagsPartially(void* current_simple_function,const uint8_t* cpos,Bitu flags_type) {
+#ifdef DRC_FLAGS_INVALIDATION
+	mf_overwrite_flags(mf_overwritten_flags(flags_type));
+	mf_enqueue_function(cpos,current_simple_function,flags_type);
+#endif
+}
+
+// the current function needs the condition flags in flags_mask, thus keep
+// the queued functions that produce any of them
+static void AcquireFlags([[maybe_unused]] Bitu flags_mask) {
+#ifdef DRC_FLAGS_INVALIDATION
+	Bitu kept=0;
+	for (Bitu ct=0; ct<mf_functions_num; ct++) {
+		if ((mf_functions[ct].live_flags & flags_mask)==0) {
+			mf_functions[kept++]=mf_functions[ct];
+		}
+	}
+	mf_functions_num=kept;
+#endif
+}
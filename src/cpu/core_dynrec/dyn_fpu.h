@@ -33,18 +33,53 @@ static void FPU_FFREE(Bitu st) {
 		#include "fpu/fpu_instructions.h"
 	#endif
 
+/*
+	The FPU stack top is tracked while a block is translated. The first FPU
+	instruction of a block checks that TOP still has the value it had when
+	the block was translated (see dyn_fpu_check_top), after that the stack
+	registers are addressed with constants instead of reading TOP at runtime.
+	Instructions with an effect on TOP that isn't known in advance switch
+	back to reading it for the rest of the block.
+*/
+constexpr int FpuTopUnchecked = -2;	// no FPU instruction translated yet
+constexpr int FpuTopUnknown   = -1;	// TOP has to be read at runtime
+
+// load the index of the stack register ST(st) into reg
+static inline void dyn_fpu_top_to_reg(HostReg reg,Bitu st=0) {
+	if (decode.fpu_top>=0) {
+		gen_mov_dword_to_reg_imm(reg,(uint32_t)((decode.fpu_top+st)&7));
+		return;
+	}
+	gen_mov_word_to_reg(reg,(void*)(&TOP),true);
+	if (st) {
+		gen_add_imm(reg,(uint32_t)st);
+		gen_and_imm(reg,7);
+	}
+}
+
+// the translated code changed TOP by delta
+static inline void dyn_fpu_move_top(int delta) {
+	if (decode.fpu_top>=0) decode.fpu_top=(decode.fpu_top+delta)&7;
+}
+
+static inline void dyn_fpu_push() {
+	gen_call_function_raw((void*)&FPU_PREP_PUSH);
+	dyn_fpu_move_top(-1);
+}
+
+static inline void dyn_fpu_pop() {
+	gen_call_function_raw((void*)&FPU_FPOP);
+	dyn_fpu_move_top(1);
+}
+
 static inline void dyn_fpu_top() {
-	gen_mov_word_to_reg(FC_OP2,(void*)(&TOP),true);
-	gen_add_imm(FC_OP2,decode.modrm.rm);
-	gen_and_imm(FC_OP2,7);
-	gen_mov_word_to_reg(FC_OP1,(void*)(&TOP),true);
+	dyn_fpu_top_to_reg(FC_OP2,decode.modrm.rm);
+	dyn_fpu_top_to_reg(FC_OP1);
 }
 
 static inline void dyn_fpu_top_swapped() {
-	gen_mov_word_to_reg(FC_OP1,(void*)(&TOP),true);
-	gen_add_imm(FC_OP1,decode.modrm.rm);
-	gen_and_imm(FC_OP1,7);
-	gen_mov_word_to_reg(FC_OP2,(void*)(&TOP),true);
+	dyn_fpu_top_to_reg(FC_OP1,decode.modrm.rm);
+	dyn_fpu_top_to_reg(FC_OP2);
 }
 
 static void dyn_eatree() {
@@ -62,7 +97,7 @@ static void dyn_eatree() {
 		break;
 	case 0x03:		// FCOMP STi
 		gen_call_function_R((void*)&FPU_FCOM_EA,FC_OP1);
-		gen_call_function_raw((void*)&FPU_FPOP);
+		dyn_fpu_pop();
 		break;
 	case 0x04:		// FSUB  ST,STi
 		gen_call_function_R((void*)&FPU_FSUB_EA,FC_OP1);
@@ -98,7 +133,7 @@ static void dyn_fpu_esc0(){
 			break;
 		case 0x03:		// FCOMP STi
 			gen_call_function_RR((void*)&FPU_FCOM,FC_OP1,FC_OP2);
-			gen_call_function_raw((void*)&FPU_FPOP);
+			dyn_fpu_pop();
 			break;
 		case 0x04:		// FSUB  ST,STi
 			gen_call_function_RR((void*)&FPU_FSUB,FC_OP1,FC_OP2);
@@ -118,7 +153,7 @@ static void dyn_fpu_esc0(){
 	} else { 
 		dyn_fill_ea(FC_ADDR);
 		gen_call_function_R((void*)&FPU_FLD_F32_EA,FC_ADDR); 
-		gen_mov_word_to_reg(FC_OP1,(void*)(&TOP),true);
+		dyn_fpu_top_to_reg(FC_OP1);
 		dyn_eatree();
 	}
 }
@@ -130,12 +165,10 @@ static void dyn_fpu_esc1(){
 	if (decode.modrm.mod == 3) {
 		switch (decode.modrm.reg){
 		case 0x00: /* FLD STi */
-			gen_mov_word_to_reg(FC_OP1,(void*)(&TOP),true);
-			gen_add_imm(FC_OP1,decode.modrm.rm);
-			gen_and_imm(FC_OP1,7);
+			dyn_fpu_top_to_reg(FC_OP1,decode.modrm.rm);
 			gen_protect_reg(FC_OP1);
-			gen_call_function_raw((void*)&FPU_PREP_PUSH); 
-			gen_mov_word_to_reg(FC_OP2,(void*)(&TOP),true);
+			dyn_fpu_push();
+			dyn_fpu_top_to_reg(FC_OP2);
 			gen_restore_reg(FC_OP1);
 			gen_call_function_RR((void*)&FPU_FST,FC_OP1,FC_OP2);
 			break;
@@ -149,7 +182,7 @@ static void dyn_fpu_esc1(){
 		case 0x03: /* FSTP STi */
 			dyn_fpu_top();
 			gen_call_function_RR((void*)&FPU_FST,FC_OP1,FC_OP2);
-			gen_call_function_raw((void*)&FPU_FPOP);
+			dyn_fpu_pop();
 			break;   
 		case 0x04:
 			switch(decode.modrm.rm){
@@ -179,24 +212,31 @@ static void dyn_fpu_esc1(){
 			switch(decode.modrm.rm){	
 			case 0x00:       /* FLD1 */
 				gen_call_function_raw((void*)&FPU_FLD1);
+				dyn_fpu_move_top(-1);
 				break;
 			case 0x01:       /* FLDL2T */
 				gen_call_function_raw((void*)&FPU_FLDL2T);
+				dyn_fpu_move_top(-1);
 				break;
 			case 0x02:       /* FLDL2E */
 				gen_call_function_raw((void*)&FPU_FLDL2E);
+				dyn_fpu_move_top(-1);
 				break;
 			case 0x03:       /* FLDPI */
 				gen_call_function_raw((void*)&FPU_FLDPI);
+				dyn_fpu_move_top(-1);
 				break;
 			case 0x04:       /* FLDLG2 */
 				gen_call_function_raw((void*)&FPU_FLDLG2);
+				dyn_fpu_move_top(-1);
 				break;
 			case 0x05:       /* FLDLN2 */
 				gen_call_function_raw((void*)&FPU_FLDLN2);
+				dyn_fpu_move_top(-1);
 				break;
 			case 0x06:       /* FLDZ*/
 				gen_call_function_raw((void*)&FPU_FLDZ);
+				dyn_fpu_move_top(-1);
 				break;
 			case 0x07:       /* ILLEGAL */
 				LOG(LOG_FPU,LOG_WARN)("ESC 1:Unhandled group %X subfunction %X",static_cast<uint32_t>(decode.modrm.reg),static_cast<uint32_t>(decode.modrm.rm));
@@ -210,24 +250,31 @@ static void dyn_fpu_esc1(){
 				break;
 			case 0x01:	/* FYL2X */
 				gen_call_function_raw((void*)&FPU_FYL2X);
+				dyn_fpu_move_top(1);
 				break;
 			case 0x02:	/* FPTAN  */
 				gen_call_function_raw((void*)&FPU_FPTAN);
+				// only pushes if the argument is in range
+				decode.fpu_top=FpuTopUnknown;
 				break;
 			case 0x03:	/* FPATAN */
 				gen_call_function_raw((void*)&FPU_FPATAN);
+				dyn_fpu_move_top(1);
 				break;
 			case 0x04:	/* FXTRACT */
 				gen_call_function_raw((void*)&FPU_FXTRACT);
+				dyn_fpu_move_top(-1);
 				break;
 			case 0x05:	/* FPREM1 */
 				gen_call_function_raw((void*)&FPU_FPREM1);
 				break;
 			case 0x06:	/* FDECSTP */
 				gen_call_function_raw((void*)&FPU_FDECSTP);
+				dyn_fpu_move_top(-1);
 				break;
 			case 0x07:	/* FINCSTP */
 				gen_call_function_raw((void*)&FPU_FINCSTP);
+				dyn_fpu_move_top(1);
 				break;
 			default:
 				LOG(LOG_FPU,LOG_WARN)("ESC 1:Unhandled group %X subfunction %X",static_cast<uint32_t>(decode.modrm.reg),static_cast<uint32_t>(decode.modrm.rm));
@@ -241,12 +288,15 @@ static void dyn_fpu_esc1(){
 				break;
 			case 0x01:		/* FYL2XP1 */
 				gen_call_function_raw((void*)&FPU_FYL2XP1);
+				dyn_fpu_move_top(1);
 				break;
 			case 0x02:		/* FSQRT */
 				gen_call_function_raw((void*)&FPU_FSQRT);
 				break;
 			case 0x03:		/* FSINCOS */
 				gen_call_function_raw((void*)&FPU_FSINCOS);
+				// only pushes if the argument is in range
+				decode.fpu_top=FpuTopUnknown;
 				break;
 			case 0x04:		/* FRNDINT */
 				gen_call_function_raw((void*)&FPU_FRNDINT);
@@ -272,9 +322,9 @@ static void dyn_fpu_esc1(){
 	} else {
 		switch(decode.modrm.reg){
 		case 0x00: /* FLD float*/
-			gen_call_function_raw((void*)&FPU_PREP_PUSH);
+			dyn_fpu_push();
 			dyn_fill_ea(FC_OP1);
-			gen_mov_word_to_reg(FC_OP2,(void*)(&TOP),true);
+			dyn_fpu_top_to_reg(FC_OP2);
 			gen_call_function_RR((void*)&FPU_FLD_F32,FC_OP1,FC_OP2);
 			break;
 		case 0x01: /* UNKNOWN */
@@ -287,11 +337,12 @@ static void dyn_fpu_esc1(){
 		case 0x03: /* FSTP float*/
 			dyn_fill_ea(FC_ADDR);
 			gen_call_function_R((void*)&FPU_FST_F32,FC_ADDR);
-			gen_call_function_raw((void*)&FPU_FPOP);
+			dyn_fpu_pop();
 			break;
 		case 0x04: /* FLDENV */
 			dyn_fill_ea(FC_ADDR);
 			gen_call_function_R((void*)&FPU_FLDENV,FC_ADDR);
+			decode.fpu_top=FpuTopUnknown;
 			break;
 		case 0x05: /* FLDCW */
 			dyn_fill_ea(FC_ADDR);
@@ -320,13 +371,11 @@ static void dyn_fpu_esc2(){
 		case 0x05:
 			switch(decode.modrm.rm){
 			case 0x01:		/* FUCOMPP */
-				gen_mov_word_to_reg(FC_OP2,(void*)(&TOP),true);
-				gen_add_imm(FC_OP2,1);
-				gen_and_imm(FC_OP2,7);
-				gen_mov_word_to_reg(FC_OP1,(void*)(&TOP),true);
+				dyn_fpu_top_to_reg(FC_OP2,1);
+				dyn_fpu_top_to_reg(FC_OP1);
 				gen_call_function_RR((void *)&FPU_FUCOM,FC_OP1,FC_OP2);
-				gen_call_function_raw((void *)&FPU_FPOP);
-				gen_call_function_raw((void *)&FPU_FPOP);
+				dyn_fpu_pop();
+				dyn_fpu_pop();
 				break;
 			default:
 				LOG(LOG_FPU,LOG_WARN)("ESC 2:Unhandled group %X subfunction %X",static_cast<uint32_t>(decode.modrm.reg),static_cast<uint32_t>(decode.modrm.rm));
@@ -340,7 +389,7 @@ static void dyn_fpu_esc2(){
 	} else {
 		dyn_fill_ea(FC_ADDR);
 		gen_call_function_R((void*)&FPU_FLD_I32_EA,FC_ADDR); 
-		gen_mov_word_to_reg(FC_OP1,(void*)(&TOP),true);
+		dyn_fpu_top_to_reg(FC_OP1);
 		dyn_eatree();
 	}
 }
@@ -363,6 +412,7 @@ static void dyn_fpu_esc3()
 				break;
 			case 0x03:				//FNINIT FINIT
 				gen_call_function_raw((void*)&FPU_FINIT);
+				decode.fpu_top=0;
 				break;
 			case 0x04:				//FNSETPM
 			case 0x05:				//FRSTPM
@@ -380,9 +430,9 @@ static void dyn_fpu_esc3()
 	} else {
 		switch(decode.modrm.reg){
 		case 0x00:	/* FILD */
-			gen_call_function_raw((void*)&FPU_PREP_PUSH);
+			dyn_fpu_push();
 			dyn_fill_ea(FC_OP1); 
-			gen_mov_word_to_reg(FC_OP2,(void*)(&TOP),true);
+			dyn_fpu_top_to_reg(FC_OP2);
 			gen_call_function_RR((void*)&FPU_FLD_I32,FC_OP1,FC_OP2);
 			break;
 		case 0x01:	/* FISTTP */
@@ -395,17 +445,17 @@ static void dyn_fpu_esc3()
 		case 0x03:	/* FISTP */
 			dyn_fill_ea(FC_ADDR); 
 			gen_call_function_R((void*)&FPU_FST_I32,FC_ADDR);
-			gen_call_function_raw((void*)&FPU_FPOP);
+			dyn_fpu_pop();
 			break;
 		case 0x05:	/* FLD 80 Bits Real */
-			gen_call_function_raw((void*)&FPU_PREP_PUSH);
+			dyn_fpu_push();
 			dyn_fill_ea(FC_ADDR); 
 			gen_call_function_R((void*)&FPU_FLD_F80,FC_ADDR);
 			break;
 		case 0x07:	/* FSTP 80 Bits Real */
 			dyn_fill_ea(FC_ADDR); 
 			gen_call_function_R((void*)&FPU_FST_F80,FC_ADDR);
-			gen_call_function_raw((void*)&FPU_FPOP);
+			dyn_fpu_pop();
 			break;
 		default:
 			FPU_LOG_WARN(3, true, decode.modrm.reg, decode.modrm.rm);
@@ -433,7 +483,7 @@ static void dyn_fpu_esc4(){
 		case 0x03:  /* FCOMP*/
 			dyn_fpu_top();
 			gen_call_function_RR((void*)&FPU_FCOM,FC_OP1,FC_OP2);
-			gen_call_function_raw((void*)&FPU_FPOP);
+			dyn_fpu_pop();
 			break;
 		case 0x04:  /* FSUBR STi,ST*/
 			dyn_fpu_top_swapped();
@@ -457,7 +507,7 @@ static void dyn_fpu_esc4(){
 	} else { 
 		dyn_fill_ea(FC_ADDR);
 		gen_call_function_R((void*)&FPU_FLD_F64_EA,FC_ADDR); 
-		gen_mov_word_to_reg(FC_OP1,(void*)(&TOP),true);
+		dyn_fpu_top_to_reg(FC_OP1);
 		dyn_eatree();
 	}
 }
@@ -479,14 +529,14 @@ static void dyn_fpu_esc5(){
 			break;
 		case 0x03:  /* FSTP STi*/
 			gen_call_function_RR((void*)&FPU_FST,FC_OP1,FC_OP2);
-			gen_call_function_raw((void*)&FPU_FPOP);
+			dyn_fpu_pop();
 			break;
 		case 0x04:	/* FUCOM STi */
 			gen_call_function_RR((void*)&FPU_FUCOM,FC_OP1,FC_OP2);
 			break;
 		case 0x05:	/*FUCOMP STi */
 			gen_call_function_RR((void*)&FPU_FUCOM,FC_OP1,FC_OP2);
-			gen_call_function_raw((void*)&FPU_FPOP);
+			dyn_fpu_pop();
 			break;
 		default:
 			LOG(LOG_FPU,LOG_WARN)("ESC 5:Unhandled group %X subfunction %X",static_cast<uint32_t>(decode.modrm.reg),static_cast<uint32_t>(decode.modrm.rm));
@@ -495,9 +545,9 @@ static void dyn_fpu_esc5(){
 	} else {
 		switch(decode.modrm.reg){
 		case 0x00:  /* FLD double real*/
-			gen_call_function_raw((void*)&FPU_PREP_PUSH);
+			dyn_fpu_push();
 			dyn_fill_ea(FC_OP1); 
-			gen_mov_word_to_reg(FC_OP2,(void*)(&TOP),true);
+			dyn_fpu_top_to_reg(FC_OP2);
 			gen_call_function_RR((void*)&FPU_FLD_F64,FC_OP1,FC_OP2);
 			break;
 		case 0x01:  /* FISTTP longint*/
@@ -510,18 +560,20 @@ static void dyn_fpu_esc5(){
 		case 0x03:	/* FSTP double real*/
 			dyn_fill_ea(FC_ADDR); 
 			gen_call_function_R((void*)&FPU_FST_F64,FC_ADDR);
-			gen_call_function_raw((void*)&FPU_FPOP);
+			dyn_fpu_pop();
 			break;
 		case 0x04:	/* FRSTOR */
 			dyn_fill_ea(FC_ADDR); 
 			gen_call_function_R((void*)&FPU_FRSTOR,FC_ADDR);
+			decode.fpu_top=FpuTopUnknown;
 			break;
 		case 0x06:	/* FSAVE */
 			dyn_fill_ea(FC_ADDR); 
 			gen_call_function_R((void*)&FPU_FSAVE,FC_ADDR);
+			decode.fpu_top=0;	// FSAVE reinitializes the FPU
 			break;
 		case 0x07:   /*FNSTSW */
-			gen_mov_word_to_reg(FC_OP1,(void*)(&TOP),true);
+			dyn_fpu_top_to_reg(FC_OP1);
 			gen_call_function_R((void*)&FPU_SET_TOP,FC_OP1);
 			dyn_fill_ea(FC_OP1); 
 			gen_mov_word_to_reg(FC_OP2,(void*)(&fpu.sw),false);
@@ -555,12 +607,10 @@ static void dyn_fpu_esc6(){
 				LOG(LOG_FPU,LOG_WARN)("ESC 6:Unhandled group %X subfunction %X",static_cast<uint32_t>(decode.modrm.reg),static_cast<uint32_t>(decode.modrm.rm));
 				return;
 			}
-			gen_mov_word_to_reg(FC_OP2,(void*)(&TOP),true);
-			gen_add_imm(FC_OP2,1);
-			gen_and_imm(FC_OP2,7);
-			gen_mov_word_to_reg(FC_OP1,(void*)(&TOP),true);
+			dyn_fpu_top_to_reg(FC_OP2,1);
+			dyn_fpu_top_to_reg(FC_OP1);
 			gen_call_function_RR((void*)&FPU_FCOM,FC_OP1,FC_OP2);
-			gen_call_function_raw((void*)&FPU_FPOP); /* extra pop at the bottom*/
+			dyn_fpu_pop(); /* extra pop at the bottom*/
 			break;
 		case 0x04:  /* FSUBRP STi,ST*/
 			dyn_fpu_top_swapped();
@@ -581,11 +631,11 @@ static void dyn_fpu_esc6(){
 		default:
 			break;
 		}
-		gen_call_function_raw((void*)&FPU_FPOP);		
+		dyn_fpu_pop();		
 	} else {
 		dyn_fill_ea(FC_ADDR);
 		gen_call_function_R((void*)&FPU_FLD_I16_EA,FC_ADDR); 
-		gen_mov_word_to_reg(FC_OP1,(void*)(&TOP),true);
+		dyn_fpu_top_to_reg(FC_OP1);
 		dyn_eatree();
 	}
 }
@@ -598,7 +648,7 @@ static void dyn_fpu_esc7(){
 		case 0x00: /* FFREEP STi */
 			dyn_fpu_top();
 			gen_call_function_R((void*)&FPU_FFREE,FC_OP2);
-			gen_call_function_raw((void*)&FPU_FPOP);
+			dyn_fpu_pop();
 			break;
 		case 0x01: /* FXCH STi*/
 			dyn_fpu_top();
@@ -608,12 +658,12 @@ static void dyn_fpu_esc7(){
 		case 0x03:  /* FSTP STi*/
 			dyn_fpu_top();
 			gen_call_function_RR((void*)&FPU_FST,FC_OP1,FC_OP2);
-			gen_call_function_raw((void*)&FPU_FPOP);
+			dyn_fpu_pop();
 			break;
 		case 0x04:
 			switch(decode.modrm.rm){
 				case 0x00:     /* FNSTSW AX*/
-					gen_mov_word_to_reg(FC_OP1,(void*)(&TOP),true);
+					dyn_fpu_top_to_reg(FC_OP1);
 					gen_call_function_R((void*)&FPU_SET_TOP,FC_OP1); 
 					gen_mov_word_to_reg(FC_OP1,(void*)(&fpu.sw),false);
 					MOV_REG_WORD16_FROM_HOST_REG(FC_OP1,DRC_REG_EAX);
@@ -630,9 +680,9 @@ static void dyn_fpu_esc7(){
 	} else {
 		switch(decode.modrm.reg){
 		case 0x00:  /* FILD int16_t */
-			gen_call_function_raw((void*)&FPU_PREP_PUSH);
+			dyn_fpu_push();
 			dyn_fill_ea(FC_OP1); 
-			gen_mov_word_to_reg(FC_OP2,(void*)(&TOP),true);
+			dyn_fpu_top_to_reg(FC_OP2);
 			gen_call_function_RR((void*)&FPU_FLD_I16,FC_OP1,FC_OP2);
 			break;
 		case 0x01:
@@ -645,29 +695,29 @@ static void dyn_fpu_esc7(){
 		case 0x03:	/* FISTP int16_t */
 			dyn_fill_ea(FC_ADDR); 
 			gen_call_function_R((void*)&FPU_FST_I16,FC_ADDR);
-			gen_call_function_raw((void*)&FPU_FPOP);
+			dyn_fpu_pop();
 			break;
 		case 0x04:   /* FBLD packed BCD */
-			gen_call_function_raw((void*)&FPU_PREP_PUSH);
+			dyn_fpu_push();
 			dyn_fill_ea(FC_OP1);
-			gen_mov_word_to_reg(FC_OP2,(void*)(&TOP),true);
+			dyn_fpu_top_to_reg(FC_OP2);
 			gen_call_function_RR((void*)&FPU_FBLD,FC_OP1,FC_OP2);
 			break;
 		case 0x05:  /* FILD int64_t */
-			gen_call_function_raw((void*)&FPU_PREP_PUSH);
+			dyn_fpu_push();
 			dyn_fill_ea(FC_OP1);
-			gen_mov_word_to_reg(FC_OP2,(void*)(&TOP),true);
+			dyn_fpu_top_to_reg(FC_OP2);
 			gen_call_function_RR((void*)&FPU_FLD_I64,FC_OP1,FC_OP2);
 			break;
 		case 0x06:	/* FBSTP packed BCD */
 			dyn_fill_ea(FC_ADDR); 
 			gen_call_function_R((void*)&FPU_FBST,FC_ADDR);
-			gen_call_function_raw((void*)&FPU_FPOP);
+			dyn_fpu_pop();
 			break;
 		case 0x07:  /* FISTP int64_t */
 			dyn_fill_ea(FC_ADDR); 
 			gen_call_function_R((void*)&FPU_FST_I64,FC_ADDR);
-			gen_call_function_raw((void*)&FPU_FPOP);
+			dyn_fpu_pop();
 			break;
 		default:
 			LOG(LOG_FPU,LOG_WARN)("ESC 7 EA:Unhandled group %X subfunction %X",static_cast<uint32_t>(decode.modrm.reg),static_cast<uint32_t>(decode.modrm.rm));
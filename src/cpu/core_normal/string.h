@@ -3,8 +3,91 @@
 
 #include "cpu/string_ops.h"
 
+#include <algorithm>
+#include <array>
+
 #define LoadD(_BLAH) _BLAH
 
+// Forward REP STOS and MOVS runs into pages without a host pointer (such as
+// the planar VGA modes) are handed to page handlers with PFLAG_BLOCKWRITE a
+// page at a time. Whatever is left stays with the per-element loop.
+static void DoStringBlocks(const STRING_OP type, const PhysPt si_base,
+                           uint32_t& si_index, const PhysPt di_base,
+                           uint32_t& di_index, const uint32_t add_mask,
+                           uint32_t& count)
+{
+	if (cpu.direction < 0) {
+		return;
+	}
+	const bool is_movs = (type >= R_MOVSB && type <= R_MOVSD);
+#if C_DEBUGGER && C_HEAVY_DEBUGGER
+	// Reading the source in bulk would skip the memory read breakpoints
+	if (is_movs) {
+		return;
+	}
+#endif
+	const uint32_t size = 1 << (type & 3);
+
+	// The number of elements that fit before the end of the page, or
+	// before the index wraps around
+	auto elements_left = [&](const PhysPt address, const uint32_t index) {
+		const auto to_page_end = MemPageSize - (address & (MemPageSize - 1));
+		const auto to_wrap     = static_cast<uint64_t>(add_mask - index) + 1;
+		return static_cast<uint32_t>(
+		        std::min<uint64_t>(to_page_end, to_wrap) / size);
+	};
+
+	std::array<uint8_t, MemPageSize> buffer;
+
+	while (count > 1) {
+		const PhysPt dest = di_base + di_index;
+		if (get_tlb_write(dest)) {
+			return;
+		}
+		auto num = std::min(count, elements_left(dest, di_index));
+
+		const uint8_t* data = buffer.data();
+		if (is_movs) {
+			const PhysPt src = si_base + si_index;
+			const auto host  = get_tlb_read(src);
+			if (!host) {
+				return;
+			}
+			num  = std::min(num, elements_left(src, si_index));
+			data = host + src;
+		}
+		if (num < 2) {
+			return;
+		}
+		const auto handler = get_slow_path_writehandler(dest);
+		if (!(handler->flags & PFLAG_BLOCKWRITE)) {
+			return;
+		}
+		const auto num_bytes = num * size;
+		switch (type) {
+		case R_STOSB: std::fill_n(buffer.begin(), num_bytes, reg_al); break;
+		case R_STOSW:
+			for (uint32_t i = 0; i < num_bytes; i += 2) {
+				host_writew(&buffer[i], reg_ax);
+			}
+			break;
+		case R_STOSD:
+			for (uint32_t i = 0; i < num_bytes; i += 4) {
+				host_writed(&buffer[i], reg_eax);
+			}
+			break;
+		default: break;
+		}
+		handler->writeblock(dest, data, num_bytes, size);
+
+		di_index = (di_index + num_bytes) & add_mask;
+		if (is_movs) {
+			si_index = (si_index + num_bytes) & add_mask;
+		}
+		count -= num;
+	}
+}
+
 static void DoString(STRING_OP type) {
 	const auto si_base = BaseDS;
 	const auto di_base = SegBase(es);
@@ -34,6 +117,17 @@ static void DoString(STRING_OP type) {
 			count_left=0;
 		}
 	}
+	switch (type) {
+	case R_STOSB:
+	case R_STOSW:
+	case R_STOSD:
+	case R_MOVSB:
+	case R_MOVSW:
+	case R_MOVSD:
+		DoStringBlocks(type, si_base, si_index, di_base, di_index, add_mask, count);
+		break;
+	default: break;
+	}
 	auto add_index = cpu.direction;
 	if (count) switch (type) {
 	case R_OUTSB:
@@ -11,12 +11,15 @@
 
 #include "config/config.h"
 #include "config/setup.h"
+#include "cpu/descriptor_cache.h"
 #include "cpu/paging.h"
 #include "debugger/debugger.h"
 #include "dos/programs.h"
 #include "gui/mapper.h"
 #include "hardware/pic.h"
 #include "lazyflags.h"
+#include "misc/perf_counters.h"
+#include "misc/profiler.h"
 #include "misc/support.h"
 #include "misc/video.h"
 #include "shell/command_line.h"
@@ -81,6 +84,8 @@ static int cpu_cycle_down = 0;
 
 int64_t CPU_IODelayRemoved = 0;
 
+static bool idle_detection = true;
+
 CPU_Decoder* cpudecoder;
 
 bool CPU_CycleAutoAdjust = false;
@@ -109,6 +114,7 @@ void CPU_Core_Dyn_X86_SetFPUMode(bool dh_fpu);
 void CPU_Core_Dynrec_Init();
 void CPU_Core_Dynrec_Cache_Init(bool enable_cache);
 void CPU_Core_Dynrec_Cache_Close();
+void CPU_Core_Dynrec_SetTraces(bool enabled);
 #endif
 
 /* In debug mode exceptions are tested and dosbox exits when
@@ -281,6 +287,29 @@ void Descriptor::Load(PhysPt address) {
 	cpu.mpl=3;
 }
 
+DescriptorCache descriptor_cache = {};
+
+void Descriptor::LoadCached(PhysPt address)
+{
+	++perf_counters.descriptor_loads;
+	if (descriptor_cache.Lookup(address, saved.fill)) {
+		++perf_counters.descriptor_cache_hits;
+		return;
+	}
+	Load(address);
+
+	// Descriptors straddling two pages are rare enough to not be worth
+	// watching both pages for
+	if ((address & 4095) > 4096 - sizeof(saved)) {
+		return;
+	}
+	if (get_tlb_readhandler(address)->flags & PFLAG_INIT) {
+		return;
+	}
+	PAGING_AddWriteWatch(PAGING_GetPhysicalPage(address) >> 12);
+	descriptor_cache.Store(address, saved.fill);
+}
+
 void Descriptor::Save(PhysPt address) {
 	cpu.mpl=0;
 	uint32_t* data = (uint32_t*)&saved;
@@ -736,6 +765,7 @@ void CPU_Interrupt(Bitu num,Bitu type,Bitu oldeip) {
 		return;
 	}
 	last_interrupt = num;
+	PROFILER_NoteInterrupt(static_cast<uint8_t>(num));
 
 	FillFlags();
 #if C_DEBUGGER
@@ -1715,6 +1745,9 @@ void CPU_LGDT(Bitu limit,Bitu base) {
 	LOG(LOG_CPU,LOG_NORMAL)("GDT Set to base:%X limit:%X",base,limit);
 	cpu.gdt.SetLimit(limit);
 	cpu.gdt.SetBase(base);
+
+	// Stop watching the pages of the previous table
+	PAGING_ClearWriteWatches();
 }
 
 void CPU_LIDT(Bitu limit,Bitu base) {
@@ -1811,6 +1844,15 @@ void CPU_SET_CRX(Bitu cr, Bitu value)
 	}
 	case 2: paging.cr2 = value; break;
 	case 3: PAGING_SetDirBase(value); break;
+	case 4: {
+		auto cr4 = static_cast<uint32_t>(value);
+		// 4 MiB and global pages are only advertised on Pentium CPUs
+		if (CPU_ArchitectureType < ArchitectureType::Pentium) {
+			cr4 &= ~(CR4_PSE | CR4_PGE);
+		}
+		PAGING_SetCR4(cr4);
+		break;
+	}
 	default:
 		LOG(LOG_CPU, LOG_ERROR)("Unhandled MOV CR%d,%X", cr, value);
 		break;
@@ -1838,6 +1880,8 @@ Bitu CPU_GET_CRX(Bitu cr) {
 		return paging.cr2;
 	case 3:
 		return PAGING_GetDirBase() & 0xfffff000;
+	case 4:
+		return PAGING_GetCR4();
 	default:
 		LOG(LOG_CPU,LOG_ERROR)("Unhandled MOV XXX, CR%d",cr);
 		break;
@@ -2227,14 +2271,15 @@ bool CPU_CPUID() {
 			reg_ecx = 0;     // No features
 		} else if (CPU_ArchitectureType == ArchitectureType::Pentium) {
 #if C_FPU
-			reg_eax = 0x517; // Intel Pentium P5 60/66 MHz D1-step
-			reg_edx = 0x11;  // FPU + Time Stamp Counter (RDTSC)
+			reg_eax = 0x517;  // Intel Pentium P5 60/66 MHz D1-step
+			reg_edx = 0x2019; // FPU + 4 MiB pages (PSE) + Time Stamp
+			                  // Counter (RDTSC) + global pages (PGE)
 #else
 			// All Pentiums had FPU built-in, so when FPU is
 			// disabled, we pretend to have early Pentium model with
 			// FDIV bug present.
-			reg_eax = 0x513; // Intel Pentium P5 60/66 MHz B1-step
-			reg_edx = 0x10;  // Time Stamp Counter (RDTSC)
+			reg_eax = 0x513;  // Intel Pentium P5 60/66 MHz B1-step
+			reg_edx = 0x2018; // PSE + Time Stamp Counter (RDTSC) + PGE
 #endif
 			reg_ebx = 0;     // Not supported
 			reg_ecx = 0;     // No features
@@ -2242,7 +2287,8 @@ bool CPU_CPUID() {
 			reg_eax = 0x543;      // Intel Pentium MMX
 			reg_ebx = 0;          // Not supported
 			reg_ecx = 0;          // No features
-			reg_edx = 0x00800011; // FPU + Time Stamp Counter (RDTSC) + MMX
+			reg_edx = 0x00802019; // FPU + PSE + Time Stamp Counter
+			                      // (RDTSC) + PGE + MMX
 		} else {
 			return false;
 		}
@@ -2281,6 +2327,20 @@ void CPU_HLT(Bitu oldeip)
 	cpudecoder          = &hlt_decode;
 }
 
+void CPU_NotifyIdle([[maybe_unused]] const CpuIdleReason reason)
+{
+	if (!idle_detection || CPU_Cycles <= 0) {
+		return;
+	}
+
+	perf_counters.idle_cycles_skipped += static_cast<uint64_t>(CPU_Cycles);
+
+	// Like HLT; the skipped cycles are reported as removed so the
+	// automatic cycles adjustment doesn't count them as work done
+	CPU_IODelayRemoved += CPU_Cycles;
+	CPU_Cycles = 0;
+}
+
 void CPU_ENTER(bool use32,Bitu bytes,Bitu level) {
 	level&=0x1f;
 	Bitu sp_index=reg_esp&cpu.stack.mask;
@@ -2681,6 +2741,7 @@ public:
 
 		// Initialise
 		CPU_SET_CRX(0, 0);
+		CPU_SET_CRX(4, 0);
 
 		cpu.code.big      = false;
 		cpu.stack.mask    = 0xffff;
@@ -3188,6 +3249,12 @@ public:
 		cpu_cycle_up   = secprop->GetInt("cycleup");
 		cpu_cycle_down = secprop->GetInt("cycledown");
 
+		idle_detection = secprop->GetBool("cpu_idle_detection");
+
+#if C_DYNREC
+		CPU_Core_Dynrec_SetTraces(secprop->GetBool("dynrec_traces"));
+#endif
+
 		GFX_NotifyCyclesChanged();
 
 		return true;
@@ -3365,6 +3432,23 @@ void init_cpu_dosbox_settings(SectionProp& secprop)
 	        "millisecond can vary; this might cause issues in some DOS programs.",
 	        (CpuThrottleDefault ? "'on'" : "'off'")));
 
+	pbool = secprop.AddBool("cpu_idle_detection", Always, true);
+	pbool->SetHelp(
+	        "Detect when the DOS program is idle and don't waste host CPU time running\n"
+	        "its idle loop ('on' by default). Waiting for a keystroke, polling the\n"
+	        "keyboard in a tight loop, and the DOS and Windows idle calls (INT 28h and\n"
+	        "INT 2Fh AX=1680h) are detected. The emulated time is not affected; disable\n"
+	        "this only if a program that relies on counting its idle loop iterations\n"
+	        "misbehaves.");
+
+	pbool = secprop.AddBool("dynrec_traces", Always, true);
+	pbool->SetHelp(
+	        "Let the dynamic core translate longer code blocks that continue across\n"
+	        "direct jumps, calls and forward conditional branches ('on' by default).\n"
+	        "This reduces the number of times the core has to look up the next block.\n"
+	        "Only affects the 'dynrec' implementation of the dynamic core and code\n"
+	        "translated after the setting is changed.");
+
 	auto pint = secprop.AddInt("cycleup", Always, DefaultCpuCycleUp);
 	pint->SetMinMax(CpuCycleStepMin, CpuCycleStepMax);
 	pint->SetHelp(
@@ -130,6 +130,22 @@ void CPU_RET(bool use32, Bitu bytes, Bitu oldeip);
 void CPU_IRET(bool use32, Bitu oldeip);
 void CPU_HLT(Bitu oldeip);
 
+// Idle detection
+//
+// Called from the BIOS and DOS services when the guest is waiting for
+// something. If idle detection is enabled, the rest of the current cycle slice
+// is skipped up to the next PIC event (the same way HLT does), so the host
+// doesn't spin running the guest's idle loop. The emulated time and the timing
+// of the PIC events are not affected.
+enum class CpuIdleReason {
+	KeyboardWait,     // INT 16h waiting for a keystroke
+	KeyboardPoll,     // INT 16h keystroke check keeps finding no key
+	DosIdle,          // INT 28h DOS idle interrupt
+	ReleaseTimeSlice, // INT 2Fh AX=1680h
+};
+
+void CPU_NotifyIdle(const CpuIdleReason reason);
+
 bool CPU_POPF(Bitu use32);
 bool CPU_PUSHF(Bitu use32);
 bool CPU_CLI();
@@ -191,6 +207,9 @@ void CPU_Push32(const uint32_t value);
 #define CR0_FPUPRESENT       0x00000010
 #define CR0_PAGING           0x80000000
 
+#define CR4_PSE 0x00000010 // 4 MiB pages
+#define CR4_PGE 0x00000080 // Global pages
+
 // Reasons for triggering a debug exception
 #define DBINT_BP0        0x00000001
 #define DBINT_BP1        0x00000002
@@ -348,6 +367,9 @@ public:
 	void Load(PhysPt address);
 	void Save(PhysPt address);
 
+	// Same as Load(), but served from the descriptor cache when possible
+	void LoadCached(PhysPt address);
+
 	PhysPt GetBase()
 	{
 		const auto base = (saved.seg.base_24_31 << 24) |
@@ -436,7 +458,7 @@ public:
 		if (selector >= table_limit) {
 			return false;
 		}
-		desc.Load(table_base + nonbitu_selector);
+		desc.LoadCached(table_base + nonbitu_selector);
 		return true;
 	}
 
@@ -455,13 +477,13 @@ public:
 			if (address >= ldt_limit) {
 				return false;
 			}
-			desc.Load(ldt_base + nonbitu_address);
+			desc.LoadCached(ldt_base + nonbitu_address);
 			return true;
 		} else {
 			if (address >= table_limit) {
 				return false;
 			}
-			desc.Load(table_base + nonbitu_address);
+			desc.LoadCached(table_base + nonbitu_address);
 			return true;
 		}
 	}
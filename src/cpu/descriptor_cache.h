@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_DESCRIPTOR_CACHE_H
+#define DOSBOX_DESCRIPTOR_CACHE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "hardware/memory.h"
+
+// Cache of the raw descriptors read from the GDT, LDT and IDT
+//
+// Protected-mode programs load the same few selectors over and over, and
+// every load used to read the descriptor from guest memory through the TLB.
+// The entries are keyed by the linear address of the descriptor, i.e. the
+// table base plus the selector index, so a table being moved never yields
+// a stale entry. The whole cache is invalidated with a single generation
+// bump whenever the linear-to-physical mapping changes, or the guest writes
+// to a page holding a cached descriptor (see PAGING_AddWriteWatch).
+
+class DescriptorCache {
+public:
+	static constexpr size_t NumEntries = 256;
+
+	bool Lookup(const PhysPt address, uint32_t (&data)[2]) const
+	{
+		const auto& entry = entries[index_of(address)];
+		if (entry.generation != generation || entry.address != address) {
+			return false;
+		}
+		data[0] = entry.data[0];
+		data[1] = entry.data[1];
+		return true;
+	}
+
+	void Store(const PhysPt address, const uint32_t (&data)[2])
+	{
+		auto& entry      = entries[index_of(address)];
+		entry.address    = address;
+		entry.generation = generation;
+		entry.data[0]    = data[0];
+		entry.data[1]    = data[1];
+	}
+
+	void Invalidate()
+	{
+		// Entries of a wrapped-around generation could look valid again
+		if (++generation == 0) {
+			entries.fill({});
+			generation = 1;
+		}
+	}
+
+private:
+	static size_t index_of(const PhysPt address)
+	{
+		return (address >> 3) % NumEntries;
+	}
+
+	struct Entry {
+		PhysPt address      = 0;
+		uint32_t generation = 0;
+		uint32_t data[2]    = {};
+	};
+
+	std::array<Entry, NumEntries> entries = {};
+
+	// Zero is never a valid generation, so default entries always miss
+	uint32_t generation = 1;
+};
+
+extern DescriptorCache descriptor_cache;
+
+#endif // DOSBOX_DESCRIPTOR_CACHE_H
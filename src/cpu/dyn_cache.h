@@ -2,6 +2,7 @@
 // SPDX-FileCopyrightText:  2002-2021 The DOSBox Team
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <cassert>
 #include <cerrno>
 #include <new>
@@ -9,6 +10,9 @@
 
 #include "utils/mem_unaligned.h"
 #include "cpu/paging.h"
+#include "cpu/smc_counters.h"
+#include "hardware/pic.h"
+#include "misc/perf_counters.h"
 #include "misc/types.h"
 
 #if defined(HAVE_MMAP)
@@ -58,6 +62,10 @@ public:
 		uint16_t start = 0;
 		uint16_t end   = 0; // where in the page is the original code
 
+		// the block ends in front of an instruction that's modified too
+		// often to be translated, the one at end + 1
+		bool stops_at_hot = false;
+
 		CodePageHandler* handler = {}; // page containing this code
 	} page = {};
 
@@ -137,6 +145,11 @@ static uint8_t* cache_code_link_blocks = {};
 static std::vector<CacheBlock> cache_blocks(CACHE_BLOCKS);
 static CacheBlock link_blocks[2] = {}; // default linking (specially marked)
 
+#if (C_DYNREC)
+// lets the decoder forget what it learned about the code in a page
+static void dyn_code_page_released(Bitu phys_page);
+#endif
+
 // the CodePageHandler class provides access to the contained
 // cache blocks and intercepts writes to the code for special treatment
 class CodePageHandler final : public PageHandler {
@@ -168,6 +181,8 @@ public:
 			delete [] invalidation_map;
 			invalidation_map = nullptr;
 		}
+		smc_last_decay_ms = PIC_Ticks;
+		smc_fallbacks     = 0;
 	}
 
 	// clear out blocks that contain code which has been modified
@@ -198,6 +213,7 @@ public:
 					block->Clear(); // clear the block,
 					                // decrements the
 					                // write_map accordingly
+					++perf_counters.dyn_invalidations;
 				}
 				block=nextblock;
 			}
@@ -206,6 +222,54 @@ public:
 		return is_current_block;
 	}
 
+	// let the write counters cool down (see smc_counters.h); blocks that
+	// stop in front of an instruction that can be translated again are
+	// cleared so they get retranslated including it
+	void DecaySmcCounters()
+	{
+		if (!invalidation_map) {
+			return;
+		}
+		smc_decay(invalidation_map,
+		          sizeof(write_map),
+		          smc_last_decay_ms,
+		          PIC_Ticks,
+		          [this](const size_t index) {
+			          InvalidateRange(index, index);
+			          ClearHotStopsAt(index);
+		          });
+	}
+
+	// clear out the blocks that stop in front of the instruction at
+	// index, they don't cover it so writes to it leave them alone;
+	// index 4096 is the first instruction of the following page
+	void ClearHotStopsAt(const Bitu index)
+	{
+		for (auto first : hash_map) {
+			CacheBlock* block = first;
+			while (block) {
+				CacheBlock* nextblock = block->hash.next;
+				if (block->page.stops_at_hot &&
+				    block->page.end + 1u == index) {
+					block->Clear();
+					++perf_counters.dyn_invalidations;
+				}
+				block = nextblock;
+			}
+		}
+	}
+
+	// an instruction in this page is run by the normal core because
+	// it's modified too often
+	void CountSmcFallback()
+	{
+		++smc_fallbacks;
+		++perf_counters.dyn_smc_fallbacks;
+		perf_counters.dyn_smc_fallbacks_page_max =
+		        std::max(perf_counters.dyn_smc_fallbacks_page_max,
+		                 smc_fallbacks);
+	}
+
 	uint8_t *alloc_invalidation_map() const
 	{
 		constexpr size_t map_size = 4096;
@@ -244,7 +308,7 @@ public:
 		} else if (!invalidation_map) {
 			invalidation_map = alloc_invalidation_map();
 		}
-		invalidation_map[addr]++;
+		smc_count_write(invalidation_map, addr, 1);
 		InvalidateRange(addr,addr);
 	}
 
@@ -272,7 +336,7 @@ public:
 		} else if (!invalidation_map) {
 			invalidation_map = alloc_invalidation_map();
 		}
-		host_addw(&invalidation_map[addr], 0x0101);
+		smc_count_write(invalidation_map, addr, 2);
 		InvalidateRange(addr,addr+1);
 	}
 
@@ -300,7 +364,7 @@ public:
 		} else if (!invalidation_map) {
 			invalidation_map = alloc_invalidation_map();
 		}
-		host_addd(&invalidation_map[addr], 0x01010101);
+		smc_count_write(invalidation_map, addr, 4);
 		InvalidateRange(addr,addr+3);
 	}
 
@@ -327,7 +391,7 @@ public:
 			if (!invalidation_map)
 				invalidation_map = alloc_invalidation_map();
 
-			invalidation_map[addr]++;
+			smc_count_write(invalidation_map, addr, 1);
 			if (InvalidateRange(addr,addr)) {
 				cpu.exception.which=SMC_CURRENT_BLOCK;
 				return true;
@@ -360,7 +424,7 @@ public:
 			if (!invalidation_map)
 				invalidation_map = alloc_invalidation_map();
 
-			host_addw(&invalidation_map[addr], 0x0101);
+			smc_count_write(invalidation_map, addr, 2);
 			if (InvalidateRange(addr,addr+1)) {
 				cpu.exception.which=SMC_CURRENT_BLOCK;
 				return true;
@@ -393,7 +457,7 @@ public:
 			if (!invalidation_map)
 				invalidation_map = alloc_invalidation_map();
 
-			host_addd(&invalidation_map[addr], 0x01010101);
+			smc_count_write(invalidation_map, addr, 4);
 			if (InvalidateRange(addr,addr+3)) {
 				cpu.exception.which=SMC_CURRENT_BLOCK;
 				return true;
@@ -474,6 +538,9 @@ public:
 		// revert to old handler
 		MEM_SetPageHandler(phys_page,1,old_pagehandler);
 		PAGING_ClearTLB();
+#if (C_DYNREC)
+		dyn_code_page_released(phys_page);
+#endif
 
 		// remove page from the lists
 		if (prev) prev->next=next;
@@ -530,6 +597,11 @@ public:
 	uint8_t write_map[4096] = {};
 	uint8_t *invalidation_map = nullptr;
 
+	// emulated time of the last decay of the invalidation map, and the
+	// number of self-modifying code fallbacks in this page
+	uint32_t smc_last_decay_ms = 0;
+	uint64_t smc_fallbacks     = 0;
+
 	CodePageHandler *prev = nullptr;
 	CodePageHandler *next = nullptr;
 
@@ -684,11 +756,14 @@ void CacheBlock::Clear()
 		page.handler->DelCacheBlock(this);
 		page.handler=nullptr;
 	}
+	page.stops_at_hot=false;
 	cache.DeleteWriteMask();
 }
 
 static CacheBlock *cache_openblock()
 {
+	++perf_counters.dyn_translations;
+
 	CacheBlock *block = cache.block.active;
 	// check for enough space in this block
 	Bitu size=block->cache.size;
@@ -647,6 +647,7 @@ uint32_t FillFlags(void) {
 		DOFLAG_SFw;
 		SET_FLAG(OF,(lf_resw ^ lf_var1w) & 0x8000);
 		DOFLAG_PF;
+		SET_FLAG(AF,false);
 		break;
 	case t_DSHLd:
 		SET_FLAG(CF,(lf_var1d >> (32 - lf_var2b)) & 1);
@@ -654,6 +655,7 @@ uint32_t FillFlags(void) {
 		DOFLAG_SFd;
 		SET_FLAG(OF,(lf_resd ^ lf_var1d) & 0x80000000);
 		DOFLAG_PF;
+		SET_FLAG(AF,false);
 		break;
 
 
@@ -692,6 +694,7 @@ uint32_t FillFlags(void) {
 		DOFLAG_SFw;
 		SET_FLAG(OF,(lf_resw ^ lf_var1w) & 0x8000);
 		DOFLAG_PF;
+		SET_FLAG(AF,false);
 		break;
 	case t_DSHRd:
 		SET_FLAG(CF, (lf_var1d >> lf_var2b_minus_one()) & 1);
@@ -699,6 +702,7 @@ uint32_t FillFlags(void) {
 		DOFLAG_SFd;
 		SET_FLAG(OF,(lf_resd ^ lf_var1d) & 0x80000000);
 		DOFLAG_PF;
+		SET_FLAG(AF,false);
 		break;
 
 
@@ -928,6 +932,7 @@ void FillFlagsNoCFOF(void) {
 		DOFLAG_ZFw;
 		DOFLAG_SFw;
 		DOFLAG_PF;
+		SET_FLAG(AF,false);
 		break;
 
 	case t_DSHLd:
@@ -935,6 +940,7 @@ void FillFlagsNoCFOF(void) {
 		DOFLAG_ZFd;
 		DOFLAG_SFd;
 		DOFLAG_PF;
+		SET_FLAG(AF,false);
 		break;
 
 	case t_SHLb:
@@ -4,6 +4,7 @@
 
 #include "cpu/paging.h"
 
+#include <array>
 #include <cassert>
 #include <cstdlib>
 #include <cstring>
@@ -11,10 +12,12 @@
 
 #include "config/setup.h"
 #include "cpu/cpu.h"
+#include "cpu/descriptor_cache.h"
 #include "cpu/registers.h"
 #include "debugger/debugger.h"
 #include "hardware/memory.h"
 #include "lazyflags.h"
+#include "misc/perf_counters.h"
 
 #define LINK_TOTAL		(64*1024)
 
@@ -73,6 +76,20 @@ void PageHandler::writeq(PhysPt addr, uint64_t val) {
     }
 }
 
+void PageHandler::writeblock(PhysPt addr, const uint8_t* data,
+                             const Bitu num_bytes, const Bitu access_size)
+{
+	for (Bitu i = 0; i < num_bytes; i += access_size) {
+		switch (access_size) {
+		case 1: writeb(addr, data[i]); break;
+		case 2: writew(addr, host_readw(data + i)); break;
+		case 4: writed(addr, host_readd(data + i)); break;
+		default: assert(false);
+		}
+		addr += static_cast<PhysPt>(access_size);
+	}
+}
+
 HostPt PageHandler::GetHostReadPt(Bitu /*phys_page*/) {
 	return nullptr;
 }
@@ -182,19 +199,48 @@ void PAGING_PageFault(PhysPt lin_addr,uint32_t page_addr,uint32_t faultcode) {
 
 static inline void InitPageUpdateLink(uint32_t relink,PhysPt addr) {
 	if (relink==0) return;
-	if (paging.links.used) {
-		if (paging.links.entries[paging.links.used-1]==(addr>>12)) {
-			paging.links.used--;
+	for (auto links : {&paging.links, &paging.global_links}) {
+		if (links->used && links->entries[links->used - 1] == (addr >> 12)) {
+			links->used--;
 			PAGING_UnlinkPages(addr>>12,1);
+			break;
 		}
 	}
 	if (relink>1) PAGING_LinkPage_ReadOnly(addr>>12,relink);
 }
 
+// With CR4.PSE set, a page directory entry with the PS bit (bit 7, where page
+// table entries have their PAT bit) maps a 4 MiB page directly
+static inline bool is_large_page(const X86PageEntry& table)
+{
+	return (paging.cr4 & CR4_PSE) && table.pat;
+}
+
+// Address of the entry mapping the linear page; for 4 MiB pages that's the
+// page directory entry itself
+static inline PhysPt get_entry_addr(const X86PageEntry& table, const uint32_t lin_page)
+{
+	if (is_large_page(table)) {
+		return (paging.base.page << 12) + (lin_page >> 10) * 4;
+	}
+	return (table.base << 12) + (lin_page & 0x3ff) * 4;
+}
+
+static inline uint32_t get_phys_page(const X86PageEntry& table,
+                                     const X86PageEntry& entry,
+                                     const uint32_t lin_page)
+{
+	if (is_large_page(table)) {
+		return (entry.base & ~0x3ffu) | (lin_page & 0x3ff);
+	}
+	return entry.base;
+}
+
 static inline void InitPageCheckPresence(PhysPt lin_addr,bool writing,X86PageEntry& table,X86PageEntry& entry) {
+	++perf_counters.tlb_misses;
+
 	const auto lin_page=lin_addr >> 12;
 	const auto d_index=lin_page >> 10;
-	const auto t_index=lin_page & 0x3ff;
 	const auto table_addr=(paging.base.page<<12)+d_index*4;
 	table.set(phys_readd(table_addr));
 	if (!table.p) {
@@ -206,7 +252,11 @@ static inline void InitPageCheckPresence(PhysPt lin_addr,bool writing,X86PageEnt
 			E_Exit("Pagefault didn't correct table");
 		}
 	}
-	const auto entry_addr = (table.base << 12) + t_index * 4;
+	if (is_large_page(table)) {
+		entry = table;
+		return;
+	}
+	const auto entry_addr = get_entry_addr(table, lin_page);
 	entry.set(phys_readd(entry_addr));
 	if (!entry.p) {
 		//		LOG(LOG_PAGING,LOG_NORMAL)("NP Page");
@@ -220,9 +270,10 @@ static inline void InitPageCheckPresence(PhysPt lin_addr,bool writing,X86PageEnt
 }
 			
 static inline bool InitPageCheckPresence_CheckOnly(PhysPt lin_addr,bool writing,X86PageEntry& table,X86PageEntry& entry) {
+	++perf_counters.tlb_misses;
+
 	const auto lin_page=lin_addr >> 12;
 	const auto d_index=lin_page >> 10;
-	const auto t_index=lin_page & 0x3ff;
 	const auto table_addr=(paging.base.page<<12)+d_index*4;
 	table.set(phys_readd(table_addr));
 	if (!table.p) {
@@ -231,7 +282,11 @@ static inline bool InitPageCheckPresence_CheckOnly(PhysPt lin_addr,bool writing,
 		cpu.exception.error=(writing?0x02:0x00) | (((cpu.cpl&cpu.mpl)==0)?0x00:0x04);
 		return false;
 	}
-	const auto entry_addr = (table.base << 12) + t_index * 4;
+	if (is_large_page(table)) {
+		entry = table;
+		return true;
+	}
+	const auto entry_addr = get_entry_addr(table, lin_page);
 	entry.set(phys_readd(entry_addr));
 	if (!entry.p) {
 		paging.cr2         = lin_addr;
@@ -439,8 +494,7 @@ public:
 				 entry.wr,
 				 table.wr);
 				PAGING_PageFault(lin_addr,
-				                 (table.base << 12) +
-				                         (lin_page & 0x3ff) * 4,
+				                 get_entry_addr(table, lin_page),
 				                 0x05 | (writing ? 0x02 : 0x00));
 				priv_check = 0;
 			}
@@ -460,19 +514,31 @@ public:
 					entry.d = 1; // mark page as dirty
 				}
 
-				phys_writed((table.base << 12) +
-				                    (lin_page & 0x3ff) * 4,
+				phys_writed(get_entry_addr(table, lin_page),
 				            entry.get());
 			}
 
-			phys_page = entry.base;
+			phys_page = get_phys_page(table, entry, lin_page);
 
 			// now see how the page should be linked best, if we need to catch privilege
 			// checks later on it should be linked as read-only page
 			if (priv_check==0) {
 				// if reading we could link the page as read-only to later cacth writes,
 				// will slow down pretty much but allows catching all dirty events
-				PAGING_LinkPage(lin_page,phys_page);
+				const bool global = (paging.cr4 & CR4_PGE) && entry.g;
+				if (is_large_page(table)) {
+					// Link the whole 4 MiB page in one go, its pages
+					// all share the same access rights
+					const auto first_lin_page  = lin_page & ~0x3ffu;
+					const auto first_phys_page = phys_page & ~0x3ffu;
+					for (uint32_t i = 0; i < 1024; ++i) {
+						PAGING_LinkPage(first_lin_page + i,
+						                first_phys_page + i,
+						                global);
+					}
+				} else {
+					PAGING_LinkPage(lin_page, phys_page, global);
+				}
 			} else {
 				if (priv_check==1) {
 					PAGING_LinkPage(lin_page,phys_page);
@@ -543,11 +609,10 @@ public:
 			}
 			if (!entry.a) {
 				entry.a = 1; // Set access
-				phys_writed((table.base << 12) +
-				                    (lin_page & 0x3ff) * 4,
+				phys_writed(get_entry_addr(table, lin_page),
 				            entry.get());
 			}
-			phys_page = entry.base;
+			phys_page = get_phys_page(table, entry, lin_page);
 			// maybe use read-only page here if possible
 		} else {
 			if (lin_page<LINK_START) phys_page=paging.firstmb[lin_page];
@@ -557,30 +622,50 @@ public:
 	}
 };
 
+// Returns the write watch handler if the linear address maps to a page
+// holding cached descriptors
+static PageHandler* get_write_watch_handler(const PhysPt lin_addr);
+
 class InitPageUserROHandler final : public PageHandler {
 public:
 	InitPageUserROHandler() {
 		flags=PFLAG_INIT|PFLAG_NOCODE;
 	}
+	// The supervisor writes to the page directly, unless it's watched
 	void writeb(PhysPt addr, uint8_t val) override
 	{
 		InitPage(addr, val);
+		if (const auto watch = get_write_watch_handler(addr)) {
+			watch->writeb(addr, val);
+			return;
+		}
 		host_writeb(get_tlb_read(addr) + addr, val);
 	}
 	void writew(PhysPt addr, uint16_t val) override
 	{
 		InitPage(addr, val);
+		if (const auto watch = get_write_watch_handler(addr)) {
+			watch->writew(addr, val);
+			return;
+		}
 		host_writew(get_tlb_read(addr) + addr, val);
 	}
 	void writed(PhysPt addr, uint32_t val) override
 	{
 		InitPage(addr, val);
+		if (const auto watch = get_write_watch_handler(addr)) {
+			watch->writed(addr, val);
+			return;
+		}
 		host_writed(get_tlb_read(addr) + addr, val);
 	}
 	bool writeb_checked(PhysPt addr, uint8_t val) override
 	{
 		const auto writecode = InitPageCheckOnly(addr, val);
 		if (writecode) {
+			if (const auto watch = get_write_watch_handler(addr)) {
+				return watch->writeb_checked(addr, val);
+			}
 			HostPt tlb_addr;
 			if (writecode>1) tlb_addr=get_tlb_read(addr);
 			else tlb_addr=get_tlb_write(addr);
@@ -593,6 +678,9 @@ public:
 	{
 		const auto writecode = InitPageCheckOnly(addr, val);
 		if (writecode) {
+			if (const auto watch = get_write_watch_handler(addr)) {
+				return watch->writew_checked(addr, val);
+			}
 			HostPt tlb_addr;
 			if (writecode>1) tlb_addr=get_tlb_read(addr);
 			else tlb_addr=get_tlb_write(addr);
@@ -605,6 +693,9 @@ public:
 	{
 		const auto writecode = InitPageCheckOnly(addr, val);
 		if (writecode) {
+			if (const auto watch = get_write_watch_handler(addr)) {
+				return watch->writed_checked(addr, val);
+			}
 			HostPt tlb_addr;
 			if (writecode>1) tlb_addr=get_tlb_read(addr);
 			else tlb_addr=get_tlb_write(addr);
@@ -630,9 +721,7 @@ public:
 			 table.us,
 			 entry.wr,
 			 table.wr);
-			PAGING_PageFault(lin_addr,
-			                 (table.base << 12) + (lin_page & 0x3ff) * 4,
-			                 0x07);
+			PAGING_PageFault(lin_addr, get_entry_addr(table, lin_page), 0x07);
 
 			if (!table.a) {
 				table.a = 1; // Set access
@@ -643,11 +732,10 @@ public:
 			if ((!entry.a) || (!entry.d)) {
 				entry.a = 1; // Set access
 				entry.d = 1; // Set dirty
-				phys_writed((table.base << 12) +
-				                    (lin_page & 0x3ff) * 4,
+				phys_writed(get_entry_addr(table, lin_page),
 				            entry.get());
 			}
-			phys_page = entry.base;
+			phys_page = get_phys_page(table, entry, lin_page);
 			PAGING_LinkPage(lin_page,phys_page);
 		} else {
 			if (lin_page<LINK_START) phys_page=paging.firstmb[lin_page];
@@ -678,7 +766,7 @@ public:
 				cpu.exception.error=0x07;
 				return 0;
 			}
-			PAGING_LinkPage(lin_page, entry.base);
+			PAGING_LinkPage(lin_page, get_phys_page(table, entry, lin_page));
 		} else {
 			uint32_t phys_page;
 			if (lin_page<LINK_START) phys_page=paging.firstmb[lin_page];
@@ -703,11 +791,10 @@ public:
 			}
 			if (!entry.a) {
 				entry.a = 1; // Set access
-				phys_writed((table.base << 12) +
-				                    (lin_page & 0x3ff) * 4,
+				phys_writed(get_entry_addr(table, lin_page),
 				            entry.get());
 			}
-			phys_page = entry.base;
+			phys_page = get_phys_page(table, entry, lin_page);
 		} else {
 			if (lin_page<LINK_START) phys_page=paging.firstmb[lin_page];
 			else phys_page=lin_page;
@@ -717,19 +804,29 @@ public:
 };
 
 
+bool PAGING_GetPageEntries(const uint32_t lin_page, X86PageEntry& table,
+                           X86PageEntry& entry)
+{
+	table.set(phys_readd((paging.base.page << 12) + (lin_page >> 10) * 4));
+	if (!table.p) {
+		return false;
+	}
+	entry = table;
+	if (is_large_page(table)) {
+		entry.base = get_phys_page(table, entry, lin_page);
+	} else {
+		entry.set(phys_readd(get_entry_addr(table, lin_page)));
+	}
+	return true;
+}
+
 bool PAGING_MakePhysPage(Bitu & page) {
 	assert(page <= UINT32_MAX);
 	if (paging.enabled) {
-		uint32_t d_index=page >> 10;
-		uint32_t t_index=page & 0x3ff;
 		X86PageEntry table;
-		table.set(phys_readd((paging.base.page << 12) + d_index * 4));
-		if (!table.p) {
-			return false;
-		}
 		X86PageEntry entry;
-		entry.set(phys_readd((table.base << 12) + t_index * 4));
-		if (!entry.p) {
+		if (!PAGING_GetPageEntries(static_cast<uint32_t>(page), table, entry) ||
+		    !entry.p) {
 			return false;
 		}
 		page = entry.base;
@@ -743,6 +840,169 @@ bool PAGING_MakePhysPage(Bitu & page) {
 static InitPageHandler init_page_handler;
 static InitPageUserROHandler init_page_handler_userro;
 
+// Physical pages with cached descriptors. Linear pages mapped to them get no
+// host write pointer; their writes go through the write watch handler.
+constexpr size_t MaxWriteWatches = 64;
+
+static struct {
+	std::array<uint32_t, MaxWriteWatches> pages = {};
+	size_t num_pages = 0;
+} write_watches = {};
+
+static bool is_write_watched(const uint32_t phys_page)
+{
+	for (size_t i = 0; i < write_watches.num_pages; ++i) {
+		if (write_watches.pages[i] == phys_page) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Forwards the writes to the handler of the physical page, then invalidates
+// the descriptor cache
+class WriteWatchPageHandler final : public PageHandler {
+public:
+	WriteWatchPageHandler()
+	{
+		flags = PFLAG_NOCODE;
+	}
+	void writeb(PhysPt addr, uint8_t val) override
+	{
+		if (const auto host = GetHostPt(addr)) {
+			host_writeb(host, val);
+		} else {
+			GetHandler(addr)->writeb(addr, val);
+		}
+		descriptor_cache.Invalidate();
+	}
+	void writew(PhysPt addr, uint16_t val) override
+	{
+		if (const auto host = GetHostPt(addr)) {
+			host_writew(host, val);
+		} else {
+			GetHandler(addr)->writew(addr, val);
+		}
+		descriptor_cache.Invalidate();
+	}
+	void writed(PhysPt addr, uint32_t val) override
+	{
+		if (const auto host = GetHostPt(addr)) {
+			host_writed(host, val);
+		} else {
+			GetHandler(addr)->writed(addr, val);
+		}
+		descriptor_cache.Invalidate();
+	}
+	void writeq(PhysPt addr, uint64_t val) override
+	{
+		if (const auto host = GetHostPt(addr)) {
+			host_writeq(host, val);
+		} else {
+			GetHandler(addr)->writeq(addr, val);
+		}
+		descriptor_cache.Invalidate();
+	}
+	bool writeb_checked(PhysPt addr, uint8_t val) override
+	{
+		auto faulted = false;
+		if (const auto host = GetHostPt(addr)) {
+			host_writeb(host, val);
+		} else {
+			faulted = GetHandler(addr)->writeb_checked(addr, val);
+		}
+		descriptor_cache.Invalidate();
+		return faulted;
+	}
+	bool writew_checked(PhysPt addr, uint16_t val) override
+	{
+		auto faulted = false;
+		if (const auto host = GetHostPt(addr)) {
+			host_writew(host, val);
+		} else {
+			faulted = GetHandler(addr)->writew_checked(addr, val);
+		}
+		descriptor_cache.Invalidate();
+		return faulted;
+	}
+	bool writed_checked(PhysPt addr, uint32_t val) override
+	{
+		auto faulted = false;
+		if (const auto host = GetHostPt(addr)) {
+			host_writed(host, val);
+		} else {
+			faulted = GetHandler(addr)->writed_checked(addr, val);
+		}
+		descriptor_cache.Invalidate();
+		return faulted;
+	}
+	bool writeq_checked(PhysPt addr, uint64_t val) override
+	{
+		auto faulted = false;
+		if (const auto host = GetHostPt(addr)) {
+			host_writeq(host, val);
+		} else {
+			faulted = GetHandler(addr)->writeq_checked(addr, val);
+		}
+		descriptor_cache.Invalidate();
+		return faulted;
+	}
+
+private:
+	static PageHandler* GetHandler(const PhysPt addr)
+	{
+		return MEM_GetPageHandler(PAGING_GetPhysicalPage(addr) >> 12);
+	}
+
+	// Plain RAM is written directly; everything else, e.g. pages with
+	// translated code, goes through its own handler
+	static HostPt GetHostPt(const PhysPt addr)
+	{
+		const auto phys_page = PAGING_GetPhysicalPage(addr) >> 12;
+		const auto handler   = MEM_GetPageHandler(phys_page);
+		if (!(handler->flags & PFLAG_WRITEABLE)) {
+			return nullptr;
+		}
+		return handler->GetHostWritePt(phys_page) + (addr & 4095);
+	}
+};
+
+static WriteWatchPageHandler write_watch_handler;
+
+static PageHandler* get_write_watch_handler(const PhysPt lin_addr)
+{
+	if (write_watches.num_pages &&
+	    is_write_watched(PAGING_GetPhysicalPage(lin_addr) >> 12)) {
+		return &write_watch_handler;
+	}
+	return nullptr;
+}
+
+static void watch_linked_entries(const PagingLinks& links, const uint32_t phys_page);
+
+void PAGING_AddWriteWatch(const uint32_t phys_page)
+{
+	if (is_write_watched(phys_page)) {
+		return;
+	}
+	if (write_watches.num_pages == MaxWriteWatches) {
+		PAGING_ClearWriteWatches();
+	}
+	write_watches.pages[write_watches.num_pages++] = phys_page;
+
+	// Drop the host write pointers already linked to the page
+	watch_linked_entries(paging.links, phys_page);
+	watch_linked_entries(paging.global_links, phys_page);
+}
+
+void PAGING_ClearWriteWatches()
+{
+	// Pages still linked to the watch handler keep working, they just
+	// invalidate the cache needlessly until they're unlinked
+	write_watches.num_pages = 0;
+	descriptor_cache.Invalidate();
+}
+
 Bitu PAGING_GetDirBase()
 {
 	return paging.cr3;
@@ -771,22 +1031,41 @@ void PAGING_InitTLB()
 		paging.tlb.writehandler[i]=&init_page_handler;
 	}
 	paging.links.used=0;
+	paging.global_links.used=0;
 }
 
-void PAGING_ClearTLB()
+static void unlink_entries(PagingLinks& links)
 {
-	uint32_t * entries=&paging.links.entries[0];
-	for (;paging.links.used>0;paging.links.used--) {
+	uint32_t * entries=&links.entries[0];
+	for (;links.used>0;links.used--) {
 		const auto page=*entries++;
 		paging.tlb.read[page]=nullptr;
 		paging.tlb.write[page]=nullptr;
 		paging.tlb.readhandler[page]=&init_page_handler;
 		paging.tlb.writehandler[page]=&init_page_handler;
 	}
-	paging.links.used=0;
+	links.used=0;
+}
+
+// Routes the writes of the fully linked pages mapping the physical page
+// through the write watch handler. Read-only and unlinked pages take the
+// init handlers, which check for watched pages themselves.
+static void watch_linked_entries(const PagingLinks& links, const uint32_t phys_page)
+{
+	for (uint32_t i = 0; i < links.used; ++i) {
+		const auto page = links.entries[i];
+		if (paging.tlb.phys_page[page] != phys_page ||
+		    (paging.tlb.readhandler[page]->flags & PFLAG_INIT) ||
+		    paging.tlb.writehandler[page] != paging.tlb.readhandler[page]) {
+			continue;
+		}
+		paging.tlb.write[page]        = nullptr;
+		paging.tlb.writehandler[page] = &write_watch_handler;
+	}
 }
 
 void PAGING_UnlinkPages(Bitu lin_page,Bitu pages) {
+	descriptor_cache.Invalidate();
 	for (;pages>0;pages--) {
 		paging.tlb.read[lin_page]=nullptr;
 		paging.tlb.write[lin_page]=nullptr;
@@ -797,6 +1076,7 @@ void PAGING_UnlinkPages(Bitu lin_page,Bitu pages) {
 }
 
 void PAGING_MapPage(Bitu lin_page,Bitu phys_page) {
+	descriptor_cache.Invalidate();
 	if (lin_page<LINK_START) {
 		paging.firstmb[lin_page]=phys_page;
 		paging.tlb.read[lin_page]=nullptr;
@@ -808,16 +1088,18 @@ void PAGING_MapPage(Bitu lin_page,Bitu phys_page) {
 	}
 }
 
-void PAGING_LinkPage(uint32_t lin_page,uint32_t phys_page) {
+void PAGING_LinkPage(uint32_t lin_page, uint32_t phys_page, const bool global)
+{
 	const auto handler=MEM_GetPageHandler(phys_page);
 	const auto lin_base=lin_page << 12;
 	if (lin_page>=TLB_SIZE || phys_page>=TLB_SIZE) 
 		E_Exit("Illegal page");
 
-	if (paging.links.used >= PAGING_LINKS) {
+	auto& links = global ? paging.global_links : paging.links;
+	if (links.used >= PAGING_LINKS) {
 		LOG(LOG_PAGING,LOG_NORMAL)("Not enough paging links, resetting cache");
 		PAGING_ClearTLB();
-		assert(paging.links.used == 0);
+		assert(links.used == 0);
 	}
 
 	paging.tlb.phys_page[lin_page]=phys_page;
@@ -826,9 +1108,14 @@ void PAGING_LinkPage(uint32_t lin_page,uint32_t phys_page) {
 	if (handler->flags & PFLAG_WRITEABLE) paging.tlb.write[lin_page]=handler->GetHostWritePt(phys_page)-lin_base;
 	else paging.tlb.write[lin_page]=nullptr;
 
-	paging.links.entries[paging.links.used++]=lin_page;
+	links.entries[links.used++]=lin_page;
 	paging.tlb.readhandler[lin_page]=handler;
 	paging.tlb.writehandler[lin_page]=handler;
+
+	if (write_watches.num_pages && is_write_watched(phys_page)) {
+		paging.tlb.write[lin_page]=nullptr;
+		paging.tlb.writehandler[lin_page]=&write_watch_handler;
+	}
 }
 
 void PAGING_LinkPage_ReadOnly(uint32_t lin_page,uint32_t phys_page) {
@@ -874,12 +1161,13 @@ void PAGING_InitTLB()
 {
 	InitTLBInt(paging.tlbh);
 	paging.links.used=0;
+	paging.global_links.used=0;
 }
 
-void PAGING_ClearTLB()
+static void unlink_entries(PagingLinks& links)
 {
-	uint32_t* entries = &paging.links.entries[0];
-	for (;paging.links.used>0;paging.links.used--) {
+	uint32_t* entries = &links.entries[0];
+	for (;links.used>0;links.used--) {
 		Bitu page=*entries++;
 		tlb_entry *entry = get_tlb_entry(page<<12);
 		entry->read=0;
@@ -887,10 +1175,28 @@ void PAGING_ClearTLB()
 		entry->readhandler=&init_page_handler;
 		entry->writehandler=&init_page_handler;
 	}
-	paging.links.used=0;
+	links.used=0;
+}
+
+// Routes the writes of the fully linked pages mapping the physical page
+// through the write watch handler. Read-only and unlinked pages take the
+// init handlers, which check for watched pages themselves.
+static void watch_linked_entries(const PagingLinks& links, const uint32_t phys_page)
+{
+	for (uint32_t i = 0; i < links.used; ++i) {
+		const auto entry = get_tlb_entry(links.entries[i] << 12);
+		if (entry->phys_page != phys_page ||
+		    (entry->readhandler->flags & PFLAG_INIT) ||
+		    entry->writehandler != entry->readhandler) {
+			continue;
+		}
+		entry->write        = 0;
+		entry->writehandler = &write_watch_handler;
+	}
 }
 
 void PAGING_UnlinkPages(Bitu lin_page,Bitu pages) {
+	descriptor_cache.Invalidate();
 	for (;pages>0;pages--) {
 		tlb_entry *entry = get_tlb_entry(lin_page<<12);
 		entry->read=0;
@@ -902,6 +1208,7 @@ void PAGING_UnlinkPages(Bitu lin_page,Bitu pages) {
 }
 
 void PAGING_MapPage(Bitu lin_page,Bitu phys_page) {
+	descriptor_cache.Invalidate();
 	if (lin_page<LINK_START) {
 		paging.firstmb[lin_page]=phys_page;
 		paging.tlbh[lin_page].read=0;
@@ -913,14 +1220,15 @@ void PAGING_MapPage(Bitu lin_page,Bitu phys_page) {
 	}
 }
 
-void PAGING_LinkPage(uint32_t lin_page, uint32_t phys_page)
+void PAGING_LinkPage(uint32_t lin_page, uint32_t phys_page, const bool global)
 {
 	PageHandler* handler = MEM_GetPageHandler(phys_page);
 	Bitu lin_base=lin_page << 12;
 	if (lin_page>=(TLB_SIZE*(TLB_BANKS+1)) || phys_page>=(TLB_SIZE*(TLB_BANKS+1))) 
 		E_Exit("Illegal page");
 
-	if (paging.links.used>=PAGING_LINKS) {
+	auto& links = global ? paging.global_links : paging.links;
+	if (links.used>=PAGING_LINKS) {
 		LOG(LOG_PAGING,LOG_NORMAL)("Not enough paging links, resetting cache");
 		PAGING_ClearTLB();
 	}
@@ -932,9 +1240,14 @@ void PAGING_LinkPage(uint32_t lin_page, uint32_t phys_page)
 	if (handler->flags & PFLAG_WRITEABLE) entry->write=handler->GetHostWritePt(phys_page)-lin_base;
 	else entry->write=0;
 
- 	paging.links.entries[paging.links.used++]=lin_page;
+ 	links.entries[links.used++]=lin_page;
 	entry->readhandler=handler;
 	entry->writehandler=handler;
+
+	if (write_watches.num_pages && is_write_watched(phys_page)) {
+		entry->write=0;
+		entry->writehandler=&write_watch_handler;
+	}
 }
 
 void PAGING_LinkPage_ReadOnly(uint32_t lin_page, uint32_t phys_page)
@@ -962,6 +1275,16 @@ void PAGING_LinkPage_ReadOnly(uint32_t lin_page, uint32_t phys_page)
 
 #endif
 
+void PAGING_ClearTLB()
+{
+	unlink_entries(paging.links);
+	unlink_entries(paging.global_links);
+
+	++perf_counters.tlb_flushes;
+
+	// The cached descriptors are keyed by linear address
+	descriptor_cache.Invalidate();
+}
 
 void PAGING_SetDirBase(Bitu cr3) {
 	assert(cr3 <= UINT32_MAX);
@@ -971,6 +1294,30 @@ void PAGING_SetDirBase(Bitu cr3) {
 	paging.base.addr=static_cast<PhysPt>(cr3 & ~4095);
 //	LOG(LOG_PAGING,LOG_NORMAL)("CR3:%X Base %X",cr3,paging.base.page);
 	if (paging.enabled) {
+		// Global pages survive the address space switch
+		if (paging.cr4 & CR4_PGE) {
+			unlink_entries(paging.links);
+			++perf_counters.tlb_flushes;
+			descriptor_cache.Invalidate();
+		} else {
+			PAGING_ClearTLB();
+		}
+	}
+}
+
+uint32_t PAGING_GetCR4()
+{
+	return paging.cr4;
+}
+
+void PAGING_SetCR4(const uint32_t cr4)
+{
+	const auto changed = (paging.cr4 ^ cr4) & (CR4_PSE | CR4_PGE);
+	paging.cr4         = cr4;
+
+	// Toggling the paging extensions flushes the whole TLB, global pages
+	// included
+	if (changed) {
 		PAGING_ClearTLB();
 	}
 }
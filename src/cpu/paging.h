@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "hardware/memory.h"
+#include "misc/perf_counters.h"
 
 // disable this to reduce the size of the TLB
 // NOTE: does not work with the dynamic core (dynrec is fine)
@@ -35,6 +36,7 @@ class PageDirectory;
 #define PFLAG_NOCODE		0x10			//No dynamic code can be generated here
 #define PFLAG_INIT			0x20			//No dynamic code can be generated here
 #define PFLAG_HASCODE16		0x40			//Page contains 16-bit dynamic code
+#define PFLAG_BLOCKWRITE	0x80			//Handler has a faster writeblock()
 #define PFLAG_HASCODE		(PFLAG_HASCODE32|PFLAG_HASCODE16)
 
 #define LINK_START	((1024+64)/4)			//Start right after the HMA
@@ -54,6 +56,14 @@ public:
 	virtual void writew(PhysPt addr, uint16_t val);
 	virtual void writed(PhysPt addr, uint32_t val);
 	virtual void writeq(PhysPt addr, uint64_t val);
+
+	// Writes 'num_bytes' from 'data' to the page starting at 'addr', the
+	// same as that many writes of 'access_size' (1, 2, or 4) bytes would.
+	// The block stays within the page. Handlers with PFLAG_BLOCKWRITE
+	// override it with something faster than the individual writes.
+	virtual void writeblock(PhysPt addr, const uint8_t* data, Bitu num_bytes,
+	                        Bitu access_size);
+
 	virtual HostPt GetHostReadPt(Bitu phys_page);
 	virtual HostPt GetHostWritePt(Bitu phys_page);
 	virtual bool readb_checked(PhysPt addr,uint8_t * val);
@@ -74,10 +84,13 @@ bool PAGING_Enabled();
 
 Bitu PAGING_GetDirBase();
 void PAGING_SetDirBase(Bitu cr3);
+uint32_t PAGING_GetCR4();
+void PAGING_SetCR4(const uint32_t cr4);
 void PAGING_InitTLB();
 void PAGING_ClearTLB();
 
-void PAGING_LinkPage(uint32_t lin_page,uint32_t phys_page);
+// Global pages stay linked when CR3 is reloaded (only with CR4.PGE set)
+void PAGING_LinkPage(uint32_t lin_page, uint32_t phys_page, const bool global = false);
 void PAGING_LinkPage_ReadOnly(uint32_t lin_page,uint32_t phys_page);
 void PAGING_UnlinkPages(Bitu lin_page,Bitu pages);
 /* This maps the page directly, only use when paging is disabled */
@@ -85,6 +98,11 @@ void PAGING_MapPage(Bitu lin_page,Bitu phys_page);
 bool PAGING_MakePhysPage(Bitu & page);
 bool PAGING_ForcePageInit(Bitu lin_addr);
 
+// Routes all writes to the physical page through a handler that invalidates
+// the descriptor cache
+void PAGING_AddWriteWatch(const uint32_t phys_page);
+void PAGING_ClearWriteWatches();
+
 void MEM_SetLFB(Bitu page, Bitu pages, PageHandler *handler, PageHandler *mmiohandler);
 void MEM_SetPageHandler(Bitu phys_page, Bitu pages, PageHandler * handler);
 void MEM_ResetPageHandler(Bitu phys_page, Bitu pages);
@@ -177,6 +195,14 @@ struct X86PageEntry {
 	}
 };
 
+// Reads the page directory and page table entries mapping the linear page,
+// without setting their accessed bits or raising a page fault. A 4 MiB page
+// has no page table, so both come from the directory entry, with the entry's
+// base pointing at the linear page's frame within the large page. Returns
+// false if the directory entry isn't present.
+bool PAGING_GetPageEntries(const uint32_t lin_page, X86PageEntry& table,
+                           X86PageEntry& entry);
+
 #if !defined(USE_FULL_TLB)
 typedef struct {
 	HostPt read  = {};
@@ -189,7 +215,13 @@ typedef struct {
 } tlb_entry = {};
 #endif
 
+struct PagingLinks {
+	uint32_t used = 0;
+	std::vector<uint32_t> entries = std::vector<uint32_t>(PAGING_LINKS);
+};
+
 struct PagingBlock {
+	uint32_t cr4 = 0;
 	uint32_t cr3 = 0;
 	uint32_t cr2 = 0;
 	struct {
@@ -210,10 +242,10 @@ struct PagingBlock {
 	std::vector<tlb_entry> tlbh        = std::vector<tlb_entry>(TLB_SIZE);
 	std::vector<tlb_entry*> tlbh_banks = std::vector<tlb_entry*>(TLB_BANKS);
 #endif
-	struct {
-		uint32_t used = 0;
-		std::vector<uint32_t> entries = std::vector<uint32_t>(PAGING_LINKS);
-	} links = {};
+	PagingLinks links = {};
+
+	// Linked global pages, kept separately so CR3 writes can skip them
+	PagingLinks global_links = {};
 
 	std::vector<uint32_t> firstmb = std::vector<uint32_t>(LINK_START);
 	bool enabled = false;
@@ -328,6 +360,19 @@ static inline PhysPt PAGING_GetPhysicalAddress(PhysPt linAddr) {
 }
 #endif // USE_FULL_TLB
 
+// Page handler lookups for accesses that missed the host pointer fast path;
+// these are counted for PERFSTAT
+static inline PageHandler* get_slow_path_readhandler(PhysPt address)
+{
+	++perf_counters.page_handler_calls;
+	return get_tlb_readhandler(address);
+}
+static inline PageHandler* get_slow_path_writehandler(PhysPt address)
+{
+	++perf_counters.page_handler_calls;
+	return get_tlb_writehandler(address);
+}
+
 template <MemOpMode op_mode = MemOpMode::WithBreakpoints>
 static inline uint8_t mem_readb_inline(const PhysPt address)
 {
@@ -338,7 +383,7 @@ static inline uint8_t mem_readb_inline(const PhysPt address)
 	if (tlb_addr) {
 		return host_readb(tlb_addr + address);
 	} else {
-		return (get_tlb_readhandler(address))->readb(address);
+		return (get_slow_path_readhandler(address))->readb(address);
 	}
 }
 
@@ -353,7 +398,7 @@ static inline uint16_t mem_readw_inline(const PhysPt address)
 		if (tlb_addr) {
 			return host_readw(tlb_addr + address);
 		} else {
-			return (get_tlb_readhandler(address))->readw(address);
+			return (get_slow_path_readhandler(address))->readw(address);
 		}
 	} else {
 		return mem_unalignedreadw(address);
@@ -371,7 +416,7 @@ static inline uint32_t mem_readd_inline(const PhysPt address)
 		if (tlb_addr)
 			return host_readd(tlb_addr + address);
 		else
-			return get_tlb_readhandler(address)->readd(address);
+			return get_slow_path_readhandler(address)->readd(address);
 	} else {
 		return mem_unalignedreadd(address);
 	}
@@ -388,7 +433,7 @@ static inline uint64_t mem_readq_inline(PhysPt address)
 		if (tlb_addr) {
 			return host_readq(tlb_addr + address);
 		} else {
-			return get_tlb_readhandler(address)->readq(address);
+			return get_slow_path_readhandler(address)->readq(address);
 		}
 	} else {
 		return mem_unalignedreadq(address);
@@ -399,14 +444,14 @@ static inline void mem_writeb_inline(PhysPt address, uint8_t val)
 {
 	HostPt tlb_addr = get_tlb_write(address);
 	if (tlb_addr) host_writeb(tlb_addr+address,val);
-	else (get_tlb_writehandler(address))->writeb(address,val);
+	else (get_slow_path_writehandler(address))->writeb(address,val);
 }
 
 static inline void mem_writew_inline(PhysPt address,uint16_t val) {
 	if ((address & 0xfff)<0xfff) {
 		HostPt tlb_addr=get_tlb_write(address);
 		if (tlb_addr) host_writew(tlb_addr+address,val);
-		else (get_tlb_writehandler(address))->writew(address,val);
+		else (get_slow_path_writehandler(address))->writew(address,val);
 	} else mem_unalignedwritew(address,val);
 }
 
@@ -414,7 +459,7 @@ static inline void mem_writed_inline(PhysPt address,uint32_t val) {
 	if ((address & 0xfff)<0xffd) {
 		HostPt tlb_addr=get_tlb_write(address);
 		if (tlb_addr) host_writed(tlb_addr+address,val);
-		else (get_tlb_writehandler(address))->writed(address,val);
+		else (get_slow_path_writehandler(address))->writed(address,val);
 	} else mem_unalignedwrited(address,val);
 }
 
@@ -425,7 +470,7 @@ static inline void mem_writeq_inline(PhysPt address, uint64_t val)
 		if (tlb_addr) {
 			host_writeq(tlb_addr + address, val);
 		} else {
-			(get_tlb_writehandler(address))->writeq(address, val);
+			(get_slow_path_writehandler(address))->writeq(address, val);
 		}
 	} else {
 		mem_unalignedwriteq(address, val);
@@ -437,7 +482,7 @@ static inline bool mem_readb_checked(PhysPt address, uint8_t * val) {
 	if (tlb_addr) {
 		*val=host_readb(tlb_addr+address);
 		return false;
-	} else return (get_tlb_readhandler(address))->readb_checked(address, val);
+	} else return (get_slow_path_readhandler(address))->readb_checked(address, val);
 }
 
 static inline bool mem_readw_checked(PhysPt address, uint16_t * val) {
@@ -446,7 +491,7 @@ static inline bool mem_readw_checked(PhysPt address, uint16_t * val) {
 		if (tlb_addr) {
 			*val=host_readw(tlb_addr+address);
 			return false;
-		} else return (get_tlb_readhandler(address))->readw_checked(address, val);
+		} else return (get_slow_path_readhandler(address))->readw_checked(address, val);
 	} else return mem_unalignedreadw_checked(address, val);
 }
 
@@ -456,7 +501,7 @@ static inline bool mem_readd_checked(PhysPt address, uint32_t * val) {
 		if (tlb_addr) {
 			*val=host_readd(tlb_addr+address);
 			return false;
-		} else return (get_tlb_readhandler(address))->readd_checked(address, val);
+		} else return (get_slow_path_readhandler(address))->readd_checked(address, val);
 	} else return mem_unalignedreadd_checked(address, val);
 }
 
@@ -468,7 +513,7 @@ static inline bool mem_readq_checked(PhysPt address, uint64_t* val)
 			*val = host_readq(tlb_addr + address);
 			return false;
 		} else {
-			return (get_tlb_readhandler(address))->readq_checked(address, val);
+			return (get_slow_path_readhandler(address))->readq_checked(address, val);
 		}
 	} else {
 		return mem_unalignedreadq_checked(address, val);
@@ -481,7 +526,7 @@ static inline bool mem_writeb_checked(PhysPt address, uint8_t val)
 	if (tlb_addr) {
 		host_writeb(tlb_addr+address,val);
 		return false;
-	} else return (get_tlb_writehandler(address))->writeb_checked(address,val);
+	} else return (get_slow_path_writehandler(address))->writeb_checked(address,val);
 }
 
 static inline bool mem_writew_checked(PhysPt address,uint16_t val) {
@@ -490,7 +535,7 @@ static inline bool mem_writew_checked(PhysPt address,uint16_t val) {
 		if (tlb_addr) {
 			host_writew(tlb_addr+address,val);
 			return false;
-		} else return (get_tlb_writehandler(address))->writew_checked(address,val);
+		} else return (get_slow_path_writehandler(address))->writew_checked(address,val);
 	} else return mem_unalignedwritew_checked(address,val);
 }
 
@@ -500,7 +545,7 @@ static inline bool mem_writed_checked(PhysPt address,uint32_t val) {
 		if (tlb_addr) {
 			host_writed(tlb_addr+address,val);
 			return false;
-		} else return (get_tlb_writehandler(address))->writed_checked(address,val);
+		} else return (get_slow_path_writehandler(address))->writed_checked(address,val);
 	} else return mem_unalignedwrited_checked(address,val);
 }
 
@@ -512,7 +557,7 @@ static inline bool mem_writeq_checked(PhysPt address, uint64_t val)
 			host_writeq(tlb_addr + address, val);
 			return false;
 		} else {
-			return (get_tlb_writehandler(address))->writeq_checked(address, val);
+			return (get_slow_path_writehandler(address))->writeq_checked(address, val);
 		}
 	} else {
 		return mem_unalignedwriteq_checked(address, val);
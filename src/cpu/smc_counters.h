@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_SMC_COUNTERS_H
+#define DOSBOX_SMC_COUNTERS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+// Self-modifying code tracking for the code pages of the dynamic cores
+//
+// Every code page counts the writes to each of its bytes that hit translated
+// code. Instructions starting at a byte that has been written at least
+// SmcFallbackThreshold times are run by the normal core instead of being
+// translated again. The counters are halved every SmcDecayIntervalMs of
+// emulated time, so code that was patched during a setup phase, or that
+// is only patched occasionally, gets translated again once the writes stop.
+
+constexpr uint8_t SmcFallbackThreshold = 4;
+constexpr uint32_t SmcDecayIntervalMs  = 10;
+
+// More intervals would clear all counters anyway
+constexpr uint32_t SmcMaxDecaySteps = 8;
+
+// Counts a write of num_bytes starting at index; the counters saturate
+// instead of wrapping around
+inline void smc_count_write(uint8_t* counters, const size_t index,
+                            const size_t num_bytes)
+{
+	for (size_t i = index; i < index + num_bytes; ++i) {
+		if (counters[i] < UINT8_MAX) {
+			++counters[i];
+		}
+	}
+}
+
+inline bool smc_is_hot(const uint8_t* counters, const size_t index)
+{
+	return counters && counters[index] >= SmcFallbackThreshold;
+}
+
+// Halves the counters once for every full decay interval that has passed
+// since last_decay_ms. The on_cooled_down(index) callback is invoked for
+// every counter that drops below the fallback threshold.
+template <typename Callback>
+void smc_decay(uint8_t* counters, const size_t num_counters,
+               uint32_t& last_decay_ms, const uint32_t now_ms,
+               Callback&& on_cooled_down)
+{
+	const auto elapsed_ms = now_ms - last_decay_ms;
+	if (elapsed_ms < SmcDecayIntervalMs) {
+		return;
+	}
+	const auto num_steps = std::min(elapsed_ms / SmcDecayIntervalMs,
+	                                SmcMaxDecaySteps);
+
+	// Keep the remainder so the decay rate doesn't depend on how often
+	// we're called
+	last_decay_ms = now_ms - (elapsed_ms % SmcDecayIntervalMs);
+
+	for (size_t i = 0; i < num_counters; ++i) {
+		const auto count = counters[i];
+		if (!count) {
+			continue;
+		}
+		counters[i] = static_cast<uint8_t>(count >> num_steps);
+
+		if (count >= SmcFallbackThreshold &&
+		    counters[i] < SmcFallbackThreshold) {
+			on_cooled_down(i);
+		}
+	}
+}
+
+#endif // DOSBOX_SMC_COUNTERS_H
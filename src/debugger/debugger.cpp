@@ -2122,15 +2122,10 @@ void LogPages(char* selname) {
 	if (paging.enabled) {
 		Bitu sel = GetHexValue(selname,selname);
 		if ((sel==0x00) && ((*selname==0) || (*selname=='*'))) {
-			for (int i=0; i<0xfffff; i++) {
-				Bitu table_addr=(paging.base.page<<12)+(i >> 10)*4;
+			for (uint32_t i = 0; i < 0xfffff; i++) {
 				X86PageEntry table;
-				table.set(phys_readd(table_addr));
-				if (table.p) {
-					X86PageEntry entry;
-					Bitu entry_addr = (table.base << 12) +
-					                  (i & 0x3ff) * 4;
-					entry.set(phys_readd(entry_addr));
+				X86PageEntry entry;
+				if (PAGING_GetPageEntries(i, table, entry)) {
 					if (entry.p) {
 						sprintf(out1,
 						        "page %05Xxxx -> %04Xxxx  flags [uw] %x:%x::%x:%x [d=%x|a=%x]",
@@ -2148,14 +2143,11 @@ void LogPages(char* selname) {
 				}
 			}
 		} else {
-			Bitu table_addr=(paging.base.page<<12)+(sel >> 10)*4;
 			X86PageEntry table;
-			table.set(phys_readd(table_addr));
-			if (table.p) {
-				X86PageEntry entry;
-				Bitu entry_addr = (table.base << 12) +
-				                  (sel & 0x3ff) * 4;
-				entry.set(phys_readd(entry_addr));
+			X86PageEntry entry;
+			if (PAGING_GetPageEntries(static_cast<uint32_t>(sel & 0xfffff),
+			                          table,
+			                          entry)) {
 				sprintf(out1,
 				        "page %05" sBitfs(X) "xxx -> %04Xxxx  flags [puw] %x:%x::%x:%x::%x:%x",
 				        sel,
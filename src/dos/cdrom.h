@@ -7,13 +7,16 @@
 
 #include "dosbox.h"
 
+#include <condition_variable>
 #include <cstring>
 #include <fstream>
 #include <iostream>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "audio/mixer.h"
@@ -205,6 +208,18 @@ private:
 		virtual uint8_t getChannels()               = 0;
 		virtual int getLength()                     = 0;
 		virtual void setAudioPosition(uint32_t pos) = 0;
+
+		// Hints that playback is likely to start at the given offset,
+		// such as at the start of a track
+		virtual void addSeekTarget([[maybe_unused]] const uint32_t offset) {}
+
+		// True if decode() returned short because the audio isn't
+		// decoded yet, rather than because the track has ended
+		virtual bool isDecodingBehind()
+		{
+			return false;
+		}
+
 		const uint16_t chunkSize                    = 0;
 	};
 
@@ -240,6 +255,11 @@ private:
 
 	private:
 		std::ifstream* file;
+
+		// Plain image files are mapped into memory where possible, so
+		// sector reads are just copies from the host's page cache
+		const uint8_t* mapped_data = nullptr;
+		size_t mapped_size         = 0;
 	};
 
 	class AudioFile final : public TrackFile {
@@ -265,8 +285,58 @@ private:
 		// areas of this class.
 		void setAudioPosition([[maybe_unused]] uint32_t pos) override {}
 
+		void addSeekTarget(const uint32_t offset) override;
+		bool isDecodingBehind() override;
+
 	private:
+		// Decoded audio from a likely seek target, which lets playback
+		// start immediately while the decoder seeks past it
+		struct Preroll {
+			std::vector<int16_t> samples = {};
+			uint64_t start_frame         = 0;
+			uint32_t end_ms              = 0;
+			bool reaches_end             = false;
+		};
+
+		void StartDecoder();
+		void StopDecoder();
+		void DecodeAheadLoop();
+		void RequestDecoderSeek(const uint32_t pos_in_ms);
+		bool WaitForDecoderSeek();
+		bool IsDecoderDone();
+		uint32_t TakeFrames(uint8_t* buffer, const uint32_t num_frames,
+		                    const bool wait);
+
+		void PushFrames(const int16_t* samples, const uint32_t num_frames);
+		void PopFrames(uint8_t* buffer, const uint32_t num_frames);
+
 		Sound_Sample* sample = nullptr;
+
+		// Cached, as the decoder thread updates the sample's flags
+		bool can_seek = false;
+
+		std::vector<Preroll> prerolls = {};
+
+		// The decoder thread keeps a ring buffer of decoded audio ahead
+		// of the playback position. The sample is only accessed by the
+		// decoder thread once it's running.
+		std::thread decoder_thread           = {};
+		std::mutex decoder_mutex             = {};
+		std::condition_variable decoder_cond = {};
+
+		std::vector<int16_t> ring = {};
+		size_t ring_head          = 0; // in frames
+		size_t ring_frames        = 0;
+		uint64_t ring_start_frame = 0; // track frame at the ring's head
+
+		// Bumped whenever the ring buffer is reset by a seek
+		uint32_t decoder_generation = 0;
+
+		uint32_t seek_ms    = 0;
+		bool seek_pending   = false;
+		bool decoder_eof    = false;
+		bool decoder_error  = false;
+		bool decoder_exit   = false;
 	};
 
 public:
@@ -346,6 +416,8 @@ private:
 	                 const uint16_t sectorSize,
 	                 const bool mode2);
 	std::vector<Track>::iterator GetTrack(const uint32_t sector);
+	uint32_t ReadTrackSectors(uint8_t* buffer, const bool raw,
+	                          const uint32_t sector, const uint32_t num);
 	void CDAudioCallback(const int desired_track_frames);
 	void PlayNextAudioTrack();
 	bool PlayAudioTrack(const Track& track, const uint32_t sector_offset);
@@ -364,6 +436,7 @@ private:
 	// member variables
 	std::vector<Track>   tracks;
 	std::vector<uint8_t> readBuffer;
+	std::vector<uint8_t> rawSectorBuffer;
 	std::string          mcn;
 	size_t               currentTrackIndex = 0;
 	static int           refCount;
@@ -6,6 +6,7 @@
 
 #include "cdrom.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cctype>
 #include <chrono>
@@ -24,8 +25,17 @@
 #include <cstring>
 #endif
 
+#if defined(HAVE_MMAP)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "audio/channel_names.h"
+#include "decoders/mp3_seek_table.h"
 #include "dos/drives.h"
+#include "misc/cross.h"
 #include "utils/fs_utils.h"
 #include "utils/math_utils.h"
 #include "config/setup.h"
@@ -87,10 +97,35 @@ CDROM_Interface_Image::BinaryFile::BinaryFile(const char *filename, bool &error)
 	file = new std::ifstream(filename, std::ios::in | std::ios::binary);
 	// If new fails, an exception is generated and scope leaves this constructor
 	error = file->fail();
+
+#if defined(HAVE_MMAP)
+	// Fall back to the stream if the file can't be mapped
+	const int fd = error ? -1 : open(filename, O_RDONLY);
+	if (fd >= 0) {
+		struct stat file_stat = {};
+		if (fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode) &&
+		    file_stat.st_size > 0) {
+			const auto size = static_cast<size_t>(file_stat.st_size);
+			void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (data != MAP_FAILED) {
+				mapped_data = static_cast<const uint8_t*>(data);
+				mapped_size = size;
+			}
+		}
+		close(fd);
+	}
+#endif
 }
 
 CDROM_Interface_Image::BinaryFile::~BinaryFile()
 {
+#if defined(HAVE_MMAP)
+	if (mapped_data) {
+		munmap(const_cast<uint8_t*>(mapped_data), mapped_size);
+		mapped_data = nullptr;
+	}
+#endif
+
 	// Guard: only cleanup if needed
 	if (file == nullptr)
 		return;
@@ -112,6 +147,15 @@ bool CDROM_Interface_Image::BinaryFile::read(uint8_t *buffer,
 	if (adjusted_bytes == 0) // no work to do!
 		return true;
 
+	if (mapped_data) {
+		if (!offsetInsideTrack(offset) ||
+		    static_cast<size_t>(offset) + adjusted_bytes > mapped_size) {
+			return false;
+		}
+		memcpy(buffer, mapped_data + offset, adjusted_bytes);
+		return true;
+	}
+
 	// Reposition if needed
 	if (!seek(offset))
 		return false;
@@ -122,6 +166,11 @@ bool CDROM_Interface_Image::BinaryFile::read(uint8_t *buffer,
 
 int CDROM_Interface_Image::BinaryFile::getLength()
 {
+	if (length_redbook_bytes < 0 && mapped_data) {
+		assert(mapped_size <= MAX_REDBOOK_BYTES);
+		length_redbook_bytes = static_cast<int>(mapped_size);
+	}
+
 	// Return our cached result if we've already been asked before
 	if (length_redbook_bytes < 0 && file) {
 		file->seekg(0, std::ios::end);
@@ -182,18 +231,30 @@ uint32_t CDROM_Interface_Image::BinaryFile::decode(int16_t *buffer,
 	assertm(audio_pos < MAX_REDBOOK_BYTES,
 	        "Tried to decode audio before the playback position was set");
 
-	// Reposition against our last audio position if needed
-	if (static_cast<uint32_t>(file->tellg()) != audio_pos)
-		if (!seek(audio_pos))
-			return 0;
+	const uint32_t desired_bytes = desired_track_frames * BYTES_PER_REDBOOK_PCM_FRAME;
 
-	file->read((char*)buffer, desired_track_frames * BYTES_PER_REDBOOK_PCM_FRAME);
-	/**
-	 *  Note: gcount returns a signed type, but according to specification:
-	 *  "Except in the constructors of std::strstreambuf, negative values of
-	 *  std::streamsize are never used."; so we store it as unsigned.
-	 */
-	const uint32_t bytes_read = static_cast<uint32_t>(file->gcount());
+	uint32_t bytes_read = 0;
+	if (mapped_data) {
+		if (audio_pos < mapped_size) {
+			bytes_read = static_cast<uint32_t>(
+			        std::min(static_cast<size_t>(desired_bytes),
+			                 mapped_size - audio_pos));
+			memcpy(buffer, mapped_data + audio_pos, bytes_read);
+		}
+	} else {
+		// Reposition against our last audio position if needed
+		if (static_cast<uint32_t>(file->tellg()) != audio_pos)
+			if (!seek(audio_pos))
+				return 0;
+
+		file->read((char*)buffer, desired_bytes);
+		/**
+		 *  Note: gcount returns a signed type, but according to specification:
+		 *  "Except in the constructors of std::strstreambuf, negative values of
+		 *  std::streamsize are never used."; so we store it as unsigned.
+		 */
+		bytes_read = static_cast<uint32_t>(file->gcount());
+	}
 
 	// decoding is an audio-task, so update our audio position
 	audio_pos += bytes_read;
@@ -210,7 +271,8 @@ CDROM_Interface_Image::AudioFile::AudioFile(const char *filename, bool &error)
 	sample = Sound_NewSampleFromFile(filename, &desired);
 	const std::string filename_only = get_basename(filename);
 	if (sample) {
-		error = false;
+		error    = false;
+		can_seek = (sample->flags & SOUND_SAMPLEFLAG_CANSEEK);
 		LOG_MSG("CDROM: Loaded %s [%d Hz, %d-channel, %2.1f minutes]",
 		        filename_only.c_str(), getRate(), getChannels(),
 		        getLength() / static_cast<double>(REDBOOK_PCM_BYTES_PER_MIN));
@@ -222,6 +284,8 @@ CDROM_Interface_Image::AudioFile::AudioFile(const char *filename, bool &error)
 
 CDROM_Interface_Image::AudioFile::~AudioFile()
 {
+	StopDecoder();
+
 	// Guard to prevent double-free or nullptr free
 	if (sample == nullptr)
 		return;
@@ -230,6 +294,24 @@ CDROM_Interface_Image::AudioFile::~AudioFile()
 	sample = nullptr;
 }
 
+// Decode-ahead tuning for codec-based tracks
+constexpr uint32_t DecodeAheadMs     = 2000; // ring buffer length
+constexpr uint32_t DecodeChunkFrames = 2048;
+constexpr uint32_t PrerollMs         = 1000;
+
+// Converts a Redbook CD-DA byte offset to a time offset, in milliseconds
+static uint32_t redbook_offset_to_ms(const uint32_t offset)
+{
+	const uint32_t ms_per_s = 1000;
+	const uint32_t pos_in_frames = ceil_udivide(offset, BYTES_PER_RAW_REDBOOK_FRAME);
+	return ceil_udivide(pos_in_frames * ms_per_s, REDBOOK_FRAMES_PER_SECOND);
+}
+
+static uint64_t ms_to_track_frame(const uint32_t ms, const uint32_t rate)
+{
+	return static_cast<uint64_t>(ms) * rate / 1000;
+}
+
 /**
  *  Seek takes in a Redbook CD-DA byte offset relative to the track's start
  *  time and returns true if the seek succeeded.
@@ -241,6 +323,10 @@ CDROM_Interface_Image::AudioFile::~AudioFile()
  *  within the track, regardless of the track's sampling rate, bit-depth,
  *  or number of channels.  To do this, we convert the byte offset to a
  *  time-offset, and use the Sound_Seek() function to move the read position.
+ *
+ *  Codec seeks can take hundreds of milliseconds, so they're performed by the
+ *  decoder thread. Seeks that land in the already decoded audio or in one of
+ *  the pre-decoded seek targets don't need the codec at all.
  */
 bool CDROM_Interface_Image::AudioFile::seek(const uint32_t requested_pos)
 {
@@ -248,7 +334,7 @@ bool CDROM_Interface_Image::AudioFile::seek(const uint32_t requested_pos)
 	assertm(sample, "Audio sample needs to be valid, but is the nullptr");
 	assertm(requested_pos <= MAX_REDBOOK_BYTES, "Requested offset exceeds CDROM size");
 
-	if (!offsetInsideTrack(requested_pos))
+	if (!offsetInsideTrack(requested_pos) || !can_seek)
 		return false;
 
 	if (audio_pos == requested_pos) {
@@ -258,48 +344,62 @@ bool CDROM_Interface_Image::AudioFile::seek(const uint32_t requested_pos)
 		return true;
 	}
 
-	// Convert the position from a byte offset to time offset, in milliseconds.
-	const uint32_t ms_per_s = 1000;
-	const uint32_t pos_in_frames = ceil_udivide(requested_pos, BYTES_PER_RAW_REDBOOK_FRAME);
-	const uint32_t pos_in_ms = ceil_udivide(pos_in_frames * ms_per_s, REDBOOK_FRAMES_PER_SECOND);
-
-#ifdef DEBUG
-	/**
-	 *  In DEBUG mode, we additionally measure the seek latency, which can
-	 *  be an issue for some codecs. 
-	 */
-	using namespace std::chrono;
-	using clock = std::chrono::steady_clock;
-	clock::time_point begin = clock::now(); // start the timer
-#endif
-
-	// Perform the seek and update our position
-	const bool result = Sound_Seek(sample, pos_in_ms);
-	audio_pos = result ? requested_pos : std::numeric_limits<uint32_t>::max();
+	const uint32_t pos_in_ms = redbook_offset_to_ms(requested_pos);
+	const uint64_t target_frame = ms_to_track_frame(pos_in_ms, getRate());
 
-#ifdef DEBUG
-	clock::time_point end = clock::now(); // stop the timer
-	const int32_t elapsed_ms = static_cast<int32_t>
-	    (duration_cast<milliseconds>(end - begin).count());
+	StartDecoder();
+	{
+		std::lock_guard lock(decoder_mutex);
 
-	// Report general seek diagnostics
-	const double pos_in_min = static_cast<double>(pos_in_ms) / 60000.0;
-	LOG_MSG("CDROM: seeked to byte %u (frame %u at %.2f min), and took %u ms",
-	        requested_pos, pos_in_frames, pos_in_min, elapsed_ms);
+		const auto ring_capacity = ring.size() / getChannels();
 
-	/**
-	 *  Inform the user if the seek took longer than that of a physical
-	 *  CDROM drive, which might have caused in-game symptoms like pauses
-	 *  or stuttering.
-	 */
-	const int32_t average_cdrom_seek_ms = 200;
-	if (elapsed_ms > average_cdrom_seek_ms)
-		LOG_MSG("CDROM: seek took %d ms, which is slower than an average "
-		        "physical CDROM drive's seek time of %d ms.",
-		        elapsed_ms, average_cdrom_seek_ms);
-#endif
+		if (target_frame >= ring_start_frame &&
+		    target_frame < ring_start_frame + ring_frames) {
+			// The target has already been decoded, drop what's before it
+			const auto num_frames = static_cast<size_t>(target_frame -
+			                                            ring_start_frame);
+			ring_head = (ring_head + num_frames) % ring_capacity;
+			ring_frames -= num_frames;
+			ring_start_frame = target_frame;
+		} else {
+			ring_head        = 0;
+			ring_frames      = 0;
+			ring_start_frame = target_frame;
+			decoder_eof      = false;
+			decoder_error    = false;
+
+			// Whatever the decoder thread is working on is stale now
+			++decoder_generation;
+
+			const auto preroll = std::find_if(
+			        prerolls.begin(), prerolls.end(), [&](const Preroll& p) {
+				        const auto num_frames = p.samples.size() / getChannels();
+				        return target_frame >= p.start_frame &&
+				               target_frame < p.start_frame + num_frames;
+			        });
+
+			if (preroll != prerolls.end()) {
+				const auto offset = static_cast<size_t>(
+				        target_frame - preroll->start_frame);
+				const auto num_frames = preroll->samples.size() / getChannels() - offset;
+				PushFrames(preroll->samples.data() + offset * getChannels(),
+				           check_cast<uint32_t>(num_frames));
+
+				if (preroll->reaches_end) {
+					decoder_eof  = true;
+					seek_pending = false;
+				} else {
+					RequestDecoderSeek(preroll->end_ms);
+				}
+			} else {
+				RequestDecoderSeek(pos_in_ms);
+			}
+		}
+	}
+	decoder_cond.notify_all();
 
-	return result;
+	audio_pos = requested_pos;
+	return true;
 }
 
 bool CDROM_Interface_Image::AudioFile::read(uint8_t *buffer,
@@ -331,7 +431,8 @@ bool CDROM_Interface_Image::AudioFile::read(uint8_t *buffer,
 		return false; // we always correctly return false to the application in this case.
 	}
 
-	if (!seek(requested_pos))
+	// Unlike playback, DAE has to wait for the decoder to get there
+	if (!seek(requested_pos) || !WaitForDecoderSeek())
 		return false;
 
 	const uint32_t adjusted_bytes = adjustOverRead(requested_pos, requested_bytes);
@@ -344,17 +445,9 @@ bool CDROM_Interface_Image::AudioFile::read(uint8_t *buffer,
 	const uint32_t requested_frames = ceil_udivide(adjusted_bytes,
 	                                               BYTES_PER_REDBOOK_PCM_FRAME);
 
-	uint32_t decoded_bytes = 0;
-	uint32_t decoded_frames = 0;
-	while (decoded_frames < requested_frames) {
-		const uint32_t decoded = Sound_Decode_Direct(sample,
-		                                             buffer + decoded_bytes,
-		                                             requested_frames - decoded_frames);
-		if (sample->flags & (SOUND_SAMPLEFLAG_ERROR | SOUND_SAMPLEFLAG_EOF) || !decoded)
-			break;
-		decoded_frames += decoded;
-		decoded_bytes = decoded_frames * bytes_per_frame;
-	}
+	const uint32_t decoded_frames = TakeFrames(buffer, requested_frames, true);
+	uint32_t decoded_bytes = decoded_frames * bytes_per_frame;
+
 	// Zero out any remainining frames that we didn't fill
 	if (decoded_frames < requested_frames)
 		memset(buffer + decoded_bytes, 0, adjusted_bytes - decoded_bytes);
@@ -405,7 +498,9 @@ bool CDROM_Interface_Image::AudioFile::read(uint8_t *buffer,
 	}
 	// reading DAE is an audio-task, so update our audio position
 	audio_pos += decoded_bytes;
-	return !(sample->flags & SOUND_SAMPLEFLAG_ERROR);
+
+	std::lock_guard lock(decoder_mutex);
+	return !decoder_error;
 }
 
 uint32_t CDROM_Interface_Image::AudioFile::decode(int16_t *buffer,
@@ -414,9 +509,11 @@ uint32_t CDROM_Interface_Image::AudioFile::decode(int16_t *buffer,
 	assertm(audio_pos < MAX_REDBOOK_BYTES,
 	        "Tried to decode audio before the playback position was set");
 
-	// Sound_Decode_Direct returns frames (agnostic of bitrate and channels)
-	const uint32_t frames_decoded =
-	    Sound_Decode_Direct(sample, (void*)buffer, desired_track_frames);
+	// Returns frames (agnostic of bitrate and channels). This runs in the
+	// mixer thread, so it only takes what's already decoded.
+	const uint32_t frames_decoded = TakeFrames(reinterpret_cast<uint8_t*>(buffer),
+	                                           desired_track_frames,
+	                                           false);
 
 	// decoding is an audio-task, so update our audio position
 	// in terms of Redbook-equivalent bytes
@@ -426,6 +523,279 @@ uint32_t CDROM_Interface_Image::AudioFile::decode(int16_t *buffer,
 	return frames_decoded;
 }
 
+bool CDROM_Interface_Image::AudioFile::isDecodingBehind()
+{
+	return !IsDecoderDone();
+}
+
+// Pre-decodes the start of a likely seek target when the image is loaded, so
+// playback from there doesn't have to wait for the codec to seek
+void CDROM_Interface_Image::AudioFile::addSeekTarget(const uint32_t offset)
+{
+	// The sample belongs to the decoder thread once it's running
+	if (!sample || decoder_thread.joinable() || !offsetInsideTrack(offset)) {
+		return;
+	}
+
+	const uint32_t pos_in_ms = redbook_offset_to_ms(offset);
+	const uint64_t start_frame = ms_to_track_frame(pos_in_ms, getRate());
+
+	for (const auto& preroll : prerolls) {
+		if (preroll.start_frame == start_frame) {
+			return;
+		}
+	}
+
+	if (!Sound_Seek(sample, pos_in_ms)) {
+		return;
+	}
+
+	Preroll preroll     = {};
+	preroll.start_frame = start_frame;
+	preroll.end_ms      = pos_in_ms + PrerollMs;
+
+	const uint8_t channels = getChannels();
+	const auto preroll_frames = check_cast<uint32_t>(
+	        ms_to_track_frame(PrerollMs, getRate()));
+	preroll.samples.resize(static_cast<size_t>(preroll_frames) * channels);
+
+	uint32_t decoded_frames = 0;
+	while (decoded_frames < preroll_frames) {
+		const uint32_t decoded = Sound_Decode_Direct(
+		        sample,
+		        preroll.samples.data() + static_cast<size_t>(decoded_frames) * channels,
+		        preroll_frames - decoded_frames);
+		decoded_frames += decoded;
+
+		if (sample->flags & SOUND_SAMPLEFLAG_ERROR) {
+			return;
+		}
+		if (sample->flags & SOUND_SAMPLEFLAG_EOF || !decoded) {
+			preroll.reaches_end = true;
+			break;
+		}
+	}
+	preroll.samples.resize(static_cast<size_t>(decoded_frames) * channels);
+
+	prerolls.push_back(std::move(preroll));
+}
+
+void CDROM_Interface_Image::AudioFile::StartDecoder()
+{
+	if (decoder_thread.joinable()) {
+		return;
+	}
+
+	const auto ring_capacity = std::max(ms_to_track_frame(DecodeAheadMs, getRate()),
+	                                    static_cast<uint64_t>(DecodeChunkFrames) * 2);
+	ring.assign(static_cast<size_t>(ring_capacity) * getChannels(), 0);
+
+	decoder_thread = std::thread(&AudioFile::DecodeAheadLoop, this);
+}
+
+void CDROM_Interface_Image::AudioFile::StopDecoder()
+{
+	if (!decoder_thread.joinable()) {
+		return;
+	}
+	{
+		std::lock_guard lock(decoder_mutex);
+		decoder_exit = true;
+	}
+	decoder_cond.notify_all();
+	decoder_thread.join();
+}
+
+// Expects the decoder mutex to be held
+void CDROM_Interface_Image::AudioFile::RequestDecoderSeek(const uint32_t pos_in_ms)
+{
+	seek_ms      = pos_in_ms;
+	seek_pending = true;
+}
+
+void CDROM_Interface_Image::AudioFile::DecodeAheadLoop()
+{
+	const uint8_t channels = getChannels();
+	const size_t ring_capacity = ring.size() / channels;
+
+	std::vector<int16_t> chunk(static_cast<size_t>(DecodeChunkFrames) * channels);
+
+	std::unique_lock lock(decoder_mutex);
+	while (true) {
+		decoder_cond.wait(lock, [&] {
+			return decoder_exit || seek_pending ||
+			       (!decoder_eof &&
+			        ring_frames + DecodeChunkFrames <= ring_capacity);
+		});
+
+		if (decoder_exit) {
+			return;
+		}
+
+		// Work started for an earlier generation is dropped
+		const auto generation = decoder_generation;
+
+		if (seek_pending) {
+			const auto pos_in_ms = seek_ms;
+			lock.unlock();
+
+#ifdef DEBUG
+			/**
+			 *  In DEBUG mode, we additionally measure the seek
+			 *  latency, which can be an issue for some codecs.
+			 */
+			using namespace std::chrono;
+			using clock = std::chrono::steady_clock;
+			clock::time_point begin = clock::now(); // start the timer
+#endif
+			const bool result = Sound_Seek(sample, pos_in_ms);
+
+#ifdef DEBUG
+			clock::time_point end = clock::now(); // stop the timer
+			const int32_t elapsed_ms = static_cast<int32_t>(
+			        duration_cast<milliseconds>(end - begin).count());
+
+			// Report general seek diagnostics
+			const double pos_in_min = static_cast<double>(pos_in_ms) / 60000.0;
+			LOG_MSG("CDROM: seeked to %.2f min, and took %d ms",
+			        pos_in_min, elapsed_ms);
+
+			/**
+			 *  Inform the user if the seek took longer than the
+			 *  pre-decoded audio covers, which might have caused
+			 *  in-game symptoms like pauses or stuttering.
+			 */
+			if (elapsed_ms > static_cast<int32_t>(PrerollMs))
+				LOG_MSG("CDROM: seek took %d ms, which is longer than "
+				        "the %u ms of audio decoded ahead of a seek target.",
+				        elapsed_ms, PrerollMs);
+#endif
+			lock.lock();
+			if (generation != decoder_generation) {
+				continue;
+			}
+			seek_pending = false;
+			if (!result) {
+				decoder_eof   = true;
+				decoder_error = true;
+			}
+			decoder_cond.notify_all();
+			continue;
+		}
+
+		// Decoding is slow, so let the playback side take frames from
+		// the ring buffer in the meantime
+		lock.unlock();
+		const uint32_t num_frames = Sound_Decode_Direct(sample,
+		                                                chunk.data(),
+		                                                DecodeChunkFrames);
+		const auto flags = sample->flags;
+		lock.lock();
+
+		// The decoded frames are stale if the ring was reset meanwhile
+		if (generation != decoder_generation) {
+			continue;
+		}
+
+		PushFrames(chunk.data(), num_frames);
+
+		if (flags & (SOUND_SAMPLEFLAG_ERROR | SOUND_SAMPLEFLAG_EOF) || !num_frames) {
+			decoder_eof   = true;
+			decoder_error = (flags & SOUND_SAMPLEFLAG_ERROR);
+		}
+		decoder_cond.notify_all();
+	}
+}
+
+// Waits until the decoder thread has carried out the pending seek, if any.
+// Returns false if the seek failed.
+bool CDROM_Interface_Image::AudioFile::WaitForDecoderSeek()
+{
+	std::unique_lock lock(decoder_mutex);
+	decoder_cond.wait(lock, [&] { return !seek_pending; });
+	return !(decoder_error && ring_frames == 0);
+}
+
+// The decoder reached the end of the track (or failed) and everything it
+// decoded has been taken
+bool CDROM_Interface_Image::AudioFile::IsDecoderDone()
+{
+	std::lock_guard lock(decoder_mutex);
+	return decoder_eof && !seek_pending && ring_frames == 0;
+}
+
+// Takes decoded frames from the ring buffer. If 'wait' is set, it waits for the
+// decoder thread as needed and returns fewer frames than requested only at the
+// end of the track. Otherwise it only takes the frames that are ready.
+uint32_t CDROM_Interface_Image::AudioFile::TakeFrames(uint8_t* buffer,
+                                                      const uint32_t num_frames,
+                                                      const bool wait)
+{
+	const size_t bytes_per_frame = static_cast<size_t>(getChannels()) * REDBOOK_BPS;
+
+	uint32_t frames_taken = 0;
+
+	std::unique_lock lock(decoder_mutex);
+	while (frames_taken < num_frames) {
+		if (wait) {
+			decoder_cond.wait(lock, [&] {
+				return ring_frames > 0 || (decoder_eof && !seek_pending);
+			});
+		}
+		if (ring_frames == 0) {
+			break;
+		}
+		const auto chunk_frames = std::min(ring_frames,
+		                                   static_cast<size_t>(num_frames - frames_taken));
+		PopFrames(buffer + frames_taken * bytes_per_frame,
+		          check_cast<uint32_t>(chunk_frames));
+		frames_taken += check_cast<uint32_t>(chunk_frames);
+
+		// Let the decoder refill the ring buffer
+		decoder_cond.notify_all();
+	}
+	return frames_taken;
+}
+
+// Expects the decoder mutex to be held and enough free space in the ring
+void CDROM_Interface_Image::AudioFile::PushFrames(const int16_t* samples,
+                                                  const uint32_t num_frames)
+{
+	const uint8_t channels = getChannels();
+	const size_t ring_capacity = ring.size() / channels;
+	assert(ring_frames + num_frames <= ring_capacity);
+
+	size_t tail = (ring_head + ring_frames) % ring_capacity;
+	for (uint32_t remaining = num_frames; remaining > 0;) {
+		const auto n = std::min(static_cast<size_t>(remaining), ring_capacity - tail);
+		std::copy_n(samples, n * channels, ring.begin() + tail * channels);
+		samples += n * channels;
+		remaining -= check_cast<uint32_t>(n);
+		tail = (tail + n) % ring_capacity;
+	}
+	ring_frames += num_frames;
+}
+
+// Expects the decoder mutex to be held and enough frames in the ring
+void CDROM_Interface_Image::AudioFile::PopFrames(uint8_t* buffer, const uint32_t num_frames)
+{
+	const uint8_t channels = getChannels();
+	const size_t ring_capacity = ring.size() / channels;
+	const size_t bytes_per_frame = static_cast<size_t>(channels) * REDBOOK_BPS;
+	assert(num_frames <= ring_frames);
+
+	for (uint32_t remaining = num_frames; remaining > 0;) {
+		const auto n = std::min(static_cast<size_t>(remaining),
+		                        ring_capacity - ring_head);
+		memcpy(buffer, ring.data() + ring_head * channels, n * bytes_per_frame);
+		buffer += n * bytes_per_frame;
+		remaining -= check_cast<uint32_t>(n);
+		ring_head = (ring_head + n) % ring_capacity;
+	}
+	ring_frames -= num_frames;
+	ring_start_frame += num_frames;
+}
+
 uint16_t CDROM_Interface_Image::AudioFile::getEndian()
 {
 	return sample ? sample->actual.format : AUDIO_S16SYS;
@@ -467,6 +837,7 @@ CDROM_Interface_Image::imagePlayer CDROM_Interface_Image::player;
 CDROM_Interface_Image::CDROM_Interface_Image()
         : tracks{},
           readBuffer{},
+          rawSectorBuffer{},
           mcn("")
 {
 	if (refCount == 0) {
@@ -873,19 +1244,23 @@ bool CDROM_Interface_Image::ReadSectors(PhysPt buffer,
 
 	// Setup state-tracking variables to be used in the read-loop
 	bool success = true; //Gobliiins reads 0 sectors
-	uint32_t bytes_read = 0;
-	uint32_t current_sector = sector;
-	uint8_t* buffer_position = readBuffer.data();
-
-	// Read until we have enough or fail
-	while (bytes_read < requested_bytes) {
-		success = ReadSector(buffer_position, raw, current_sector);
-		if (!success)
+	uint32_t sectors_read = 0;
+
+	// Read whole runs of sectors until we have enough or fail
+	while (sectors_read < num) {
+		const uint32_t run = ReadTrackSectors(readBuffer.data() +
+		                                              sectors_read * sectorSize,
+		                                      raw,
+		                                      sector + sectors_read,
+		                                      num - sectors_read);
+		if (run == 0) {
+			success = false;
 			break;
-		current_sector++;
-		bytes_read += sectorSize;
-		buffer_position += sectorSize;
+		}
+		sectors_read += run;
 	}
+	const uint32_t bytes_read = sectors_read * sectorSize;
+
 	// Write only the successfully read bytes
 	MEM_BlockWrite(buffer, readBuffer.data(), bytes_read);
 #ifdef DEBUG
@@ -898,6 +1273,62 @@ bool CDROM_Interface_Image::ReadSectors(PhysPt buffer,
 	return success;
 }
 
+// Reads consecutive sectors with a single read from the track's file, up to
+// the end of the track the first sector is in. Returns the number of sectors
+// read, or zero on failure.
+uint32_t CDROM_Interface_Image::ReadTrackSectors(uint8_t* buffer,
+                                                 const bool raw,
+                                                 const uint32_t sector,
+                                                 const uint32_t num)
+{
+	track_const_iter track = GetTrack(sector);
+	if (track == tracks.end() || track->file == nullptr) {
+		return 0;
+	}
+
+	// Pregap sectors are read one at a time
+	if (sector < track->start || num == 1) {
+		return ReadSector(buffer, raw, sector) ? 1 : 0;
+	}
+
+	const uint16_t length = (raw ? BYTES_PER_RAW_REDBOOK_FRAME : BYTES_PER_COOKED_REDBOOK_FRAME);
+	if (track->sectorSize != BYTES_PER_RAW_REDBOOK_FRAME && raw) {
+		return 0;
+	}
+
+	uint32_t payload_offset = 0;
+	if (track->sectorSize == BYTES_PER_RAW_REDBOOK_FRAME && !track->mode2 && !raw)
+		payload_offset = 16;
+	if (track->mode2 && !raw)
+		payload_offset = 24;
+
+	const uint32_t num_sectors = std::min(num, track->start + track->length - sector);
+	const uint32_t offset = track->skip + (sector - track->start) * track->sectorSize;
+
+	// The sectors can be read straight into the buffer if they're stored
+	// without any headers
+	if (track->sectorSize == length) {
+		return track->file->read(buffer, offset, num_sectors * length)
+		             ? num_sectors
+		             : 0;
+	}
+
+	// Otherwise read the whole raw sectors and extract their user data
+	const uint32_t raw_bytes = num_sectors * track->sectorSize;
+	if (rawSectorBuffer.size() < raw_bytes) {
+		rawSectorBuffer.resize(raw_bytes);
+	}
+	if (!track->file->read(rawSectorBuffer.data(), offset, raw_bytes)) {
+		return 0;
+	}
+	for (uint32_t i = 0; i < num_sectors; ++i) {
+		memcpy(buffer + i * length,
+		       rawSectorBuffer.data() + i * track->sectorSize + payload_offset,
+		       length);
+	}
+	return num_sectors;
+}
+
 bool CDROM_Interface_Image::LoadUnloadMedia(bool /*unload*/)
 {
 	return true;
@@ -988,14 +1419,22 @@ bool CDROM_Interface_Image::ReadSector(uint8_t *buffer, const bool raw, const ui
 
 bool CDROM_Interface_Image::ReadSectorsHost(void *buffer, bool raw, unsigned long sector, unsigned long num)
 {
-	unsigned int sectorSize = raw ? BYTES_PER_RAW_REDBOOK_FRAME : BYTES_PER_COOKED_REDBOOK_FRAME;
-	bool success = true; //Gobliiins reads 0 sectors
-	for(unsigned long i = 0; i < num; i++) {
-		success = ReadSector((uint8_t*)buffer + (i * (Bitu)sectorSize), raw, sector + i);
-		if (!success) break;
+	const unsigned int sectorSize = raw ? BYTES_PER_RAW_REDBOOK_FRAME : BYTES_PER_COOKED_REDBOOK_FRAME;
+	auto sector_buffer = static_cast<uint8_t*>(buffer);
+
+	unsigned long sectors_read = 0;
+	while (sectors_read < num) { //Gobliiins reads 0 sectors
+		const auto run = ReadTrackSectors(
+		        sector_buffer + sectors_read * sectorSize,
+		        raw,
+		        check_cast<uint32_t>(sector + sectors_read),
+		        check_cast<uint32_t>(num - sectors_read));
+		if (run == 0) {
+			return false;
+		}
+		sectors_read += run;
 	}
-
-	return success;
+	return true;
 }
 
 void CDROM_Interface_Image::PlayNextAudioTrack()
@@ -1040,7 +1479,10 @@ void CDROM_Interface_Image::CDAudioCallback(const int desired_track_frames)
 	const auto decoded_track_frames = check_cast<uint16_t>(
 	        track_file->decode(player.buffer, desired_track_frames));
 
-	if (!decoded_track_frames) {
+	const auto is_decoding_behind = decoded_track_frames < desired_track_frames &&
+	                                track_file->isDecodingBehind();
+
+	if (!decoded_track_frames && !is_decoding_behind) {
 		// This particular CDDA track has come to an end, but the
 		// program has requested we continue playing for a longer
 		// period. So keep going!
@@ -1063,9 +1505,21 @@ void CDROM_Interface_Image::CDAudioCallback(const int desired_track_frames)
 		}
 	}
 
+	auto frames_to_play = decoded_track_frames;
+	if (is_decoding_behind) {
+		// The decoder thread hasn't caught up yet (e.g., right after a
+		// seek), so play silence rather than stall the mixer. The play
+		// position only moves on by the decoded frames.
+		const auto channels = track_file->getChannels();
+		std::fill_n(player.buffer + static_cast<size_t>(decoded_track_frames) * channels,
+		            static_cast<size_t>(desired_track_frames - decoded_track_frames) * channels,
+		            static_cast<int16_t>(0));
+		frames_to_play = check_cast<uint16_t>(desired_track_frames);
+	}
+
 	// Use the stereo or mono and native or nonnative AddSamples call
 	// assigned during construction
-	(player.channel.get()->*player.addFrames)(decoded_track_frames, player.buffer);
+	(player.channel.get()->*player.addFrames)(frames_to_play, player.buffer);
 
 	player.playedTrackFrames += decoded_track_frames;
 	if (player.playedTrackFrames >= player.totalTrackFrames) {
@@ -1308,6 +1762,13 @@ bool CDROM_Interface_Image::LoadCueSheet(const char *cuefile)
 	if (!AddTrack(track, shift, -1, totalPregap, 0)) {
 		return false;
 	}
+
+	// Playback usually starts at the beginning of an audio track
+	for (const auto& audio_track : tracks) {
+		if (audio_track.file && audio_track.attr == 0) {
+			audio_track.file->addSeekTarget(audio_track.skip);
+		}
+	}
 	return true;
 }
 
@@ -1483,4 +1944,6 @@ void CDROM_Image_Init(Section* sec)
 		sec->AddDestroyFunction(CDROM_Image_Destroy);
 	}
 	Sound_Init();
+
+	mp3_set_seek_table_cache_dir((GetConfigDir() / SeekTableCacheDir).string());
 }
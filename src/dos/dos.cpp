@@ -1598,6 +1598,12 @@ static Bitu DOS_27Handler(void) {
 	return CBRET_NONE;
 }
 
+static Bitu DOS_28Handler(void) {
+	// DOS idle interrupt, called by programs waiting for input
+	CPU_NotifyIdle(CpuIdleReason::DosIdle);
+	return CBRET_NONE;
+}
+
 static uint16_t DOS_SectorAccess(const bool read)
 {
 	const auto drive = std::dynamic_pointer_cast<fatDrive>(Drives.at(reg_al));
@@ -1764,7 +1770,7 @@ public:
 		callback[4].Install(DOS_27Handler,CB_IRET,"DOS Int 27");
 		callback[4].Set_RealVec(0x27);
 
-		callback[5].Install(nullptr,CB_IRET,"DOS Int 28");
+		callback[5].Install(DOS_28Handler,CB_IRET,"DOS Int 28");
 		callback[5].Set_RealVec(0x28);
 
 		callback[6].Install(nullptr,CB_INT29,"CON Output Int 29");
@@ -7,6 +7,7 @@
 #include <list>
 
 #include "cpu/callback.h"
+#include "cpu/cpu.h"
 #include "hardware/memory.h"
 #include "cpu/registers.h"
 
@@ -202,7 +203,7 @@ static bool DOS_MultiplexFunctions(void) {
 		else if (reg_bx == 0x18) return true;	// idle callout
 		else return false;
 	case 0x1680:	/*  RELEASE CURRENT VIRTUAL MACHINE TIME-SLICE */
-		//TODO Maybe do some idling but could screw up other systems :)
+		CPU_NotifyIdle(CpuIdleReason::ReleaseTimeSlice);
 		return true; //So no warning in the debugger anymore
 	case 0x1689:	/*  Kernel IDLE CALL */
 	case 0x168f:	/*  Close awareness crap */
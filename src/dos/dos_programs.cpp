@@ -25,6 +25,7 @@
 #include "programs/mouse.h"
 #include "programs/mousectl.h"
 #include "programs/move.h"
+#include "programs/perfstat.h"
 #include "programs/placeholder.h"
 #include "programs/rescan.h"
 #include "programs/serial.h"
@@ -83,6 +84,7 @@ void Add_VFiles()
 	PROGRAMS_MakeFile("MOUSE.COM", ProgramCreate<MOUSE>);
 	PROGRAMS_MakeFile("MOUSECTL.COM", ProgramCreate<MOUSECTL>);
 	PROGRAMS_MakeFile("MOVE.EXE", ProgramCreate<MOVE>);
+	PROGRAMS_MakeFile("PERFSTAT.COM", ProgramCreate<PERFSTAT>);
 	PROGRAMS_MakeFile("RESCAN.COM", ProgramCreate<RESCAN>);
 	PROGRAMS_MakeFile("SERIAL.COM", ProgramCreate<SERIAL>);
 	PROGRAMS_MakeFile("SETVER.EXE", ProgramCreate<SETVER>);
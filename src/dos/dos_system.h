@@ -7,6 +7,7 @@
 
 #include "dosbox.h"
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -181,6 +182,8 @@ private:
 #define MAX_OPENDIRS 2048
 //Can be high as it's only storage (16 bit variable)
 
+class HostDirWatcher;
+
 class DOS_Drive_Cache {
 public:
 	enum TDirSort { NOSORT, ALPHABETICAL, DIRALPHABETICAL, ALPHABETICALREV, DIRALPHABETICALREV };
@@ -213,6 +216,10 @@ public:
 	void SetLabel(const char *name, bool cdrom, bool allowupdate);
 	const char *GetLabel() const { return label; }
 
+	// Keep the cached directories in sync with changes made on the host,
+	// so they don't have to be rescanned
+	void EnableHostWatch(const bool enable);
+
 	class CFileInfo {
 	public:
 		CFileInfo(void)
@@ -267,6 +274,13 @@ private:
 	uint16_t		GetFreeID		(CFileInfo* dir);
 	void		Clear			(void);
 
+	void ProcessHostChanges();
+	void ResyncDir(CFileInfo* dir, const char* path);
+	void ApplyHostChange(CFileInfo* dir, const char* name,
+	                     const bool is_directory, const bool removed);
+	void InsertEntry(CFileInfo* dir, const char* name, const bool is_directory);
+	void RemoveEntry(CFileInfo* dir, const size_t index);
+
 	CFileInfo*	dirBase;
 	char		dirPath				[CROSS_LEN];
 	char		basePath			[CROSS_LEN];
@@ -282,6 +296,8 @@ private:
 
 	char		label				[CROSS_LEN];
 	bool		updatelabel;
+
+	std::unique_ptr<HostDirWatcher> host_watcher;
 };
 
 enum class DosDriveType : uint16_t {
@@ -6,11 +6,15 @@
 #include <algorithm>
 #include <cassert>
 #include <iterator>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "misc/cross.h"
 #include "dos_inc.h"
 #include "dos/drives.h"
+#include "dos/host_dir_watcher.h"
 #include "utils/string_utils.h"
 #include "misc/support.h"
 
@@ -104,6 +108,161 @@ void DOS_Drive_Cache::EmptyCache(void) {
 	if (basePath[0] != 0) SetBaseDir(basePath);
 }
 
+void DOS_Drive_Cache::EnableHostWatch(const bool enable)
+{
+	if (enable == static_cast<bool>(host_watcher)) {
+		return;
+	}
+	if (!enable) {
+		host_watcher.reset();
+		return;
+	}
+	host_watcher = std::make_unique<HostDirWatcher>();
+
+	// Read the base directory again so it's watched from now on
+	if (basePath[0] != 0) {
+		EmptyCache();
+	}
+}
+
+void DOS_Drive_Cache::ProcessHostChanges()
+{
+	if (!host_watcher) {
+		return;
+	}
+	std::vector<HostDirWatcher::ChangedDir> changed_dirs = {};
+	if (!host_watcher->GetChangedDirs(changed_dirs)) {
+		LOG(LOG_DOSMISC, LOG_NORMAL)
+		("DIRCACHE: Lost track of host changes, emptying the cache");
+		EmptyCache();
+		return;
+	}
+	for (const auto& changed : changed_dirs) {
+		// Updating a directory can delete the nodes of other changed
+		// directories below it. A directory that was cached out (as the
+		// guest's own deletes do) gets read in full on its next use.
+		const auto dir = changed.node;
+		if (!host_watcher->IsWatched(dir) || !IsCachedIn(dir)) {
+			continue;
+		}
+		if (changed.needs_rescan) {
+			ResyncDir(dir, changed.path.c_str());
+			continue;
+		}
+		// Most of these are the guest's own changes coming back, which
+		// the cache already has
+		for (const auto& entry : changed.entries) {
+			ApplyHostChange(dir, entry.name.c_str(), entry.is_dir, entry.removed);
+		}
+	}
+}
+
+// Applies a single entry the host added or removed
+void DOS_Drive_Cache::ApplyHostChange(CFileInfo* dir, const char* name,
+                                      const bool is_directory, const bool removed)
+{
+	const auto it = std::find_if(dir->fileList.begin(),
+	                             dir->fileList.end(),
+	                             [&](const CFileInfo* info) {
+		                             return strcmp(name, info->orgname) == 0;
+	                             });
+	if (it != dir->fileList.end()) {
+		if (!removed && (*it)->isDir == is_directory) {
+			return;
+		}
+		RemoveEntry(dir, static_cast<size_t>(it - dir->fileList.begin()));
+	}
+	if (!removed) {
+		InsertEntry(dir, name, is_directory);
+	}
+}
+
+// Brings a cached directory up to date with the host, keeping the entries
+// (and their short names) that are still there
+void DOS_Drive_Cache::ResyncDir(CFileInfo* dir, const char* path)
+{
+	dir_information* dirp = open_directory(path);
+	if (!dirp) {
+		// The directory itself is gone; its parent's update removes it
+		return;
+	}
+	std::vector<std::pair<std::string, bool>> host_entries = {};
+	std::unordered_map<std::string, bool> is_host_dir      = {};
+
+	char dir_name[CROSS_LEN];
+	bool is_directory = false;
+	if (read_directory_first(dirp, dir_name, is_directory)) {
+		do {
+			host_entries.emplace_back(dir_name, is_directory);
+			is_host_dir.emplace(dir_name, is_directory);
+		} while (read_directory_next(dirp, dir_name, is_directory));
+	}
+	close_directory(dirp);
+
+	// Drop the entries that are gone from the host, remember the rest
+	std::unordered_map<std::string, bool> cached = {};
+	for (auto i = dir->fileList.size(); i-- > 0;) {
+		const auto info  = dir->fileList[i];
+		const auto entry = is_host_dir.find(info->orgname);
+		if (entry == is_host_dir.end() || entry->second != info->isDir) {
+			RemoveEntry(dir, i);
+		} else {
+			cached.emplace(info->orgname, info->isDir);
+		}
+	}
+
+	// Add the new ones in the host's order, like when reading it in
+	for (const auto& [name, is_dir] : host_entries) {
+		if (!cached.count(name)) {
+			InsertEntry(dir, name.c_str(), is_dir);
+		}
+	}
+	save_dir = nullptr;
+}
+
+void DOS_Drive_Cache::InsertEntry(CFileInfo* dir, const char* name,
+                                  const bool is_directory)
+{
+	CreateEntry(dir, name, is_directory);
+
+	const auto it = std::find_if(dir->fileList.begin(),
+	                             dir->fileList.end(),
+	                             [&](const CFileInfo* info) {
+		                             return strcmp(name, info->orgname) == 0;
+	                             });
+	const auto index = static_cast<size_t>(it - dir->fileList.begin());
+
+	// Check if there are any open search dir that are affected by this...
+	for (uint32_t i = 0; i < MAX_OPENDIRS; i++) {
+		if ((dirSearch[i] == dir) && (index <= dirSearch[i]->nextEntry)) {
+			dirSearch[i]->nextEntry++;
+		}
+	}
+	save_dir = nullptr;
+}
+
+void DOS_Drive_Cache::RemoveEntry(CFileInfo* dir, const size_t index)
+{
+	CFileInfo* info = dir->fileList[index];
+	dir->fileList.erase(dir->fileList.begin() + static_cast<ptrdiff_t>(index));
+
+	const auto long_name = std::find(dir->longNameList.begin(),
+	                                 dir->longNameList.end(),
+	                                 info);
+	if (long_name != dir->longNameList.end()) {
+		dir->longNameList.erase(long_name);
+	}
+
+	// Check if there are any open search dir that are affected by this...
+	for (uint32_t i = 0; i < MAX_OPENDIRS; i++) {
+		if ((dirSearch[i] == dir) && (index < dirSearch[i]->nextEntry)) {
+			dirSearch[i]->nextEntry--;
+		}
+	}
+	DeleteFileInfo(info);
+	save_dir = nullptr;
+}
+
 void DOS_Drive_Cache::SetLabel(const char* vname,bool cdrom,bool allowupdate) {
 /* allowupdate defaults to true. if mount sets a label then allowupdate is 
  * false and will this function return at once after the first call.
@@ -166,6 +325,8 @@ void DOS_Drive_Cache::ExpandNameAndNormaliseCase(char* path)
 
 char* DOS_Drive_Cache::GetExpandNameAndNormaliseCase(const char* path)
 {
+	ProcessHostChanges();
+
 	static char work [CROSS_LEN] = { 0 };
 	char dir [CROSS_LEN];
 
@@ -361,6 +522,8 @@ bool DOS_Drive_Cache::IsCachedIn(CFileInfo* curDir)
 
 
 bool DOS_Drive_Cache::GetShortName(const char* fullname, char* shortname) {
+	ProcessHostChanges();
+
 	// Get Dir Info
 	char expand[CROSS_LEN] = {0};
 	CFileInfo* curDir = FindDirInfo(fullname,expand);
@@ -792,6 +955,8 @@ DOS_Drive_Cache::CFileInfo* DOS_Drive_Cache::FindDirInfo(const char* path, char*
 }
 
 bool DOS_Drive_Cache::OpenDir(const char* path, uint16_t& id) {
+	ProcessHostChanges();
+
 	char expand[CROSS_LEN] = {0};
 	CFileInfo* dir = FindDirInfo(path,expand);
 	if (OpenDir(dir,expand,id)) {
@@ -904,6 +1069,10 @@ bool DOS_Drive_Cache::ReadDir(uint16_t id, char* &result) {
 		// close dir
 		close_directory(dirp);
 
+		if (host_watcher) {
+			host_watcher->Watch(dirSearch[id], dirPath);
+		}
+
 		// Info
 /*		if (!dirp) {
 			LOG_DEBUG("DIR: Error Caching in %s",dirPath);			
@@ -1011,6 +1180,9 @@ void DOS_Drive_Cache::ClearFileInfo(CFileInfo *dir) {
 		if (CFileInfo *info = dir->fileList[i])
 			ClearFileInfo(info);
 	}
+	if (host_watcher) {
+		host_watcher->Unwatch(dir);
+	}
 	if (dir->id != MAX_OPENDIRS) {
 		dirSearch[dir->id] = nullptr;
 		dir->id = MAX_OPENDIRS;
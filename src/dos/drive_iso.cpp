@@ -3,8 +3,10 @@
 
 #include "dos/drives.h"
 
+#include <algorithm>
 #include <cctype>
 #include <cstring>
+#include <vector>
 
 #include "cdrom.h"
 #include "dos_mscdex.h"
@@ -29,12 +31,19 @@ public:
 	bool IsOnReadOnlyMedium() const override;
 
 private:
+	bool FillBuffer(const uint32_t sector);
+
 	std::shared_ptr<isoDrive> drive = nullptr;
-	int cachedSector = -1;
 	uint32_t fileBegin = 0;
 	uint32_t filePos = 0;
 	uint32_t fileEnd = 0;
-	uint8_t buffer[ISO_FRAMESIZE] = {{}};
+
+	// Window of sectors read from the image. It grows while the file is
+	// read sequentially, so streaming takes few large reads.
+	std::vector<uint8_t> buffer = {};
+	uint32_t bufferSector = 0;
+	uint32_t bufferSectors = 0;
+	uint32_t readAheadSectors = 1;
 };
 
 isoFile::isoFile(std::shared_ptr<isoDrive> iso_drive, const char *name, FileStat_Block *stat, uint32_t offset)
@@ -57,40 +66,60 @@ bool isoFile::Read(uint8_t *data, uint16_t *size) {
 		*size = (uint16_t)(fileEnd - filePos);
 
 	uint16_t nowSize = 0;
-	uint32_t sector = filePos / ISO_FRAMESIZE;
-
-	if (static_cast<int>(sector) != cachedSector) {
-		if (drive->readSector(buffer, sector)) {
-			cachedSector = static_cast<int>(sector);
-		} else {
-			*size = 0;
-			cachedSector = -1;
+	while (nowSize < *size) {
+		const uint32_t sector = filePos / ISO_FRAMESIZE;
+		if (sector < bufferSector || sector >= bufferSector + bufferSectors) {
+			if (!FillBuffer(sector)) {
+				break;
+			}
 		}
+		const uint32_t bufferPos = (sector - bufferSector) * ISO_FRAMESIZE +
+		                           filePos % ISO_FRAMESIZE;
+		const uint32_t available = bufferSectors * ISO_FRAMESIZE - bufferPos;
+
+		const auto chunk = static_cast<uint16_t>(
+		        std::min(available, static_cast<uint32_t>(*size - nowSize)));
+		memcpy(&data[nowSize], &buffer[bufferPos], chunk);
+		nowSize += chunk;
+		filePos += chunk;
+	}
+	*size = nowSize;
+	return true;
+}
+
+bool isoFile::FillBuffer(const uint32_t sector) {
+	// Reading on from the end of the window means the file is being read
+	// sequentially, so read further ahead each time
+	if (bufferSectors > 0 && sector == bufferSector + bufferSectors) {
+		readAheadSectors = std::min(readAheadSectors * 2,
+		                            static_cast<uint32_t>(ISO_MAX_READ_AHEAD));
+	} else {
+		readAheadSectors = 1;
 	}
 
-	static_assert(ISO_FRAMESIZE <= UINT16_MAX);
-	auto sectorPos = static_cast<uint16_t>(filePos % ISO_FRAMESIZE);
+	assert(filePos < fileEnd);
+	const uint32_t lastSector = (fileEnd - 1) / ISO_FRAMESIZE;
+	const uint32_t num = std::min(readAheadSectors, lastSector - sector + 1);
 
-	while (nowSize < *size) {
-		uint16_t remSector = ISO_FRAMESIZE - sectorPos;
-		uint16_t remSize = *size - nowSize;
-		if(remSector < remSize) {
-			memcpy(&data[nowSize], &buffer[sectorPos], remSector);
-			nowSize += remSector;
-			sectorPos = 0;
-			sector++;
-			cachedSector++;
-			if (!drive->readSector(buffer, sector)) {
-				*size = nowSize;
-				cachedSector = -1;
-			}
-		} else {
-			memcpy(&data[nowSize], &buffer[sectorPos], remSize);
-			nowSize += remSize;
+	if (buffer.empty()) {
+		buffer.resize(ISO_MAX_READ_AHEAD * ISO_FRAMESIZE);
+	}
+	bufferSectors = 0;
+
+	// Single sectors go through the drive's cache, as random accesses
+	// tend to revisit the same sectors
+	if (num == 1) {
+		uint8_t* cached = nullptr;
+		if (!drive->ReadCachedSector(&cached, sector)) {
+			return false;
 		}
+		memcpy(buffer.data(), cached, ISO_FRAMESIZE);
+	} else if (!drive->readSectors(buffer.data(), sector, num)) {
+		return false;
 	}
-	*size = nowSize;
-	filePos += *size;
+
+	bufferSector = sector;
+	bufferSectors = num;
 	return true;
 }
 
@@ -143,7 +172,6 @@ isoDrive::isoDrive(char driveLetter, const char *fileName, uint8_t mediaid, int
 	this->fileName[0]  = '\0';
 	this->discLabel[0] = '\0';
 	memset(dirIterators, 0, sizeof(dirIterators));
-	memset(sectorHashEntries, 0, sizeof(sectorHashEntries));
 	memset(&rootEntry, 0, sizeof(isoDirEntry));
 
 	safe_strcpy(this->fileName, fileName);
@@ -191,6 +219,10 @@ int isoDrive::UpdateMscdex(char drive_letter, const char *path, uint8_t &sub_uni
 
 void isoDrive::Activate(void) {
 	UpdateMscdex(driveLetter, fileName, subUnit);
+
+	// The image could have been swapped
+	sectorCache.clear();
+	sectorCacheIndex.clear();
 }
 
 std::unique_ptr<DOS_File> isoDrive::FileOpen(const char* name, uint8_t flags)
@@ -454,20 +486,30 @@ void isoDrive::FreeDirIterator(const int dirIterator) {
 }
 
 bool isoDrive::ReadCachedSector(uint8_t** buffer, const uint32_t sector) {
-	// get hash table entry
-	int pos = sector % ISO_MAX_HASH_TABLE_SIZE;
-	SectorHashEntry& he = sectorHashEntries[pos];
+	if (const auto it = sectorCacheIndex.find(sector); it != sectorCacheIndex.end()) {
+		// Mark the sector as the most recently used
+		sectorCache.splice(sectorCache.begin(), sectorCache, it->second);
+		*buffer = it->second->data.data();
+		return true;
+	}
 
-	// check if the entry is valid and contains the correct sector
-	if (!he.valid || he.sector != sector) {
-		if (!CDROM::cdroms[subUnit]->ReadSector(he.data, false, sector)) {
-			return false;
-		}
-		he.valid = true;
-		he.sector = sector;
+	// Reuse the least recently used entry if the cache is full
+	if (sectorCache.size() >= ISO_SECTOR_CACHE_SIZE) {
+		sectorCacheIndex.erase(sectorCache.back().sector);
+		sectorCache.splice(sectorCache.begin(), sectorCache, std::prev(sectorCache.end()));
+	} else {
+		sectorCache.emplace_front();
+	}
+
+	auto& entry = sectorCache.front();
+	if (!CDROM::cdroms[subUnit]->ReadSector(entry.data.data(), false, sector)) {
+		sectorCache.pop_front();
+		return false;
 	}
+	entry.sector = sector;
+	sectorCacheIndex[sector] = sectorCache.begin();
 
-	*buffer = he.data;
+	*buffer = entry.data.data();
 	return true;
 }
 
@@ -475,6 +517,10 @@ inline bool isoDrive::readSector(uint8_t *buffer, uint32_t sector) {
 	return CDROM::cdroms[subUnit]->ReadSector(buffer, false, sector);
 }
 
+bool isoDrive::readSectors(uint8_t *buffer, uint32_t sector, uint32_t num) {
+	return CDROM::cdroms[subUnit]->ReadSectorsHost(buffer, false, sector, num);
+}
+
 int isoDrive :: readDirEntry(isoDirEntry *de, uint8_t *data) {
 	// copy data into isoDirEntry struct, data[0] = length of DirEntry
 //	if (data[0] > sizeof(isoDirEntry)) return -1;//check disabled as isoDirentry is currently 258 bytes large. So it always fits
@@ -549,6 +549,7 @@ localDrive::localDrive(const char* startdir, uint16_t _bytes_sector,
 	type = DosDriveType::Local;
 	safe_strcpy(basedir, startdir);
 	safe_strcpy(info, startdir);
+	dirCache.EnableHostWatch(true);
 	dirCache.SetBaseDir(basedir);
 }
 
@@ -370,6 +370,10 @@ Overlay_Drive::Overlay_Drive(const char *startdir,
           DOSdirs_cache{},
           special_prefix("DBOVERLAY")
 {
+	// The cache merges the base and overlay directories, so it can't be
+	// brought up to date from just one of them
+	dirCache.EnableHostWatch(false);
+
 	//Currently this flag does nothing, as the current behavior is to not reread due to caching everything.
 #if defined (WIN32)	
 	if (strcasecmp(startdir,overlay) == 0) {
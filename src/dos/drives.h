@@ -6,6 +6,8 @@
 
 #include "dosbox.h"
 
+#include <array>
+#include <list>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -354,7 +356,8 @@ struct isoDirEntry {
 #define IS_ASSOC(fileFlags)	(!!(fileFlags & ISO_ASSOCIATED))
 #define IS_DIR(fileFlags)	(!!(fileFlags & ISO_DIRECTORY))
 #define IS_HIDDEN(fileFlags)	(!!(fileFlags & ISO_HIDDEN))
-#define ISO_MAX_HASH_TABLE_SIZE 	100
+#define ISO_SECTOR_CACHE_SIZE		512
+#define ISO_MAX_READ_AHEAD		32
 
 // Must be constructed with a shared_ptr or it will throw an exception on internal call to shared_from_this()
 class isoDrive final : public DOS_Drive, public std::enable_shared_from_this<isoDrive> {
@@ -385,6 +388,8 @@ public:
 	bool IsRemovable(void) override;
 	Bits UnMount(void) override;
 	bool readSector(uint8_t* buffer, uint32_t sector);
+	bool readSectors(uint8_t* buffer, uint32_t sector, uint32_t num);
+	bool ReadCachedSector(uint8_t** buffer, const uint32_t sector);
 	const char* GetLabel() override
 	{
 		return discLabel;
@@ -400,7 +405,6 @@ private:
 	int  GetDirIterator(const isoDirEntry* de);
 	bool GetNextDirEntry(const int dirIterator, isoDirEntry* de);
 	void FreeDirIterator(const int dirIterator);
-	bool ReadCachedSector(uint8_t** buffer, const uint32_t sector);
 	
 	struct DirIterator {
 		bool valid;
@@ -412,11 +416,13 @@ private:
 	
 	int nextFreeDirIterator;
 	
-	struct SectorHashEntry {
-		bool valid;
-		uint32_t sector;
-		uint8_t data[ISO_FRAMESIZE];
-	} sectorHashEntries[ISO_MAX_HASH_TABLE_SIZE];
+	// Least recently used sectors, most recent first
+	struct CachedSector {
+		uint32_t sector = 0;
+		std::array<uint8_t, ISO_FRAMESIZE> data = {};
+	};
+	std::list<CachedSector> sectorCache = {};
+	std::unordered_map<uint32_t, std::list<CachedSector>::iterator> sectorCacheIndex = {};
 
 	bool iso;
 	bool dataCD;
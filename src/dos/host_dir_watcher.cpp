@@ -0,0 +1,193 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "host_dir_watcher.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <utility>
+
+#if defined(LINUX)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "utils/checks.h"
+
+CHECK_NARROWING();
+
+#if defined(LINUX)
+
+// Only changes to the directory's entries matter, not to their contents
+constexpr uint32_t WatchMask = IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+                               IN_MOVED_TO | IN_ONLYDIR;
+
+HostDirWatcher::HostDirWatcher()
+{
+	inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (inotify_fd < 0) {
+		LOG_WARNING("DIRCACHE: Could not set up inotify, host directory "
+		            "changes won't be noticed: %s",
+		            strerror(errno));
+	}
+}
+
+HostDirWatcher::~HostDirWatcher()
+{
+	if (inotify_fd >= 0) {
+		close(inotify_fd);
+	}
+}
+
+void HostDirWatcher::Watch(DirNode* node, const std::string& path)
+{
+	if (inotify_fd < 0 || watch_limit_reached || watched_dirs.count(node)) {
+		return;
+	}
+
+	const auto wd = inotify_add_watch(inotify_fd, path.c_str(), WatchMask);
+	if (wd < 0) {
+		if (errno == ENOSPC) {
+			LOG_WARNING("DIRCACHE: Reached the host's inotify watch limit, "
+			            "changes in further directories won't be noticed");
+			watch_limit_reached = true;
+		}
+		return;
+	}
+
+	watched_dirs[node] = {path, wd};
+	nodes_by_wd.emplace(wd, node);
+}
+
+void HostDirWatcher::Unwatch(DirNode* node)
+{
+	const auto it = watched_dirs.find(node);
+	if (it == watched_dirs.end()) {
+		return;
+	}
+	const auto wd = it->second.wd;
+	watched_dirs.erase(it);
+
+	auto [first, last] = nodes_by_wd.equal_range(wd);
+	for (auto entry = first; entry != last; ++entry) {
+		if (entry->second == node) {
+			nodes_by_wd.erase(entry);
+			break;
+		}
+	}
+	if (nodes_by_wd.count(wd) == 0) {
+		inotify_rm_watch(inotify_fd, wd);
+	}
+}
+
+bool HostDirWatcher::GetChangedDirs(std::vector<ChangedDir>& changed_dirs)
+{
+	if (inotify_fd < 0 || watched_dirs.empty()) {
+		return true;
+	}
+
+	bool events_lost = false;
+
+	std::unordered_map<DirNode*, ChangedDir> changes = {};
+
+	alignas(inotify_event) char buffer[4096];
+	ssize_t len = 0;
+	while ((len = read(inotify_fd, buffer, sizeof(buffer))) > 0) {
+		for (ssize_t pos = 0; pos < len;) {
+			const auto event = reinterpret_cast<const inotify_event*>(
+			        buffer + pos);
+			pos += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+			if (event->mask & IN_Q_OVERFLOW) {
+				events_lost = true;
+				continue;
+			}
+			if (event->mask & IN_IGNORED) {
+				// The kernel dropped the watch, the directory is gone
+				auto [first, last] = nodes_by_wd.equal_range(event->wd);
+				for (auto entry = first; entry != last; ++entry) {
+					watched_dirs.erase(entry->second);
+				}
+				nodes_by_wd.erase(event->wd);
+				continue;
+			}
+			auto [first, last] = nodes_by_wd.equal_range(event->wd);
+			for (auto entry = first; entry != last; ++entry) {
+				auto& changed = changes[entry->second];
+				if (event->len == 0) {
+					changed.needs_rescan = true;
+					continue;
+				}
+				// The name is padded with null bytes
+				changed.entries.push_back(
+				        {event->name,
+				         (event->mask & IN_ISDIR) != 0,
+				         (event->mask & (IN_DELETE | IN_MOVED_FROM)) != 0});
+			}
+		}
+	}
+
+	for (auto& [node, changed] : changes) {
+		if (const auto it = watched_dirs.find(node); it != watched_dirs.end()) {
+			changed.node = node;
+			changed.path = it->second.path;
+			changed_dirs.push_back(std::move(changed));
+		}
+	}
+	return !events_lost;
+}
+
+#else
+
+HostDirWatcher::HostDirWatcher() = default;
+
+HostDirWatcher::~HostDirWatcher() = default;
+
+void HostDirWatcher::Watch(DirNode* node, const std::string& path)
+{
+	std::error_code ec = {};
+	const auto last_write_time = std_fs::last_write_time(path, ec);
+	if (ec) {
+		return;
+	}
+	watched_dirs[node] = {path, last_write_time};
+}
+
+void HostDirWatcher::Unwatch(DirNode* node)
+{
+	watched_dirs.erase(node);
+}
+
+bool HostDirWatcher::GetChangedDirs(std::vector<ChangedDir>& changed_dirs)
+{
+	// Checking the modification time of every cached directory costs a
+	// system call each, so don't do it too often
+	constexpr int64_t PollIntervalMs = 1000;
+
+	using namespace std::chrono;
+	const auto now_ms = duration_cast<milliseconds>(
+	                            steady_clock::now().time_since_epoch())
+	                            .count();
+	if (now_ms - last_poll_ms < PollIntervalMs) {
+		return true;
+	}
+	last_poll_ms = now_ms;
+
+	for (auto& [node, dir] : watched_dirs) {
+		std::error_code ec = {};
+		const auto last_write_time = std_fs::last_write_time(dir.path, ec);
+		if (ec || last_write_time == dir.last_write_time) {
+			continue;
+		}
+		dir.last_write_time = last_write_time;
+
+		ChangedDir changed   = {node, dir.path};
+		changed.needs_rescan = true;
+		changed_dirs.push_back(std::move(changed));
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_HOST_DIR_WATCHER_H
+#define DOSBOX_HOST_DIR_WATCHER_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dos/dos_system.h"
+#include "misc/std_filesystem.h"
+
+// Notices changes made on the host to the directories cached by a
+// DOS_Drive_Cache, so the cache can update just the affected directory nodes
+// instead of being emptied.
+//
+// On Linux the directories are watched with inotify, which names the entries
+// that changed. Elsewhere their modification times are polled, at most once
+// per second, and a changed directory has to be read again.
+
+class HostDirWatcher {
+public:
+	using DirNode = DOS_Drive_Cache::CFileInfo;
+
+	// An entry that appeared in or disappeared from a directory
+	struct EntryChange {
+		std::string name = {};
+		bool is_dir      = false;
+		bool removed     = false;
+	};
+
+	struct ChangedDir {
+		DirNode* node    = nullptr;
+		std::string path = {};
+
+		// The entry changes in the order they happened; only valid if
+		// the directory doesn't have to be read again as a whole
+		std::vector<EntryChange> entries = {};
+		bool needs_rescan                = false;
+	};
+
+	HostDirWatcher();
+	~HostDirWatcher();
+
+	HostDirWatcher(const HostDirWatcher&)            = delete;
+	HostDirWatcher& operator=(const HostDirWatcher&) = delete;
+
+	// Starts watching the host directory whose listing was cached in the
+	// node; the path includes the trailing directory separator
+	void Watch(DirNode* node, const std::string& path);
+
+	// The node is about to be deleted
+	void Unwatch(DirNode* node);
+
+	bool IsWatched(DirNode* node) const
+	{
+		return watched_dirs.count(node) > 0;
+	}
+
+	// Collects the watched directories that changed since the last call.
+	// Returns false if changes were lost and the whole cache has to be
+	// considered stale.
+	bool GetChangedDirs(std::vector<ChangedDir>& changed_dirs);
+
+private:
+	struct WatchedDir {
+		std::string path = {};
+#if defined(LINUX)
+		int wd = -1;
+#else
+		std_fs::file_time_type last_write_time = {};
+#endif
+	};
+
+	std::unordered_map<DirNode*, WatchedDir> watched_dirs = {};
+
+#if defined(LINUX)
+	int inotify_fd = -1;
+
+	// Several nodes can share a watch descriptor when they refer to the
+	// same host directory (e.g., through symbolic links)
+	std::unordered_multimap<int, DirNode*> nodes_by_wd = {};
+#else
+	int64_t last_poll_ms = 0;
+#endif
+
+	bool watch_limit_reached = false;
+};
+
+#endif // DOSBOX_HOST_DIR_WATCHER_H
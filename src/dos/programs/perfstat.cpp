@@ -0,0 +1,200 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "perfstat.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "cpu/cpu.h"
+#include "misc/perf_counters.h"
+#include "more_output.h"
+#include "utils/checks.h"
+#include "utils/string_utils.h"
+
+CHECK_NARROWING();
+
+using ull = unsigned long long;
+
+void PERFSTAT::Run()
+{
+	if (HelpRequested()) {
+		MoreOutputStrings output(*this);
+		output.AddString(MSG_Get("PROGRAM_PERFSTAT_HELP_LONG"));
+		output.Display();
+		return;
+	}
+
+	if (cmd->FindExist("/reset", false) || cmd->FindExist("-reset", false)) {
+		PERF_Reset();
+		WriteOut(MSG_Get("PROGRAM_PERFSTAT_RESET"));
+		return;
+	}
+
+	if (cmd->GetCount() > 0) {
+		WriteOut(MSG_Get("SHELL_SYNTAX_ERROR"));
+		return;
+	}
+
+	ShowCounters();
+}
+
+void PERFSTAT::ShowCounters()
+{
+	const auto& c = perf_counters;
+
+	const auto elapsed_s = PERF_GetElapsedSeconds();
+
+	const auto mips = elapsed_s > 0.0
+	                        ? static_cast<double>(c.cycles) / elapsed_s / 1e6
+	                        : 0.0;
+	const auto cycles_per_tick = c.ticks ? c.cycles / c.ticks : 0;
+
+	// One tick is one emulated millisecond
+	const auto dispatches_per_emulated_s =
+	        c.ticks ? static_cast<double>(c.dyn_dispatches) * 1000.0 /
+	                          static_cast<double>(c.ticks)
+	                : 0.0;
+
+	const auto mixer_callbacks = c.mixer_callbacks.load();
+	const auto mixer_callback_us =
+	        mixer_callbacks ? static_cast<double>(c.mixer_callback_time_us.load()) /
+	                                  static_cast<double>(mixer_callbacks)
+	                        : 0.0;
+
+	MoreOutputStrings output(*this);
+
+	auto add_row = [&](const char* message_name, const std::string& value) {
+		output.AddString("  %-28s %s\n", MSG_Get(message_name).c_str(), value.c_str());
+	};
+
+	output.AddString(MSG_Get("PROGRAM_PERFSTAT_TITLE"));
+	output.AddString("\n");
+
+	add_row("PROGRAM_PERFSTAT_UPTIME", format_str("%.1f s", elapsed_s));
+	add_row("PROGRAM_PERFSTAT_MIPS", format_str("%.2f", mips));
+	add_row("PROGRAM_PERFSTAT_CYCLES_PER_TICK",
+	        format_str("%llu (max %d)",
+	                   static_cast<ull>(cycles_per_tick),
+	                   CPU_CycleMax));
+	add_row("PROGRAM_PERFSTAT_PIC_EVENTS",
+	        format_str("%llu", static_cast<ull>(c.pic_events)));
+	add_row("PROGRAM_PERFSTAT_IO_ACCESSES",
+	        format_str("%llu", static_cast<ull>(c.io_accesses)));
+	add_row("PROGRAM_PERFSTAT_PAGE_HANDLER_CALLS",
+	        format_str("%llu", static_cast<ull>(c.page_handler_calls)));
+	add_row("PROGRAM_PERFSTAT_DYN_TRANSLATIONS",
+	        format_str("%llu", static_cast<ull>(c.dyn_translations)));
+	add_row("PROGRAM_PERFSTAT_DYN_INVALIDATIONS",
+	        format_str("%llu", static_cast<ull>(c.dyn_invalidations)));
+	add_row("PROGRAM_PERFSTAT_DYN_FLAG_HELPERS",
+	        format_str("%llu (%llu skipped)",
+	                   static_cast<ull>(c.dyn_flag_helpers),
+	                   static_cast<ull>(c.dyn_flag_helpers_skipped)));
+	add_row("PROGRAM_PERFSTAT_DYN_DISPATCHES",
+	        format_str("%.0f per emulated second",
+	                   dispatches_per_emulated_s));
+	add_row("PROGRAM_PERFSTAT_DYN_TRACE_BRANCHES",
+	        format_str("%llu", static_cast<ull>(c.dyn_trace_branches)));
+	add_row("PROGRAM_PERFSTAT_DYN_SMC_FALLBACKS",
+	        format_str("%llu (max %llu in one page)",
+	                   static_cast<ull>(c.dyn_smc_fallbacks),
+	                   static_cast<ull>(c.dyn_smc_fallbacks_page_max)));
+	add_row("PROGRAM_PERFSTAT_DESCRIPTOR_CACHE",
+	        format_str("%llu of %llu loads",
+	                   static_cast<ull>(c.descriptor_cache_hits),
+	                   static_cast<ull>(c.descriptor_loads)));
+	add_row("PROGRAM_PERFSTAT_IDLE_CYCLES",
+	        format_str("%llu", static_cast<ull>(c.idle_cycles_skipped)));
+	add_row("PROGRAM_PERFSTAT_TLB",
+	        format_str("%llu / %llu",
+	                   static_cast<ull>(c.tlb_misses),
+	                   static_cast<ull>(c.tlb_flushes)));
+	add_row("PROGRAM_PERFSTAT_MIXER_CALLBACK",
+	        format_str("%.1f us", mixer_callback_us));
+	add_row("PROGRAM_PERFSTAT_FRAMES",
+	        format_str("%llu / %llu",
+	                   static_cast<ull>(c.frames_rendered),
+	                   static_cast<ull>(c.frames_dropped)));
+	add_row("PROGRAM_PERFSTAT_CAPTURE_QUEUE",
+	        format_str("%u", c.capture_queue_depth.load()));
+	add_row("PROGRAM_PERFSTAT_SOCKET_REACTOR",
+	        format_str("%llu",
+	                   static_cast<ull>(c.socket_reactor_syscalls.load())));
+
+	// Busiest I/O ports
+	constexpr size_t NumTopPorts = 10;
+
+	std::vector<std::pair<uint32_t, uint32_t>> ports = {};
+	for (uint32_t port = 0; port < c.io_port_accesses.size(); ++port) {
+		if (c.io_port_accesses[port] > 0) {
+			ports.emplace_back(c.io_port_accesses[port], port);
+		}
+	}
+
+	const auto num_ports = std::min(NumTopPorts, ports.size());
+	std::partial_sort(ports.begin(),
+	                  ports.begin() + static_cast<ptrdiff_t>(num_ports),
+	                  ports.end(),
+	                  std::greater<>());
+
+	if (num_ports > 0) {
+		output.AddString("\n");
+		output.AddString(MSG_Get("PROGRAM_PERFSTAT_TOP_PORTS"));
+		for (size_t i = 0; i < num_ports; ++i) {
+			const auto& [count, port] = ports[i];
+			output.AddString("  %04Xh  %u\n", port, count);
+		}
+	}
+
+	output.Display();
+}
+
+void PERFSTAT::AddMessages()
+{
+	MSG_Add("PROGRAM_PERFSTAT_HELP_LONG",
+	        "Display the emulator's performance counters.\n"
+	        "\n"
+	        "Usage:\n"
+	        "  [color=light-green]perfstat[reset]\n"
+	        "  [color=light-green]perfstat[reset] /reset\n"
+	        "\n"
+	        "Notes:\n"
+	        "  - The counters accumulate from startup or from the last reset.\n"
+	        "  - MIPS is the number of emulated instructions (cycles) executed per\n"
+	        "    second of host time.\n"
+	        "  - Dynamic core dispatches are the code blocks the dynamic core had to\n"
+	        "    look up per emulated second; compare them with the 'dynrec_traces'\n"
+	        "    setting on and off.\n"
+	        "  - The counters can also be logged periodically to a file with the\n"
+	        "    'perfstat_log' setting.\n"
+	        "\n"
+	        "Examples:\n"
+	        "  [color=light-green]perfstat[reset]\n"
+	        "  [color=light-green]perfstat[reset] /reset\n");
+
+	MSG_Add("PROGRAM_PERFSTAT_TITLE", "[color=white]Performance counters[reset]\n");
+	MSG_Add("PROGRAM_PERFSTAT_RESET", "Performance counters reset.\n");
+
+	MSG_Add("PROGRAM_PERFSTAT_UPTIME", "Elapsed host time:");
+	MSG_Add("PROGRAM_PERFSTAT_MIPS", "Emulated MIPS:");
+	MSG_Add("PROGRAM_PERFSTAT_CYCLES_PER_TICK", "Average cycles per ms:");
+	MSG_Add("PROGRAM_PERFSTAT_PIC_EVENTS", "PIC events:");
+	MSG_Add("PROGRAM_PERFSTAT_IO_ACCESSES", "I/O port accesses:");
+	MSG_Add("PROGRAM_PERFSTAT_PAGE_HANDLER_CALLS", "Page handler calls:");
+	MSG_Add("PROGRAM_PERFSTAT_DYN_TRANSLATIONS", "Dynamic core translations:");
+	MSG_Add("PROGRAM_PERFSTAT_DYN_INVALIDATIONS", "Dynamic core invalidations:");
+	MSG_Add("PROGRAM_PERFSTAT_DYN_FLAG_HELPERS", "Dynamic core flag helpers:");
+	MSG_Add("PROGRAM_PERFSTAT_DYN_DISPATCHES", "Dynamic core dispatches:");
+	MSG_Add("PROGRAM_PERFSTAT_DYN_TRACE_BRANCHES", "Dynamic core traced jumps:");
+	MSG_Add("PROGRAM_PERFSTAT_DYN_SMC_FALLBACKS", "Self-modifying code fallbacks:");
+	MSG_Add("PROGRAM_PERFSTAT_DESCRIPTOR_CACHE", "Descriptor cache hits:");
+	MSG_Add("PROGRAM_PERFSTAT_IDLE_CYCLES", "Idle cycles skipped:");
+	MSG_Add("PROGRAM_PERFSTAT_TLB", "TLB misses / flushes:");
+	MSG_Add("PROGRAM_PERFSTAT_MIXER_CALLBACK", "Average mixer callback time:");
+	MSG_Add("PROGRAM_PERFSTAT_FRAMES", "Frames rendered / dropped:");
+	MSG_Add("PROGRAM_PERFSTAT_CAPTURE_QUEUE", "Capture queue depth:");
+	MSG_Add("PROGRAM_PERFSTAT_SOCKET_REACTOR", "Socket reactor system calls:");
+	MSG_Add("PROGRAM_PERFSTAT_TOP_PORTS", "Busiest I/O ports:\n");
+}
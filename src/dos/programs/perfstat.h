@@ -0,0 +1,26 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_PROGRAM_PERFSTAT_H
+#define DOSBOX_PROGRAM_PERFSTAT_H
+
+#include "dos/programs.h"
+
+class PERFSTAT final : public Program {
+public:
+	PERFSTAT()
+	{
+		AddMessages();
+		help_detail = {HELP_Filter::All,
+		               HELP_Category::Dosbox,
+		               HELP_CmdType::Program,
+		               "PERFSTAT"};
+	}
+	void Run() override;
+
+private:
+	void ShowCounters();
+	static void AddMessages();
+};
+
+#endif // DOSBOX_PROGRAM_PERFSTAT_H
@@ -19,7 +19,9 @@
 #include "capture/capture.h"
 #include "config/config.h"
 #include "cpu/cpu.h"
+#include "misc/benchmark.h"
 #include "misc/cross.h"
+#include "misc/profiler.h"
 #include "debugger/debugger.h"
 #include "dos/dos_locale.h"
 #include "dos/dos_inc.h"
@@ -141,13 +143,24 @@ void Null_Init([[maybe_unused]] Section *sec) {
 // forward declaration
 static void increase_ticks();
 
-static Bitu normal_loop()
+template <bool IsBenchmark>
+static Bitu run_loop()
 {
+	using PhaseTimer = BenchmarkPhaseTimer<IsBenchmark>;
+
 	Bits ret;
 
 	while (true) {
-		if (PIC_RunQueue()) {
-			ret = (*cpudecoder)();
+		bool has_cycles_left = false;
+		{
+			PhaseTimer timer(BenchmarkPhase::PicEvents);
+			has_cycles_left = PIC_RunQueue();
+		}
+		if (has_cycles_left) {
+			{
+				PhaseTimer timer(BenchmarkPhase::Cpu);
+				ret = (*cpudecoder)();
+			}
 			if (ret < 0) {
 				return 1;
 			}
@@ -155,6 +168,7 @@ static Bitu normal_loop()
 				if (ret >= CB_MAX) {
 					return 0;
 				}
+				PhaseTimer timer(BenchmarkPhase::Callbacks);
 				Bitu result = (*Callback_Handlers[ret])();
 				if (result) {
 					return result;
@@ -166,31 +180,47 @@ static Bitu normal_loop()
 			}
 #endif
 		} else {
-			// In 'host-rate' presentation mode, this effectively
-			// accomplishes polling at the sub-millisecond level for
-			// presenting the frame.
-			//
-			// We're effectively implementing cooperative
-			// multitasking here to present the frame at roughly the
-			// right time as `GFX_MaybePresentFrame()` is called
-			// around 2-5 times per tick (1 ms) depending on the
-			// cycles setting.
-			//
-			// This is a good-enough alternative to moving the
-			// entire emulation off the main thread and then
-			// presenting the last-rendered frame at regular
-			// intervals from the main thread.
-			//
-			if (GFX_GetPresentationMode() == PresentationMode::HostRate) {
-				GFX_MaybePresentFrame();
-			}
+			{
+				PhaseTimer timer(BenchmarkPhase::HostEvents);
+
+				// In 'host-rate' presentation mode, this
+				// effectively accomplishes polling at the
+				// sub-millisecond level for presenting the frame.
+				//
+				// We're effectively implementing cooperative
+				// multitasking here to present the frame at
+				// roughly the right time as
+				// `GFX_MaybePresentFrame()` is called around 2-5
+				// times per tick (1 ms) depending on the cycles
+				// setting.
+				//
+				// This is a good-enough alternative to moving the
+				// entire emulation off the main thread and then
+				// presenting the last-rendered frame at regular
+				// intervals from the main thread.
+				//
+				if (GFX_GetPresentationMode() ==
+				    PresentationMode::HostRate) {
+					GFX_MaybePresentFrame();
+				}
 
-			if (!DOSBOX_PollAndHandleEvents()) {
-				return 0;
+				if (!DOSBOX_PollAndHandleEvents()) {
+					return 0;
+				}
 			}
 			if (ticks.remain > 0) {
-				TIMER_AddTick();
+				{
+					PhaseTimer timer(BenchmarkPhase::TickHandlers);
+					TIMER_AddTick();
+				}
 				--ticks.remain;
+
+				if constexpr (IsBenchmark) {
+					if (BENCHMARK_AddTick()) {
+						GFX_RequestExit(true);
+						return 1;
+					}
+				}
 			} else {
 				increase_ticks();
 				return 0;
@@ -207,8 +237,8 @@ static void increase_ticks()
 	// remove the global variable.
 	ZoneScoped;
 
-	// For fast-forward mode
-	if (ticks.locked) {
+	// For fast-forward and benchmark modes
+	if (ticks.locked || BENCHMARK_IsActive()) {
 		ticks.remain = 5;
 
 		// Reset any auto cycle guessing for this frame
@@ -442,7 +472,9 @@ void DOSBOX_SetLoop(LoopHandler* handler)
 
 void DOSBOX_SetNormalLoop()
 {
-	loop = normal_loop;
+	// The benchmark loop variant measures the time spent in each
+	// subsystem; keep the regular loop free of the timing overhead
+	loop = BENCHMARK_IsActive() ? run_loop<true> : run_loop<false>;
 }
 
 void DOSBOX_RunMachine()
@@ -1412,6 +1444,9 @@ void DOSBOX_InitAllModuleConfigsAndMessages()
 	secprop->AddInitFunction(&VIRTUALBOX_Init);
 	secprop->AddInitFunction(&VMWARE_Init);
 
+	// Guest sampling profiler
+	PROFILER_AddConfigSection(control);
+
 	// TODO ?
 	control->AddSectionLine("autoexec", &AUTOEXEC_Init);
 
@@ -161,6 +161,7 @@ constexpr auto DefaultSoundfontsDir = "soundfonts";
 constexpr auto GlShadersDir         = "glshaders";
 constexpr auto DiskNoiseDir         = "disknoises";
 constexpr auto PluginsDir           = "plugins";
+constexpr auto SeekTableCacheDir    = "seek-tables";
 
 constexpr auto MicrosInMillisecond = 1000;
 constexpr auto BytesPerKilobyte    = 1024;
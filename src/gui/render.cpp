@@ -16,6 +16,7 @@
 #include "gui/mapper.h"
 #include "gui/render.h"
 #include "hardware/video/vga.h"
+#include "misc/perf_counters.h"
 #include "misc/support.h"
 #include "misc/video.h"
 #include "shader_manager.h"
@@ -270,6 +271,11 @@ void RENDER_EndUpdate(bool abort)
 
 	if (render.scale.outWrite) {
 		GFX_EndUpdate(abort ? nullptr : Scaler_ChangedLines);
+		if (abort) {
+			++perf_counters.frames_dropped;
+		} else {
+			++perf_counters.frames_rendered;
+		}
 	} else {
 		// If we made it here, then there's nothing new to render.
 		GFX_EndUpdate(nullptr);
@@ -55,6 +55,7 @@
 #include "hardware/timer.h"
 #include "hardware/video/vga.h"
 #include "ints/int10.h"
+#include "misc/benchmark.h"
 #include "misc/cross.h"
 #include "misc/notifications.h"
 #include "misc/pacer.h"
@@ -4031,6 +4032,14 @@ static void register_command_line_help_message()
 	        "\n"
 	        "  --socket <num>           Run nullmodem on the specified socket number.\n"
 	        "\n"
+	        "  --benchmark <ms>         Run for <ms> emulated milliseconds as fast as possible\n"
+	        "                           without a window or audio output, then print a JSON\n"
+	        "                           performance report and exit.\n"
+	        "\n"
+	        "  --benchmark-output <file>\n"
+	        "                           Write the benchmark report to <file> instead of the\n"
+	        "                           standard output.\n"
+	        "\n"
 	        "  -h, -?, --help           Print help message and exit.\n"
 	        "\n"
 	        "  -V, --version            Print version information and exit.\n");
@@ -4882,6 +4891,26 @@ static void maybe_create_resource_directories()
 #endif
 }
 
+// Benchmark mode runs headless; the SDL 'dummy' drivers don't open a window
+// or an audio device, and don't pace the emulation in any way.
+static void set_up_benchmark_mode(const CommandLineArguments& arguments)
+{
+	assert(arguments.benchmark);
+
+	const auto duration_ms = *arguments.benchmark;
+	if (duration_ms <= 0) {
+		LOG_WARNING("BENCHMARK: Invalid duration %d ms, benchmark mode disabled",
+		            duration_ms);
+		return;
+	}
+
+	constexpr int Overwrite = 0;
+	SDL_setenv("SDL_VIDEODRIVER", "dummy", Overwrite);
+	SDL_setenv("SDL_AUDIODRIVER", "dummy", Overwrite);
+
+	BENCHMARK_Start(duration_ms, arguments.benchmark_output);
+}
+
 int sdl_main(int argc, char* argv[])
 {
 	// Ensure we perform SDL cleanup and restore console settings
@@ -5004,12 +5033,21 @@ int sdl_main(int argc, char* argv[])
 		SetConsoleCtrlHandler((PHANDLER_ROUTINE)console_event_handler, TRUE);
 #endif
 
+		if (arguments->benchmark) {
+			set_up_benchmark_mode(*arguments);
+		}
+
 		init_sdl();
 
 		// Handle configuration settings passed with `--set` commands
 		// from the CLI.
 		handle_cli_set_commands(arguments->set);
 
+		if (BENCHMARK_IsActive()) {
+			// Benchmark results must not depend on the audio device
+			set_section_property_value("mixer", "nosound", "on");
+		}
+
 		maybe_create_resource_directories();
 
 		control->ParseEnv();
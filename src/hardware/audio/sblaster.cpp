@@ -980,11 +980,43 @@ static constexpr float to_float(T sample)
 	return 0.0f;
 }
 
+// Converts a run of source samples into AudioFrames. The loops are kept free
+// of per-sample branches so they can be unrolled and vectorised.
+template <FrameType frame_type, typename T>
+static void convert_samples(const T* samples, const size_t num_frames,
+                            AudioFrame* frames)
+{
+	if constexpr (frame_type == FrameType::Mono) {
+		for (size_t i = 0; i < num_frames; ++i) {
+			const float sample = to_float(samples[i]);
+			frames[i]          = {sample, sample};
+		}
+	} else {
+		// The Sound Blaster Pro cards have their stereo channels
+		// reversed
+		const auto is_reversed = (sb.type == SbType::SBPro1 ||
+		                          sb.type == SbType::SBPro2);
+
+		const size_t left_offset  = is_reversed ? 1 : 0;
+		const size_t right_offset = is_reversed ? 0 : 1;
+
+		for (size_t i = 0; i < num_frames; ++i) {
+			frames[i] = {to_float(samples[i * 2 + left_offset]),
+			             to_float(samples[i * 2 + right_offset])};
+		}
+	}
+}
+
 // Returns a vector of AudioFrames from the source samples. If the Sound Blaster
 // is still warming up or the speaker's off, then the frames will be silent.
+//
+// Each call counts as one millisecond step of the warm-up period, unless
+// 'frames_per_warmup_step' is given; the batched ADPCM decoder uses it to keep
+// counting the warm-up once per decoded DMA byte, as it always has.
 template <FrameType frame_type, typename T>
 static std::vector<AudioFrame>& maybe_silence(const T* samples,
-                                              const uint32_t num_samples)
+                                              const uint32_t num_samples,
+                                              const uint32_t frames_per_warmup_step = 0)
 {
 	assert(samples);
 	assert(num_samples > 0);
@@ -995,32 +1027,38 @@ static std::vector<AudioFrame>& maybe_silence(const T* samples,
 
 	static std::vector<AudioFrame> frames = {};
 	frames.clear();
-	frames.reserve(num_frames);
+	frames.resize(num_frames);
 
-	// Return silent frames if still in warmup
+	// Silence the frames covered by the remaining warmup
+	size_t num_silent_frames = 0;
 	if (sb.dsp.warmup_remaining_ms > 0) {
-		frames.resize(num_frames);
-		--sb.dsp.warmup_remaining_ms;
-		return frames;
-	} else if (!sb.speaker_enabled) {
-		frames.resize(num_frames);
-		return frames;
-	}
-	// Process samples into AudioFrames
-	for (size_t i = 0; i < num_frames; ++i) {
-		const float left = to_float(samples[i * SamplesPerFrame]);
-
-		const float right = (frame_type == FrameType::Mono)
-		                          ? left
-		                          : to_float(samples[i * 2 + 1]);
-
-		if (sb.type == SbType::SBPro1 || sb.type == SbType::SBPro2) {
-			frames.emplace_back(right, left);
+		if (frames_per_warmup_step == 0) {
+			--sb.dsp.warmup_remaining_ms;
+			num_silent_frames = num_frames;
 		} else {
-			frames.emplace_back(left, right);
+			const auto num_steps = ceil_udivide(num_frames,
+			                                    frames_per_warmup_step);
+			const auto num_silent_steps = std::min(
+			        num_steps,
+			        static_cast<size_t>(sb.dsp.warmup_remaining_ms));
+
+			sb.dsp.warmup_remaining_ms -= static_cast<int>(num_silent_steps);
+			num_silent_frames = std::min(num_frames,
+			                             num_silent_steps *
+			                                     frames_per_warmup_step);
 		}
 	}
 
+	// Frames past the warmup are still silent while the speaker's off
+	if (!sb.speaker_enabled) {
+		num_silent_frames = num_frames;
+	}
+
+	// Process the rest of the samples into AudioFrames
+	convert_samples<frame_type>(samples + num_silent_frames * SamplesPerFrame,
+	                            num_frames - num_silent_frames,
+	                            frames.data() + num_silent_frames);
+
 	return frames;
 }
 
@@ -1128,8 +1166,6 @@ static void play_dma_transfer(const uint32_t bytes_requested)
 	auto decode_adpcm_dma =
 	        [&](auto decode_adpcm_fn) -> std::tuple<uint32_t, uint32_t, uint16_t> {
 		const uint32_t num_bytes = read_dma_8bit(bytes_to_read);
-		uint32_t num_samples     = 0;
-		uint16_t num_frames      = 0;
 
 		// Parse the reference ADPCM byte, if provided
 		uint32_t i = 0;
@@ -1139,19 +1175,31 @@ static void play_dma_transfer(const uint32_t bytes_requested)
 			sb.adpcm.stepsize  = MinAdaptiveStepSize;
 			++i;
 		}
+
 		// Decode the remaining DMA buffer into samples using the
-		// provided function
+		// provided function, then convert and enqueue the whole run
+		// at once
+		constexpr auto NumDecoded = check_cast<uint32_t>(
+		        std::tuple_size_v<decltype(decode_adpcm_fn(uint8_t{}))>);
+
+		static std::vector<uint8_t> decoded_samples = {};
+		decoded_samples.resize((num_bytes - i) * NumDecoded);
+
+		auto out = decoded_samples.begin();
 		while (i < num_bytes) {
 			const auto decoded = decode_adpcm_fn(sb.dma.buf.b8[i]);
-			constexpr auto NumDecoded = check_cast<uint8_t>(
-			        decoded.size());
-
-			enqueue_frames(maybe_silence<FrameType::Mono>(decoded.data(), NumDecoded));
-			num_samples += NumDecoded;
+			out = std::copy(decoded.begin(), decoded.end(), out);
 			i++;
 		}
+
+		const auto num_samples = check_cast<uint32_t>(decoded_samples.size());
+		if (num_samples > 0) {
+			enqueue_frames(maybe_silence<FrameType::Mono>(
+			        decoded_samples.data(), num_samples, NumDecoded));
+		}
+
 		// ADPCM is mono
-		num_frames = check_cast<uint16_t>(num_samples);
+		const auto num_frames = check_cast<uint16_t>(num_samples);
 		return {num_bytes, num_samples, num_frames};
 	};
 
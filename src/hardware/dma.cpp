@@ -76,18 +76,19 @@ static void perform_dma_io(const DmaDirection direction, const PhysPt spage,
 		// Determine how many bytes to transfer within this page
 		const auto chunk_bytes = std::min(remaining_bytes, bytes_to_page_end);
 
+		// The chunk never crosses a page boundary and physical memory is
+		// one contiguous host block, so the whole chunk can be copied
+		// directly instead of byte-by-byte through phys_readb/writeb.
+		const auto host_pt = MemBase + chunk_start;
+
 		// Copy the data from the page address into the data pointer
 		if (direction == DmaDirection::Read) {
-			for (auto i = 0; i < chunk_bytes; ++i) {
-				data_pt[i] = phys_readb(chunk_start + i);
-			}
+			std::memcpy(data_pt, host_pt, chunk_bytes);
 		}
 
 		// Copy the data from the data pointer into the page address
 		else if (direction == DmaDirection::Write) {
-			for (auto i = 0; i < chunk_bytes; ++i) {
-				phys_writeb(chunk_start + i, data_pt[i]);
-			}
+			std::memcpy(host_pt, data_pt, chunk_bytes);
 		}
 
 		mem_address += chunk_bytes;
@@ -12,6 +12,8 @@
 #include "cpu/cpu.h"
 #include "cpu/lazyflags.h"
 #include "hardware/port.h"
+#include "misc/perf_counters.h"
+#include "misc/profiler.h"
 
 
 //#define ENABLE_PORTLOG
@@ -151,6 +153,8 @@ void log_io(io_width_t width, bool write, io_port_t port, io_val_t val)
 void IO_WriteB(io_port_t port, uint8_t val)
 {
 	log_io(io_width_t::byte, true, port, val);
+	PROFILER_NoteIoPort(port);
+	PERF_CountIoAccess(port);
 	if (GETFLAG(VM) && (CPU_IO_Exception(port, 1))) {
 		const auto old_lflags = lflags;
 		const auto old_cpudecoder=cpudecoder;
@@ -185,6 +189,8 @@ void IO_WriteB(io_port_t port, uint8_t val)
 void IO_WriteW(io_port_t port, uint16_t val)
 {
 	log_io(io_width_t::word, true, port, val);
+	PROFILER_NoteIoPort(port);
+	PERF_CountIoAccess(port);
 	if (GETFLAG(VM) && (CPU_IO_Exception(port, 2))) {
 		const auto old_lflags = lflags;
 		const auto old_cpudecoder=cpudecoder;
@@ -219,6 +225,8 @@ void IO_WriteW(io_port_t port, uint16_t val)
 void IO_WriteD(io_port_t port, uint32_t val)
 {
 	log_io(io_width_t::dword, true, port, val);
+	PROFILER_NoteIoPort(port);
+	PERF_CountIoAccess(port);
 	if (GETFLAG(VM) && (CPU_IO_Exception(port, 4))) {
 		const auto old_lflags = lflags;
 		const auto old_cpudecoder=cpudecoder;
@@ -252,6 +260,8 @@ void IO_WriteD(io_port_t port, uint32_t val)
 uint8_t IO_ReadB(io_port_t port)
 {
 	uint8_t retval;
+	PROFILER_NoteIoPort(port);
+	PERF_CountIoAccess(port);
 	if (GETFLAG(VM) && (CPU_IO_Exception(port, 1))) {
 		const auto old_lflags = lflags;
 		const auto old_cpudecoder=cpudecoder;
@@ -289,6 +299,8 @@ uint8_t IO_ReadB(io_port_t port)
 uint16_t IO_ReadW(io_port_t port)
 {
 	uint16_t retval;
+	PROFILER_NoteIoPort(port);
+	PERF_CountIoAccess(port);
 	if (GETFLAG(VM) && (CPU_IO_Exception(port, 2))) {
 		const auto old_lflags = lflags;
 		const auto old_cpudecoder=cpudecoder;
@@ -325,6 +337,8 @@ uint16_t IO_ReadW(io_port_t port)
 uint32_t IO_ReadD(io_port_t port)
 {
 	uint32_t retval;
+	PROFILER_NoteIoPort(port);
+	PERF_CountIoAccess(port);
 	if (GETFLAG(VM) && (CPU_IO_Exception(port, 4))) {
 		const auto old_lflags = lflags;
 		const auto old_cpudecoder=cpudecoder;
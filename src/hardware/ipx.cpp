@@ -6,10 +6,12 @@
 
 #if C_IPX
 
+#include <algorithm>
 #include <cinttypes>
 #include <cstdio>
 #include <cstring>
 #include <ctime>
+#include <memory>
 
 #include <SDL_net.h>
 
@@ -25,6 +27,7 @@
 #include "hardware/memory.h"
 #include "hardware/pic.h"
 #include "hardware/port.h"
+#include "hardware/socket_reactor.h"
 #include "hardware/timer.h"
 #include "misc/cross.h"
 #include "utils/string_utils.h"
@@ -592,24 +595,83 @@ static void receivePacket(uint8_t *buffer, int16_t bufSize) {
 	LOG_IPX("IPX: RX Packet loss!");
 }
 
-static void IPX_ClientLoop(void) {
-	int numrecv;
+// Receives the packets from the server on the socket reactor's network
+// thread, so the client loop only runs while packets are waiting. Without
+// the reactor, the client loop polls the socket on every tick.
+static std::unique_ptr<ReactorSocket> ipxClientReactorSocket;
+static bool isClientLoopRunning = false;
+static bool isPinging = false;
+
+static bool receiveFromServer(UDPpacket &packet) {
+	if (!ipxClientReactorSocket)
+		return SDLNet_UDP_Recv(ipxClientSocket, &packet) != 0;
+
+	const auto received = ipxClientReactorSocket->ReceivePacket();
+	if (!received)
+		return false;
+
+	const auto len = std::min(received->data.size(),
+	                          static_cast<size_t>(packet.maxlen));
+	memcpy(packet.data, received->data.data(), len);
+	packet.len = static_cast<int>(len);
+	packet.address.host = received->host;
+	packet.address.port = received->port;
+	return true;
+}
+
+static void IPX_ClientLoop(void);
+
+static void startClientLoop() {
+	if (!isClientLoopRunning) {
+		TIMER_AddTickHandler(&IPX_ClientLoop);
+		isClientLoopRunning = true;
+	}
+}
+
+static void stopClientLoop() {
+	if (isClientLoopRunning) {
+		TIMER_DelTickHandler(&IPX_ClientLoop);
+		isClientLoopRunning = false;
+	}
+}
+
+static bool receiveOnePacket() {
 	UDPpacket inPacket;
 	inPacket.data = (Uint8 *)recvBuffer;
 	inPacket.maxlen = IPXBUFFERSIZE;
 	inPacket.channel = UDPChannel;
 
 	// Its amazing how much simpler UDP is than TCP
-	numrecv = SDLNet_UDP_Recv(ipxClientSocket, &inPacket);
-	if(numrecv) receivePacket(inPacket.data, inPacket.len);
+	if (!receiveFromServer(inPacket))
+		return false;
+
+	receivePacket(inPacket.data, inPacket.len);
+	return true;
+}
+
+static void IPX_ClientLoop(void) {
+	// Wait for the reactor to signal the next packets
+	if (!receiveOnePacket() && ipxClientReactorSocket)
+		stopClientLoop();
 }
 
+// Called by the socket reactor when packets from the server are waiting
+static void onServerPacketsReady() {
+	// The ping command collects the replies itself
+	if (isPinging)
+		return;
+
+	// Deliver one packet per tick as before, starting right away
+	startClientLoop();
+	receiveOnePacket();
+}
 
 void DisconnectFromServer(bool unexpected) {
 	if(unexpected) LOG_MSG("IPX: Server disconnected unexpectedly");
 	if(incomingPacket.connected) {
 		incomingPacket.connected = false;
-		TIMER_DelTickHandler(&IPX_ClientLoop);
+		stopClientLoop();
+		ipxClientReactorSocket.reset();
 		SDLNet_UDP_Close(ipxClientSocket);
 	}
 }
@@ -732,8 +794,7 @@ static bool pingCheck(IPXHeader * outHeader) {
 	regPacket.channel = UDPChannel;
 	regHeader = (IPXHeader *)buffer;
 
-	const int result = SDLNet_UDP_Recv(ipxClientSocket, &regPacket);
-	if (result != 0) {
+	if (receiveFromServer(regPacket)) {
 		memcpy(outHeader, regHeader, sizeof(IPXHeader));
 		return true;
 	}
@@ -811,7 +872,15 @@ bool ConnectToServer(const char* strAddr)
 				LOG_MSG("IPX: Connected to server.  IPX address is %d:%d:%d:%d:%d:%d", CONVIPX(localIpxAddr.netnode));
 
 				incomingPacket.connected = true;
-				TIMER_AddTickHandler(&IPX_ClientLoop);
+
+				ipxClientReactorSocket = std::make_unique<ReactorSocket>(
+				        get_native_socket(ipxClientSocket),
+				        ReactorSocketType::Datagram,
+				        onServerPacketsReady);
+				if (!ipxClientReactorSocket->IsWatched())
+					ipxClientReactorSocket.reset();
+
+				startClientLoop();
 				return true;
 			}
 		} else {
@@ -1030,7 +1099,8 @@ public:
 					WriteOut("IPX Tunneling Client not connected.\n");
 					return;
 				}
-				TIMER_DelTickHandler(&IPX_ClientLoop);
+				isPinging = true;
+				stopClientLoop();
 				WriteOut("Sending broadcast ping:\n\n");
 				pingSend();
 				const auto ticks = GetTicks();
@@ -1044,7 +1114,8 @@ public:
 						        GetTicksSince(ticks));
 					}
 				}
-				TIMER_AddTickHandler(&IPX_ClientLoop);
+				isPinging = false;
+				startClientLoop();
 				return;
 			}
 		}
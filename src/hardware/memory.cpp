@@ -4,7 +4,9 @@
 
 #include "memory.h"
 
+#include <algorithm>
 #include <cstring>
+#include <unordered_map>
 
 #include "config/setup.h"
 #include "cpu/paging.h"
@@ -24,6 +26,13 @@ constexpr auto SafeMegabytesDos   = 31;
 constexpr auto SafeMegabytesWin95 = 480;
 constexpr auto SafeMegabytesWin98 = 512;
 
+// A run of physically contiguous pages in a page chain
+struct MemExtent {
+	uint32_t first_index = 0; // position of the first page in the chain
+	MemHandle first_page = 0;
+	uint32_t num_pages   = 0;
+};
+
 static struct MemoryBlock {
 	struct page_t {
 		uint8_t bytes[DosPageSize] = {};
@@ -31,6 +40,11 @@ static struct MemoryBlock {
 	std::vector<page_t> pages           = {};
 	std::vector<PageHandler*> phandlers = {};
 	std::vector<MemHandle> mhandles     = {};
+
+	// Extent lists of the page chains, keyed by their first page; built on
+	// demand and dropped when the chain is resized or released
+	std::unordered_map<MemHandle, std::vector<MemExtent>> extents = {};
+
 	struct {
 		Bitu start_page = 0;
 		Bitu end_page   = 0;
@@ -195,18 +209,60 @@ void mem_memcpy(PhysPt dest,PhysPt src,Bitu size) {
 	while (size--) mem_writeb_inline(dest++,mem_readb_inline(src++));
 }
 
+// Bytes left in the page of the address
+static inline Bitu bytes_to_page_end(const PhysPt address)
+{
+	return MemPageSize - (address & (MemPageSize - 1));
+}
+
+// Bytes from the start of the page up to and including the address
+static inline Bitu bytes_from_page_start(const PhysPt address)
+{
+	return (address & (MemPageSize - 1)) + 1;
+}
+
+// The block functions below work a page at a time: spans in pages the TLB
+// links directly to host memory are copied with memcpy/memmove, everything
+// else goes through the page handlers byte by byte. Unlinked pages get
+// linked by their first byte access, so the rest of the page is fast again.
+
 void MEM_BlockRead(PhysPt pt,void * data,Bitu size) {
 	uint8_t * write=reinterpret_cast<uint8_t *>(data);
-	while (size--) {
-		*write++=mem_readb_inline(pt++);
+	while (size) {
+		const auto host = get_tlb_read(pt);
+		if (!host) {
+			*write++ = mem_readb_inline(pt++);
+			--size;
+			continue;
+		}
+		const auto len = std::min(size, bytes_to_page_end(pt));
+		memcpy(write, host + pt, len);
+		write += len;
+		pt += static_cast<PhysPt>(len);
+		size -= len;
 	}
 }
 
 void MEM_BlockWrite(PhysPt pt, const void *data, size_t size)
 {
 	const uint8_t *read = static_cast<const uint8_t *>(data);
-	while (size--) {
-		mem_writeb_inline(pt++,*read++);
+	while (size) {
+		const auto host = get_tlb_write(pt);
+		const auto len  = std::min<size_t>(size, bytes_to_page_end(pt));
+		if (!host) {
+			const auto handler = get_slow_path_writehandler(pt);
+			if (!(handler->flags & PFLAG_BLOCKWRITE)) {
+				handler->writeb(pt++, *read++);
+				--size;
+				continue;
+			}
+			handler->writeblock(pt, read, len, 1);
+		} else {
+			memcpy(host + pt, read, len);
+		}
+		read += len;
+		pt += static_cast<PhysPt>(len);
+		size -= len;
 	}
 }
 
@@ -214,6 +270,76 @@ void MEM_BlockCopy(PhysPt dest,PhysPt src,Bitu size) {
 	mem_memcpy(dest,src,size);
 }
 
+void MEM_BlockMove(PhysPt dest, PhysPt src, Bitu size)
+{
+	if (dest == src || !size) {
+		return;
+	}
+	if (dest < src || dest >= src + size) {
+		// Forwards, also fine for an overlapping destination below the
+		// source
+		while (size) {
+			const auto host_src  = get_tlb_read(src);
+			const auto host_dest = get_tlb_write(dest);
+			if (!host_src || !host_dest) {
+				mem_writeb_inline(dest++, mem_readb_inline(src++));
+				--size;
+				continue;
+			}
+			const auto len = std::min({size,
+			                           bytes_to_page_end(src),
+			                           bytes_to_page_end(dest)});
+			memmove(host_dest + dest, host_src + src, len);
+			src += static_cast<PhysPt>(len);
+			dest += static_cast<PhysPt>(len);
+			size -= len;
+		}
+		return;
+	}
+	// Backwards from the end, the destination overlaps the end of the
+	// source
+	auto src_end  = static_cast<PhysPt>(src + size);
+	auto dest_end = static_cast<PhysPt>(dest + size);
+	while (size) {
+		const auto host_src  = get_tlb_read(src_end - 1);
+		const auto host_dest = get_tlb_write(dest_end - 1);
+		if (!host_src || !host_dest) {
+			mem_writeb_inline(--dest_end, mem_readb_inline(--src_end));
+			--size;
+			continue;
+		}
+		const auto len = std::min({size,
+		                           bytes_from_page_start(src_end - 1),
+		                           bytes_from_page_start(dest_end - 1)});
+		src_end -= static_cast<PhysPt>(len);
+		dest_end -= static_cast<PhysPt>(len);
+		memmove(host_dest + dest_end, host_src + src_end, len);
+		size -= len;
+	}
+}
+
+void MEM_BlockExchange(PhysPt a, PhysPt b, Bitu size)
+{
+	while (size) {
+		// Both sides are read and written, so they need to be plain RAM
+		const auto host_a = get_tlb_write(a);
+		const auto host_b = get_tlb_write(b);
+		if (!host_a || !host_b || host_a != get_tlb_read(a) ||
+		    host_b != get_tlb_read(b)) {
+			const auto val = mem_readb_inline(a);
+			mem_writeb_inline(a++, mem_readb_inline(b));
+			mem_writeb_inline(b++, val);
+			--size;
+			continue;
+		}
+		const auto len = std::min({size, bytes_to_page_end(a), bytes_to_page_end(b)});
+		std::swap_ranges(host_a + a, host_a + a + len, host_b + b);
+		a += static_cast<PhysPt>(len);
+		b += static_cast<PhysPt>(len);
+		size -= len;
+	}
+}
+
 void MEM_StrCopy(PhysPt pt,char * data,Bitu size) {
 	while (size--) {
 		uint8_t r=mem_readb_inline(pt++);
@@ -259,15 +385,67 @@ uint32_t MEM_FreeTotal()
 	return free;
 }
 
+static const std::vector<MemExtent>& get_extents(const MemHandle handle)
+{
+	auto& extents = memory.extents[handle];
+	if (extents.empty()) {
+		uint32_t index = 0;
+		for (auto page = handle; page > 0; page = memory.mhandles[page]) {
+			if (!extents.empty() &&
+			    extents.back().first_page +
+			                    static_cast<MemHandle>(extents.back().num_pages) ==
+			            page) {
+				++extents.back().num_pages;
+			} else {
+				extents.push_back({index, page, 1});
+			}
+			++index;
+		}
+	}
+	return extents;
+}
+
+// The page chains changed, the extents are rebuilt the next time they are
+// needed
+static void invalidate_extents()
+{
+	memory.extents.clear();
+}
+
+MemPageRun MEM_GetPageRun(const MemHandle handle, const Bitu index)
+{
+	if (handle <= 0) {
+		return {-1, 0};
+	}
+	const auto& extents = get_extents(handle);
+
+	// The last extent starting at or before the index
+	auto extent = std::upper_bound(extents.begin(),
+	                               extents.end(),
+	                               index,
+	                               [](const Bitu i, const MemExtent& e) {
+		                               return i < e.first_index;
+	                               });
+	if (extent == extents.begin()) {
+		return {-1, 0};
+	}
+	--extent;
+
+	const auto offset = static_cast<uint32_t>(index - extent->first_index);
+	if (offset >= extent->num_pages) {
+		return {-1, 0};
+	}
+	return {extent->first_page + static_cast<MemHandle>(offset),
+	        extent->num_pages - offset};
+}
+
 uint32_t MEM_AllocatedPages(MemHandle handle) 
 {
-	uint32_t pages = 0;
-	while (handle > 0) {
-		++pages;
-		assert(pages != 0);
-		handle = memory.mhandles[handle];
+	if (handle <= 0) {
+		return 0;
 	}
-	return pages;
+	const auto& extents = get_extents(handle);
+	return extents.back().first_index + extents.back().num_pages;
 }
 
 //TODO Maybe some protection for this whole allocation scheme
@@ -343,6 +521,7 @@ MemHandle MEM_GetNextFreePage(void) {
 }
 
 void MEM_ReleasePages(MemHandle handle) {
+	invalidate_extents();
 	while (handle>0) {
 		MemHandle next=memory.mhandles[handle];
 		memory.mhandles[handle]=0;
@@ -351,6 +530,7 @@ void MEM_ReleasePages(MemHandle handle) {
 }
 
 bool MEM_ReAllocatePages(MemHandle & handle,Bitu pages,bool sequence) {
+	invalidate_extents();
 	if (handle<=0) {
 		if (!pages) return true;
 		handle=MEM_AllocatePages(pages,sequence);
@@ -430,11 +610,10 @@ MemHandle MEM_NextHandle(MemHandle handle) {
 }
 
 MemHandle MEM_NextHandleAt(MemHandle handle,Bitu where) {
-	while (where) {
-		where--;	
-		handle=memory.mhandles[handle];
+	if (!where) {
+		return handle;
 	}
-	return handle;
+	return MEM_GetPageRun(handle, where).page;
 }
 
 
@@ -737,6 +916,7 @@ public:
 		// memory-allocation
 		memory.mhandles.clear();
 		memory.mhandles.resize(num_pages, 0);
+		invalidate_extents();
 
 		using page_range_t = std::pair<uint16_t, uint16_t>;
 		auto install_rom_page_handlers = [&](const page_range_t& page_range) {
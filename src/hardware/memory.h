@@ -61,6 +61,15 @@ void MEM_PreparePCJRCartRom();
 MemHandle MEM_NextHandle(MemHandle handle);
 MemHandle MEM_NextHandleAt(MemHandle handle, Bitu where);
 
+// The page at the given position of a handle's page chain and the number of
+// physically contiguous pages starting with it; the page is -1 when the
+// position is past the end of the chain
+struct MemPageRun {
+	MemHandle page     = -1;
+	uint32_t num_pages = 0;
+};
+MemPageRun MEM_GetPageRun(const MemHandle handle, const Bitu index);
+
 static inline void var_write(uint8_t *var, uint8_t val)
 {
 	host_writeb(var, val);
@@ -174,6 +183,9 @@ static inline uint64_t phys_readq(PhysPt addr)
 void MEM_BlockWrite(PhysPt pt, const void *data, size_t size);
 void MEM_BlockRead(PhysPt pt, void *data, Bitu size);
 void MEM_BlockCopy(PhysPt dest, PhysPt src, Bitu size);
+// Like memmove(), overlapping blocks are handled
+void MEM_BlockMove(PhysPt dest, PhysPt src, Bitu size);
+void MEM_BlockExchange(PhysPt a, PhysPt b, Bitu size);
 void MEM_StrCopy(PhysPt pt, char *data, Bitu size);
 
 void mem_memcpy(PhysPt dest, PhysPt src, Bitu size);
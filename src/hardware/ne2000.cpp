@@ -1410,6 +1410,8 @@ static void NE2000_TX_Event([[maybe_unused]] uint32_t val)
 	theNE2kDevice->tx_timer();
 }
 
+// Runs every emulated millisecond; only passes on the packets the Ethernet
+// backend has already received, the host sockets are polled elsewhere
 static void NE2000_Poller(void) {
 	ethernet->GetPackets([](const uint8_t *packet, int len) {
 		//LOG_MSG("NE2000: Received %d bytes", header->len);
@@ -9,6 +9,7 @@
 #include "hardware/pic.h"
 #include "hardware/port.h"
 #include "hardware/timer.h"
+#include "misc/perf_counters.h"
 
 // PIC Controllers
 // ~~~~~~~~~~~~~~~
@@ -546,6 +547,7 @@ bool PIC_RunQueue(void) {
 
 		srv_lag = entry->index;
 		(entry->pic_event)(entry->value); // call the event handler
+		++perf_counters.pic_events;
 
 		/* Put the entry in the free list */
 		entry->next=pic_queue.free_entry;
@@ -603,6 +605,11 @@ void TIMER_AddTickHandler(TIMER_TickHandler handler) {
 }
 
 void TIMER_AddTick(void) {
+	/* Account the cycles executed during the finished tick */
+	static int64_t tick_cycle_budget = 0;
+	PERF_AddTick(tick_cycle_budget - (CPU_CycleLeft + CPU_Cycles));
+	tick_cycle_budget = CPU_CycleMax;
+
 	/* Setup new amount of cycles for PIC */
 	CPU_CycleLeft=CPU_CycleMax;
 	CPU_Cycles=0;
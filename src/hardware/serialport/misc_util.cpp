@@ -606,6 +606,9 @@ TCPClientSocket::TCPClientSocket(const char *destination, uint16_t port)
 
 TCPClientSocket::~TCPClientSocket()
 {
+	// The reactor has to let go of the socket before it's closed
+	reactor_socket.reset();
+
 #ifdef NATIVESOCKETS
 	if (nativetcpstruct) { //-V809
 		delete nativetcpstruct;
@@ -643,6 +646,14 @@ bool TCPClientSocket::ReceiveArray(uint8_t *data, size_t &n)
 	assertm(n <= static_cast<size_t>(std::numeric_limits<int>::max()),
 	        "SDL_net can't handle more bytes at a time.");
 	assert(data);
+	if (reactor_socket) {
+		n = reactor_socket->ReceiveBytes(data, n);
+		if (n == 0 && reactor_socket->IsClosed()) {
+			isopen = false;
+			return false;
+		}
+		return true;
+	}
 	if (SDLNet_CheckSockets(listensocketset, 0)) {
 		const int result = SDLNet_TCP_Recv(mysock, data, static_cast<int>(n));
 		if(result < 1) {
@@ -661,6 +672,16 @@ bool TCPClientSocket::ReceiveArray(uint8_t *data, size_t &n)
 
 SocketState TCPClientSocket::GetcharNonBlock(uint8_t &val)
 {
+	if (reactor_socket) {
+		if (reactor_socket->ReceiveBytes(&val, 1) == 1)
+			return SocketState::Good;
+		if (reactor_socket->IsClosed()) {
+			isopen = false;
+			return SocketState::Closed;
+		}
+		return SocketState::Empty;
+	}
+
 	SocketState state = SocketState::Empty;
 	if(SDLNet_CheckSockets(listensocketset,0))
 	{
@@ -674,6 +695,21 @@ SocketState TCPClientSocket::GetcharNonBlock(uint8_t &val)
 	return state;
 }
 
+bool TCPClientSocket::WatchForData(std::function<void()> callback)
+{
+	if (!mysock)
+		return false;
+
+	reactor_socket = std::make_unique<ReactorSocket>(get_native_socket(mysock),
+	                                                 ReactorSocketType::Stream,
+	                                                 std::move(callback));
+	if (!reactor_socket->IsWatched()) {
+		reactor_socket.reset();
+		return false;
+	}
+	return true;
+}
+
 bool TCPClientSocket::Putchar(uint8_t val)
 {
 	return SendArray(&val, 1);
@@ -714,6 +750,9 @@ TCPServerSocket::TCPServerSocket(const uint16_t port)
 
 TCPServerSocket::~TCPServerSocket()
 {
+	// The reactor has to let go of the socket before it's closed
+	reactor_socket.reset();
+
 	if (mysock) {
 		SDLNet_TCP_Close(mysock);
 		LOG_INFO("SDLNET: closed server TCP listening socket");
@@ -733,4 +772,19 @@ NETClientSocket *TCPServerSocket::Accept()
 	return new TCPClientSocket(new_tcpsock);
 }
 
+bool TCPServerSocket::WatchForConnections(std::function<void()> callback)
+{
+	if (!mysock)
+		return false;
+
+	reactor_socket = std::make_unique<ReactorSocket>(get_native_socket(mysock),
+	                                                 ReactorSocketType::Listener,
+	                                                 std::move(callback));
+	if (!reactor_socket->IsWatched()) {
+		reactor_socket.reset();
+		return false;
+	}
+	return true;
+}
+
 #endif // C_MODEM
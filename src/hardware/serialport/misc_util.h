@@ -8,8 +8,11 @@
 
 #if C_MODEM
 
+#include <functional>
+#include <memory>
 #include <vector>
 
+#include "hardware/socket_reactor.h"
 #include "misc/support.h"
 
 #if defined WIN32
@@ -90,6 +93,14 @@ public:
 	virtual bool ReceiveArray(uint8_t *data, size_t &n) = 0;
 	virtual bool GetRemoteAddressString(char *buffer) = 0;
 
+	// Asks the socket reactor to call back (on the emulation thread) when
+	// data arrives or the connection closes. Returns false if the socket
+	// type doesn't support it, then the caller has to keep polling.
+	virtual bool WatchForData(std::function<void()> /*callback*/)
+	{
+		return false;
+	}
+
 	void FlushBuffer();
 	void SetSendBufferSize(size_t n);
 	bool SendByteBuffered(uint8_t val);
@@ -116,6 +127,14 @@ public:
 
 	virtual NETClientSocket *Accept() = 0;
 
+	// Asks the socket reactor to call back (on the emulation thread) when a
+	// connection is waiting to be accepted. Returns false if the socket type
+	// doesn't support it, then the caller has to keep polling.
+	virtual bool WatchForConnections(std::function<void()> /*callback*/)
+	{
+		return false;
+	}
+
 	bool isopen = false;
 };
 
@@ -194,6 +213,7 @@ public:
 	bool SendArray(const uint8_t *data, size_t n) override;
 	bool ReceiveArray(uint8_t *data, size_t &n) override;
 	bool GetRemoteAddressString(char *buffer) override;
+	bool WatchForData(std::function<void()> callback) override;
 
 private:
 
@@ -203,6 +223,9 @@ private:
 
 	TCPsocket mysock = nullptr;
 	SDLNet_SocketSet listensocketset = nullptr;
+
+	// Receives the data on the reactor's network thread, if watched
+	std::unique_ptr<ReactorSocket> reactor_socket = {};
 };
 
 class TCPServerSocket : public NETServerSocket {
@@ -216,6 +239,10 @@ public:
 	~TCPServerSocket() override;
 
 	NETClientSocket *Accept() override;
+	bool WatchForConnections(std::function<void()> callback) override;
+
+private:
+	std::unique_ptr<ReactorSocket> reactor_socket = {};
 };
 
 #endif // C_MODEM
@@ -6,6 +6,8 @@
 
 #if C_MODEM
 
+#include <algorithm>
+
 #include "shell/command_line.h"
 #include "config/config.h"
 #include "serialport.h"
@@ -160,28 +162,48 @@ void CNullModem::WriteChar(uint8_t data)
 	}
 }
 
-SocketState CNullModem::readChar(uint8_t &val)
+SocketState CNullModem::readChar(uint8_t &val, uint8_t &error)
 {
-	SocketState state = clientsocket->GetcharNonBlock(val);
-	if (state != SocketState::Good)
-		return state;
+	error = 0;
+
+	// Skip the telnet commands and line state changes until a data byte
+	// turns up. Sockets watched by the reactor only signal newly arrived
+	// data, so stopping at them could leave the data behind them unread.
+	while (true) {
+		SocketState state = clientsocket->GetcharNonBlock(val);
+		if (state != SocketState::Good)
+			return state;
 
-	if (telnet)
-		return TelnetEmulation(val);
+		if (telnet) {
+			if (TelnetEmulation(val) == SocketState::Empty)
+				continue; // no "payload" received
+			return SocketState::Good;
+		}
+		if (transparent)
+			return SocketState::Good;
 
-	if (val == 0xff && !transparent) { // escape char
-		// get the next character
-		state = clientsocket->GetcharNonBlock(val);
-		if (state != SocketState::Good || val == 0xff) // 0xff 0xff -> 0xff was meant
-			return state;
+		// The byte after the escape char can arrive with a later read
+		if (rx_escape) {
+			rx_escape = false;
+			if (val == 0xff) // 0xff 0xff -> 0xff was meant
+				return SocketState::Good;
 
-		setCTS(val & 0x1);
-		setDSR(val & 0x2);
-		if (val & 0x4)
-			receiveByteEx(0x0, 0x10);
-		return SocketState::Empty; // no "payload" received
+			setCTS(val & 0x1);
+			setDSR(val & 0x2);
+			if (val & 0x4) {
+				// a break is received like a byte
+				val   = 0x0;
+				error = 0x10;
+				return SocketState::Good;
+			}
+			continue; // no "payload" received
+		}
+		if (val == 0xff) { // escape char
+			rx_escape = true;
+			continue;
+		}
+		return SocketState::Good;
 	}
-	return SocketState::Good;
 }
 
 bool CNullModem::ClientConnect(NETClientSocket *newsocket)
@@ -196,13 +218,14 @@ bool CNullModem::ClientConnect(NETClientSocket *newsocket)
 		setCD(false);
 		return false;
 	}
-	clientsocket->SetSendBufferSize(256);
+	SetSendBufferSize();
 	clientsocket->GetRemoteAddressString(peernamebuf);
 	// transmit the line status
 	if (!transparent) setRTSDTR(getRTS(), getDTR());
 	rx_state=N_RX_IDLE;
+	rx_escape=false;
 	LOG_MSG("SERIAL: Port %" PRIu8 " connected to %s.", GetPortNumber(), peernamebuf);
-	setEvent(SERIAL_POLLING_EVENT, 1);
+	WatchClientSocket();
 	setCD(true);
 	return true;
 }
@@ -216,7 +239,7 @@ bool CNullModem::ServerListen() {
 	        GetPortNumber(),
 	        to_string(socketType),
 	        serverport);
-	setEvent(SERIAL_SERVER_POLLING_EVENT, 50);
+	WatchServerSocket();
 	setCD(false);
 	return true;
 }
@@ -234,13 +257,15 @@ bool CNullModem::ServerConnect() {
 	log_ser(dbg_aux, "SERIAL: Port %" PRIu8 " a client (%s) has connected.",
 	        GetPortNumber(), peeripbuf);
 #endif
-	clientsocket->SetSendBufferSize(256);
+	SetSendBufferSize();
 	rx_state=N_RX_IDLE;
-	setEvent(SERIAL_POLLING_EVENT, 1);
-	
+	rx_escape=false;
+	WatchClientSocket();
+
 	// we don't accept further connections
 	delete serversocket;
 	serversocket=nullptr;
+	server_watched = false;
 
 	// transmit the line status
 	setRTSDTR(getRTS(), getDTR());
@@ -255,6 +280,7 @@ void CNullModem::Disconnect() {
 	LOG_MSG("SERIAL: Port %" PRIu8 " disconnected.", GetPortNumber());
 	delete clientsocket;
 	clientsocket=nullptr;
+	rx_watched = false;
 	setDSR(false);
 	setCTS(false);
 	setCD(false);
@@ -263,21 +289,60 @@ void CNullModem::Disconnect() {
 		serversocket = NETServerSocket::NETServerFactory(socketType,
 		                                                 serverport);
 		if (serversocket->isopen)
-			setEvent(SERIAL_SERVER_POLLING_EVENT, 50);
-		else delete serversocket;
+			WatchServerSocket();
+		else {
+			delete serversocket;
+			serversocket = nullptr;
+		}
 	} else if (dtrrespect) {
 		setEvent(SERIAL_NULLMODEM_DTR_EVENT,50);
 		DTR_delta = getDTR(); // try to reconnect the next time DTR is set
 	}
 }
 
+// Makes room for everything the port can send at the maximum baud rate while
+// the transmit data is gathered (twice that with the 0xff escapes), so each
+// SERIAL_TX_REDUCTION flushes all of it with a single send
+void CNullModem::SetSendBufferSize()
+{
+	constexpr uint32_t BitsPerByte = 10; // including the start and stop bits
+	const auto max_gathered_bytes = tx_gather * SerialMaxBaudRate / BitsPerByte / 1000;
+	clientsocket->SetSendBufferSize(std::max<size_t>(256, 2 * max_gathered_bytes + 1));
+}
+
+// Lets the socket reactor tell us when data arrives if the socket supports
+// it, so an idle connection costs nothing; otherwise polls every millisecond
+void CNullModem::WatchClientSocket()
+{
+	rx_watched = clientsocket->WatchForData([this] { OnDataReady(); });
+	if (!rx_watched)
+		setEvent(SERIAL_POLLING_EVENT, 1);
+}
+
+void CNullModem::WatchServerSocket()
+{
+	server_watched = serversocket->WatchForConnections(
+	        [this] { setEvent(SERIAL_SERVER_POLLING_EVENT, 0.0f); });
+	if (!server_watched)
+		setEvent(SERIAL_SERVER_POLLING_EVENT, 50);
+}
+
+// Called by the socket reactor when data arrived or the connection closed
+void CNullModem::OnDataReady()
+{
+	// The pending receive events of a busy receiver pick up the new data
+	// by themselves, only an idle one needs to be woken up
+	if (rx_state == N_RX_IDLE) {
+		removeEvent(SERIAL_POLLING_EVENT);
+		setEvent(SERIAL_POLLING_EVENT, 0.0f);
+	}
+}
+
 void CNullModem::handleUpperEvent(uint16_t type)
 {
 	switch (type) {
 	case SERIAL_POLLING_EVENT: {
-		// periodically check if new data arrived, disconnect
-		// if required. Add it back.
-		setEvent(SERIAL_POLLING_EVENT, 1.0f);
+		// check if new data arrived, disconnect if required
 		// update Modem input line states
 		updateMSR();
 		switch (rx_state) {
@@ -336,6 +401,10 @@ void CNullModem::handleUpperEvent(uint16_t type)
 				case N_RX_FASTWAIT:
 					break;
 			}
+			// Keep polling unless the reactor tells us about new
+			// data; a blocked receiver still counts its retries
+			if (clientsocket && (!rx_watched || rx_state == N_RX_BLOCKED))
+				setEvent(SERIAL_POLLING_EVENT, 1.0f);
 			break;
 		}
 		case SERIAL_RX_EVENT: {
@@ -371,6 +440,9 @@ void CNullModem::handleUpperEvent(uint16_t type)
 							log_ser(dbg_aux,"Nullmodem: rx still blocked (retry=%d)",rx_retry);
 						else log_ser(dbg_aux,"Nullmodem: block on continued rx (retry=%d).",rx_retry);
 #endif
+						// the polling counts the retries while blocked
+						if (rx_watched && rx_state != N_RX_BLOCKED)
+							setEvent(SERIAL_POLLING_EVENT, 1.0f);
 						setEvent(SERIAL_RX_EVENT, bytetime*0.65f);
 						rx_state=N_RX_BLOCKED;
 					}
@@ -399,8 +471,8 @@ void CNullModem::handleUpperEvent(uint16_t type)
 		}
 		case SERIAL_SERVER_POLLING_EVENT: {
 			// As long as nothing is connected to our server poll the
-			// connection.
-			if (!ServerConnect()) {
+			// connection, unless the reactor tells us about it.
+			if (!ServerConnect() && !server_watched) {
 				// continue looking
 				setEvent(SERIAL_SERVER_POLLING_EVENT, 50);
 			}
@@ -441,9 +513,10 @@ void CNullModem::updateMSR () {
 
 bool CNullModem::doReceive () {
 	uint8_t val;
-	SocketState state = readChar(val);
+	uint8_t error;
+	SocketState state = readChar(val, error);
 	if (state == SocketState::Good) {
-		receiveByteEx(val, 0);
+		receiveByteEx(val, error);
 		return true;
 	}
 	if (state == SocketState::Closed) {
@@ -59,8 +59,17 @@ private:
 	bool ServerListen();
 	bool ServerConnect();
     void Disconnect();
-    SocketState readChar(uint8_t &val);
+    SocketState readChar(uint8_t &val, uint8_t &error);
     void WriteChar(uint8_t data);
+	void SetSendBufferSize();
+	void WatchClientSocket();
+	void WatchServerSocket();
+	void OnDataReady();
+
+	bool rx_watched = false; // the socket reactor tells us when data
+	                         // arrives, so there's no need to poll
+
+	bool server_watched = false; // same for incoming connections
 
 	bool DTR_delta = false; // with dtrrespect, we try to establish a
 	                        // connection whenever DTR switches to 1. This
@@ -85,6 +94,9 @@ private:
 
 	bool telnet = false; // Do Telnet parsing.
 
+	bool rx_escape = false; // received an 0xff escape char, the next byte
+	                        // says what it means
+
     // Telnet's brain
 #define TEL_CLIENT 0
 #define TEL_SERVER 1
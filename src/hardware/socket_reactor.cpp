@@ -0,0 +1,564 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "hardware/socket_reactor.h"
+
+#include "dosbox.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <unordered_map>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
+#include "hardware/timer.h"
+#include "misc/perf_counters.h"
+#include "misc/support.h"
+
+// Bytes a stream socket can have queued before the network thread stops
+// reading from it; TCP flow control throttles the peer in the meantime
+constexpr size_t MaxQueuedBytes = 64 * 1024;
+
+// Packets a datagram socket can have queued before the network thread stops
+// reading from it; the host drops the packets beyond its own buffer
+constexpr size_t MaxQueuedPackets = 256;
+
+constexpr size_t MaxPacketSize = 64 * 1024;
+
+#ifndef WIN32
+
+class SocketReactor {
+public:
+	SocketReactor();
+	~SocketReactor();
+
+	SocketReactor(const SocketReactor&)            = delete;
+	SocketReactor& operator=(const SocketReactor&) = delete;
+
+	bool IsRunning() const
+	{
+		return is_running;
+	}
+
+	bool IsEmpty() const
+	{
+		return sockets.empty();
+	}
+
+	bool IsRunningCallbacks() const
+	{
+		return is_running_callbacks;
+	}
+
+	// Emulation thread
+	uint64_t Add(ReactorSocket& socket);
+	void Remove(ReactorSocket& socket);
+	void Resume(ReactorSocket& socket);
+	void RunCallbacks();
+
+private:
+	void Run();
+	void Wait(std::vector<uint64_t>& ready_ids);
+	void Service(const uint64_t id);
+	bool ReadStream(ReactorSocket& socket);
+	bool ReadDatagrams(ReactorSocket& socket);
+	void Pause(ReactorSocket& socket);
+
+	bool Watch(ReactorSocket& socket);
+	void Unwatch(ReactorSocket& socket);
+	void Wake();
+	void DrainWakeups();
+
+	// Only the emulation thread adds and removes sockets, so it can look
+	// them up without taking the lock
+	std::mutex mutex = {};
+	std::unordered_map<uint64_t, ReactorSocket*> sockets = {};
+	uint64_t last_id = 0;
+
+	std::atomic<bool> has_ready_sockets = false;
+	std::vector<uint64_t> ready_ids     = {};
+	bool is_running_callbacks           = false;
+
+	// Wakes the network thread up to stop, or to rebuild its poll() set.
+	// Zero is never a socket ID, so it stands for the pipe in the waits.
+	int wake_pipe[2] = {-1, -1};
+
+#ifdef __linux__
+	int epoll_fd = -1;
+#else
+	std::vector<pollfd> poll_fds   = {};
+	std::vector<uint64_t> poll_ids = {};
+#endif
+
+	std::vector<uint8_t> receive_buffer = {};
+
+	std::atomic<bool> is_running = false;
+	std::thread network_thread   = {};
+};
+
+static std::unique_ptr<SocketReactor> reactor = {};
+
+static void count_syscall()
+{
+	perf_counters.socket_reactor_syscalls.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void socket_reactor_tick()
+{
+	assert(reactor);
+	reactor->RunCallbacks();
+
+	// The callbacks could have destroyed the last socket
+	if (reactor->IsEmpty()) {
+		reactor.reset();
+	}
+}
+
+SocketReactor::SocketReactor()
+{
+	if (pipe(wake_pipe) != 0) {
+		LOG_WARNING("SOCKETS: Failed to create the reactor's wake-up pipe: %s",
+		            strerror(errno));
+		return;
+	}
+	for (const auto fd : wake_pipe) {
+		fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+	}
+
+#ifdef __linux__
+	epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (epoll_fd < 0) {
+		LOG_WARNING("SOCKETS: Failed to create the reactor's epoll instance: %s",
+		            strerror(errno));
+		return;
+	}
+	epoll_event event = {};
+	event.events      = EPOLLIN;
+	event.data.u64    = 0;
+	epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_pipe[0], &event);
+#endif
+
+	receive_buffer.resize(MaxPacketSize);
+
+	is_running     = true;
+	network_thread = std::thread(&SocketReactor::Run, this);
+	set_thread_name(network_thread, "dosbox:sockets");
+
+	TIMER_AddTickHandler(&socket_reactor_tick);
+}
+
+SocketReactor::~SocketReactor()
+{
+	if (is_running) {
+		TIMER_DelTickHandler(&socket_reactor_tick);
+
+		is_running = false;
+		Wake();
+		network_thread.join();
+	}
+#ifdef __linux__
+	if (epoll_fd >= 0) {
+		close(epoll_fd);
+	}
+#endif
+	for (const auto fd : wake_pipe) {
+		if (fd >= 0) {
+			close(fd);
+		}
+	}
+}
+
+uint64_t SocketReactor::Add(ReactorSocket& socket)
+{
+	const std::lock_guard lock(mutex);
+
+	socket.id = ++last_id;
+	if (!Watch(socket)) {
+		socket.id = 0;
+		return 0;
+	}
+	sockets[socket.id] = &socket;
+	return socket.id;
+}
+
+void SocketReactor::Remove(ReactorSocket& socket)
+{
+	// Waits for the network thread to finish reading from the socket
+	const std::lock_guard lock(mutex);
+
+	Unwatch(socket);
+	sockets.erase(socket.id);
+}
+
+void SocketReactor::Resume(ReactorSocket& socket)
+{
+	const std::lock_guard lock(mutex);
+
+	if (socket.is_paused.exchange(false)) {
+		Watch(socket);
+	}
+}
+
+void SocketReactor::RunCallbacks()
+{
+	if (!has_ready_sockets.exchange(false)) {
+		return;
+	}
+
+	ready_ids.clear();
+	for (const auto& [id, socket] : sockets) {
+		if (socket->is_ready.exchange(false)) {
+			ready_ids.push_back(id);
+		}
+	}
+
+	// The callbacks may destroy any socket, including their own
+	is_running_callbacks = true;
+	for (const auto id : ready_ids) {
+		auto it = sockets.find(id);
+		if (it == sockets.end()) {
+			continue;
+		}
+		const auto on_ready = it->second->on_ready;
+		on_ready();
+
+		// Listeners stay paused until the pending connection was accepted
+		it = sockets.find(id);
+		if (it != sockets.end() && it->second->type == ReactorSocketType::Listener) {
+			Resume(*it->second);
+		}
+	}
+	is_running_callbacks = false;
+}
+
+void SocketReactor::Run()
+{
+	std::vector<uint64_t> ids = {};
+	while (is_running) {
+		ids.clear();
+		Wait(ids);
+		for (const auto id : ids) {
+			Service(id);
+		}
+	}
+}
+
+#ifdef __linux__
+
+void SocketReactor::Wait(std::vector<uint64_t>& ids)
+{
+	std::array<epoll_event, 16> events = {};
+
+	const auto num_events = epoll_wait(epoll_fd,
+	                                   events.data(),
+	                                   static_cast<int>(events.size()),
+	                                   -1);
+	count_syscall();
+
+	for (auto i = 0; i < num_events; ++i) {
+		const auto id = events[i].data.u64;
+		if (id == 0) {
+			DrainWakeups();
+		} else {
+			ids.push_back(id);
+		}
+	}
+}
+
+bool SocketReactor::Watch(ReactorSocket& socket)
+{
+	epoll_event event = {};
+	event.events      = EPOLLIN;
+	event.data.u64    = socket.id;
+	return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, socket.native_socket, &event) == 0;
+}
+
+void SocketReactor::Unwatch(ReactorSocket& socket)
+{
+	// Fails harmlessly for the sockets that were already unwatched
+	epoll_ctl(epoll_fd, EPOLL_CTL_DEL, socket.native_socket, nullptr);
+}
+
+#else
+
+void SocketReactor::Wait(std::vector<uint64_t>& ids)
+{
+	poll_fds.clear();
+	poll_ids.clear();
+
+	poll_fds.push_back({wake_pipe[0], POLLIN, 0});
+	poll_ids.push_back(0);
+	{
+		const std::lock_guard lock(mutex);
+		for (const auto& [id, socket] : sockets) {
+			if (!socket->is_paused && !socket->is_closed) {
+				poll_fds.push_back({socket->native_socket, POLLIN, 0});
+				poll_ids.push_back(id);
+			}
+		}
+	}
+
+	const auto num_events = poll(poll_fds.data(),
+	                             static_cast<nfds_t>(poll_fds.size()),
+	                             -1);
+	count_syscall();
+	if (num_events <= 0) {
+		return;
+	}
+
+	for (size_t i = 0; i < poll_fds.size(); ++i) {
+		if (poll_fds[i].revents == 0) {
+			continue;
+		}
+		if (poll_ids[i] == 0) {
+			DrainWakeups();
+		} else {
+			ids.push_back(poll_ids[i]);
+		}
+	}
+}
+
+bool SocketReactor::Watch(ReactorSocket&)
+{
+	// The network thread rebuilds its poll() set after waking up
+	Wake();
+	return true;
+}
+
+void SocketReactor::Unwatch(ReactorSocket&)
+{
+	Wake();
+}
+
+#endif
+
+void SocketReactor::Service(const uint64_t id)
+{
+	const std::lock_guard lock(mutex);
+
+	// The socket could have been removed, paused, or closed since the wait
+	// returned
+	const auto it = sockets.find(id);
+	if (it == sockets.end()) {
+		return;
+	}
+	auto& socket = *it->second;
+	if (socket.is_paused || socket.is_closed) {
+		return;
+	}
+
+	auto is_ready = false;
+	switch (socket.type) {
+	case ReactorSocketType::Stream: is_ready = ReadStream(socket); break;
+	case ReactorSocketType::Datagram: is_ready = ReadDatagrams(socket); break;
+	case ReactorSocketType::Listener:
+		Unwatch(socket);
+		socket.is_paused = true;
+		is_ready         = true;
+		break;
+	}
+
+	if (is_ready) {
+		socket.is_ready   = true;
+		has_ready_sockets = true;
+	}
+}
+
+bool SocketReactor::ReadStream(ReactorSocket& socket)
+{
+	const auto room = socket.bytes.MaxCapacity() - socket.bytes.Size();
+	if (room == 0) {
+		Pause(socket);
+		return false;
+	}
+
+	const auto len = recv(socket.native_socket,
+	                      receive_buffer.data(),
+	                      std::min(room, receive_buffer.size()),
+	                      MSG_DONTWAIT);
+	count_syscall();
+
+	if (len > 0) {
+		socket.bytes.NonblockingBulkEnqueue(
+		        std::span<const uint8_t>(receive_buffer.data(),
+		                                 static_cast<size_t>(len)));
+		return true;
+	}
+	if (len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+		return false;
+	}
+
+	// The peer closed the connection, or it failed
+	Unwatch(socket);
+	socket.is_closed = true;
+	return true;
+}
+
+bool SocketReactor::ReadDatagrams(ReactorSocket& socket)
+{
+	auto has_received = false;
+	while (true) {
+		if (socket.packets.IsFull()) {
+			Pause(socket);
+			break;
+		}
+
+		sockaddr_in address = {};
+		socklen_t size      = sizeof(address);
+
+		const auto len = recvfrom(socket.native_socket,
+		                          receive_buffer.data(),
+		                          receive_buffer.size(),
+		                          MSG_DONTWAIT,
+		                          reinterpret_cast<sockaddr*>(&address),
+		                          &size);
+		count_syscall();
+
+		// Drained, or an error reported for an earlier send
+		if (len < 0) {
+			break;
+		}
+
+		ReactorPacket packet = {};
+		packet.data.assign(receive_buffer.begin(), receive_buffer.begin() + len);
+		packet.host = address.sin_addr.s_addr;
+		packet.port = address.sin_port;
+
+		socket.packets.NonblockingEnqueue(std::move(packet));
+		has_received = true;
+	}
+	return has_received;
+}
+
+void SocketReactor::Pause(ReactorSocket& socket)
+{
+	Unwatch(socket);
+	socket.is_paused = true;
+
+	// The emulation thread could have made room before it saw the flag
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	const auto has_room = (socket.type == ReactorSocketType::Stream)
+	                            ? socket.bytes.Size() < socket.bytes.MaxCapacity()
+	                            : !socket.packets.IsFull();
+	if (has_room) {
+		socket.is_paused = false;
+		Watch(socket);
+	}
+}
+
+void SocketReactor::Wake()
+{
+	constexpr uint8_t Wakeup = 1;
+	[[maybe_unused]] const auto result = write(wake_pipe[1], &Wakeup, 1);
+}
+
+void SocketReactor::DrainWakeups()
+{
+	std::array<uint8_t, 64> buffer = {};
+	while (read(wake_pipe[0], buffer.data(), buffer.size()) > 0) {
+		count_syscall();
+	}
+	count_syscall();
+}
+
+#endif // WIN32
+
+ReactorSocket::ReactorSocket(const native_socket_t socket,
+                             const ReactorSocketType socket_type, callback_t callback)
+        : native_socket(socket),
+          type(socket_type),
+          on_ready(std::move(callback))
+{
+#ifndef WIN32
+	if (type == ReactorSocketType::Stream) {
+		bytes.Resize(MaxQueuedBytes);
+	} else if (type == ReactorSocketType::Datagram) {
+		packets.Resize(MaxQueuedPackets);
+	}
+
+	if (!reactor) {
+		reactor = std::make_unique<SocketReactor>();
+	}
+	if (reactor->IsRunning()) {
+		reactor->Add(*this);
+	}
+	if (reactor->IsEmpty()) {
+		reactor.reset();
+	}
+#endif
+}
+
+ReactorSocket::~ReactorSocket()
+{
+#ifndef WIN32
+	if (!IsWatched()) {
+		return;
+	}
+	assert(reactor);
+	reactor->Remove(*this);
+
+	// Otherwise the tick handler destroys the reactor once the callbacks
+	// are done
+	if (reactor->IsEmpty() && !reactor->IsRunningCallbacks()) {
+		reactor.reset();
+	}
+#endif
+}
+
+size_t ReactorSocket::ReceiveBytes(uint8_t* data, const size_t num_requested)
+{
+	assert(data);
+	const auto num_received = bytes.NonblockingBulkDequeue(
+	        std::span<uint8_t>(data, num_requested));
+	if (num_received > 0) {
+		ResumeIfPaused();
+	}
+	return num_received;
+}
+
+bool ReactorSocket::IsClosed() const
+{
+	// The network thread queues all the received bytes before it flags
+	// the socket as closed
+	return is_closed && bytes.IsEmpty();
+}
+
+std::optional<ReactorPacket> ReactorSocket::ReceivePacket()
+{
+	ReactorPacket packet = {};
+	if (packets.NonblockingBulkDequeue(std::span<ReactorPacket>(&packet, 1)) == 0) {
+		return {};
+	}
+	ResumeIfPaused();
+	return packet;
+}
+
+void ReactorSocket::ResumeIfPaused()
+{
+#ifndef WIN32
+	// Pairs with the fence in SocketReactor::Pause(), so either side sees
+	// the other's update
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (is_paused && reactor) {
+		reactor->Resume(*this);
+	}
+#endif
+}
@@ -0,0 +1,125 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_SOCKET_REACTOR_H
+#define DOSBOX_SOCKET_REACTOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include "utils/spsc_queue.h"
+
+/*  Host socket reactor
+ *  -------------------
+ *  The serial nullmodem and the IPX tunnel client used to poll their host
+ *  sockets from the emulation thread on every emulated millisecond, costing
+ *  a PIC event and a system call per socket even when nothing arrives.
+ *
+ *  The reactor waits for all the watched sockets on a single network thread
+ *  (epoll on Linux, poll() on the other POSIX systems) and reads whatever
+ *  arrives into a lock-free queue per socket. The emulation thread checks
+ *  one atomic flag on every timer tick, and only when a socket received
+ *  something (or was closed by its peer) it runs that socket's callback,
+ *  which schedules the device's own PIC event to collect the data.
+ *
+ *  The reactor isn't available on Windows; the callers keep polling their
+ *  sockets there, and for the socket types it doesn't handle (e.g., ENet).
+ */
+
+#ifdef WIN32
+using native_socket_t = uintptr_t;
+#else
+using native_socket_t = int;
+#endif
+
+// SDL_net doesn't expose the host socket behind its TCPsocket and UDPsocket
+// handles, but both of its socket structs start with the 'ready' flag
+// followed by the socket (see _TCPsocketX in serialport/misc_util.h)
+template <typename SdlNetSocket>
+native_socket_t get_native_socket(const SdlNetSocket sdl_net_socket)
+{
+	struct SdlNetSocketHead {
+		int ready;
+		native_socket_t channel;
+	};
+	return reinterpret_cast<const SdlNetSocketHead*>(sdl_net_socket)->channel;
+}
+
+enum class ReactorSocketType {
+	Stream,   // connected TCP socket, the received bytes are queued
+	Datagram, // UDP socket, the received packets are queued
+	Listener, // listening TCP socket, only incoming connections are signalled
+};
+
+struct ReactorPacket {
+	std::vector<uint8_t> data = {};
+
+	// The sender's address, in network byte order like SDL_net's IPaddress
+	uint32_t host = 0;
+	uint16_t port = 0;
+};
+
+// A host socket watched by the reactor. It's created, used, and destroyed
+// on the emulation thread. The host socket stays owned by the caller, and
+// has to stay open until this object is destroyed.
+class ReactorSocket {
+public:
+	using callback_t = std::function<void()>;
+
+	// The callback runs on the emulation thread whenever new data was
+	// queued, the peer closed the connection, or a listener has an
+	// incoming connection to accept
+	ReactorSocket(const native_socket_t socket, const ReactorSocketType type,
+	              callback_t callback);
+	~ReactorSocket();
+
+	ReactorSocket(const ReactorSocket&)            = delete;
+	ReactorSocket& operator=(const ReactorSocket&) = delete;
+
+	// False if the reactor isn't available, then the caller has to keep
+	// polling the socket itself
+	bool IsWatched() const
+	{
+		return id != 0;
+	}
+
+	// Stream sockets: moves up to 'num_requested' received bytes into
+	// 'data' and returns the number of bytes moved
+	size_t ReceiveBytes(uint8_t* data, const size_t num_requested);
+
+	// Stream sockets: true once the connection was closed and all the
+	// bytes received before were collected
+	bool IsClosed() const;
+
+	// Datagram sockets: the oldest received packet, if any
+	std::optional<ReactorPacket> ReceivePacket();
+
+private:
+	friend class SocketReactor;
+
+	void ResumeIfPaused();
+
+	const native_socket_t native_socket = {};
+	const ReactorSocketType type        = {};
+	const callback_t on_ready           = {};
+
+	uint64_t id = 0;
+
+	SpscQueue<uint8_t> bytes{1};
+	SpscQueue<ReactorPacket> packets{1};
+
+	// Set by the network thread, cleared by the emulation thread
+	std::atomic<bool> is_ready  = false;
+	std::atomic<bool> is_closed = false;
+
+	// The network thread stops watching sockets with full queues (and
+	// listeners with a pending connection) until the emulation thread
+	// made room
+	std::atomic<bool> is_paused = false;
+};
+
+#endif // DOSBOX_SOCKET_REACTOR_H
@@ -1141,6 +1141,12 @@ double VGA_GetRefreshRate();
 void VGA_DACSetEntirePalette(void);
 void VGA_StartRetrace(void);
 void VGA_StartUpdateLFB(void);
+
+// Copy and fill for the video BIOS, with the same results as reading and
+// writing the bytes one by one through the page handlers, but done in bulk
+// wherever the memory allows
+void VGA_BlockCopy(PhysPt dest, PhysPt src, Bitu len);
+void VGA_BlockFill(PhysPt dest, const uint8_t val, Bitu len);
 void VGA_SetBlinking(uint8_t enabled);
 void VGA_SetCGA2Table(uint8_t val0, uint8_t val1);
 void VGA_SetCGA4Table(uint8_t val0, uint8_t val1, uint8_t val2, uint8_t val3);
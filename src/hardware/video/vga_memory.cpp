@@ -4,6 +4,7 @@
 
 #include "dosbox.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <vector>
@@ -16,6 +17,8 @@
 #include "hardware/memory.h"
 #include "hardware/pic.h"
 #include "hardware/port.h"
+#include "misc/support.h"
+#include "simde/x86/sse2.h"
 #include "utils/mem_host.h"
 
 #ifndef C_VGARAM_CHECKED
@@ -92,6 +95,118 @@ inline static uint32_t ModeOperation(uint8_t val) {
 	return full;
 }
 
+// ModeOperation() and RasterOp() for four host bytes at a time, used by the
+// block writes into planar memory. Every byte becomes the four plane bytes
+// of a 32-bit lane, so the ExpandTable and FillTable lookups turn into byte
+// unpacks and compares.
+struct ModeOperationVectors {
+	ModeOperationVectors()
+	        : latch(set1(vga.latch.d)),
+	          bit_mask(set1(vga.config.full_bit_mask)),
+	          set_reset(set1(vga.config.full_set_reset)),
+	          not_enable_set_reset(set1(vga.config.full_not_enable_set_reset)),
+	          enable_and_set_reset(set1(vga.config.full_enable_and_set_reset)),
+	          low_bits(simde_mm_set1_epi8(
+	                  static_cast<int8_t>(0xff >> vga.config.data_rotate))),
+	          rotate_right(simde_mm_cvtsi32_si128(vga.config.data_rotate)),
+	          rotate_left(simde_mm_cvtsi32_si128(8 - vga.config.data_rotate)),
+	          write_mode(vga.config.write_mode),
+	          raster_op(vga.config.raster_op),
+	          data_rotate(vga.config.data_rotate)
+	{}
+
+	static simde__m128i set1(const uint32_t val)
+	{
+		return simde_mm_set1_epi32(static_cast<int32_t>(val));
+	}
+
+	const simde__m128i latch;
+	const simde__m128i bit_mask;
+	const simde__m128i set_reset;
+	const simde__m128i not_enable_set_reset;
+	const simde__m128i enable_and_set_reset;
+	const simde__m128i low_bits;
+	const simde__m128i rotate_right;
+	const simde__m128i rotate_left;
+
+	const uint8_t write_mode;
+	const uint8_t raster_op;
+	const uint8_t data_rotate;
+};
+
+static inline simde__m128i RasterOp_x4(const ModeOperationVectors& op,
+                                       const simde__m128i input,
+                                       const simde__m128i mask)
+{
+	switch (op.raster_op) {
+	case 0x00: /* None */
+		return simde_mm_or_si128(simde_mm_and_si128(input, mask),
+		                         simde_mm_andnot_si128(mask, op.latch));
+	case 0x01: /* AND */
+		return simde_mm_and_si128(
+		        simde_mm_or_si128(input,
+		                          simde_mm_xor_si128(mask,
+		                                             simde_mm_set1_epi32(-1))),
+		        op.latch);
+	case 0x02: /* OR */
+		return simde_mm_or_si128(simde_mm_and_si128(input, mask), op.latch);
+	case 0x03: /* XOR */
+		return simde_mm_xor_si128(simde_mm_and_si128(input, mask), op.latch);
+	};
+	return simde_mm_setzero_si128();
+}
+
+// Repeats each of the four low bytes in the four bytes of its lane
+static inline simde__m128i expand_x4(const simde__m128i vals)
+{
+	const auto doubled = simde_mm_unpacklo_epi8(vals, vals);
+	return simde_mm_unpacklo_epi16(doubled, doubled);
+}
+
+// The bytes rotated right by the data rotate count; SSE2 only shifts 16-bit
+// lanes, so the bits crossing into the neighbouring byte are masked off
+static inline simde__m128i rotate_x4(const ModeOperationVectors& op,
+                                     const simde__m128i vals)
+{
+	if (!op.data_rotate) {
+		return vals;
+	}
+	const auto right = simde_mm_srl_epi16(vals, op.rotate_right);
+	const auto left  = simde_mm_sll_epi16(vals, op.rotate_left);
+	return simde_mm_or_si128(simde_mm_and_si128(right, op.low_bits),
+	                         simde_mm_andnot_si128(op.low_bits, left));
+}
+
+static inline simde__m128i ModeOperation_x4(const ModeOperationVectors& op,
+                                            const uint8_t* vals)
+{
+	switch (op.write_mode) {
+	case 0x00: {
+		const auto full = expand_x4(rotate_x4(op, simde_mm_loadu_si32(vals)));
+		return RasterOp_x4(op,
+		                   simde_mm_or_si128(simde_mm_and_si128(full,
+		                                                        op.not_enable_set_reset),
+		                                     op.enable_and_set_reset),
+		                   op.bit_mask);
+	}
+	case 0x01: return op.latch;
+	case 0x02: {
+		// The FillTable entry: the planes whose bit is set in the value
+		const auto plane_bits = simde_mm_set_epi8(
+		        8, 4, 2, 1, 8, 4, 2, 1, 8, 4, 2, 1, 8, 4, 2, 1);
+		const auto full = expand_x4(simde_mm_loadu_si32(vals));
+		const auto fill = simde_mm_cmpeq_epi8(simde_mm_and_si128(full, plane_bits),
+		                                      plane_bits);
+		return RasterOp_x4(op, fill, op.bit_mask);
+	}
+	case 0x03: {
+		const auto full = expand_x4(rotate_x4(op, simde_mm_loadu_si32(vals)));
+		return RasterOp_x4(op, op.set_reset, simde_mm_and_si128(full, op.bit_mask));
+	}
+	}
+	return simde_mm_setzero_si128();
+}
+
 /* Gonna assume that whoever maps vga memory, maps it on 32/64kb boundary */
 
 #define VGA_PAGES		(128/4)
@@ -103,26 +218,87 @@ static struct {
 	Bitu base, mask;
 } vgapages;
 
-static void read_delay()
+static void read_delay(const int num_reads = 1)
 {
 	if (vga.vmem_delay_ns > 0) {
 		const int32_t delay_cycles = (CPU_CycleMax * vga.vmem_delay_ns) /
 		                             1000000;
-		CPU_Cycles -= delay_cycles;
-		CPU_IODelayRemoved += delay_cycles;
+		CPU_Cycles -= delay_cycles * num_reads;
+		CPU_IODelayRemoved += delay_cycles * num_reads;
 	}
 }
 
-static void write_delay()
+static void write_delay(const int num_writes = 1)
 {
 	if (vga.vmem_delay_ns > 0) {
 		const int32_t delay_cycles = (CPU_CycleMax * vga.vmem_delay_ns * 3) /
 		                             (1000000 * 4);
-		CPU_Cycles -= delay_cycles;
-		CPU_IODelayRemoved += delay_cycles;
+		CPU_Cycles -= delay_cycles * num_writes;
+		CPU_IODelayRemoved += delay_cycles * num_writes;
+	}
+}
+
+// Updates the pixel buffer of a planar address from its four planes
+static inline void update_planar_pixels(const PhysPt start, const uint32_t planes)
+{
+	uint8_t* write_pixels = &vga.fastmem[start << 3];
+
+	VgaLatch temp;
+	temp.d = (planes >> 4) & 0x0f0f0f0f;
+	const uint32_t colors0_3 = Expand16Table[0][temp.b[0]] |
+	                           Expand16Table[1][temp.b[1]] |
+	                           Expand16Table[2][temp.b[2]] |
+	                           Expand16Table[3][temp.b[3]];
+	*(uint32_t*)write_pixels = colors0_3;
+
+	temp.d = planes & 0x0f0f0f0f;
+	const uint32_t colors4_7 = Expand16Table[0][temp.b[0]] |
+	                           Expand16Table[1][temp.b[1]] |
+	                           Expand16Table[2][temp.b[2]] |
+	                           Expand16Table[3][temp.b[3]];
+	*(uint32_t*)(write_pixels + 4) = colors4_7;
+}
+
+// Writes a run of bytes into consecutive planar addresses, as if they were
+// written one by one; the pixel buffer is only kept for the EGA and 16-colour
+// modes
+static void write_planar_block(const PhysPt start, const uint8_t* vals,
+                               const Bitu num_bytes, const bool update_pixels)
+{
+	auto planes = reinterpret_cast<uint32_t*>(vga.mem.linear) + start;
+
+	const ModeOperationVectors op = {};
+
+	const auto map_mask = ModeOperationVectors::set1(vga.config.full_map_mask);
+
+	Bitu i = 0;
+	for (; i + 4 <= num_bytes; i += 4) {
+		const auto data = ModeOperation_x4(op, vals + i);
+		const auto old  = simde_mm_loadu_si128(planes + i);
+		simde_mm_storeu_si128(planes + i,
+		                      simde_mm_or_si128(simde_mm_andnot_si128(map_mask, old),
+		                                        simde_mm_and_si128(data, map_mask)));
+	}
+	for (; i < num_bytes; ++i) {
+		const auto data = ModeOperation(vals[i]);
+		planes[i] = (planes[i] & vga.config.full_not_map_mask) |
+		            (data & vga.config.full_map_mask);
+	}
+
+	if (update_pixels) {
+		for (i = 0; i < num_bytes; ++i) {
+			update_planar_pixels(start + check_cast<PhysPt>(i), planes[i]);
+		}
 	}
 }
 
+// True if a block of bytes at the planar offset would wrap around the end
+// of video memory
+static inline bool wraps_planar_memory(const PhysPt start, const Bitu num_bytes)
+{
+	return start + num_bytes > (vga.vmemwrap >> 2);
+}
+
 class VGA_UnchainedRead_Handler : public PageHandler {
 public:
 	uint8_t readHandler(PhysPt start)
@@ -182,25 +358,7 @@ public:
 		vga.mem.linear[start] = val;
 		start >>= 2;
 		pixels.d=((uint32_t*)vga.mem.linear)[start];
-
-		uint8_t * write_pixels=&vga.fastmem[start<<3];
-
-		uint32_t colors0_3, colors4_7;
-		VgaLatch temp;
-		temp.d=(pixels.d>>4) & 0x0f0f0f0f;
-		colors0_3 = 
-			Expand16Table[0][temp.b[0]] |
-			Expand16Table[1][temp.b[1]] |
-			Expand16Table[2][temp.b[2]] |
-			Expand16Table[3][temp.b[3]];
-		*(uint32_t *)write_pixels=colors0_3;
-		temp.d=pixels.d & 0x0f0f0f0f; //-V519
-		colors4_7 = 
-			Expand16Table[0][temp.b[0]] |
-			Expand16Table[1][temp.b[1]] |
-			Expand16Table[2][temp.b[2]] |
-			Expand16Table[3][temp.b[3]];
-		*(uint32_t *)(write_pixels+4)=colors4_7;
+		update_planar_pixels(start, pixels.d);
 	}
 public:	
 	VGA_ChainedEGA_Handler()  {
@@ -283,28 +441,11 @@ public:
 		pixels.d&=vga.config.full_not_map_mask;
 		pixels.d|=(data & vga.config.full_map_mask);
 		((uint32_t*)vga.mem.linear)[start]=pixels.d;
-		uint8_t * write_pixels=&vga.fastmem[start<<3];
-
-		uint32_t colors0_3, colors4_7;
-		VgaLatch temp;
-		temp.d=(pixels.d>>4) & 0x0f0f0f0f;
-			colors0_3 = 
-			Expand16Table[0][temp.b[0]] |
-			Expand16Table[1][temp.b[1]] |
-			Expand16Table[2][temp.b[2]] |
-			Expand16Table[3][temp.b[3]];
-		*(uint32_t *)write_pixels=colors0_3;
-		temp.d=pixels.d & 0x0f0f0f0f; //-V519
-		colors4_7 = 
-			Expand16Table[0][temp.b[0]] |
-			Expand16Table[1][temp.b[1]] |
-			Expand16Table[2][temp.b[2]] |
-			Expand16Table[3][temp.b[3]];
-		*(uint32_t *)(write_pixels+4)=colors4_7;
+		update_planar_pixels(start, pixels.d);
 	}
 public:	
 	VGA_UnchainedEGA_Handler()  {
-		flags=PFLAG_NOCODE;
+		flags = PFLAG_NOCODE | PFLAG_BLOCKWRITE;
 	}
 
 	void writeb(PhysPt addr, uint8_t val) override
@@ -335,10 +476,24 @@ public:
 		addr += vga.svga.bank_write_full;
 		addr = CHECKED2(addr);
 		MEM_CHANGED( addr << 3);
-		writeHandler(addr+0,(uint8_t)(val >> 0));
-		writeHandler(addr+1,(uint8_t)(val >> 8));
-		writeHandler(addr+2,(uint8_t)(val >> 16));
-		writeHandler(addr+3,(uint8_t)(val >> 24));
+		uint8_t vals[4];
+		host_writed(vals, val);
+		write_planar_block(addr, vals, sizeof(vals), true);
+	}
+
+	void writeblock(PhysPt addr, const uint8_t* data, const Bitu num_bytes,
+	                const Bitu access_size) override
+	{
+		auto start = PAGING_GetPhysicalAddress(addr) & vgapages.mask;
+		start += vga.svga.bank_write_full;
+		start = CHECKED2(start);
+		if (wraps_planar_memory(start, num_bytes)) {
+			PageHandler::writeblock(addr, data, num_bytes, access_size);
+			return;
+		}
+		write_delay(check_cast<int>(num_bytes / access_size));
+		MEM_CHANGED(start << 3);
+		write_planar_block(start, data, num_bytes, true);
 	}
 };
 
@@ -514,7 +669,7 @@ public:
 	}
 public:
 	VGA_UnchainedVGA_Handler()  {
-		flags=PFLAG_NOCODE;
+		flags = PFLAG_NOCODE | PFLAG_BLOCKWRITE;
 	}
 
 	void writeb(PhysPt addr, uint8_t val) override
@@ -545,10 +700,24 @@ public:
 		addr += vga.svga.bank_write_full;
 		addr = CHECKED2(addr);
 		MEM_CHANGED( addr << 2);
-		writeHandler(addr+0,(uint8_t)(val >> 0));
-		writeHandler(addr+1,(uint8_t)(val >> 8));
-		writeHandler(addr+2,(uint8_t)(val >> 16));
-		writeHandler(addr+3,(uint8_t)(val >> 24));
+		uint8_t vals[4];
+		host_writed(vals, val);
+		write_planar_block(addr, vals, sizeof(vals), false);
+	}
+
+	void writeblock(PhysPt addr, const uint8_t* data, const Bitu num_bytes,
+	                const Bitu access_size) override
+	{
+		auto start = PAGING_GetPhysicalAddress(addr) & vgapages.mask;
+		start += vga.svga.bank_write_full;
+		start = CHECKED2(start);
+		if (wraps_planar_memory(start, num_bytes)) {
+			PageHandler::writeblock(addr, data, num_bytes, access_size);
+			return;
+		}
+		write_delay(check_cast<int>(num_bytes / access_size));
+		MEM_CHANGED(start << 2);
+		write_planar_block(start, data, num_bytes, false);
 	}
 };
 
@@ -674,7 +843,7 @@ public:
 class VGA_LIN4_Handler final : public VGA_UnchainedEGA_Handler {
 public:
 	VGA_LIN4_Handler() {
-		flags=PFLAG_NOCODE;
+		flags = PFLAG_NOCODE | PFLAG_BLOCKWRITE;
 	}
 	void writeb(PhysPt addr, uint8_t val) override
 	{
@@ -701,10 +870,24 @@ public:
 		addr = vga.svga.bank_write_full + (PAGING_GetPhysicalAddress(addr) & 0xffff);
 		addr = CHECKED4(addr);
 		MEM_CHANGED( addr << 3 );
-		writeHandler(addr+0,(uint8_t)(val >> 0));
-		writeHandler(addr+1,(uint8_t)(val >> 8));
-		writeHandler(addr+2,(uint8_t)(val >> 16));
-		writeHandler(addr+3,(uint8_t)(val >> 24));
+		uint8_t vals[4];
+		host_writed(vals, val);
+		write_planar_block(addr, vals, sizeof(vals), true);
+	}
+
+	void writeblock(PhysPt addr, const uint8_t* data, const Bitu num_bytes,
+	                const Bitu access_size) override
+	{
+		auto start = vga.svga.bank_write_full +
+		             (PAGING_GetPhysicalAddress(addr) & 0xffff);
+		start = CHECKED4(start);
+		if (wraps_planar_memory(start, num_bytes)) {
+			PageHandler::writeblock(addr, data, num_bytes, access_size);
+			return;
+		}
+		write_delay(check_cast<int>(num_bytes / access_size));
+		MEM_CHANGED(start << 3);
+		write_planar_block(start, data, num_bytes, true);
 	}
 
 	uint8_t readb(PhysPt addr) override
@@ -1107,6 +1290,236 @@ range_done:
 	PAGING_ClearTLB();
 }
 
+// Bulk access for the video BIOS
+// ------------------------------
+// Copying or filling a scroll window through mem_readb() and mem_writeb()
+// costs a page handler call, an address translation, and the delay
+// emulation for every byte. These give the same results a page at a time:
+// directly on the video memory for the planar and the chained VGA handlers,
+// through the host pointers for the mapped pages, and byte by byte through
+// the page handlers for everything else.
+
+static Bitu bytes_to_page_end(const PhysPt addr)
+{
+	return MemPageSize - (addr & (MemPageSize - 1));
+}
+
+static PageHandler* get_page_handler(const PhysPt addr)
+{
+	return MEM_GetPageHandler(PAGING_GetPhysicalAddress(addr) / MemPageSize);
+}
+
+static bool is_planar_handler(const PageHandler* handler)
+{
+	return handler == &vgaph.uega || handler == &vgaph.lin4;
+}
+
+// The plane offsets the planar handlers' readb() and writeb() access
+static PhysPt get_planar_offset(const PageHandler* handler, const PhysPt addr,
+                                const Bitu bank_full)
+{
+	const auto phys_addr = PAGING_GetPhysicalAddress(addr);
+	if (handler == &vgaph.lin4) {
+		return CHECKED4(bank_full + (phys_addr & 0xffff));
+	}
+	return CHECKED2((phys_addr & vgapages.mask) + bank_full);
+}
+
+// The linear offsets the chained VGA handler's readb() and writeb() access
+static PhysPt get_chained_offset(const PhysPt addr, const Bitu bank_full)
+{
+	return CHECKED((PAGING_GetPhysicalAddress(addr) & vgapages.mask) + bank_full);
+}
+
+static bool fits_planes(const PhysPt offset, const Bitu len)
+{
+	return offset + len <= (vga.vmemwrap >> 2);
+}
+
+// Write mode 1: every byte read loads the latches, and every byte written
+// stores them to the enabled planes
+static void planar_copy(const PhysPt dest_offset, const PhysPt src_offset,
+                        const Bitu len)
+{
+	auto planes = reinterpret_cast<uint32_t*>(vga.mem.linear);
+
+	const auto overlaps = dest_offset < src_offset + len &&
+	                      src_offset < dest_offset + len;
+
+	if (vga.config.full_map_mask == 0xffffffff && !overlaps) {
+		memcpy(&planes[dest_offset], &planes[src_offset], len * sizeof(uint32_t));
+
+		// The source's pixel buffer could be stale after a mode change
+		// without clearing the memory, so it's expanded again
+		for (Bitu i = 0; i < len; ++i) {
+			update_planar_pixels(dest_offset + i, planes[dest_offset + i]);
+		}
+		vga.latch.d = planes[src_offset + len - 1];
+		return;
+	}
+	for (Bitu i = 0; i < len; ++i) {
+		vga.latch.d = planes[src_offset + i];
+
+		auto& pixels = planes[dest_offset + i];
+		pixels = (pixels & vga.config.full_not_map_mask) |
+		         (vga.latch.d & vga.config.full_map_mask);
+		update_planar_pixels(dest_offset + i, pixels);
+	}
+}
+
+// Without reads in between, the latches and so the result of the write mode
+// stay the same for every byte
+static void planar_fill(const PhysPt dest_offset, const uint8_t val, const Bitu len)
+{
+	auto planes = reinterpret_cast<uint32_t*>(vga.mem.linear);
+
+	const auto data = ModeOperation(val);
+
+	if (vga.config.full_map_mask == 0xffffffff) {
+		std::fill_n(&planes[dest_offset], len, data);
+		update_planar_pixels(dest_offset, data);
+		for (Bitu i = 1; i < len; ++i) {
+			memcpy(&vga.fastmem[(dest_offset + i) << 3],
+			       &vga.fastmem[dest_offset << 3],
+			       8);
+		}
+		return;
+	}
+	for (Bitu i = 0; i < len; ++i) {
+		auto& pixels = planes[dest_offset + i];
+		pixels = (pixels & vga.config.full_not_map_mask) |
+		         (data & vga.config.full_map_mask);
+		update_planar_pixels(dest_offset + i, pixels);
+	}
+}
+
+static void fill_page(PhysPt dest, const uint8_t val, Bitu len)
+{
+	while (len) {
+		// The first byte access links an unlinked page to its host memory
+		if (const auto host = get_tlb_write(dest)) {
+			memset(host + dest, val, len);
+			return;
+		}
+		mem_writeb(dest++, val);
+		--len;
+	}
+}
+
+void VGA_BlockCopy(PhysPt dest, PhysPt src, Bitu len)
+{
+	while (len) {
+		const auto chunk = std::min({len,
+		                             bytes_to_page_end(dest),
+		                             bytes_to_page_end(src)});
+
+		const auto dest_handler = get_page_handler(dest);
+		const auto src_handler  = get_page_handler(src);
+
+		if (is_planar_handler(dest_handler) && src_handler == dest_handler &&
+		    vga.config.write_mode == 1) {
+			const auto dest_offset = get_planar_offset(
+			        dest_handler, dest, vga.svga.bank_write_full);
+			const auto src_offset = get_planar_offset(
+			        src_handler, src, vga.svga.bank_read_full);
+
+			if (fits_planes(dest_offset, chunk) &&
+			    fits_planes(src_offset, chunk)) {
+				read_delay(check_cast<int>(chunk));
+				write_delay(check_cast<int>(chunk));
+#ifdef VGA_KEEP_CHANGES
+				for (Bitu i = 0; i < chunk; ++i) {
+					MEM_CHANGED((dest_offset + i) << 3);
+				}
+#endif
+				planar_copy(dest_offset, src_offset, chunk);
+				dest += static_cast<PhysPt>(chunk);
+				src += static_cast<PhysPt>(chunk);
+				len -= chunk;
+				continue;
+			}
+		}
+
+		if (dest_handler == &vgaph.cvga && src_handler == &vgaph.cvga) {
+			const auto dest_offset = get_chained_offset(dest,
+			                                            vga.svga.bank_write_full);
+			const auto src_offset = get_chained_offset(src,
+			                                           vga.svga.bank_read_full);
+
+			if (dest_offset + chunk <= vga.vmemwrap &&
+			    src_offset + chunk <= vga.vmemwrap) {
+				read_delay(check_cast<int>(chunk));
+				write_delay(check_cast<int>(chunk));
+				for (Bitu i = 0; i < chunk; ++i) {
+					const auto val = VGA_ChainedVGA_Handler::readHandler_byte(
+					        src_offset + i);
+					MEM_CHANGED(dest_offset + i);
+					VGA_ChainedVGA_Handler::writeHandler_byte(dest_offset + i,
+					                                          val);
+					VGA_ChainedVGA_Handler::writeCache_byte(dest_offset + i,
+					                                        val);
+				}
+				dest += static_cast<PhysPt>(chunk);
+				src += static_cast<PhysPt>(chunk);
+				len -= chunk;
+				continue;
+			}
+		}
+
+		MEM_BlockMove(dest, src, chunk);
+		dest += static_cast<PhysPt>(chunk);
+		src += static_cast<PhysPt>(chunk);
+		len -= chunk;
+	}
+}
+
+void VGA_BlockFill(PhysPt dest, const uint8_t val, Bitu len)
+{
+	while (len) {
+		const auto chunk = std::min(len, bytes_to_page_end(dest));
+
+		const auto handler = get_page_handler(dest);
+
+		if (is_planar_handler(handler)) {
+			const auto offset = get_planar_offset(handler,
+			                                      dest,
+			                                      vga.svga.bank_write_full);
+			if (fits_planes(offset, chunk)) {
+				write_delay(check_cast<int>(chunk));
+#ifdef VGA_KEEP_CHANGES
+				for (Bitu i = 0; i < chunk; ++i) {
+					MEM_CHANGED((offset + i) << 3);
+				}
+#endif
+				planar_fill(offset, val, chunk);
+				dest += static_cast<PhysPt>(chunk);
+				len -= chunk;
+				continue;
+			}
+		}
+
+		if (handler == &vgaph.cvga) {
+			const auto offset = get_chained_offset(dest,
+			                                       vga.svga.bank_write_full);
+			if (offset + chunk <= vga.vmemwrap) {
+				write_delay(check_cast<int>(chunk));
+				for (Bitu i = 0; i < chunk; ++i) {
+					MEM_CHANGED(offset + i);
+					VGA_ChainedVGA_Handler::writeHandler_byte(offset + i, val);
+					VGA_ChainedVGA_Handler::writeCache_byte(offset + i, val);
+				}
+				dest += static_cast<PhysPt>(chunk);
+				len -= chunk;
+				continue;
+			}
+		}
+
+		fill_page(dest, val, chunk);
+		dest += static_cast<PhysPt>(chunk);
+		len -= chunk;
+	}
+}
+
 void VGA_StartUpdateLFB(void) {
 	vga.lfb.page = vga.s3.la_window << 4;
 	vga.lfb.addr = vga.s3.la_window << 16;
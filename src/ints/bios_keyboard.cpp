@@ -5,7 +5,9 @@
 #include "ints/bios.h"
 
 #include "cpu/callback.h"
+#include "cpu/cpu.h"
 #include "hardware/memory.h"
+#include "hardware/pic.h"
 #include "hardware/input/keyboard.h"
 #include "cpu/registers.h"
 #include "hardware/port.h"
@@ -518,6 +520,39 @@ static bool IsEnhancedKey(uint16_t &key) {
 	return false;
 }
 
+// Many programs check for keystrokes while doing useful work (e.g., games and
+// text mode UIs once per frame or main loop iteration). The guest is only
+// considered idle if the keystroke check keeps finding no key with hardly any
+// instructions executed in between, as in a tight polling loop.
+static struct {
+	double last_index = 0.0;
+	int num_empty     = 0;
+} keyboard_polls = {};
+
+static void notify_empty_keyboard_poll()
+{
+	constexpr int MinEmptyPolls            = 8;
+	constexpr double MaxCyclesBetweenPolls = 100.0;
+
+	const auto index      = PIC_FullIndex();
+	const auto num_cycles = (index - keyboard_polls.last_index) * CPU_CycleMax;
+
+	keyboard_polls.last_index = index;
+
+	if (num_cycles < 0.0 || num_cycles > MaxCyclesBetweenPolls) {
+		keyboard_polls.num_empty = 0;
+	}
+	if (++keyboard_polls.num_empty >= MinEmptyPolls) {
+		CPU_NotifyIdle(CpuIdleReason::KeyboardPoll);
+	}
+}
+
+// A keystroke check that found a key ends the polling streak
+static void notify_keyboard_poll_hit()
+{
+	keyboard_polls.num_empty = 0;
+}
+
 static Bitu INT16_Handler(void) {
 	uint16_t temp=0;
 	switch (reg_ah) {
@@ -528,6 +563,7 @@ static Bitu INT16_Handler(void) {
 		} else {
 			/* enter small idle loop to allow for irqs to happen */
 			reg_ip+=1;
+			CPU_NotifyIdle(CpuIdleReason::KeyboardWait);
 		}
 		break;
 	case 0x10: /* GET KEYSTROKE (enhanced keyboards only) */
@@ -540,6 +576,7 @@ static Bitu INT16_Handler(void) {
 		} else {
 			/* enter small idle loop to allow for irqs to happen */
 			reg_ip+=1;
+			CPU_NotifyIdle(CpuIdleReason::KeyboardWait);
 		}
 		break;
 	case 0x01: /* CHECK FOR KEYSTROKE */
@@ -549,6 +586,7 @@ static Bitu INT16_Handler(void) {
 			if (check_key(temp)) { //  check_key changes ZF and CF as required
 				if (!IsEnhancedKey(temp)) {
 					/* normal key, return translated key in ax */
+					notify_keyboard_poll_hit();
 					break;
 				} else {
 					/* remove enhanced key from buffer and ignore it */
@@ -556,6 +594,7 @@ static Bitu INT16_Handler(void) {
 				}
 			} else {
 				/* no key available, return key at buffer head anyway */
+				notify_empty_keyboard_poll();
 				break;
 			}
 //			CALLBACK_Idle();
@@ -570,6 +609,9 @@ static Bitu INT16_Handler(void) {
 				/* special enhanced key, clear low part before returning key */
 				temp&=0xff00;
 			}
+			notify_keyboard_poll_hit();
+		} else {
+			notify_empty_keyboard_poll();
 		}
 		reg_ax=temp;
 		break;
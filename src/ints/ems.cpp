@@ -7,6 +7,8 @@
 #include <algorithm>
 #include <cstring>
 #include <cstdlib>
+#include <utility>
+#include <vector>
 
 #include "ints/bios.h"
 #include "cpu/callback.h"
@@ -635,6 +637,25 @@ static void LoadMoveRegion(PhysPt data,MoveRegion & region) {
 	region.dest_page_seg=mem_readw(data+0x10);
 }
 
+// Physical address of an offset into one side of a move region, and the
+// number of bytes that are contiguous in physical memory from there on
+static std::pair<PhysPt, Bitu> ResolveRegionOffset(const uint8_t type,
+                                                   const MemHandle mem,
+                                                   const PhysPt conv_mem,
+                                                   const Bitu offset,
+                                                   const Bitu remain)
+{
+	if (!type) {
+		return {static_cast<PhysPt>(conv_mem + offset), remain};
+	}
+	const auto run = MEM_GetPageRun(mem, offset / MEM_PAGE_SIZE);
+	assert(run.page > 0);
+
+	const auto page_offset = offset & (MEM_PAGE_SIZE - 1);
+	return {static_cast<PhysPt>(run.page * MEM_PAGE_SIZE + page_offset),
+	        run.num_pages * MEM_PAGE_SIZE - page_offset};
+}
+
 static uint8_t MemoryRegion()
 {
 	MoveRegion region;
@@ -647,17 +668,14 @@ static uint8_t MemoryRegion()
 	/* Parse the region for information */
 	PhysPt src_mem = 0,dest_mem = 0;
 	MemHandle src_handle = 0,dest_handle = 0;
-	Bitu src_off = 0,dest_off = 0 ;Bitu src_remain = 0,dest_remain = 0;
+	Bitu src_start = 0,dest_start = 0;
 	if (!region.src_type) {
 		src_mem=region.src_page_seg*16+region.src_offset;
 	} else {
 		if (!ValidHandle(region.src_handle)) return EMM_INVALID_HANDLE;
 		if ((emm_handles[region.src_handle].pages*EMM_PAGE_SIZE) < ((region.src_page_seg*EMM_PAGE_SIZE)+region.src_offset+region.bytes)) return EMM_LOG_OUT_RANGE;
 		src_handle=emm_handles[region.src_handle].mem;
-		Bitu pages=region.src_page_seg*4+(region.src_offset/MEM_PAGE_SIZE);
-		for (;pages>0;pages--) src_handle=MEM_NextHandle(src_handle);
-		src_off=region.src_offset&(MEM_PAGE_SIZE-1);
-		src_remain=MEM_PAGE_SIZE-src_off;
+		src_start=region.src_page_seg*EMM_PAGE_SIZE+region.src_offset;
 	}
 	if (!region.dest_type) {
 		dest_mem=region.dest_page_seg*16+region.dest_offset;
@@ -665,75 +683,49 @@ static uint8_t MemoryRegion()
 		if (!ValidHandle(region.dest_handle)) return EMM_INVALID_HANDLE;
 		if (emm_handles[region.dest_handle].pages*EMM_PAGE_SIZE < (region.dest_page_seg*EMM_PAGE_SIZE)+region.dest_offset+region.bytes) return EMM_LOG_OUT_RANGE;
 		dest_handle=emm_handles[region.dest_handle].mem;
-		Bitu pages=region.dest_page_seg*4+(region.dest_offset/MEM_PAGE_SIZE);
-		for (;pages>0;pages--) dest_handle=MEM_NextHandle(dest_handle);
-		dest_off=region.dest_offset&(MEM_PAGE_SIZE-1);
-		dest_remain=MEM_PAGE_SIZE-dest_off;
+		dest_start=region.dest_page_seg*EMM_PAGE_SIZE+region.dest_offset;
 	}
 
-	uint8_t buf_src[MEM_PAGE_SIZE];
-	uint8_t buf_dest[MEM_PAGE_SIZE];
-
-	while (region.bytes > 0) {
-		const size_t toread = std::min<size_t>(region.bytes, MEM_PAGE_SIZE);
-
-		/* Read from the source */
-		if (!region.src_type) {
-			MEM_BlockRead(src_mem,buf_src,toread);
-		} else {
-			assert(toread <= MEM_PAGE_SIZE);
-			if (toread <= src_remain) {
-				MEM_BlockRead((src_handle*MEM_PAGE_SIZE)+src_off,buf_src,toread);
-			} else {
-				MEM_BlockRead((src_handle*MEM_PAGE_SIZE)+src_off,buf_src,src_remain);
-				MEM_BlockRead((MEM_NextHandle(src_handle)*MEM_PAGE_SIZE),&buf_src[src_remain],toread-src_remain);
-			}
+	const bool is_exchange = (reg_al == 1);
+
+	// A move within the same handle whose source and destination overlap
+	// can span several physical extents, so it's done through a copy of
+	// the source to keep the memmove() semantics
+	const bool overlaps_in_handle = region.src_type && region.dest_type &&
+	                                (src_handle == dest_handle) &&
+	                                (src_start < dest_start + region.bytes) &&
+	                                (dest_start < src_start + region.bytes);
+	std::vector<uint8_t> overlap_copy = {};
+	if (overlaps_in_handle && !is_exchange) {
+		overlap_copy.resize(region.bytes);
+		for (Bitu done = 0; done < region.bytes;) {
+			const auto [src_pt, src_len] = ResolveRegionOffset(
+			        region.src_type, src_handle, src_mem, src_start + done, region.bytes - done);
+			const auto len = std::min<Bitu>(region.bytes - done, src_len);
+			MEM_BlockRead(src_pt, overlap_copy.data() + done, len);
+			done += len;
 		}
-		/* Check for a move */
-		if (reg_al==1) {
-			/* Read from the destination */
-			if (!region.dest_type) {
-				MEM_BlockRead(dest_mem,buf_dest,toread);
-			} else {
-				assert(toread <= MEM_PAGE_SIZE);
-				if (toread <= dest_remain) {
-					MEM_BlockRead((dest_handle*MEM_PAGE_SIZE)+dest_off,buf_dest,toread);
-				} else {
-					MEM_BlockRead((dest_handle*MEM_PAGE_SIZE)+dest_off,buf_dest,dest_remain);
-					MEM_BlockRead((MEM_NextHandle(dest_handle)*MEM_PAGE_SIZE),&buf_dest[dest_remain],toread-dest_remain);
-				}
-			}
-			/* Write to the source */
-			if (!region.src_type) {
-				MEM_BlockWrite(src_mem,buf_dest,toread);
-			} else {
-				assert(toread <= MEM_PAGE_SIZE);
-				if (toread <= src_remain) {
-					MEM_BlockWrite((src_handle*MEM_PAGE_SIZE)+src_off,buf_dest,toread);
-				} else {
-					MEM_BlockWrite((src_handle*MEM_PAGE_SIZE)+src_off,buf_dest,src_remain);
-					MEM_BlockWrite((MEM_NextHandle(src_handle)*MEM_PAGE_SIZE),&buf_dest[src_remain],toread-src_remain);
-				}
-			}
-		}
-		/* Write to the destination */
-		if (!region.dest_type) {
-			MEM_BlockWrite(dest_mem,buf_src,toread);
+	}
+
+	// Work through the largest spans that are contiguous on both sides;
+	// RAM is moved or exchanged directly in host memory
+	for (Bitu done = 0; done < region.bytes;) {
+		const auto remain = region.bytes - done;
+
+		const auto [src_pt, src_len] = ResolveRegionOffset(
+		        region.src_type, src_handle, src_mem, src_start + done, remain);
+		const auto [dest_pt, dest_len] = ResolveRegionOffset(
+		        region.dest_type, dest_handle, dest_mem, dest_start + done, remain);
+
+		const auto len = std::min({remain, src_len, dest_len});
+		if (is_exchange) {
+			MEM_BlockExchange(src_pt, dest_pt, len);
+		} else if (overlaps_in_handle) {
+			MEM_BlockWrite(dest_pt, overlap_copy.data() + done, len);
 		} else {
-			assert(toread <= MEM_PAGE_SIZE);
-			if (toread <= dest_remain) {
-				MEM_BlockWrite((dest_handle*MEM_PAGE_SIZE)+dest_off,buf_src,toread);
-			} else {
-				MEM_BlockWrite((dest_handle*MEM_PAGE_SIZE)+dest_off,buf_src,dest_remain);
-				MEM_BlockWrite((MEM_NextHandle(dest_handle)*MEM_PAGE_SIZE),&buf_src[dest_remain],toread-dest_remain);
-			}
+			MEM_BlockMove(dest_pt, src_pt, len);
 		}
-		/* Advance the pointers */
-		if (!region.src_type) src_mem+=toread;
-		else src_handle=MEM_NextHandle(src_handle);
-		if (!region.dest_type) dest_mem+=toread;
-		else dest_handle=MEM_NextHandle(dest_handle);
-		region.bytes-=toread;
+		done += len;
 	}
 	return EMM_NO_ERROR;
 }
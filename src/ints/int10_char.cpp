@@ -6,6 +6,8 @@
 
 #include "int10.h"
 
+#include <array>
+
 #include "ints/bios.h"
 #include "cpu/callback.h"
 #include "hardware/port.h"
@@ -20,8 +22,8 @@ static void CGA2_CopyRow(uint8_t cleft,uint8_t cright,uint8_t rold,uint8_t rnew,
 	Bitu copy=(cright-cleft);
 	Bitu nextline=CurMode->twidth;
 	for (Bitu i=0;i<cheight/2U;i++) {
-		MEM_BlockCopy(dest,src,copy);
-		MEM_BlockCopy(dest+8*1024,src+8*1024,copy);
+		MEM_BlockMove(dest,src,copy);
+		MEM_BlockMove(dest+8*1024,src+8*1024,copy);
 		dest+=nextline;src+=nextline;
 	}
 }
@@ -32,8 +34,8 @@ static void CGA4_CopyRow(uint8_t cleft,uint8_t cright,uint8_t rold,uint8_t rnew,
 	PhysPt src=base+((CurMode->twidth*rold)*(cheight/2)+cleft)*2;	
 	Bitu copy=(cright-cleft)*2;Bitu nextline=CurMode->twidth*2;
 	for (Bitu i=0;i<cheight/2U;i++) {
-		MEM_BlockCopy(dest,src,copy);
-		MEM_BlockCopy(dest+8*1024,src+8*1024,copy);
+		MEM_BlockMove(dest,src,copy);
+		MEM_BlockMove(dest+8*1024,src+8*1024,copy);
 		dest+=nextline;src+=nextline;
 	}
 }
@@ -45,7 +47,7 @@ static void TANDY16_CopyRow(uint8_t cleft,uint8_t cright,uint8_t rold,uint8_t rn
 	PhysPt src=base+((CurMode->twidth*rold)*(cheight/banks)+cleft)*4;
 	Bitu copy=(cright-cleft)*4;Bitu nextline=CurMode->twidth*4;
 	for (Bitu i=0;i<static_cast<Bitu>(cheight/banks);i++) {
-		for (Bitu b=0;b<banks;b++) MEM_BlockCopy(dest+b*8*1024,src+b*8*1024,copy);
+		for (Bitu b=0;b<banks;b++) MEM_BlockMove(dest+b*8*1024,src+b*8*1024,copy);
 		dest+=nextline;src+=nextline;
 	}
 }
@@ -63,7 +65,7 @@ static void EGA16_CopyRow(uint8_t cleft,uint8_t cright,uint8_t rold,uint8_t rnew
 	Bitu rowsize=(cright-cleft);
 	copy=cheight;
 	for (;copy>0;copy--) {
-		for (Bitu x=0;x<rowsize;x++) mem_writeb(dest+x,mem_readb(src+x));
+		VGA_BlockCopy(dest,src,rowsize);
 		dest+=nextline;src+=nextline;
 	}
 	/* Restore registers */
@@ -79,7 +81,7 @@ static void VGA_CopyRow(uint8_t cleft,uint8_t cright,uint8_t rold,uint8_t rnew,P
 	Bitu rowsize=8*(cright-cleft);
 	copy=cheight;
 	for (;copy>0;copy--) {
-		for (Bitu x=0;x<rowsize;x++) mem_writeb(dest+x,mem_readb(src+x));
+		VGA_BlockCopy(dest,src,rowsize);
 		dest+=nextline;src+=nextline;
 	}
 }
@@ -88,7 +90,7 @@ static void TEXT_CopyRow(uint8_t cleft,uint8_t cright,uint8_t rold,uint8_t rnew,
 	PhysPt src,dest;
 	src=base+(rold*CurMode->twidth+cleft)*2;
 	dest=base+(rnew*CurMode->twidth+cleft)*2;
-	MEM_BlockCopy(dest,src,(cright-cleft)*2);
+	MEM_BlockMove(dest,src,(cright-cleft)*2);
 }
 
 static void CGA2_FillRow(uint8_t cleft,uint8_t cright,uint8_t row,PhysPt base,uint8_t attr) {
@@ -98,10 +100,8 @@ static void CGA2_FillRow(uint8_t cleft,uint8_t cright,uint8_t row,PhysPt base,ui
 	Bitu nextline=CurMode->twidth;
 	attr=(attr & 0x3) | ((attr & 0x3) << 2) | ((attr & 0x3) << 4) | ((attr & 0x3) << 6);
 	for (Bitu i=0;i<cheight/2U;i++) {
-		for (Bitu x=0;x<copy;x++) {
-			mem_writeb(dest+x,attr);
-			mem_writeb(dest+8*1024+x,attr);
-		}
+		VGA_BlockFill(dest,attr,copy);
+		VGA_BlockFill(dest+8*1024,attr,copy);
 		dest+=nextline;
 	}
 }
@@ -112,10 +112,8 @@ static void CGA4_FillRow(uint8_t cleft,uint8_t cright,uint8_t row,PhysPt base,ui
 	Bitu copy=(cright-cleft)*2;Bitu nextline=CurMode->twidth*2;
 	attr=(attr & 0x3) | ((attr & 0x3) << 2) | ((attr & 0x3) << 4) | ((attr & 0x3) << 6);
 	for (Bitu i=0;i<cheight/2U;i++) {
-		for (Bitu x=0;x<copy;x++) {
-			mem_writeb(dest+x,attr);
-			mem_writeb(dest+8*1024+x,attr);
-		}
+		VGA_BlockFill(dest,attr,copy);
+		VGA_BlockFill(dest+8*1024,attr,copy);
 		dest+=nextline;
 	}
 }
@@ -127,9 +125,7 @@ static void TANDY16_FillRow(uint8_t cleft,uint8_t cright,uint8_t row,PhysPt base
 	Bitu copy=(cright-cleft)*4;Bitu nextline=CurMode->twidth*4;
 	attr=(attr & 0xf) | (attr & 0xf) << 4;
 	for (Bitu i=0;i<static_cast<Bitu>(cheight/banks);i++) {
-		for (Bitu x=0;x<copy;x++) {
-			for (Bitu b=0;b<banks;b++) mem_writeb(dest+b*8*1024+x,attr);
-		}
+		for (Bitu b=0;b<banks;b++) VGA_BlockFill(dest+b*8*1024,attr,copy);
 		dest+=nextline;
 	}
 }
@@ -147,7 +143,7 @@ static void EGA16_FillRow(uint8_t cleft,uint8_t cright,uint8_t row,PhysPt base,u
 	Bitu nextline=CurMode->twidth;
 	Bitu copy = cheight;Bitu rowsize=(cright-cleft);
 	for (;copy>0;copy--) {
-		for (Bitu x=0;x<rowsize;x++) mem_writeb(dest+x,0xff);
+		VGA_BlockFill(dest,0xff,rowsize);
 		dest+=nextline;
 	}
 	IO_Write(0x3cf,0);
@@ -160,7 +156,7 @@ static void VGA_FillRow(uint8_t cleft,uint8_t cright,uint8_t row,PhysPt base,uin
 	Bitu nextline=8*CurMode->twidth;
 	Bitu copy = cheight;Bitu rowsize=8*(cright-cleft);
 	for (;copy>0;copy--) {
-		for (Bitu x=0;x<rowsize;x++) mem_writeb(dest+x,attr);
+		VGA_BlockFill(dest,attr,rowsize);
 		dest+=nextline;
 	}
 }
@@ -169,11 +165,14 @@ static void TEXT_FillRow(uint8_t cleft,uint8_t cright,uint8_t row,PhysPt base,ui
 	/* Do some filing */
 	PhysPt dest;
 	dest=base+(row*CurMode->twidth+cleft)*2;
-	uint16_t fill=(attr<<8)+' ';
-	for (uint8_t x=0;x<(cright-cleft);x++) {
-		mem_writew(dest,fill);
-		dest+=2;
-	}
+	/* Write the whole row at once */
+	std::array<uint8_t, 2 * 256> fill;
+	const Bitu rowsize = (cright-cleft)*2;
+	for (Bitu x=0;x<rowsize;x+=2) {
+		fill[x]=' ';
+		fill[x+1]=attr;
+	}
+	MEM_BlockWrite(dest,fill.data(),rowsize);
 }
 
 uint16_t INT10_GetTextColumns()
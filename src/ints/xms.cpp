@@ -380,7 +380,7 @@ static Result xms_move_memory(const PhysPt bpt)
 		++a20.num_times_enabled;
 		a20_enable(true);
 
-		mem_memcpy(destpt, srcpt, length);
+		MEM_BlockMove(destpt, srcpt, length);
 
 		--a20.num_times_enabled;
 		if (!a20_was_enabled) {
@@ -112,7 +112,7 @@ static int32_t MP3_open(Sound_Sample* const sample, const char* const ext)
 
     bool result;
     // Count the MP3's frames
-    const uint64_t num_frames = populate_seek_points(p_mp3, result);
+    const uint64_t num_frames = populate_seek_points(p_mp3, internal->rw, result);
     if (!result) {
         SNDDBG(("MP3: Unable to count the number of PCM frames.\n"));
         MP3_close(sample);
@@ -4,7 +4,14 @@
 
 #include "mp3_seek_table.h"
 
+// System headers
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <fstream>
+
 // Local headers
+#include "misc/std_filesystem.h"
 #include "utils/math_utils.h"
 
 // How many compressed MP3 frames should we skip between each recorded
@@ -13,8 +20,7 @@
 //   - a smaller numbers (below 10) results in fast seeks on slow hardware.
 constexpr uint32_t FRAMES_PER_SEEK_POINT = 7;
 
-// This function generates a new seek-table for a given mp3 stream and writes
-// the data to the fast-seek file.
+// This function generates a new seek-table for a given mp3 stream.
 //
 static uint64_t generate_new_seek_points(drmp3* const p_dr,
                                          std::vector<drmp3_seek_point>& seek_points_vector) {
@@ -65,15 +71,175 @@ static uint64_t generate_new_seek_points(drmp3* const p_dr,
     return pcm_frame_count;
 }
 
-uint64_t populate_seek_points(mp3_t* p_mp3, bool &result)
+// Seek table cache
+// ----------------
+// The cache files hold a small header followed by the seek points as laid out
+// in memory. Files written by a build with a different layout are rejected by
+// the header check and simply regenerated.
+//
+static std::string seek_table_cache_dir = {};
+
+constexpr std::array<char, 8> CACHE_MAGIC   = {'D', 'B', 'M', 'P', '3', 'S', 'T', '1'};
+constexpr size_t CACHE_HASHED_BYTES         = 64 * 1024;
+constexpr uint32_t MAX_CACHED_SEEK_POINTS   = 1 << 22;
+
+struct seek_table_cache_header {
+    std::array<char, 8> magic = {};
+    uint32_t point_size       = 0;
+    uint32_t num_points       = 0;
+    uint64_t pcm_frame_count  = 0;
+};
+
+void mp3_set_seek_table_cache_dir(const std::string& dir)
+{
+    seek_table_cache_dir = dir;
+}
+
+// Identifies the stream by a FNV-1a hash of its first and last bytes and its
+// size, which is cheap and doesn't depend on the file's name or location. The
+// head alone isn't enough: rips of the same album can share a large ID3 tag
+// with the cover art, leaving no audio in the hashed bytes.
+static std::string get_cache_path(SDL_RWops* const rw)
+{
+    if (seek_table_cache_dir.empty() || !rw) {
+        return {};
+    }
+
+    const auto stream_size = SDL_RWsize(rw);
+    const auto saved_pos   = SDL_RWtell(rw);
+    if (stream_size <= 0 || saved_pos < 0) {
+        return {};
+    }
+
+    uint64_t hash = 0xcbf29ce484222325;
+    auto add_byte = [&hash](const uint8_t byte) {
+        hash ^= byte;
+        hash *= 0x100000001b3;
+    };
+
+    std::vector<uint8_t> buffer(CACHE_HASHED_BYTES);
+    auto add_bytes_at = [&](const int64_t offset) {
+        if (SDL_RWseek(rw, offset, RW_SEEK_SET) < 0) {
+            return false;
+        }
+        const auto num_read = SDL_RWread(rw, buffer.data(), 1, buffer.size());
+        for (size_t i = 0; i < num_read; ++i) {
+            add_byte(buffer[i]);
+        }
+        return true;
+    };
+
+    const auto tail_offset = std::max(static_cast<int64_t>(0),
+                                      static_cast<int64_t>(stream_size) -
+                                              static_cast<int64_t>(CACHE_HASHED_BYTES));
+    const auto hashed = add_bytes_at(0) && add_bytes_at(tail_offset);
+    SDL_RWseek(rw, saved_pos, RW_SEEK_SET);
+    if (!hashed) {
+        return {};
+    }
+
+    for (auto size = static_cast<uint64_t>(stream_size); size; size >>= 8) {
+        add_byte(static_cast<uint8_t>(size & 0xff));
+    }
+
+    char filename[32];
+    snprintf(filename, sizeof(filename), "%016llx.mp3seek",
+             static_cast<unsigned long long>(hash));
+    return (std_fs::path(seek_table_cache_dir) / filename).string();
+}
+
+static uint64_t load_cached_seek_points(const std::string& path,
+                                        std::vector<drmp3_seek_point>& seek_points_vector)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return 0;
+    }
+
+    seek_table_cache_header header = {};
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in
+        || header.magic != CACHE_MAGIC
+        || header.point_size != sizeof(drmp3_seek_point)
+        || header.num_points == 0
+        || header.num_points > MAX_CACHED_SEEK_POINTS
+        || header.pcm_frame_count == 0) {
+        return 0;
+    }
+
+    seek_points_vector.resize(header.num_points);
+    in.read(reinterpret_cast<char*>(seek_points_vector.data()),
+            static_cast<std::streamsize>(header.num_points * sizeof(drmp3_seek_point)));
+    if (!in) {
+        seek_points_vector.clear();
+        return 0;
+    }
+    return header.pcm_frame_count;
+}
+
+static void save_cached_seek_points(const std::string& path,
+                                    const std::vector<drmp3_seek_point>& seek_points_vector,
+                                    const uint64_t pcm_frame_count)
+{
+    std::error_code ec = {};
+    std_fs::create_directories(seek_table_cache_dir, ec);
+    if (ec) {
+        return;
+    }
+
+    // Write to a temporary file first so a concurrently running instance
+    // never sees a partial table
+    const auto temp_path = path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return;
+        }
+        seek_table_cache_header header = {};
+        header.magic           = CACHE_MAGIC;
+        header.point_size      = sizeof(drmp3_seek_point);
+        header.num_points      = static_cast<uint32_t>(seek_points_vector.size());
+        header.pcm_frame_count = pcm_frame_count;
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(seek_points_vector.data()),
+                  static_cast<std::streamsize>(seek_points_vector.size() *
+                                               sizeof(drmp3_seek_point)));
+        if (!out) {
+            out.close();
+            std_fs::remove(temp_path, ec);
+            return;
+        }
+    }
+    std_fs::rename(temp_path, path, ec);
+    if (ec) {
+        std_fs::remove(temp_path, ec);
+    }
+}
+
+uint64_t populate_seek_points(mp3_t* p_mp3, SDL_RWops* rw, bool &result)
 {
     // assume failure until proven otherwise
     result = false;
 
-    const auto pcm_frame_count = generate_new_seek_points(p_mp3->p_dr,
-                                                          p_mp3->seek_points_vector);
+    const auto cache_path = get_cache_path(rw);
+
+    uint64_t pcm_frame_count = 0;
+    if (!cache_path.empty()) {
+        pcm_frame_count = load_cached_seek_points(cache_path,
+                                                  p_mp3->seek_points_vector);
+    }
     if (pcm_frame_count == 0) {
-        return 0;
+        pcm_frame_count = generate_new_seek_points(p_mp3->p_dr,
+                                                   p_mp3->seek_points_vector);
+        if (pcm_frame_count == 0) {
+            return 0;
+        }
+        if (!cache_path.empty()) {
+            save_cached_seek_points(cache_path,
+                                    p_mp3->seek_points_vector,
+                                    pcm_frame_count);
+        }
     }
 
     // We bind our seek points to the dr_mp3 object which will be used for fast seeking.
@@ -16,6 +16,7 @@
 
 #include "dosbox_config.h"
 
+#include <string>    // provides: string
 #include <vector>    // provides: vector
 #include <SDL.h>     // provides: SDL_RWops
 
@@ -33,6 +34,11 @@ struct mp3_t {
     std::vector<drmp3_seek_point> seek_points_vector = {};
 };
 
-uint64_t populate_seek_points(mp3_t* p_mp3, bool &result);
+// Generating a seek table needs a scan of the entire stream, so the tables
+// are kept in this directory between runs, named after a hash of the stream's
+// start, end and size. An empty directory disables the cache.
+void mp3_set_seek_table_cache_dir(const std::string& dir);
+
+uint64_t populate_seek_points(mp3_t* p_mp3, SDL_RWops* rw, bool &result);
 
 #endif
@@ -16,7 +16,7 @@
 #include "audio/mixer.h"
 #include "misc/std_filesystem.h"
 #include "utils/dynlib.h"
-#include "utils/rwqueue.h"
+#include "utils/spsc_queue.h"
 
 namespace FluidSynth {
 
@@ -68,8 +68,8 @@ private:
 	FluidSynthPtr synth{nullptr, FluidSynth::delete_fluid_synth};
 
 	MixerChannelPtr mixer_channel = nullptr;
-	RWQueue<AudioFrame> audio_frame_fifo{1};
-	RWQueue<MidiWork> work_fifo{1};
+	SpscQueue<AudioFrame> audio_frame_fifo{1};
+	SpscQueue<MidiWork> work_fifo{1};
 	std::thread renderer = {};
 
 	std_fs::path soundfont_path = {};
@@ -22,7 +22,7 @@
 #include "audio/mixer.h"
 #include "midi/midi.h"
 #include "misc/std_filesystem.h"
-#include "utils/rwqueue.h"
+#include "utils/spsc_queue.h"
 
 // forward declaration
 class LASynthModel;
@@ -69,8 +69,8 @@ private:
 
 	// Managed objects
 	MixerChannelPtr channel = nullptr;
-	RWQueue<AudioFrame> audio_frame_fifo{1};
-	RWQueue<MidiWork> work_fifo{1};
+	SpscQueue<AudioFrame> audio_frame_fifo{1};
+	SpscQueue<MidiWork> work_fifo{1};
 
 	std::mutex service_mutex                  = {};
 	std::unique_ptr<MT32Emu::Service> service = {};
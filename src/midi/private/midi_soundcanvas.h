@@ -12,7 +12,7 @@
 #include "audio/clap/event_list.h"
 #include "audio/clap/plugin.h"
 #include "audio/mixer.h"
-#include "utils/rwqueue.h"
+#include "utils/spsc_queue.h"
 
 namespace SoundCanvas {
 
@@ -86,8 +86,8 @@ private:
 
 	// Managed objects
 	MixerChannelPtr mixer_channel = nullptr;
-	RWQueue<AudioFrame> audio_frame_fifo{1};
-	RWQueue<MidiWork> work_fifo{1};
+	SpscQueue<AudioFrame> audio_frame_fifo{1};
+	SpscQueue<MidiWork> work_fifo{1};
 
 	struct {
 		std::unique_ptr<Clap::Plugin> plugin = nullptr;
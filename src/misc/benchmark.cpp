@@ -0,0 +1,182 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "benchmark.h"
+
+#include <array>
+#include <cstdio>
+#include <fstream>
+
+#include "dosbox.h"
+
+#include "audio/mixer.h"
+#include "cpu/cpu.h"
+#include "misc/perf_counters.h"
+#include "utils/checks.h"
+#include "utils/string_utils.h"
+
+CHECK_NARROWING();
+
+using clock_type = std::chrono::steady_clock;
+
+static struct {
+	bool active    = false;
+	bool measuring = false;
+
+	int64_t duration_ms     = 0;
+	int64_t elapsed_ms      = 0;
+	std::string output_path = {};
+
+	clock_type::time_point start_time = {};
+
+	std::array<clock_type::duration, static_cast<size_t>(BenchmarkPhase::NumPhases)>
+	        phase_times = {};
+
+	// Counter snapshots taken at the start of the run
+	uint64_t start_cycles = 0;
+	uint64_t start_frames = 0;
+} benchmark = {};
+
+constexpr std::array<const char*, static_cast<size_t>(BenchmarkPhase::NumPhases)> PhaseNames = {
+        "cpu", "callbacks", "pic_events", "tick_handlers", "host_events"};
+
+void BENCHMARK_Start(const int duration_ms, const std::string& output_path)
+{
+	benchmark = {};
+
+	benchmark.active      = true;
+	benchmark.duration_ms = duration_ms;
+	benchmark.output_path = output_path;
+
+	// Don't let the audio output pace the emulation
+	MIXER_EnableFastForwardMode();
+
+	LOG_MSG("BENCHMARK: Running for %d emulated milliseconds", duration_ms);
+}
+
+// The measurement starts at the first emulated tick, so the time spent
+// initialising the emulator is not included
+static void begin_measurement()
+{
+	benchmark.start_cycles = perf_counters.cycles;
+	benchmark.start_frames = perf_counters.frames_rendered;
+	benchmark.start_time   = clock_type::now();
+
+	benchmark.phase_times = {};
+	benchmark.measuring   = true;
+
+	if (CPU_CycleAutoAdjust) {
+		LOG_WARNING(
+		        "BENCHMARK: Automatic cycles adjustment is disabled in benchmark "
+		        "mode, running at a fixed %d cycles per millisecond",
+		        CPU_CycleMax);
+	}
+}
+
+bool BENCHMARK_IsActive()
+{
+	return benchmark.active;
+}
+
+void BENCHMARK_AddPhaseTime(const BenchmarkPhase phase,
+                            const std::chrono::steady_clock::duration duration)
+{
+	benchmark.phase_times[static_cast<size_t>(phase)] += duration;
+}
+
+static double to_seconds(const clock_type::duration duration)
+{
+	return std::chrono::duration_cast<std::chrono::duration<double>>(duration).count();
+}
+
+static std::string make_report()
+{
+	const auto wall_time = clock_type::now() - benchmark.start_time;
+	const auto wall_s    = to_seconds(wall_time);
+
+	const auto cycles = perf_counters.cycles - benchmark.start_cycles;
+	const auto frames = perf_counters.frames_rendered - benchmark.start_frames;
+
+	auto per_second = [&](const double value) {
+		return wall_s > 0.0 ? value / wall_s : 0.0;
+	};
+
+	const auto mixer_callbacks = perf_counters.mixer_callbacks.load();
+	const auto mixer_callback_us =
+	        mixer_callbacks
+	                ? static_cast<double>(perf_counters.mixer_callback_time_us.load()) /
+	                          static_cast<double>(mixer_callbacks)
+	                : 0.0;
+
+	std::string report = "{";
+
+	report += format_str("\"version\":\"%s\",", DOSBOX_GetDetailedVersion());
+	report += format_str("\"emulated_ms\":%lld,",
+	                     static_cast<long long>(benchmark.elapsed_ms));
+	report += format_str("\"wall_time_s\":%.6f,", wall_s);
+	report += format_str("\"realtime_factor\":%.3f,",
+	                     per_second(static_cast<double>(benchmark.elapsed_ms) / 1000.0));
+	report += format_str("\"cycles_per_ms\":%d,", CPU_CycleMax);
+	report += format_str("\"cycles\":%llu,", static_cast<unsigned long long>(cycles));
+	report += format_str("\"cycles_per_second\":%.0f,",
+	                     per_second(static_cast<double>(cycles)));
+	report += format_str("\"frames\":%llu,", static_cast<unsigned long long>(frames));
+	report += format_str("\"frames_per_second\":%.3f,",
+	                     per_second(static_cast<double>(frames)));
+	report += format_str("\"mixer_callback_avg_us\":%.3f,", mixer_callback_us);
+
+	report += "\"phases_s\":{";
+
+	auto accounted = clock_type::duration::zero();
+	for (size_t i = 0; i < PhaseNames.size(); ++i) {
+		report += format_str("\"%s\":%.6f,",
+		                     PhaseNames[i],
+		                     to_seconds(benchmark.phase_times[i]));
+		accounted += benchmark.phase_times[i];
+	}
+	report += format_str("\"other\":%.6f}", to_seconds(wall_time - accounted));
+
+	report += "}\n";
+	return report;
+}
+
+static void write_report()
+{
+	const auto report = make_report();
+
+	if (benchmark.output_path.empty()) {
+		printf("%s", report.c_str());
+		fflush(stdout);
+		return;
+	}
+
+	std::ofstream out(benchmark.output_path, std::ios::trunc);
+	if (!out) {
+		LOG_ERR("BENCHMARK: Could not write report to '%s'",
+		        benchmark.output_path.c_str());
+		printf("%s", report.c_str());
+		return;
+	}
+	out << report;
+
+	LOG_MSG("BENCHMARK: Wrote report to '%s'", benchmark.output_path.c_str());
+}
+
+bool BENCHMARK_AddTick()
+{
+	if (!benchmark.active) {
+		return false;
+	}
+	if (!benchmark.measuring) {
+		begin_measurement();
+		return false;
+	}
+
+	if (++benchmark.elapsed_ms < benchmark.duration_ms) {
+		return false;
+	}
+
+	write_report();
+	benchmark.active = false;
+	return true;
+}
@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_BENCHMARK_H
+#define DOSBOX_BENCHMARK_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Deterministic headless benchmark mode
+//
+// Started with the '--benchmark <ms>' command line option. The emulation runs
+// for the given number of emulated milliseconds as fast as the host allows
+// (no sleeping, no auto cycles adjustment, no audio device, no visible
+// window), then a machine-readable JSON report is written and the emulator
+// exits.
+
+enum class BenchmarkPhase {
+	Cpu,          // CPU core (cpudecoder)
+	Callbacks,    // BIOS and DOS services implemented in the host
+	PicEvents,    // PIC event queue (VGA, timers, device emulation)
+	TickHandlers, // Per-millisecond tick handlers (audio devices, timers)
+	HostEvents,   // Host event polling and frame presentation
+
+	NumPhases
+};
+
+void BENCHMARK_Start(const int duration_ms, const std::string& output_path);
+
+bool BENCHMARK_IsActive();
+
+// Called after each emulated millisecond; returns true when the benchmark is
+// finished, after writing the report
+bool BENCHMARK_AddTick();
+
+void BENCHMARK_AddPhaseTime(const BenchmarkPhase phase,
+                            const std::chrono::steady_clock::duration duration);
+
+// Measures the host time spent in a scope; compiles to nothing when disabled
+// so the timing doesn't cost anything outside of benchmark mode
+template <bool Enabled>
+class BenchmarkPhaseTimer {
+public:
+	explicit BenchmarkPhaseTimer(const BenchmarkPhase) {}
+};
+
+template <>
+class BenchmarkPhaseTimer<true> {
+public:
+	explicit BenchmarkPhaseTimer(const BenchmarkPhase phase)
+	        : phase(phase),
+	          start(std::chrono::steady_clock::now())
+	{}
+
+	~BenchmarkPhaseTimer()
+	{
+		BENCHMARK_AddPhaseTime(phase, std::chrono::steady_clock::now() - start);
+	}
+
+	BenchmarkPhaseTimer(const BenchmarkPhaseTimer&)            = delete;
+	BenchmarkPhaseTimer& operator=(const BenchmarkPhaseTimer&) = delete;
+
+private:
+	const BenchmarkPhase phase;
+	const std::chrono::steady_clock::time_point start;
+};
+
+#endif // DOSBOX_BENCHMARK_H
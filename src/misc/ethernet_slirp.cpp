@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <algorithm>
+#include <chrono>
 #include <map>
 #include <stdexcept>
 
@@ -9,12 +10,21 @@
 #include <sys/socket.h> // AF_INET
 #endif
 
+#ifndef WIN32
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #include "dosbox.h"
 #include "dosbox_config.h"
 #include "utils/dynlib.h"
 #include "ethernet_slirp.h"
 #include "hardware/timer.h"
 #include "config/setup.h"
+#include "misc/support.h"
 #include "utils/string_utils.h"
 
 /**
@@ -28,6 +38,21 @@ constexpr const char* libslirp_dynlib_file = "libslirp.dylib";
 constexpr const char* libslirp_dynlib_file = "libslirp.so.0";
 #endif
 
+// Without a way to wake the network thread up, it waits at most this long
+// for the host sockets, so the packets sent by the guest are picked up
+// about as often as with the polling on every emulated millisecond
+constexpr uint32_t PollIntervalMs = 1;
+
+// Otherwise the guest's packets wake it up, and it waits for as long as
+// libslirp and its timers allow, up to this
+constexpr uint32_t MaxPollTimeoutMs = 1000;
+
+// Per direction; more than the NE2000's receive ring can hold
+constexpr size_t MaxQueuedPackets = 256;
+
+// Packets moved between a queue and the thread owning the batch at once
+constexpr size_t PacketBatchSize = 16;
+
 namespace LibSlirp
 {
 /**
@@ -190,6 +215,22 @@ SlirpEthernetConnection::SlirpEthernetConnection()
 
 SlirpEthernetConnection::~SlirpEthernetConnection()
 {
+	// Stop the network thread before tearing down libslirp
+	is_running = false;
+	tx_queue.Stop();
+	rx_queue.Stop();
+	if (network_thread.joinable()) {
+		Wake();
+		network_thread.join();
+	}
+#ifndef WIN32
+	for (const auto fd : wake_pipe) {
+		if (fd >= 0) {
+			close(fd);
+		}
+	}
+#endif
+
 	if (slirp)
 		LibSlirp::slirp_cleanup(slirp);
 }
@@ -266,6 +307,28 @@ bool SlirpEthernetConnection::Initialize(Section *dosbox_config)
 		ClearPortForwards(is_udp, forwarded_udp_ports);
 		forwarded_udp_ports = SetupPortForwards(is_udp, section->GetString("udp_port_forwards"));
 
+		// From here on, libslirp is only used by the network thread
+		tx_queue.Resize(MaxQueuedPackets);
+		rx_queue.Resize(MaxQueuedPackets);
+		tx_batch.resize(PacketBatchSize);
+		rx_batch.resize(PacketBatchSize);
+
+#ifndef WIN32
+		if (pipe(wake_pipe) == 0) {
+			for (const auto fd : wake_pipe) {
+				fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+			}
+		} else {
+			LOG_WARNING("SLIRP: Failed to create the network thread's wake-up pipe: %s",
+			            strerror(errno));
+			wake_pipe[0] = wake_pipe[1] = -1;
+		}
+#endif
+
+		is_running     = true;
+		network_thread = std::thread(&SlirpEthernetConnection::Run, this);
+		set_thread_name(network_thread, "dosbox:slirp");
+
 		LOG_MSG("SLIRP: Successfully initialized");
 		return true;
 	} else {
@@ -417,19 +480,96 @@ void SlirpEthernetConnection::SendPacket(const uint8_t *packet, int len)
 		            len, GetMTU());
 		return;
 	}
-	LibSlirp::slirp_input(slirp, packet, len);
+	// Dropped if the network thread can't keep up
+	if (tx_queue.NonblockingEnqueue(packet_t(packet, packet + len)))
+		Wake();
 }
 
 void SlirpEthernetConnection::GetPackets(std::function<int(const uint8_t *, int)> callback)
 {
-	get_packet_callback = callback;
-	uint32_t timeout_ms = 0;
-	PollsClear();
-	PollsAddRegistered();
-	LibSlirp::slirp_pollfds_fill(slirp, &timeout_ms, db_slirp_add_poll, this);
-	const bool poll_failed = !PollsPoll(timeout_ms);
-	LibSlirp::slirp_pollfds_poll(slirp, poll_failed, db_slirp_get_revents, this);
-	TimersRun();
+	// Only hands over what the network thread has received, so this
+	// never waits for the host sockets
+	size_t num_packets = 0;
+	while ((num_packets = rx_queue.NonblockingBulkDequeue(rx_batch)) > 0) {
+		for (size_t i = 0; i < num_packets; ++i) {
+			const auto& packet = rx_batch[i];
+			callback(packet.data(), check_cast<int>(packet.size()));
+		}
+	}
+}
+
+void SlirpEthernetConnection::SendQueuedPackets()
+{
+	size_t num_packets = 0;
+	while ((num_packets = tx_queue.NonblockingBulkDequeue(tx_batch)) > 0) {
+		for (size_t i = 0; i < num_packets; ++i) {
+			const auto& packet = tx_batch[i];
+			LibSlirp::slirp_input(slirp,
+			                      packet.data(),
+			                      check_cast<int>(packet.size()));
+		}
+	}
+}
+
+void SlirpEthernetConnection::Run()
+{
+#ifndef WIN32
+	const bool can_wake = (wake_pipe[0] >= 0);
+#else
+	// select() only takes sockets, so there's nothing to wake it up with
+	constexpr bool can_wake = false;
+#endif
+	const auto max_timeout_ms = can_wake ? MaxPollTimeoutMs : PollIntervalMs;
+
+	while (is_running) {
+#ifndef WIN32
+		// Cleared before taking the packets, so any sent after this
+		// wake the thread up again
+		is_wake_pending = false;
+#endif
+		SendQueuedPackets();
+
+		uint32_t timeout_ms = TimersTimeoutMs(max_timeout_ms);
+		PollsClear();
+#ifndef WIN32
+		// Always the first descriptor
+		if (can_wake)
+			PollAdd(wake_pipe[0], SLIRP_POLL_IN);
+#endif
+		PollsAddRegistered();
+		LibSlirp::slirp_pollfds_fill(slirp, &timeout_ms, db_slirp_add_poll, this);
+		const bool poll_failed = !PollsPoll(timeout_ms);
+#ifndef WIN32
+		if (can_wake && !poll_failed && (polls.front().revents & POLLIN))
+			DrainWakeups();
+#endif
+		LibSlirp::slirp_pollfds_poll(slirp, poll_failed, db_slirp_get_revents, this);
+		TimersRun();
+
+		// Without any descriptors to wait on, poll() and select()
+		// return right away
+		if (poll_failed)
+			std::this_thread::sleep_for(std::chrono::milliseconds(PollIntervalMs));
+	}
+}
+
+void SlirpEthernetConnection::Wake()
+{
+#ifndef WIN32
+	if (wake_pipe[1] < 0 || is_wake_pending.exchange(true))
+		return;
+	constexpr uint8_t Wakeup = 1;
+	[[maybe_unused]] const auto result = write(wake_pipe[1], &Wakeup, 1);
+#endif
+}
+
+void SlirpEthernetConnection::DrainWakeups()
+{
+#ifndef WIN32
+	std::array<uint8_t, 64> buffer = {};
+	while (read(wake_pipe[0], buffer.data(), buffer.size()) > 0) {
+	}
+#endif
 }
 
 int SlirpEthernetConnection::ReceivePacket(const uint8_t *packet, int len)
@@ -442,7 +582,11 @@ int SlirpEthernetConnection::ReceivePacket(const uint8_t *packet, int len)
 		            len, GetMRU());
 		return -1;
 	}
-	return get_packet_callback(packet, len);
+	// The emulation thread picks it up with GetPackets; it's dropped if
+	// the guest isn't keeping up
+	if (!rx_queue.NonblockingEnqueue(packet_t(packet, packet + len)))
+		return -1;
+	return len;
 }
 
 struct slirp_timer *SlirpEthernetConnection::TimerNew(SlirpTimerCb cb, void *cb_opaque)
@@ -479,6 +623,18 @@ void SlirpEthernetConnection::TimersRun()
 	}
 }
 
+uint32_t SlirpEthernetConnection::TimersTimeoutMs(const uint32_t max_timeout_ms) const
+{
+	const int64_t now = db_slirp_clock_get_ns(nullptr);
+	int64_t timeout_ns = int64_t{max_timeout_ms} * 1'000'000;
+	for (const struct slirp_timer *timer : timers) {
+		if (timer->expires_ns)
+			timeout_ns = std::min(timeout_ns, timer->expires_ns - now);
+	}
+	// Rounded up, so the timer has expired when the thread wakes up
+	return static_cast<uint32_t>((std::max(timeout_ns, int64_t{0}) + 999'999) / 1'000'000);
+}
+
 void SlirpEthernetConnection::TimersClear()
 {
 	for (auto *timer : timers)
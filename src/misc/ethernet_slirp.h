@@ -6,14 +6,17 @@
 
 #include "dosbox.h"
 
+#include <atomic>
 #include <map>
 #include <deque>
+#include <thread>
 #include <vector>
 
 #include <slirp/libslirp.h>
 
 #include "dosbox_config.h"
 #include "misc/ethernet.h"
+#include "utils/spsc_queue.h"
 
 /*
  * libslirp really wants a poll() API, so we'll use that when we're
@@ -44,6 +47,11 @@ struct slirp_timer {
  * This backend uses a virtual Ethernet device. Only TCP, UDP and some ICMP
  * work over this interface. This is because libslirp terminates guest
  * connections during routing and passes them to sockets created in the host.
+ *
+ * libslirp runs on its own network thread, which does all the polling of
+ * the host sockets. The packets are passed between the emulation thread and
+ * the network thread through a lock-free queue in each direction, so
+ * SendPacket and GetPackets never block the emulation.
  */
 class SlirpEthernetConnection : public EthernetConnection {
 public:
@@ -59,7 +67,7 @@ public:
 	void SendPacket(const uint8_t* packet, int len) override;
 	void GetPackets(std::function<int(const uint8_t*, int)> callback) override;
 
-	/* Called by libslirp when it has a packet for us */
+	/* Called by libslirp on the network thread when it has a packet for us */
 	int ReceivePacket(const uint8_t* packet, int len);
 
 	// Used in callbacks to bounds-check packet lengths
@@ -84,9 +92,20 @@ public:
 	void PollUnregister(int fd);
 
 private:
+	using packet_t = std::vector<uint8_t>;
+
+	/* The network thread's loop, and the guest packets it passes on */
+	void Run();
+	void SendQueuedPackets();
+
+	/* Wakes the network thread up from waiting on the host sockets */
+	void Wake();
+	void DrainWakeups();
+
 	/* Runs and clears all the timers*/
 	void TimersRun();
 	void TimersClear();
+	uint32_t TimersTimeoutMs(uint32_t max_timeout_ms) const;
 
 	void ClearPortForwards(const bool is_udp, std::map<int, int> &existing_port_forwards);
 	std::map<int, int> SetupPortForwards(const bool is_udp, const std::string &port_forward_rules);
@@ -101,15 +120,19 @@ private:
 	SlirpCb slirp_callbacks = {};  /*!< Callbacks used by libslirp */
 	std::deque<struct slirp_timer *> timers = {}; /*!< Stored timers */
 
-	/** The GetPacket callback
-	 * When libslirp has a new packet for us it calls ReceivePacket,
-	 * but the EthernetConnection interface requires users to poll
-	 * for new packets using GetPackets. We temporarily store the
-	 * callback from GetPackets here for ReceivePacket.
-	 * This might seem racy, but keep in mind we control when
-	 * libslirp sends us packets via our polling system.
+	/** Packets sent by the guest (tx) and received from libslirp (rx)
+	 * The emulation thread produces the tx packets and consumes the rx
+	 * packets, the network thread does the opposite. Packets that don't
+	 * fit in a full queue are dropped, like on a congested link.
 	 */
-	std::function<int(const uint8_t *, int)> get_packet_callback = nullptr;
+	SpscQueue<packet_t> tx_queue{1};
+	SpscQueue<packet_t> rx_queue{1};
+
+	std::vector<packet_t> tx_batch = {}; /*!< Used by the network thread */
+	std::vector<packet_t> rx_batch = {}; /*!< Used by the emulation thread */
+
+	std::thread network_thread   = {};
+	std::atomic<bool> is_running = false;
 
 	std::deque<int> registered_fds = {}; /*!< File descriptors to watch */
 
@@ -119,6 +142,12 @@ private:
 
 #ifndef WIN32
 	std::vector<struct pollfd> polls = {}; /*!< Descriptors for poll() */
+
+	// Wakes the network thread up when the guest sends a packet or the
+	// connection is closed. Only the first packet since the thread last
+	// woke up writes to the pipe.
+	int wake_pipe[2] = {-1, -1};
+	std::atomic<bool> is_wake_pending = false;
 #else
 	fd_set readfds = {};   /*!< Read descriptors for select() */
 	fd_set writefds = {};  /*!< Write descriptors for select() */
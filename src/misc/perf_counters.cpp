@@ -0,0 +1,250 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "perf_counters.h"
+
+#include <chrono>
+#include <fstream>
+#include <string>
+
+#include "dosbox.h"
+
+#include "config/setup.h"
+#include "cpu/cpu.h"
+#include "utils/checks.h"
+#include "utils/string_utils.h"
+
+CHECK_NARROWING();
+
+PerfCounters perf_counters = {};
+
+using clock_type = std::chrono::steady_clock;
+
+static clock_type::time_point reset_time = clock_type::now();
+
+static struct {
+	std::ofstream file = {};
+	bool is_json       = false;
+
+	int64_t interval_ms = 0;
+
+	clock_type::time_point last_write = {};
+
+	// Counter values at the time of the previous log entry
+	uint64_t last_cycles = 0;
+	uint64_t last_ticks  = 0;
+} perf_log = {};
+
+double PERF_GetElapsedSeconds()
+{
+	using namespace std::chrono;
+	return duration_cast<duration<double>>(clock_type::now() - reset_time).count();
+}
+
+void PERF_Reset()
+{
+	auto& c = perf_counters;
+
+	c.ticks              = 0;
+	c.cycles             = 0;
+	c.pic_events         = 0;
+	c.io_accesses        = 0;
+	c.page_handler_calls = 0;
+	c.dyn_translations   = 0;
+	c.dyn_invalidations  = 0;
+	c.frames_rendered    = 0;
+	c.frames_dropped     = 0;
+
+	c.idle_cycles_skipped = 0;
+
+	c.dyn_flag_helpers         = 0;
+	c.dyn_flag_helpers_skipped = 0;
+
+	c.dyn_dispatches     = 0;
+	c.dyn_trace_branches = 0;
+
+	c.dyn_smc_fallbacks          = 0;
+	c.dyn_smc_fallbacks_page_max = 0;
+
+	c.descriptor_loads      = 0;
+	c.descriptor_cache_hits = 0;
+
+	c.tlb_misses  = 0;
+	c.tlb_flushes = 0;
+
+	c.io_port_accesses.fill(0);
+
+	c.mixer_callbacks        = 0;
+	c.mixer_callback_time_us = 0;
+
+	c.socket_reactor_syscalls = 0;
+
+	reset_time = clock_type::now();
+
+	perf_log.last_cycles = 0;
+	perf_log.last_ticks  = 0;
+}
+
+static void write_log_header()
+{
+	if (!perf_log.is_json) {
+		perf_log.file << "time_s,ticks,cycles,mips,cycles_per_tick,"
+		                 "pic_events,io_accesses,page_handler_calls,"
+		                 "dyn_translations,dyn_invalidations,"
+		                 "frames_rendered,frames_dropped,idle_cycles_skipped,"
+		                 "dyn_flag_helpers,dyn_flag_helpers_skipped,"
+		                 "dyn_dispatches,dyn_trace_branches,"
+		                 "dyn_smc_fallbacks,dyn_smc_fallbacks_page_max,"
+		                 "descriptor_loads,descriptor_cache_hits,"
+		                 "tlb_misses,tlb_flushes,"
+		                 "mixer_callbacks,"
+		                 "mixer_callback_time_us,capture_queue_depth,"
+		                 "socket_reactor_syscalls\n";
+	}
+}
+
+static void write_log_entry(const double interval_s)
+{
+	const auto& c = perf_counters;
+
+	const auto cycles = c.cycles - perf_log.last_cycles;
+	const auto ticks  = c.ticks - perf_log.last_ticks;
+
+	const auto mips = interval_s > 0.0
+	                        ? static_cast<double>(cycles) / interval_s / 1e6
+	                        : 0.0;
+	const auto cycles_per_tick = ticks ? cycles / ticks : 0;
+
+	const auto format = perf_log.is_json
+	                          ? std::string(
+	                                    "{\"time_s\":%.3f,\"ticks\":%llu,"
+	                                    "\"cycles\":%llu,\"mips\":%.3f,"
+	                                    "\"cycles_per_tick\":%llu,"
+	                                    "\"pic_events\":%llu,"
+	                                    "\"io_accesses\":%llu,"
+	                                    "\"page_handler_calls\":%llu,"
+	                                    "\"dyn_translations\":%llu,"
+	                                    "\"dyn_invalidations\":%llu,"
+	                                    "\"frames_rendered\":%llu,"
+	                                    "\"frames_dropped\":%llu,"
+	                                    "\"idle_cycles_skipped\":%llu,"
+	                                    "\"dyn_flag_helpers\":%llu,"
+	                                    "\"dyn_flag_helpers_skipped\":%llu,"
+	                                    "\"dyn_dispatches\":%llu,"
+	                                    "\"dyn_trace_branches\":%llu,"
+	                                    "\"dyn_smc_fallbacks\":%llu,"
+	                                    "\"dyn_smc_fallbacks_page_max\":%llu,"
+	                                    "\"descriptor_loads\":%llu,"
+	                                    "\"descriptor_cache_hits\":%llu,"
+	                                    "\"tlb_misses\":%llu,"
+	                                    "\"tlb_flushes\":%llu,"
+	                                    "\"mixer_callbacks\":%llu,"
+	                                    "\"mixer_callback_time_us\":%llu,"
+	                                    "\"capture_queue_depth\":%u,"
+	                                    "\"socket_reactor_syscalls\":%llu}\n")
+	                          : std::string(
+	                                    "%.3f,%llu,%llu,%.3f,%llu,%llu,%llu,"
+	                                    "%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,"
+	                                    "%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,"
+	                                    "%llu,%llu,%u,%llu\n");
+
+	using ull = unsigned long long;
+
+	perf_log.file << format_str(format,
+	                            PERF_GetElapsedSeconds(),
+	                            static_cast<ull>(c.ticks),
+	                            static_cast<ull>(c.cycles),
+	                            mips,
+	                            static_cast<ull>(cycles_per_tick),
+	                            static_cast<ull>(c.pic_events),
+	                            static_cast<ull>(c.io_accesses),
+	                            static_cast<ull>(c.page_handler_calls),
+	                            static_cast<ull>(c.dyn_translations),
+	                            static_cast<ull>(c.dyn_invalidations),
+	                            static_cast<ull>(c.frames_rendered),
+	                            static_cast<ull>(c.frames_dropped),
+	                            static_cast<ull>(c.idle_cycles_skipped),
+	                            static_cast<ull>(c.dyn_flag_helpers),
+	                            static_cast<ull>(c.dyn_flag_helpers_skipped),
+	                            static_cast<ull>(c.dyn_dispatches),
+	                            static_cast<ull>(c.dyn_trace_branches),
+	                            static_cast<ull>(c.dyn_smc_fallbacks),
+	                            static_cast<ull>(c.dyn_smc_fallbacks_page_max),
+	                            static_cast<ull>(c.descriptor_loads),
+	                            static_cast<ull>(c.descriptor_cache_hits),
+	                            static_cast<ull>(c.tlb_misses),
+	                            static_cast<ull>(c.tlb_flushes),
+	                            static_cast<ull>(c.mixer_callbacks.load()),
+	                            static_cast<ull>(c.mixer_callback_time_us.load()),
+	                            c.capture_queue_depth.load(),
+	                            static_cast<ull>(c.socket_reactor_syscalls.load()));
+	perf_log.file.flush();
+
+	perf_log.last_cycles = c.cycles;
+	perf_log.last_ticks  = c.ticks;
+}
+
+void PERF_AddTick(const int64_t cycles_executed)
+{
+	++perf_counters.ticks;
+	if (cycles_executed > 0) {
+		perf_counters.cycles += static_cast<uint64_t>(cycles_executed);
+	}
+
+	if (!perf_log.file.is_open()) {
+		return;
+	}
+
+	// Only check the host clock every 64 ticks to keep the cost negligible
+	constexpr uint64_t CheckIntervalTicks = 64;
+	if (perf_counters.ticks % CheckIntervalTicks != 0) {
+		return;
+	}
+
+	using namespace std::chrono;
+
+	const auto now     = clock_type::now();
+	const auto elapsed = duration_cast<milliseconds>(now - perf_log.last_write);
+	if (elapsed.count() < perf_log.interval_ms) {
+		return;
+	}
+
+	write_log_entry(duration_cast<duration<double>>(elapsed).count());
+	perf_log.last_write = now;
+}
+
+static void perf_destroy(Section* /*section*/)
+{
+	if (perf_log.file.is_open()) {
+		perf_log.file.close();
+	}
+}
+
+void PERF_Init(Section* section)
+{
+	assert(section);
+	const auto prop = static_cast<SectionProp*>(section);
+
+	const auto path = prop->GetString("perfstat_log");
+	if (path.empty()) {
+		return;
+	}
+
+	perf_log.file.open(path, std::ios::trunc);
+	if (!perf_log.file) {
+		LOG_WARNING("PERFSTAT: Could not open log file '%s'", path.c_str());
+		return;
+	}
+
+	perf_log.is_json     = (prop->GetString("perfstat_log_format") == "json");
+	perf_log.interval_ms = prop->GetInt("perfstat_log_interval") * 1000;
+	perf_log.last_write  = clock_type::now();
+
+	write_log_header();
+
+	LOG_MSG("PERFSTAT: Logging performance counters to '%s' every %d seconds",
+	        path.c_str(),
+	        prop->GetInt("perfstat_log_interval"));
+
+	section->AddDestroyFunction(&perf_destroy);
+}
@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_PERF_COUNTERS_H
+#define DOSBOX_PERF_COUNTERS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Always-available host performance counters
+//
+// The counters are cheap enough to be updated unconditionally from the hot
+// paths. Counters owned by the emulation thread are plain integers; the ones
+// updated by other threads are relaxed atomics. Readers (the PERFSTAT program
+// and the periodic log writer) run on the emulation thread.
+
+struct PerfCounters {
+	// Emulation thread
+	uint64_t ticks              = 0;
+	uint64_t cycles             = 0;
+	uint64_t pic_events         = 0;
+	uint64_t io_accesses        = 0;
+	uint64_t page_handler_calls = 0;
+	uint64_t dyn_translations   = 0;
+	uint64_t dyn_invalidations  = 0;
+	uint64_t frames_rendered    = 0;
+	uint64_t frames_dropped     = 0;
+
+	uint64_t idle_cycles_skipped = 0;
+
+	// Flag-producing helper calls emitted by the dynamic core, and how many
+	// of them were replaced because their flags were never read
+	uint64_t dyn_flag_helpers         = 0;
+	uint64_t dyn_flag_helpers_skipped = 0;
+
+	// Code blocks run from the dynamic core's dispatcher loop, and branches
+	// the dynamic core translated as part of a superblock trace
+	uint64_t dyn_dispatches     = 0;
+	uint64_t dyn_trace_branches = 0;
+
+	// Instructions the dynamic core left to the normal core because they're
+	// modified too often, in total and in the page with the most of them
+	uint64_t dyn_smc_fallbacks          = 0;
+	uint64_t dyn_smc_fallbacks_page_max = 0;
+
+	// Protected-mode descriptor reads, and how many of them were served
+	// from the descriptor cache
+	uint64_t descriptor_loads      = 0;
+	uint64_t descriptor_cache_hits = 0;
+
+	uint64_t tlb_misses  = 0;
+	uint64_t tlb_flushes = 0;
+
+	std::array<uint32_t, UINT16_MAX + 1> io_port_accesses = {};
+
+	// Mixer thread
+	std::atomic<uint64_t> mixer_callbacks        = 0;
+	std::atomic<uint64_t> mixer_callback_time_us = 0;
+	std::atomic<uint32_t> capture_queue_depth    = 0;
+
+	// Socket reactor thread
+	std::atomic<uint64_t> socket_reactor_syscalls = 0;
+};
+
+extern PerfCounters perf_counters;
+
+static inline void PERF_CountIoAccess(const uint16_t port)
+{
+	++perf_counters.io_accesses;
+	++perf_counters.io_port_accesses[port];
+}
+
+// Called once per emulated millisecond with the number of cycles the CPU
+// executed during the tick
+void PERF_AddTick(const int64_t cycles_executed);
+
+// Resets all the counters and the host time reference
+void PERF_Reset();
+
+// Seconds of host time since the counters were last reset
+double PERF_GetElapsedSeconds();
+
+// Periodic CSV/JSON log, configured from the [profiler] section
+class Section;
+void PERF_Init(Section* section);
+
+#endif // DOSBOX_PERF_COUNTERS_H
@@ -0,0 +1,326 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "profiler.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "config/setup.h"
+#include "cpu/callback.h"
+#include "cpu/cpu.h"
+#include "cpu/registers.h"
+#include "dos/dos_inc.h"
+#include "hardware/pic.h"
+#include "misc/perf_counters.h"
+#include "utils/checks.h"
+#include "utils/string_utils.h"
+
+CHECK_NARROWING();
+
+ProfilerAttribution profiler_attribution = {};
+
+// Aggregation key of a single sample
+struct SampleKey {
+	std::string program = {};
+
+	uint16_t cs     = 0;
+	uint32_t eip    = 0;
+	uint32_t linear = 0;
+
+	// Negative values mean 'no attribution'
+	int32_t io_port   = -1;
+	int32_t interrupt = -1;
+
+	bool operator<(const SampleKey& other) const
+	{
+		return std::tie(program, cs, eip, linear, io_port, interrupt) <
+		       std::tie(other.program,
+		                other.cs,
+		                other.eip,
+		                other.linear,
+		                other.io_port,
+		                other.interrupt);
+	}
+};
+
+static struct {
+	bool enabled = false;
+
+	double period_ms        = 1.0;
+	std::string output_path = {};
+
+	std::map<SampleKey, uint64_t> samples = {};
+	uint64_t num_samples                  = 0;
+} profiler = {};
+
+// Walk the DOS memory chain to find out which program owns the segment; this
+// is how we 'symbolize' real and virtual 8086 mode samples
+static std::string get_owner_name(const uint16_t segment)
+{
+	constexpr uint8_t EndingMcbType = 0x5a; // 'Z'
+	constexpr int MaxMcbBlocks      = 1000;
+
+	if (segment >= CB_SEG) {
+		return "BIOS";
+	}
+	if (dos.firstMCB == 0 || segment < dos.firstMCB) {
+		return "DOS";
+	}
+
+	uint16_t mcb_segment = dos.firstMCB;
+	DOS_MCB mcb(mcb_segment);
+
+	for (int i = 0; i < MaxMcbBlocks; ++i) {
+		const auto mcb_type = mcb.GetType();
+		if (mcb_type != EndingMcbType && mcb_type != 0x4d) { // 'M'
+			break; // corrupted chain
+		}
+
+		const uint32_t block_end = mcb_segment + mcb.GetSize() + 1;
+		if (segment > mcb_segment && segment < block_end) {
+			const auto psp_segment = mcb.GetPSPSeg();
+			if (psp_segment == MCB_FREE) {
+				return "FREE";
+			}
+			if (psp_segment == MCB_DOS) {
+				return "DOS";
+			}
+
+			char name[9] = {};
+			DOS_MCB(static_cast<uint16_t>(psp_segment - 1)).GetFileName(name);
+
+			std::string result = {};
+			for (const auto character : std::string(name)) {
+				if (isgraph(static_cast<unsigned char>(character)) &&
+				    character != ';') {
+					result.push_back(character);
+				}
+			}
+			return result.empty() ? format_str("PSP_%04X", psp_segment)
+			                      : result;
+		}
+
+		if (mcb_type == EndingMcbType || block_end > UINT16_MAX) {
+			break;
+		}
+		mcb_segment = static_cast<uint16_t>(block_end);
+		mcb.SetPt(mcb_segment);
+	}
+
+	return "UNKNOWN";
+}
+
+static void take_sample(uint32_t /*val*/)
+{
+	SampleKey key = {};
+
+	key.cs     = SegValue(cs);
+	key.eip    = reg_eip;
+	key.linear = SegPhys(cs) + reg_eip;
+
+	if (!cpu.pmode || GETFLAG(VM)) {
+		key.program = get_owner_name(key.cs);
+	} else {
+		key.program = "PMODE";
+	}
+
+	auto& attribution = profiler_attribution;
+	if (attribution.has_io_port) {
+		key.io_port             = attribution.last_io_port;
+		attribution.has_io_port = false;
+	}
+	if (attribution.has_interrupt) {
+		key.interrupt             = attribution.last_interrupt;
+		attribution.has_interrupt = false;
+	}
+
+	++profiler.samples[key];
+	++profiler.num_samples;
+
+	PIC_AddEvent(take_sample, profiler.period_ms);
+}
+
+static void write_folded_report(const std::string& path)
+{
+	std::ofstream out(path, std::ios::trunc);
+	if (!out) {
+		LOG_WARNING("PROFILER: Could not write report to '%s'", path.c_str());
+		return;
+	}
+
+	// One line per unique stack, frames separated by semicolons, followed
+	// by the sample count; this is what 'flamegraph.pl' and compatible
+	// tools (speedscope, inferno) consume
+	for (const auto& [key, count] : profiler.samples) {
+		out << key.program
+		    << format_str(";page_%05X;%04X:%08X",
+		                  key.linear >> 12,
+		                  key.cs,
+		                  key.eip);
+		if (key.interrupt >= 0) {
+			out << format_str(";int_%02X", key.interrupt);
+		}
+		if (key.io_port >= 0) {
+			out << format_str(";port_%03X", key.io_port);
+		}
+		out << ' ' << count << '\n';
+	}
+
+	LOG_MSG("PROFILER: Wrote %llu samples to '%s'",
+	        static_cast<unsigned long long>(profiler.num_samples),
+	        path.c_str());
+}
+
+static void log_hot_spots()
+{
+	constexpr size_t NumHotSpots = 10;
+
+	// Aggregate by code page and by program, ignoring attribution
+	std::map<std::pair<std::string, uint32_t>, uint64_t> pages = {};
+	std::map<std::tuple<std::string, uint16_t, uint32_t>, uint64_t> addresses = {};
+	for (const auto& [key, count] : profiler.samples) {
+		pages[{key.program, key.linear >> 12}] += count;
+		addresses[{key.program, key.cs, key.eip}] += count;
+	}
+
+	auto log_top = [&](const auto& histogram, const char* title, auto format) {
+		std::vector<std::pair<uint64_t, std::string>> sorted = {};
+		for (const auto& [entry, count] : histogram) {
+			sorted.emplace_back(count, format(entry));
+		}
+		std::sort(sorted.rbegin(), sorted.rend());
+
+		LOG_MSG("PROFILER: Hottest %s:", title);
+		for (size_t i = 0; i < std::min(NumHotSpots, sorted.size()); ++i) {
+			const auto& [count, name] = sorted[i];
+			LOG_MSG("PROFILER:   %5.1f%%  %s",
+			        100.0 * static_cast<double>(count) /
+			                static_cast<double>(profiler.num_samples),
+			        name.c_str());
+		}
+	};
+
+	log_top(pages, "code pages", [](const auto& entry) {
+		return format_str("%s page %05Xxxx",
+		                  entry.first.c_str(),
+		                  entry.second);
+	});
+	log_top(addresses, "instructions", [](const auto& entry) {
+		return format_str("%s %04X:%08X",
+		                  std::get<0>(entry).c_str(),
+		                  std::get<1>(entry),
+		                  std::get<2>(entry));
+	});
+}
+
+static void profiler_destroy(Section* /*section*/)
+{
+	if (!profiler.enabled) {
+		return;
+	}
+
+	PIC_RemoveEvents(take_sample);
+
+	if (profiler.num_samples > 0) {
+		log_hot_spots();
+		write_folded_report(profiler.output_path);
+	}
+
+	profiler.samples.clear();
+	profiler.num_samples = 0;
+	profiler.enabled     = false;
+	profiler_attribution = {};
+}
+
+static void profiler_init(Section* section)
+{
+	assert(section);
+	const auto prop = static_cast<SectionProp*>(section);
+
+	profiler.enabled = prop->GetBool("profiler");
+	if (!profiler.enabled) {
+		return;
+	}
+
+	profiler.period_ms   = 1000.0 / prop->GetInt("profiler_rate");
+	profiler.output_path = prop->GetString("profiler_output");
+
+	const auto attribution = prop->GetString("profiler_attribution");
+	profiler_attribution.track_io = (attribution == "io" || attribution == "all");
+	profiler_attribution.track_interrupts = (attribution == "interrupts" ||
+	                                         attribution == "all");
+
+	PIC_AddEvent(take_sample, profiler.period_ms);
+
+	LOG_MSG("PROFILER: Sampling guest code %d times per emulated second",
+	        prop->GetInt("profiler_rate"));
+
+	section->AddDestroyFunction(&profiler_destroy);
+}
+
+static void init_profiler_settings(SectionProp& secprop)
+{
+	constexpr auto OnlyAtStart = Property::Changeable::OnlyAtStart;
+
+	auto* bool_prop = secprop.AddBool("profiler", OnlyAtStart, false);
+	bool_prop->SetHelp(
+	        "Enable the guest sampling profiler ('off' by default).\n"
+	        "Periodically records the guest CS:EIP and writes a flamegraph-compatible\n"
+	        "report (folded stacks) on exit, plus a summary of the hottest code pages\n"
+	        "and instructions to the log.");
+
+	auto* int_prop = secprop.AddInt("profiler_rate", OnlyAtStart, 1000);
+	int_prop->SetMinMax(10, 100000);
+	int_prop->SetHelp(
+	        "Number of samples to take per emulated second (1000 by default).");
+
+	auto* str_prop = secprop.AddString("profiler_attribution", OnlyAtStart, "off");
+	str_prop->SetValues({"off", "io", "interrupts", "all"});
+	str_prop->SetHelp(
+	        "Attribute samples to the I/O ports and interrupt vectors accessed since\n"
+	        "the previous sample ('off' by default):\n"
+	        "  off:         No attribution (default).\n"
+	        "  io:          Attribute samples to I/O ports.\n"
+	        "  interrupts:  Attribute samples to interrupt vectors.\n"
+	        "  all:         Attribute samples to both.");
+
+	str_prop = secprop.AddString("profiler_output", OnlyAtStart, "profile.folded");
+	str_prop->SetHelp(
+	        "Path of the profiler report file ('profile.folded' by default).");
+
+	str_prop = secprop.AddString("perfstat_log", OnlyAtStart, "");
+	str_prop->SetHelp(
+	        "Path of the file to periodically log the host performance counters to\n"
+	        "(unset by default). The same counters can be inspected interactively with\n"
+	        "the PERFSTAT command.");
+
+	str_prop = secprop.AddString("perfstat_log_format", OnlyAtStart, "csv");
+	str_prop->SetValues({"csv", "json"});
+	str_prop->SetHelp(
+	        "Format of the performance counter log ('csv' by default):\n"
+	        "  csv:   One comma-separated row per interval, with a header row (default).\n"
+	        "  json:  One JSON object per line (JSON Lines).");
+
+	int_prop = secprop.AddInt("perfstat_log_interval", OnlyAtStart, 1);
+	int_prop->SetMinMax(1, 3600);
+	int_prop->SetHelp(
+	        "Interval between performance counter log entries in seconds of host time\n"
+	        "(1 by default).");
+}
+
+void PROFILER_AddConfigSection(const ConfigPtr& conf)
+{
+	assert(conf);
+
+	SectionProp* sec = conf->AddSectionProp("profiler", &profiler_init);
+	assert(sec);
+	init_profiler_settings(*sec);
+
+	sec->AddInitFunction(&PERF_Init);
+}
@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_PROFILER_H
+#define DOSBOX_PROFILER_H
+
+#include "dosbox.h"
+
+#include "config/config.h"
+#include "hardware/port.h"
+
+// Guest sampling profiler
+//
+// Periodically records the guest CS:EIP (and the corresponding linear
+// address) from a PIC event, aggregates the samples by owning program, code
+// page and instruction address, and writes a flamegraph-compatible report
+// ('folded stacks' format) when the emulator shuts down.
+//
+// Optionally, samples can be attributed to the I/O ports and interrupt
+// vectors the guest accessed since the previous sample.
+
+void PROFILER_AddConfigSection(const ConfigPtr& conf);
+
+struct ProfilerAttribution {
+	bool track_io         = false;
+	bool track_interrupts = false;
+
+	bool has_io_port       = false;
+	io_port_t last_io_port = 0;
+
+	bool has_interrupt     = false;
+	uint8_t last_interrupt = 0;
+};
+
+extern ProfilerAttribution profiler_attribution;
+
+static inline void PROFILER_NoteIoPort(const io_port_t port)
+{
+	if (profiler_attribution.track_io) {
+		profiler_attribution.has_io_port  = true;
+		profiler_attribution.last_io_port = port;
+	}
+}
+
+static inline void PROFILER_NoteInterrupt(const uint8_t vector)
+{
+	if (profiler_attribution.track_interrupts) {
+		profiler_attribution.has_interrupt  = true;
+		profiler_attribution.last_interrupt = vector;
+	}
+}
+
+#endif // DOSBOX_PROFILER_H
@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <cctype>
+#include <chrono>
 #include <fstream>
 #include <map>
 #include <set>
@@ -253,6 +254,7 @@ static const std::string dir_name_mapping        = "mapping";
 
 // Thresholds for UTF-8 decoding/encoding
 constexpr uint8_t DecodeThresholdNonAscii = 0b1'000'0000;
+constexpr size_t NumNonAsciiCharacters    = UINT8_MAX + 1 - DecodeThresholdNonAscii;
 constexpr uint8_t DecodeThreshold2Bytes   = 0b1'100'0000;
 constexpr uint8_t DecodeThreshold3Bytes   = 0b1'110'0000;
 constexpr uint8_t DecodeThreshold4Bytes   = 0b1'111'0000;
@@ -286,6 +288,59 @@ static map_code_point_case_t lowercase = {};
 // Unicode 'KD' decomposition rules
 static decomposition_rules_t decomposition_rules = {};
 
+// Flat perfect hash table mapping graphemes without combining marks (single
+// code points) to DOS characters. Constructed once per code page, it spares
+// the conversion routines from walking the 'std::map' red-black tree and
+// comparing combining mark vectors for the most common case.
+//
+// Uses the 'hash and displace' scheme: the first hash selects a bucket, the
+// bucket's seed is then used to compute a collision-free slot index.
+class CodePointLookup final {
+public:
+	void Build(const map_grapheme_to_dos_t& mapping);
+
+	[[nodiscard]] std::optional<uint8_t> Find(const uint16_t code_point) const
+	{
+		if (slots.empty()) {
+			return {};
+		}
+
+		const auto bucket = Hash(code_point, 0) & (seeds.size() - 1);
+		const auto index  = Hash(code_point, seeds[bucket]) &
+		                   (slots.size() - 1);
+
+		const auto& slot = slots[index];
+		if (slot.value == EmptySlot || slot.code_point != code_point) {
+			return {};
+		}
+		return static_cast<uint8_t>(slot.value);
+	}
+
+private:
+	static uint32_t Hash(const uint16_t code_point, const uint32_t seed)
+	{
+		auto value = (code_point ^ (seed << 16)) * 0x9e3779b1u + seed;
+		value ^= value >> 15;
+		value *= 0x85ebca6bu;
+		value ^= value >> 13;
+		return value;
+	}
+
+	using entries_t = std::vector<std::pair<uint16_t, uint8_t>>;
+
+	bool TryBuild(const entries_t& entries, const size_t num_slots);
+
+	static constexpr uint16_t EmptySlot = UINT16_MAX;
+
+	struct Slot {
+		uint16_t code_point = 0;
+		uint16_t value      = EmptySlot;
+	};
+
+	std::vector<uint16_t> seeds = {};
+	std::vector<Slot> slots     = {};
+};
+
 // Set of per code page mappings
 
 struct code_page_maps_t {
@@ -296,8 +351,14 @@ struct code_page_maps_t {
 	// not existing in current code page
 	map_grapheme_to_dos_t aliases_normalized = {};
 	map_grapheme_to_dos_t aliases_decomposed = {};
+	// Fast lookup tables for graphemes without combining marks
+	CodePointLookup lookup_normalized = {};
+	CodePointLookup lookup_aliases    = {};
 	// Reverse mapping, Unicode grapheme to DOS character
 	map_dos_to_grapheme_t grapheme_to_dos = {};
+	// Reverse mapping flattened to wide strings, indexed by
+	// (DOS character - 0x80)
+	std::vector<wide_string> dos_to_wide = {};
 	// Mapping for box-optimized fallback mode
 	map_box_code_points_t box_code_points = {};
 	// Mapping to change DOS character casing
@@ -519,6 +580,104 @@ bool Grapheme::operator<(const Grapheme& other) const
 	return false;
 }
 
+// ***************************************************************************
+// Code point lookup table implementation
+// ***************************************************************************
+
+void CodePointLookup::Build(const map_grapheme_to_dos_t& mapping)
+{
+	entries_t entries = {};
+	for (const auto& [grapheme, character_code] : mapping) {
+		if (grapheme.IsEmpty() || !grapheme.IsValid() || grapheme.HasMark()) {
+			continue;
+		}
+		entries.emplace_back(grapheme.GetCodePoint(), character_code);
+	}
+
+	seeds.clear();
+	slots.clear();
+	if (entries.empty()) {
+		return;
+	}
+
+	// Start with the table twice as large as the number of entries, enlarge
+	// it if no collision-free seeds could be found
+	size_t num_slots = 2;
+	while (num_slots < entries.size() * 2) {
+		num_slots *= 2;
+	}
+
+	while (!TryBuild(entries, num_slots)) {
+		num_slots *= 2;
+	}
+}
+
+bool CodePointLookup::TryBuild(const entries_t& entries, const size_t num_slots)
+{
+	constexpr uint32_t MaxSeed = UINT16_MAX;
+
+	// Distribute the entries into buckets, about 2 entries per bucket
+	size_t num_buckets = 1;
+	while (num_buckets * 2 < entries.size()) {
+		num_buckets *= 2;
+	}
+
+	std::vector<entries_t> buckets(num_buckets);
+	for (const auto& entry : entries) {
+		buckets[Hash(entry.first, 0) & (num_buckets - 1)].push_back(entry);
+	}
+
+	// Place the largest buckets first, while the table is still sparse
+	std::vector<size_t> order(num_buckets);
+	for (size_t idx = 0; idx < num_buckets; ++idx) {
+		order[idx] = idx;
+	}
+	std::stable_sort(order.begin(), order.end(), [&](const auto a, const auto b) {
+		return buckets[a].size() > buckets[b].size();
+	});
+
+	seeds.assign(num_buckets, 0);
+	slots.assign(num_slots, Slot());
+
+	std::vector<size_t> indices = {};
+	for (const auto bucket_idx : order) {
+		const auto& bucket = buckets[bucket_idx];
+		if (bucket.empty()) {
+			break;
+		}
+
+		bool placed = false;
+		for (uint32_t seed = 1; seed <= MaxSeed && !placed; ++seed) {
+			indices.clear();
+			placed = true;
+			for (const auto& entry : bucket) {
+				const auto index = Hash(entry.first, seed) & (num_slots - 1);
+				if (slots[index].value != EmptySlot ||
+				    std::find(indices.begin(), indices.end(), index) !=
+				            indices.end()) {
+					placed = false;
+					break;
+				}
+				indices.push_back(index);
+			}
+
+			if (placed) {
+				seeds[bucket_idx] = static_cast<uint16_t>(seed);
+				for (size_t idx = 0; idx < bucket.size(); ++idx) {
+					slots[indices[idx]].code_point = bucket[idx].first;
+					slots[indices[idx]].value = bucket[idx].second;
+				}
+			}
+		}
+
+		if (!placed) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
 // ***************************************************************************
 // Helpers for control codes handing
 // ***************************************************************************
@@ -805,6 +964,9 @@ static std::string wide_to_dos(const wide_string& str,
 	const map_grapheme_to_dos_t* aliases_normalized = nullptr;
 	const map_grapheme_to_dos_t* aliases_decomposed = nullptr;
 
+	const CodePointLookup* lookup_normalized = nullptr;
+	const CodePointLookup* lookup_aliases    = nullptr;
+
 	const map_box_code_points_t* box_code_points = nullptr;
 
 	// Try to find UTF8 -> code page mapping
@@ -817,6 +979,8 @@ static std::string wide_to_dos(const wide_string& str,
 			mapping_decomposed = &mappings.dos_to_grapheme_decomposed;
 			aliases_normalized = &mappings.aliases_normalized;
 			aliases_decomposed = &mappings.aliases_decomposed;
+			lookup_normalized  = &mappings.lookup_normalized;
+			lookup_aliases     = &mappings.lookup_aliases;
 			box_code_points    = &mappings.box_code_points;
 		} else {
 			warn_code_page(code_page);
@@ -851,10 +1015,10 @@ static std::string wide_to_dos(const wide_string& str,
 
 	// Handle box drawing characters, if needed use specialized fallback
 	// strategy to guarantee table consistency
-	auto push_box_drawing = [&str_out](const map_grapheme_to_dos_t* mapping,
+	auto push_box_drawing = [&str_out](const CodePointLookup* lookup,
 	                                   const map_box_code_points_t* mapping_box,
 	                                   const Grapheme& grapheme) {
-		if (!mapping || !mapping_box) {
+		if (!lookup || !mapping_box) {
 			return false;
 		}
 
@@ -862,14 +1026,16 @@ static std::string wide_to_dos(const wide_string& str,
 			return false; // not a box drawing character
 		}
 
-		const auto code_point = grapheme.GetCodePoint();
-		if (!mapping_box->contains(code_point)) {
+		const auto it = mapping_box->find(grapheme.GetCodePoint());
+		if (it == mapping_box->end()) {
 			return false; // not a box drawing character
 		}
 
-		const auto alias_code_point = mapping_box->at(code_point);
+		const auto alias_code_point = it->second;
 		if (alias_code_point >= DecodeThresholdNonAscii) {
-			str_out.push_back(static_cast<char>(mapping->at(alias_code_point)));
+			const auto character = lookup->Find(alias_code_point);
+			assert(character);
+			str_out.push_back(static_cast<char>(*character));
 		} else {
 			str_out.push_back(static_cast<char>(alias_code_point));
 		}
@@ -878,16 +1044,25 @@ static std::string wide_to_dos(const wide_string& str,
 
 	// Handle code points belonging to selected code page
 	auto push_code_page = [&str_out, &convert_mode](const map_grapheme_to_dos_t* mapping,
+	                                                const CodePointLookup* lookup,
 	                                                const Grapheme& grapheme) {
 		if (!mapping) {
 			return false;
 		}
 
 		// Check if code page has a characters matching the grapheme
-		const auto it = mapping->find(grapheme);
-		if (it != mapping->end()) {
-			str_out.push_back(static_cast<char>(it->second));
-			return true;
+		if (lookup && !grapheme.HasMark()) {
+			const auto character = lookup->Find(grapheme.GetCodePoint());
+			if (character) {
+				str_out.push_back(static_cast<char>(*character));
+				return true;
+			}
+		} else {
+			const auto it = mapping->find(grapheme);
+			if (it != mapping->end()) {
+				str_out.push_back(static_cast<char>(it->second));
+				return true;
+			}
 		}
 
 		// Check if the grapheme represent a screen characters which has
@@ -934,19 +1109,29 @@ static std::string wide_to_dos(const wide_string& str,
 		switch (fallback) {
 		case UnicodeFallback::EmptyString:
 			return push_7bit(grapheme) ||
-			       push_code_page(mapping_normalized, grapheme);
+			       push_code_page(mapping_normalized,
+			                      lookup_normalized,
+			                      grapheme);
 		case UnicodeFallback::Simple:
 			return push_7bit(grapheme) ||
-			       push_code_page(mapping_normalized, grapheme) ||
-			       push_code_page(aliases_normalized, grapheme) ||
+			       push_code_page(mapping_normalized,
+			                      lookup_normalized,
+			                      grapheme) ||
+			       push_code_page(aliases_normalized,
+			                      lookup_aliases,
+			                      grapheme) ||
 			       push_fallback(grapheme);
 		case UnicodeFallback::Box:
 			return push_7bit(grapheme) ||
-			       push_box_drawing(mapping_normalized,
+			       push_box_drawing(lookup_normalized,
 			                        box_code_points,
 			                        grapheme) ||
-			       push_code_page(mapping_normalized, grapheme) ||
-			       push_code_page(aliases_normalized, grapheme) ||
+			       push_code_page(mapping_normalized,
+			                      lookup_normalized,
+			                      grapheme) ||
+			       push_code_page(aliases_normalized,
+			                      lookup_aliases,
+			                      grapheme) ||
 			       push_fallback(grapheme);
 		default: assert(false); return false;
 		}
@@ -959,11 +1144,11 @@ static std::string wide_to_dos(const wide_string& str,
 
 		switch (fallback) {
 		case UnicodeFallback::EmptyString:
-			return push_code_page(mapping_decomposed, decomposed);
+			return push_code_page(mapping_decomposed, nullptr, decomposed);
 		case UnicodeFallback::Simple:
 		case UnicodeFallback::Box:
-			return push_code_page(mapping_decomposed, decomposed) ||
-			       push_code_page(aliases_decomposed, decomposed);
+			return push_code_page(mapping_decomposed, nullptr, decomposed) ||
+			       push_code_page(aliases_decomposed, nullptr, decomposed);
 		default: assert(false); return false;
 		}
 	};
@@ -1007,17 +1192,24 @@ static wide_string dos_to_wide(const std::string& str,
 	wide_string str_out = {};
 	str_out.reserve(str.size());
 
+	// Looking up a code page that was never prepared can leave an entry
+	// without the DOS-to-wide table behind
+	const auto it = per_code_page_mappings.find(code_page);
+	const std::vector<wide_string>* mapping = nullptr;
+	if (it != per_code_page_mappings.end() &&
+	    it->second.dos_to_wide.size() == NumNonAsciiCharacters) {
+		mapping = &it->second.dos_to_wide;
+	}
+
 	for (const auto character : str) {
 		const auto byte = static_cast<uint8_t>(character);
 		if (byte >= DecodeThresholdNonAscii) {
 			// Take from code page mapping
-			auto& mappings = per_code_page_mappings[code_page];
-
-			if (!per_code_page_mappings.contains(code_page) ||
-			    !mappings.grapheme_to_dos.contains(byte)) {
+			if (!mapping) {
 				str_out.push_back(UnknownCharacter);
 			} else {
-				mappings.grapheme_to_dos[byte].PushInto(str_out);
+				const auto& wide = (*mapping)[byte - DecodeThresholdNonAscii];
+				str_out.insert(str_out.end(), wide.begin(), wide.end());
 			}
 		} else if (is_control_code(byte)) {
 			const auto wide = control_code_to_wide(byte, convert_mode);
@@ -1040,6 +1232,14 @@ static wide_string dos_to_wide(const std::string& str,
 
 static bool prepare_code_page(const uint16_t code_page);
 
+[[maybe_unused]] static double get_elapsed_ms(
+        const std::chrono::steady_clock::time_point start)
+{
+	using namespace std::chrono;
+	const auto elapsed = steady_clock::now() - start;
+	return duration_cast<duration<double, std::milli>>(elapsed).count();
+}
+
 template <typename T1, typename T2>
 bool add_if_not_mapped(std::map<T1, T2>& mapping, T1 first, T2 second)
 {
@@ -1307,8 +1507,8 @@ static bool import_mapping_code_page(const std_fs::path& path_root,
 
 	map_dos_to_grapheme_t new_mapping = {};
 
+	std::vector<std::string> tokens = {};
 	while (get_line(in_file, line_str, line_num)) {
-		std::vector<std::string> tokens;
 		if (!get_tokens(line_str, tokens)) {
 			continue; // empty line
 		}
@@ -1394,8 +1594,8 @@ static void import_config_main(const std_fs::path& path_root)
 	config_duplicates_t new_config_duplicates = {};
 	config_aliases_t new_config_aliases       = {};
 
+	std::vector<std::string> tokens = {};
 	while (get_line(in_file, line_str, line_num)) {
-		std::vector<std::string> tokens;
 		if (!get_tokens(line_str, tokens))
 			continue; // empty line
 		uint8_t character_code = 0;
@@ -1580,8 +1780,8 @@ static void import_decomposition(const std_fs::path& path_root)
 
 	decomposition_rules_t new_rules = {};
 
+	std::vector<std::string> tokens = {};
 	while (get_line(in_file, line_str, line_num)) {
-		std::vector<std::string> tokens;
 		if (!get_tokens(line_str, tokens)) {
 			continue; // empty line
 		}
@@ -1639,8 +1839,8 @@ static void import_mapping_ascii(const std_fs::path& path_root)
 
 	map_grapheme_to_dos_t new_mapping_ascii = {};
 
+	std::vector<std::string> tokens = {};
 	while (get_line(in_file, line_str, line_num)) {
-		std::vector<std::string> tokens;
 		if (!get_tokens(line_str, tokens)) {
 			continue; // empty line
 		}
@@ -1690,8 +1890,8 @@ static void import_mapping_case(const std_fs::path& path_root)
 	map_code_point_case_t new_uppercase = {};
 	map_code_point_case_t new_lowercase = {};
 
+	std::vector<std::string> tokens = {};
 	while (get_line(in_file, line_str, line_num)) {
-		std::vector<std::string> tokens;
 		if (!get_tokens(line_str, tokens)) {
 			continue; // empty line
 		}
@@ -2029,6 +2229,17 @@ static bool construct_mapping(const uint16_t code_page)
 	mappings.dos_to_grapheme_normalized = std::move(new_mapping);
 	mappings.grapheme_to_dos = std::move(new_mapping_reverse);
 
+	// Construct flat lookup tables
+	mappings.lookup_normalized.Build(mappings.dos_to_grapheme_normalized);
+
+	mappings.dos_to_wide.assign(NumNonAsciiCharacters,
+	                            wide_string{UnknownCharacter});
+	for (const auto& [character_code, grapheme] : mappings.grapheme_to_dos) {
+		auto& wide = mappings.dos_to_wide[character_code - DecodeThresholdNonAscii];
+		wide.clear();
+		grapheme.PushInto(wide);
+	}
+
 	// Construct decomposed mapping
 	construct_decomposed(mappings.dos_to_grapheme_normalized,
 	                     mappings.dos_to_grapheme_decomposed);
@@ -2076,6 +2287,8 @@ static void construct_aliases(const uint16_t code_page)
 	// Construct decomposed aliases
 	construct_decomposed(mappings.aliases_normalized,
 	                     mappings.aliases_decomposed);
+
+	mappings.lookup_aliases.Build(mappings.aliases_normalized);
 }
 
 static bool prepare_code_page(const uint16_t code_page)
@@ -2084,6 +2297,8 @@ static bool prepare_code_page(const uint16_t code_page)
 		return true; // code page already prepared
 	}
 
+	[[maybe_unused]] const auto start = std::chrono::steady_clock::now();
+
 	if (!config_mappings.contains(code_page) || !construct_mapping(code_page)) {
 		// Unsupported code page or error
 		per_code_page_mappings.erase(code_page);
@@ -2091,6 +2306,10 @@ static bool prepare_code_page(const uint16_t code_page)
 	}
 
 	construct_aliases(code_page);
+
+	LOG_DEBUG("UNICODE: Prepared code page %d mapping in %.2f ms",
+	          code_page,
+	          get_elapsed_ms(start));
 	return true;
 }
 
@@ -2101,12 +2320,17 @@ static void load_config_if_needed()
 
 	static bool config_loaded = false;
 	if (!config_loaded) {
+		[[maybe_unused]] const auto start = std::chrono::steady_clock::now();
+
 		const auto path_root = get_resource_path(dir_name_mapping);
 		import_decomposition(path_root);
 		import_mapping_ascii(path_root);
 		import_mapping_case(path_root);
 		import_config_main(path_root);
 		config_loaded = true;
+
+		LOG_DEBUG("UNICODE: Loaded mapping configuration in %.2f ms",
+		          get_elapsed_ms(start));
 	}
 }
 
@@ -2214,7 +2438,7 @@ std::string fs_utf8_to_dos_437(const std::string& str)
 	}
 	assert(per_code_page_mappings.contains(CodePage));
 
-	const auto mapping = per_code_page_mappings.at(CodePage).dos_to_grapheme_normalized;
+	const auto& lookup = per_code_page_mappings.at(CodePage).lookup_normalized;
 
 	std::string str_out = {};
 	for (const auto code_point : utf8_to_wide(str)) {
@@ -2229,12 +2453,13 @@ std::string fs_utf8_to_dos_437(const std::string& str)
 			continue;
 		}
 
-		if (!mapping.contains(code_point)) {
+		const auto character = lookup.Find(code_point);
+		if (!character) {
 			// Not a valid character for our code page
 			return {};
 		}
 
-		str_out.push_back(mapping.at(code_point));
+		str_out.push_back(static_cast<char>(*character));
 	}
 
 	str_out.shrink_to_fit();
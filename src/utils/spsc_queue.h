@@ -0,0 +1,500 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_SPSC_QUEUE_H
+#define DOSBOX_SPSC_QUEUE_H
+
+/*  SPSC (Single-Producer/Single-Consumer) Queue
+ *  --------------------------------------------
+ *  A fixed-capacity lock-free ring buffer with the same interface as RWQueue,
+ *  meant for the paths where exactly one thread produces and exactly one
+ *  thread consumes the items (e.g., the mixer thread and the SDL audio
+ *  callback, or the slirp network thread and the emulation thread).
+ *
+ *  The non-blocking calls never take a lock or make a system call. The
+ *  blocking calls wait on C++20 atomic waits (futexes on Linux), and the other
+ *  side only issues a wake-up when a thread is actually waiting.
+ *
+ *  Stop(), Start(), Clear(), and the size queries can be called from any
+ *  thread. Resize() must only be called when neither the producer nor the
+ *  consumer is running.
+ *
+ *  Clear() only marks the queued items as discarded; the consumer drops them
+ *  on its next access. Until then, the discarded items still take up room in
+ *  the queue.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+template <typename T>
+class SpscQueue {
+public:
+	SpscQueue()                                        = delete;
+	SpscQueue(const SpscQueue<T>& other)               = delete;
+	SpscQueue<T>& operator=(const SpscQueue<T>& other) = delete;
+
+	explicit SpscQueue(const size_t queue_capacity)
+	{
+		Resize(queue_capacity);
+	}
+
+	// Not thread-safe; the queue is emptied
+	void Resize(const size_t queue_capacity)
+	{
+		assert(queue_capacity > 0);
+
+		capacity = queue_capacity;
+
+		// Power-of-two storage so the positions can be masked instead of
+		// wrapped with a division
+		slots.clear();
+		slots.resize(std::bit_ceil(capacity));
+		index_mask = slots.size() - 1;
+
+		write_pos   = 0;
+		read_pos    = 0;
+		discard_pos = 0;
+
+		cached_read_pos  = 0;
+		cached_write_pos = 0;
+	}
+
+	// non-blocking call
+	size_t Size() const
+	{
+		const auto write = write_pos.load(std::memory_order_acquire);
+		const auto read  = std::max(read_pos.load(std::memory_order_acquire),
+		                            discard_pos.load(std::memory_order_acquire));
+		return (write > read) ? write - read : 0;
+	}
+
+	// non-blocking call
+	bool IsEmpty() const
+	{
+		return Size() == 0;
+	}
+
+	// non-blocking call
+	bool IsFull() const
+	{
+		return write_pos.load(std::memory_order_acquire) -
+		               read_pos.load(std::memory_order_acquire) >=
+		       capacity;
+	}
+
+	// non-blocking call
+	bool IsRunning() const
+	{
+		return is_running.load(std::memory_order_acquire);
+	}
+
+	// non-blocking call
+	size_t MaxCapacity() const
+	{
+		return capacity;
+	}
+
+	// non-blocking call
+	float GetPercentFull() const
+	{
+		const auto cur_level = static_cast<float>(Size());
+		const auto max_level = static_cast<float>(capacity);
+		return (100.0f * cur_level) / max_level;
+	}
+
+	// non-blocking call
+	void Start()
+	{
+		is_running.store(true, std::memory_order_release);
+	}
+
+	// non-blocking call; wakes up the blocked producer and consumer
+	void Stop()
+	{
+		if (!is_running.exchange(false)) {
+			return;
+		}
+		Wake(items_event);
+		Wake(room_event);
+	}
+
+	// non-blocking call
+	void Clear()
+	{
+		discard_pos.store(write_pos.load(std::memory_order_acquire),
+		                  std::memory_order_release);
+	}
+
+	// Producer calls
+	// ~~~~~~~~~~~~~~
+
+	// Blocks until there's room for the item. Returns false if the queue
+	// was stopped.
+	bool Enqueue(T&& item)
+	{
+		if (!WaitForRoom(1)) {
+			return false;
+		}
+		const auto write = write_pos.load(std::memory_order_relaxed);
+		slots[write & index_mask] = std::move(item);
+		PublishItems(write + 1);
+		return true;
+	}
+
+	// Returns false and does nothing if the queue is at capacity or the
+	// queue is not running
+	bool NonblockingEnqueue(T&& item)
+	{
+		if (!IsRunning() || GetFreeRoom(1) == 0) {
+			return false;
+		}
+		const auto write = write_pos.load(std::memory_order_relaxed);
+		slots[write & index_mask] = std::move(item);
+		PublishItems(write + 1);
+		return true;
+	}
+
+	// Copies as many items as there's room for; returns the number of items
+	// enqueued
+	size_t NonblockingBulkEnqueue(std::span<const T> items)
+	{
+		if (!IsRunning() || items.empty()) {
+			return 0;
+		}
+		const auto num_items = std::min(GetFreeRoom(items.size()),
+		                                items.size());
+		CopyIn(items.first(num_items));
+		return num_items;
+	}
+
+	// Moves as many items as there's room for out of the source vector and
+	// erases them; the rest are left in the vector
+	size_t NonblockingBulkEnqueue(std::vector<T>& from_source, const size_t num_requested)
+	{
+		assert(num_requested <= from_source.size());
+
+		if (!IsRunning() || num_requested == 0) {
+			return 0;
+		}
+		const auto num_items = std::min(GetFreeRoom(num_requested),
+		                                num_requested);
+		MoveIn(from_source.data(), num_items);
+		from_source.erase(from_source.begin(),
+		                  from_source.begin() +
+		                          static_cast<std::ptrdiff_t>(num_items));
+		return num_items;
+	}
+
+	size_t NonblockingBulkEnqueue(std::vector<T>& from_source)
+	{
+		return NonblockingBulkEnqueue(from_source, from_source.size());
+	}
+
+	// Blocks until all items are copied into the queue, in chunks if
+	// needed. Returns fewer items than requested if the queue was stopped.
+	size_t BulkEnqueue(std::span<const T> items)
+	{
+		size_t num_enqueued = 0;
+		while (num_enqueued < items.size()) {
+			if (!WaitForRoom(1)) {
+				break;
+			}
+			const auto num_remaining = items.size() - num_enqueued;
+			const auto num_items = std::min(GetFreeRoom(num_remaining),
+			                                num_remaining);
+
+			CopyIn(items.subspan(num_enqueued, num_items));
+			num_enqueued += num_items;
+		}
+		return num_enqueued;
+	}
+
+	// Like the above, but the items are moved and the source vector is
+	// cleared afterwards
+	size_t BulkEnqueue(std::vector<T>& from_source, const size_t num_requested)
+	{
+		assert(num_requested <= from_source.size());
+
+		size_t num_enqueued = 0;
+		while (num_enqueued < num_requested) {
+			if (!WaitForRoom(1)) {
+				break;
+			}
+			const auto num_remaining = num_requested - num_enqueued;
+			const auto num_items = std::min(GetFreeRoom(num_remaining),
+			                                num_remaining);
+
+			MoveIn(from_source.data() + num_enqueued, num_items);
+			num_enqueued += num_items;
+		}
+		from_source.clear();
+		return num_enqueued;
+	}
+
+	size_t BulkEnqueue(std::vector<T>& from_source)
+	{
+		return BulkEnqueue(from_source, from_source.size());
+	}
+
+	// Consumer calls
+	// ~~~~~~~~~~~~~~
+
+	// Blocks until there's an item to dequeue. Once the queue is stopped,
+	// the remaining items are still returned, then empty results.
+	std::optional<T> Dequeue()
+	{
+		if (!WaitForItems(1)) {
+			return {};
+		}
+		const auto read = read_pos.load(std::memory_order_relaxed);
+		std::optional<T> item = std::move(slots[read & index_mask]);
+		ReleaseSlots(read + 1);
+		return item;
+	}
+
+	// Moves as many items as available into the target span; returns the
+	// number of items dequeued
+	size_t NonblockingBulkDequeue(std::span<T> into_target)
+	{
+		const auto num_items = std::min(GetAvailableItems(into_target.size()),
+		                                into_target.size());
+		MoveOut(into_target.data(), num_items);
+		return num_items;
+	}
+
+	// Blocks until the requested number of items have been dequeued, or the
+	// queue was stopped and drained. The caller is responsible for sizing
+	// the target's array to accommodate the number requested.
+	size_t BulkDequeue(T* const into_target, const size_t num_requested)
+	{
+		assert(into_target);
+
+		size_t num_dequeued = 0;
+		while (num_dequeued < num_requested) {
+			if (!WaitForItems(1)) {
+				break;
+			}
+			const auto num_remaining = num_requested - num_dequeued;
+			const auto num_items = std::min(GetAvailableItems(num_remaining),
+			                                num_remaining);
+
+			MoveOut(into_target + num_dequeued, num_items);
+			num_dequeued += num_items;
+		}
+		return num_dequeued;
+	}
+
+	// The target vector is sized to match the number of dequeued items
+	size_t BulkDequeue(std::vector<T>& into_target, const size_t num_requested)
+	{
+		if (into_target.size() < num_requested) {
+			into_target.resize(num_requested);
+		}
+		const auto num_dequeued = BulkDequeue(into_target.data(), num_requested);
+		into_target.resize(num_dequeued);
+		return num_dequeued;
+	}
+
+private:
+	static constexpr size_t CacheLineSize = 64;
+
+	// Free room as seen by the producer; only reloads the consumer's
+	// position when the cached one doesn't leave enough room
+	size_t GetFreeRoom(const size_t num_wanted)
+	{
+		const auto write = write_pos.load(std::memory_order_relaxed);
+
+		auto free_room = capacity - (write - cached_read_pos);
+		if (free_room < num_wanted) {
+			cached_read_pos = read_pos.load(std::memory_order_acquire);
+			free_room = capacity - (write - cached_read_pos);
+		}
+		return free_room;
+	}
+
+	// Available items as seen by the consumer; discarded items are dropped
+	// first
+	size_t GetAvailableItems(const size_t num_wanted)
+	{
+		DropDiscardedItems();
+
+		const auto read = read_pos.load(std::memory_order_relaxed);
+
+		auto num_available = cached_write_pos - read;
+		if (num_available < num_wanted) {
+			cached_write_pos = write_pos.load(std::memory_order_acquire);
+			num_available = cached_write_pos - read;
+		}
+		return num_available;
+	}
+
+	void DropDiscardedItems()
+	{
+		const auto discard = discard_pos.load(std::memory_order_acquire);
+		const auto read    = read_pos.load(std::memory_order_relaxed);
+		if (discard <= read) {
+			return;
+		}
+		if constexpr (!std::is_trivially_destructible_v<T>) {
+			for (auto pos = read; pos != discard; ++pos) {
+				slots[pos & index_mask] = T{};
+			}
+		}
+		if (cached_write_pos < discard) {
+			cached_write_pos = discard;
+		}
+		ReleaseSlots(discard);
+	}
+
+	void CopyIn(std::span<const T> items)
+	{
+		const auto write = write_pos.load(std::memory_order_relaxed);
+		const auto start = write & index_mask;
+		const auto first = std::min(items.size(), slots.size() - start);
+
+		std::copy_n(items.begin(),
+		            first,
+		            slots.begin() + static_cast<std::ptrdiff_t>(start));
+		std::copy(items.begin() + static_cast<std::ptrdiff_t>(first),
+		          items.end(),
+		          slots.begin());
+
+		PublishItems(write + items.size());
+	}
+
+	void MoveIn(T* const items, const size_t num_items)
+	{
+		const auto write = write_pos.load(std::memory_order_relaxed);
+		const auto start = write & index_mask;
+		const auto first = std::min(num_items, slots.size() - start);
+
+		std::move(items, items + first, slots.data() + start);
+		std::move(items + first, items + num_items, slots.data());
+
+		PublishItems(write + num_items);
+	}
+
+	void MoveOut(T* const into_target, const size_t num_items)
+	{
+		if (num_items == 0) {
+			return;
+		}
+		const auto read  = read_pos.load(std::memory_order_relaxed);
+		const auto start = read & index_mask;
+		const auto first = std::min(num_items, slots.size() - start);
+
+		std::move(slots.data() + start, slots.data() + start + first, into_target);
+		std::move(slots.data(), slots.data() + (num_items - first), into_target + first);
+
+		ReleaseSlots(read + num_items);
+	}
+
+	// The stores of the positions and the loads of the waiting flags are
+	// sequentially consistent, and the waiting side has a full fence between
+	// setting its flag and re-checking the position. So either the waiting
+	// side sees the new position before going to sleep, or this side sees
+	// the waiting flag and wakes it up.
+	void PublishItems(const size_t new_write_pos)
+	{
+		write_pos.store(new_write_pos);
+		if (consumer_waiting.load()) {
+			Wake(items_event);
+		}
+	}
+
+	void ReleaseSlots(const size_t new_read_pos)
+	{
+		read_pos.store(new_read_pos);
+		if (producer_waiting.load()) {
+			Wake(room_event);
+		}
+	}
+
+	static void Wake(std::atomic<uint32_t>& event)
+	{
+		event.fetch_add(1);
+		event.notify_all();
+	}
+
+	bool WaitForRoom(const size_t num_wanted)
+	{
+		while (GetFreeRoom(num_wanted) < num_wanted) {
+			producer_waiting.store(true);
+
+			// Keeps the position re-check below from being ordered
+			// before the flag store
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			const auto event = room_event.load();
+
+			// Stop() wakes us up after changing the running state, so
+			// the event must be loaded before checking it
+			if (!IsRunning()) {
+				break;
+			}
+			if (GetFreeRoom(num_wanted) >= num_wanted) {
+				break;
+			}
+			room_event.wait(event);
+		}
+		producer_waiting.store(false);
+		return IsRunning();
+	}
+
+	// Returns false if the queue was stopped and there are no more items
+	bool WaitForItems(const size_t num_wanted)
+	{
+		while (GetAvailableItems(num_wanted) < num_wanted) {
+			consumer_waiting.store(true);
+
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			const auto event = items_event.load();
+
+			if (GetAvailableItems(num_wanted) >= num_wanted) {
+				break;
+			}
+			if (!IsRunning()) {
+				consumer_waiting.store(false);
+				// Drain the previously queued items
+				return GetAvailableItems(1) > 0;
+			}
+			items_event.wait(event);
+		}
+		consumer_waiting.store(false);
+		return true;
+	}
+
+	std::vector<T> slots = {};
+	size_t index_mask    = 0;
+	size_t capacity      = 0;
+
+	// The positions only ever increase; they're masked when accessing the
+	// slots. Each is on its own cache line, so the producer and the
+	// consumer don't keep invalidating each other's cache lines.
+	alignas(CacheLineSize) std::atomic<size_t> write_pos = 0;
+	alignas(CacheLineSize) std::atomic<size_t> read_pos  = 0;
+
+	// Items before this position have been cleared
+	alignas(CacheLineSize) std::atomic<size_t> discard_pos = 0;
+	std::atomic<bool> is_running                           = true;
+
+	// Producer state
+	alignas(CacheLineSize) size_t cached_read_pos = 0;
+	std::atomic<bool> producer_waiting            = false;
+	std::atomic<uint32_t> room_event              = 0;
+
+	// Consumer state
+	alignas(CacheLineSize) size_t cached_write_pos = 0;
+	std::atomic<bool> consumer_waiting             = false;
+	std::atomic<uint32_t> items_event              = 0;
+};
+
+#endif // DOSBOX_SPSC_QUEUE_H
@@ -0,0 +1,178 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "dos/cdrom.h"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "misc/std_filesystem.h"
+
+#include "dosbox_test_fixture.h"
+
+namespace {
+
+constexpr uint32_t FramesPerSector = BYTES_PER_RAW_REDBOOK_FRAME /
+                                     BYTES_PER_REDBOOK_PCM_FRAME;
+
+// Ten seconds of audio, so seeks can land well past the decode-ahead buffer
+constexpr uint32_t TrackSectors = 10 * REDBOOK_FRAMES_PER_SECOND;
+constexpr uint32_t TrackFrames  = TrackSectors * FramesPerSector;
+
+// Every frame of the track is different, so reading from the wrong position
+// can't go unnoticed
+int16_t left_sample(const uint32_t frame)
+{
+	return static_cast<int16_t>(frame);
+}
+
+int16_t right_sample(const uint32_t frame)
+{
+	return static_cast<int16_t>(frame >> 4);
+}
+
+void write_le(std::ofstream& out, const uint32_t value, const int num_bytes)
+{
+	for (auto i = 0; i < num_bytes; ++i) {
+		out.put(static_cast<char>((value >> (i * 8)) & 0xff));
+	}
+}
+
+void write_wav(const std_fs::path& path)
+{
+	constexpr uint32_t DataBytes = TrackFrames * BYTES_PER_REDBOOK_PCM_FRAME;
+
+	std::ofstream out(path, std::ios::binary);
+	out << "RIFF";
+	write_le(out, 36 + DataBytes, 4);
+	out << "WAVEfmt ";
+	write_le(out, 16, 4);
+	write_le(out, 1, 2); // PCM
+	write_le(out, 2, 2); // channels
+	write_le(out, REDBOOK_PCM_FRAMES_PER_SECOND, 4);
+	write_le(out, REDBOOK_PCM_FRAMES_PER_SECOND * BYTES_PER_REDBOOK_PCM_FRAME, 4);
+	write_le(out, BYTES_PER_REDBOOK_PCM_FRAME, 2);
+	write_le(out, 16, 2); // bits per sample
+	out << "data";
+	write_le(out, DataBytes, 4);
+
+	for (uint32_t frame = 0; frame < TrackFrames; ++frame) {
+		write_le(out, static_cast<uint16_t>(left_sample(frame)), 2);
+		write_le(out, static_cast<uint16_t>(right_sample(frame)), 2);
+	}
+}
+
+class CdromImageTest : public DOSBoxTestFixture {
+protected:
+	void SetUp() override
+	{
+		DOSBoxTestFixture::SetUp();
+
+		image_dir = std_fs::temp_directory_path() / "dosbox_cdrom_image";
+		std_fs::remove_all(image_dir);
+		std_fs::create_directories(image_dir);
+
+		write_wav(image_dir / "track01.wav");
+
+		std::ofstream(image_dir / "image.cue") << "FILE \"track01.wav\" WAVE\n"
+		                                          "  TRACK 01 AUDIO\n"
+		                                          "    INDEX 01 00:00:00\n";
+
+		cdrom = std::make_unique<CDROM_Interface_Image>();
+		ASSERT_TRUE(cdrom->SetDevice((image_dir / "image.cue").string().c_str()));
+	}
+
+	void TearDown() override
+	{
+		cdrom.reset();
+
+		std::error_code ec = {};
+		std_fs::remove_all(image_dir, ec);
+
+		DOSBoxTestFixture::TearDown();
+	}
+
+	// Reads the sectors through digital audio extraction and checks they
+	// hold the track's audio from the given position
+	void ExpectSectors(const uint32_t first_sector, const uint32_t num_sectors)
+	{
+		std::vector<uint8_t> buffer(num_sectors * BYTES_PER_RAW_REDBOOK_FRAME);
+		ASSERT_TRUE(cdrom->ReadSectorsHost(buffer.data(), true, first_sector, num_sectors));
+
+		const auto first_frame = first_sector * FramesPerSector;
+		const auto num_frames  = num_sectors * FramesPerSector;
+
+		for (uint32_t i = 0; i < num_frames; ++i) {
+			const auto frame = first_frame + i;
+			const auto data  = buffer.data() + i * BYTES_PER_REDBOOK_PCM_FRAME;
+
+			const auto left  = static_cast<int16_t>(data[0] | data[1] << 8);
+			const auto right = static_cast<int16_t>(data[2] | data[3] << 8);
+
+			if (left != left_sample(frame) || right != right_sample(frame)) {
+				FAIL() << "Frame " << frame << " read as " << left
+				       << "/" << right;
+			}
+		}
+	}
+
+	std_fs::path image_dir = {};
+	std::unique_ptr<CDROM_Interface_Image> cdrom = {};
+};
+
+// Seeks are done with millisecond precision, so these all use sectors that
+// are a multiple of three, which start on a whole millisecond
+
+TEST_F(CdromImageTest, ReadsTheTrackStart)
+{
+	// Served from the audio decoded when the image was loaded
+	ExpectSectors(0, 30);
+}
+
+TEST_F(CdromImageTest, ReadsOnPastThePrerolledAudio)
+{
+	// The preroll is one second long, so this continues with the audio
+	// the decoder thread picks up after it
+	ExpectSectors(0, 30);
+	ExpectSectors(30, 30);
+	ExpectSectors(60, 30);
+}
+
+TEST_F(CdromImageTest, SeeksIntoThePrerolledAudio)
+{
+	ExpectSectors(72, 9);
+}
+
+TEST_F(CdromImageTest, SeeksWithinTheDecodedAudio)
+{
+	ExpectSectors(0, 9);
+
+	// Wait for the decoder to run ahead, then skip forward within the
+	// decoded audio
+	ExpectSectors(90, 3);
+	ExpectSectors(120, 9);
+}
+
+TEST_F(CdromImageTest, SeeksPastTheDecodedAudio)
+{
+	ExpectSectors(0, 9);
+	ExpectSectors(600, 9);
+	ExpectSectors(300, 9);
+}
+
+TEST_F(CdromImageTest, SeeksBackToTheTrackStart)
+{
+	ExpectSectors(450, 9);
+	ExpectSectors(0, 9);
+	ExpectSectors(9, 9);
+}
+
+TEST_F(CdromImageTest, ReadsTheTrackEnd)
+{
+	ExpectSectors(TrackSectors - 9, 9);
+}
+
+} // namespace
@@ -0,0 +1,189 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "cpu/descriptor_cache.h"
+
+#include <gtest/gtest.h>
+
+#include "cpu/cpu.h"
+#include "cpu/paging.h"
+#include "hardware/memory.h"
+#include "misc/perf_counters.h"
+
+#include "dosbox_test_fixture.h"
+
+namespace {
+
+TEST(DescriptorCache, StoreAndLookup)
+{
+	DescriptorCache cache = {};
+
+	uint32_t data[2] = {};
+	EXPECT_FALSE(cache.Lookup(0x1000, data));
+
+	const uint32_t stored[2] = {0x1234ffff, 0x00cf9a00};
+	cache.Store(0x1000, stored);
+
+	EXPECT_TRUE(cache.Lookup(0x1000, data));
+	EXPECT_EQ(data[0], stored[0]);
+	EXPECT_EQ(data[1], stored[1]);
+
+	// Addresses sharing the same slot don't alias
+	const auto aliased = 0x1000 + DescriptorCache::NumEntries * 8;
+	EXPECT_FALSE(cache.Lookup(aliased, data));
+}
+
+TEST(DescriptorCache, Invalidate)
+{
+	DescriptorCache cache = {};
+
+	const uint32_t stored[2] = {0x1234ffff, 0x00cf9a00};
+	cache.Store(0x2008, stored);
+	cache.Invalidate();
+
+	uint32_t data[2] = {};
+	EXPECT_FALSE(cache.Lookup(0x2008, data));
+
+	// Entries stored after the invalidation are valid again
+	cache.Store(0x2008, stored);
+	EXPECT_TRUE(cache.Lookup(0x2008, data));
+}
+
+class DescriptorCacheTest : public DOSBoxTestFixture {};
+
+// A table in conventional memory with a flat data segment at selector 8
+constexpr PhysPt GdtBase        = 0x90000;
+constexpr uint16_t DataSelector = 0x08;
+
+void write_data_descriptor(const uint32_t base)
+{
+	const auto address = GdtBase + DataSelector;
+	mem_writed(address, ((base & 0xffff) << 16) | 0xffff);
+	mem_writed(address + 4,
+	           (base & 0xff000000) | 0x00cf9200 | ((base >> 16) & 0xff));
+}
+
+TEST_F(DescriptorCacheTest, RepeatedLoadsHitTheCache)
+{
+	write_data_descriptor(0x00123400);
+	CPU_LGDT(0xff, GdtBase);
+
+	Descriptor desc = {};
+	ASSERT_TRUE(cpu.gdt.GetDescriptor(DataSelector, desc));
+	EXPECT_EQ(desc.GetBase(), 0x00123400);
+
+	const auto hits = perf_counters.descriptor_cache_hits;
+	for (auto i = 0; i < 10; ++i) {
+		ASSERT_TRUE(cpu.gdt.GetDescriptor(DataSelector, desc));
+		EXPECT_EQ(desc.GetBase(), 0x00123400);
+	}
+	EXPECT_EQ(perf_counters.descriptor_cache_hits, hits + 10);
+}
+
+TEST_F(DescriptorCacheTest, PicksUpModifiedDescriptor)
+{
+	write_data_descriptor(0x00123400);
+	CPU_LGDT(0xff, GdtBase);
+
+	Descriptor desc = {};
+	ASSERT_TRUE(cpu.gdt.GetDescriptor(DataSelector, desc));
+	ASSERT_TRUE(cpu.gdt.GetDescriptor(DataSelector, desc));
+	EXPECT_EQ(desc.GetBase(), 0x00123400);
+
+	// The guest rewrites the descriptor in place
+	write_data_descriptor(0x00567800);
+
+	ASSERT_TRUE(cpu.gdt.GetDescriptor(DataSelector, desc));
+	EXPECT_EQ(desc.GetBase(), 0x00567800);
+
+	// A single byte write is noticed as well
+	mem_writeb(GdtBase + DataSelector + 7, 0x01);
+
+	ASSERT_TRUE(cpu.gdt.GetDescriptor(DataSelector, desc));
+	EXPECT_EQ(desc.GetBase(), 0x01567800);
+}
+
+TEST_F(DescriptorCacheTest, PicksUpMovedTable)
+{
+	write_data_descriptor(0x00123400);
+	CPU_LGDT(0xff, GdtBase);
+
+	Descriptor desc = {};
+	ASSERT_TRUE(cpu.gdt.GetDescriptor(DataSelector, desc));
+
+	// A second table with a different descriptor at the same selector
+	constexpr PhysPt OtherGdtBase = GdtBase + 0x1000;
+	mem_writed(OtherGdtBase + DataSelector, 0x0000ffff);
+	mem_writed(OtherGdtBase + DataSelector + 4, 0x00cf9200);
+	CPU_LGDT(0xff, OtherGdtBase);
+
+	ASSERT_TRUE(cpu.gdt.GetDescriptor(DataSelector, desc));
+	EXPECT_EQ(desc.GetBase(), 0u);
+}
+
+TEST_F(DescriptorCacheTest, WatchingTheTableKeepsTheOtherPagesLinked)
+{
+	write_data_descriptor(0x00123400);
+	CPU_LGDT(0xff, GdtBase);
+
+	constexpr PhysPt OtherPage = 0x20000;
+	mem_writeb(OtherPage, 0x12);
+	ASSERT_NE(get_tlb_write(OtherPage), nullptr);
+
+	const auto flushes = perf_counters.tlb_flushes;
+
+	Descriptor desc = {};
+	ASSERT_TRUE(cpu.gdt.GetDescriptor(DataSelector, desc));
+	ASSERT_TRUE(cpu.gdt.GetDescriptor(DataSelector, desc));
+
+	EXPECT_EQ(perf_counters.tlb_flushes, flushes);
+	EXPECT_NE(get_tlb_write(OtherPage), nullptr);
+	EXPECT_EQ(get_tlb_write(GdtBase), nullptr);
+}
+
+// Page tables mapping the first 4 MB one to one, with the page holding the
+// table read-only for user mode
+constexpr PhysPt PageDirectory = 0x80000;
+constexpr PhysPt PageTable     = 0x81000;
+
+TEST_F(DescriptorCacheTest, PicksUpSupervisorWriteToUserReadOnlyPage)
+{
+	// Only the CPU types with exact privilege checks link pages that are
+	// read-only for user mode as read-only for the supervisor as well
+	const auto architecture = CPU_ArchitectureType;
+	CPU_ArchitectureType    = ArchitectureType::Pentium;
+
+	phys_writed(PageDirectory, PageTable | 0x07);
+	for (uint32_t page = 0; page < 1024; ++page) {
+		const uint32_t flags = (page == GdtBase >> 12) ? 0x05 : 0x07;
+		phys_writed(PageTable + page * 4, (page << 12) | flags);
+	}
+	write_data_descriptor(0x00123400);
+
+	PAGING_SetDirBase(PageDirectory);
+	PAGING_Enable(true);
+	CPU_LGDT(0xff, GdtBase);
+
+	Descriptor desc = {};
+	ASSERT_TRUE(cpu.gdt.GetDescriptor(DataSelector, desc));
+	ASSERT_TRUE(cpu.gdt.GetDescriptor(DataSelector, desc));
+	EXPECT_EQ(desc.GetBase(), 0x00123400);
+
+	// Linked read-only, so the writes go through the init handler
+	ASSERT_EQ(get_tlb_write(GdtBase), nullptr);
+	ASSERT_FALSE(get_tlb_readhandler(GdtBase)->flags & PFLAG_INIT);
+
+	const auto hits = perf_counters.descriptor_cache_hits;
+	ASSERT_TRUE(cpu.gdt.GetDescriptor(DataSelector, desc));
+	EXPECT_EQ(perf_counters.descriptor_cache_hits, hits + 1);
+
+	write_data_descriptor(0x00567800);
+
+	ASSERT_TRUE(cpu.gdt.GetDescriptor(DataSelector, desc));
+	EXPECT_EQ(desc.GetBase(), 0x00567800);
+
+	PAGING_Enable(false);
+	CPU_ArchitectureType = architecture;
+}
+
+} // namespace
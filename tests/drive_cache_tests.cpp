@@ -0,0 +1,162 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "dos/dos_system.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <set>
+#include <string>
+#include <thread>
+
+#include "misc/cross.h"
+#include "misc/std_filesystem.h"
+#include "utils/string_utils.h"
+
+namespace {
+
+class DriveCacheTest : public ::testing::Test {
+protected:
+	void SetUp() override
+	{
+		const auto test_name =
+		        ::testing::UnitTest::GetInstance()->current_test_info()->name();
+
+		host_dir = std_fs::temp_directory_path() /
+		           (std::string("dosbox_drive_cache_") + test_name);
+		std_fs::remove_all(host_dir);
+		std_fs::create_directories(host_dir);
+
+		CreateHostFile("alpha.txt");
+		CreateHostFile("LongFileName1.txt");
+
+		base_path = host_dir.string() + CROSS_FILESPLIT;
+		cache.SetBaseDir(base_path.c_str());
+		cache.EnableHostWatch(true);
+	}
+
+	void TearDown() override
+	{
+		std::error_code ec = {};
+		std_fs::remove_all(host_dir, ec);
+	}
+
+	void CreateHostFile(const std::string& name) const
+	{
+		std::ofstream(host_dir / name) << name;
+	}
+
+	std::string HostPath(const std::string& name) const
+	{
+		return base_path + name;
+	}
+
+	std::multiset<std::string> List()
+	{
+		char path[CROSS_LEN];
+		safe_strcpy(path, base_path.c_str());
+
+		std::multiset<std::string> names = {};
+
+		uint16_t id = 0;
+		if (!cache.FindFirst(path, id)) {
+			return names;
+		}
+		char* result = nullptr;
+		while (cache.FindNext(id, result)) {
+			names.insert(result);
+		}
+		return names;
+	}
+
+	std::string ShortName(const std::string& name)
+	{
+		char short_name[CROSS_LEN] = {};
+		if (!cache.GetShortName(HostPath(name).c_str(), short_name)) {
+			return {};
+		}
+		return short_name;
+	}
+
+	// Changes are noticed right away with inotify, but polled directory
+	// modification times can take a while
+	bool WaitFor(const std::function<bool()>& condition)
+	{
+		using namespace std::chrono;
+		const auto deadline = steady_clock::now() + seconds(3);
+		while (!condition()) {
+			if (steady_clock::now() > deadline) {
+				return false;
+			}
+			std::this_thread::sleep_for(milliseconds(50));
+		}
+		return true;
+	}
+
+	std_fs::path host_dir = {};
+	std::string base_path = {};
+
+	DOS_Drive_Cache cache = {};
+};
+
+TEST_F(DriveCacheTest, NoticesHostCreatedFile)
+{
+	ASSERT_EQ(List().count("ALPHA.TXT"), 1u);
+	ASSERT_EQ(List().count("BETA.TXT"), 0u);
+
+	CreateHostFile("beta.txt");
+
+	EXPECT_TRUE(WaitFor([&] { return List().count("BETA.TXT") == 1; }));
+	EXPECT_EQ(List().count("ALPHA.TXT"), 1u);
+}
+
+TEST_F(DriveCacheTest, NoticesHostDeletedFile)
+{
+	ASSERT_EQ(List().count("ALPHA.TXT"), 1u);
+
+	std_fs::remove(host_dir / "alpha.txt");
+
+	EXPECT_TRUE(WaitFor([&] { return List().count("ALPHA.TXT") == 0; }));
+}
+
+TEST_F(DriveCacheTest, NoticesHostRenamedFile)
+{
+	ASSERT_EQ(List().count("ALPHA.TXT"), 1u);
+
+	std_fs::rename(host_dir / "alpha.txt", host_dir / "gamma.txt");
+
+	EXPECT_TRUE(WaitFor([&] {
+		const auto names = List();
+		return names.count("ALPHA.TXT") == 0 && names.count("GAMMA.TXT") == 1;
+	}));
+}
+
+TEST_F(DriveCacheTest, KeepsShortNamesOfRemainingEntries)
+{
+	ASSERT_EQ(ShortName("LongFileName1.txt"), "LONGFI~1.TXT");
+
+	// Sorts before the existing long name, but mustn't take its short name
+	CreateHostFile("LongFileName0.txt");
+
+	EXPECT_TRUE(WaitFor([&] { return List().count("LONGFI~2.TXT") == 1; }));
+	EXPECT_EQ(ShortName("LongFileName1.txt"), "LONGFI~1.TXT");
+	EXPECT_EQ(ShortName("LongFileName0.txt"), "LONGFI~2.TXT");
+}
+
+TEST_F(DriveCacheTest, GuestCreatedFileIsListedOnce)
+{
+	ASSERT_EQ(List().count("DELTA.TXT"), 0u);
+
+	// What a local drive does when the guest creates a file; the host
+	// then reports the same file back
+	CreateHostFile("delta.txt");
+	cache.AddEntry(HostPath("delta.txt").c_str(), true);
+
+	EXPECT_EQ(List().count("DELTA.TXT"), 1u);
+	EXPECT_EQ(List().count("DELTA.TXT"), 1u);
+}
+
+} // namespace
@@ -0,0 +1,478 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "dosbox.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <random>
+#include <vector>
+
+#include "cpu/flags.h"
+#include "cpu/lazyflags.h"
+#include "cpu/registers.h"
+#include "hardware/port.h"
+#include "misc/perf_counters.h"
+#include "utils/math_utils.h"
+
+// The flags optimization of the dynamic core replaces the calls of flag
+// producing helpers by their simple variants once no later instruction can
+// read the flags they produce. Blocks are translated for a backend that
+// only records the calls, and then run twice: once with the helpers that
+// were originally emitted, which is what the normal core computes, and once
+// with the calls the optimization patched. The flags every reader asks for
+// and all flags at the end of the block have to be the same.
+
+namespace {
+
+enum HostReg : uint8_t { FC_OP1, FC_OP2, FC_OP3, NumHostRegs };
+
+enum SingleOps { SOP_INC, SOP_DEC, SOP_NOT, SOP_NEG };
+
+enum DualOps {
+	DOP_ADD,
+	DOP_ADC,
+	DOP_SUB,
+	DOP_SBB,
+	DOP_CMP,
+	DOP_XOR,
+	DOP_AND,
+	DOP_OR,
+	DOP_TEST,
+	DOP_MOV,
+	DOP_XCHG
+};
+
+enum ShiftOps {
+	SHIFT_ROL,
+	SHIFT_ROR,
+	SHIFT_RCL,
+	SHIFT_RCR,
+	SHIFT_SHL,
+	SHIFT_SHR,
+	SHIFT_SAL,
+	SHIFT_SAR
+};
+
+enum BranchTypes {
+	BR_O,
+	BR_NO,
+	BR_B,
+	BR_NB,
+	BR_Z,
+	BR_NZ,
+	BR_BE,
+	BR_NBE,
+	BR_S,
+	BR_NS,
+	BR_P,
+	BR_NP,
+	BR_L,
+	BR_NL,
+	BR_LE,
+	BR_NLE
+};
+
+enum class Kind { Single, Dual, Shift, DoubleShift, Condition, Read };
+
+struct Step {
+	Kind kind = Kind::Read;
+
+	// 1, 2 or 4 bytes
+	int size = 0;
+
+	// What was emitted, and what the call was patched to
+	void* emitted = nullptr;
+	void* called  = nullptr;
+
+	uint32_t op1  = 0;
+	uint32_t op2  = 0;
+	uint8_t count = 0;
+
+	Bitu read_mask = 0;
+};
+
+static std::vector<Step> program = {};
+
+// Every call takes one byte of the fake code cache, so a position is the
+// index of the step
+static std::array<uint8_t, 1024> code = {};
+
+static struct {
+	const uint8_t* pos;
+} cache = {};
+
+static void IllegalOptionDynrec(const char* msg)
+{
+	ADD_FAILURE() << "Illegal option " << msg;
+}
+
+static const uint8_t* emit(void* func)
+{
+	const auto pos = cache.pos;
+	program.push_back({});
+	program.back().emitted = func;
+	program.back().called  = func;
+	++cache.pos;
+	return pos;
+}
+
+static void gen_call_function_raw(void* func)
+{
+	emit(func);
+}
+
+static const uint8_t* gen_call_function_R3(void* func, HostReg)
+{
+	return emit(func);
+}
+
+static void gen_fill_function_ptr(const uint8_t* pos, void* fct_ptr, Bitu)
+{
+	const auto index = static_cast<size_t>(pos - code.data());
+	ASSERT_LT(index, program.size());
+	program[index].called = fct_ptr;
+}
+
+#define DRC_CALL_CONV
+#define DRC_FC
+#define DRC_FLAGS_INVALIDATION
+
+#include "cpu/core_dynrec/dyn_flags.h"
+#include "cpu/core_dynrec/operators.h"
+
+constexpr std::array<Bitu, 6> Flags = {
+        FLAG_CF, FLAG_PF, FLAG_AF, FLAG_ZF, FLAG_SF, FLAG_OF};
+
+static bool get_flag(const Bitu flag)
+{
+	switch (flag) {
+	case FLAG_CF: return get_CF() != 0;
+	case FLAG_PF: return get_PF() != 0;
+	case FLAG_AF: return get_AF() != 0;
+	case FLAG_ZF: return get_ZF() != 0;
+	case FLAG_SF: return get_SF() != 0;
+	case FLAG_OF: return get_OF() != 0;
+	}
+	ADD_FAILURE() << "Unknown flag " << flag;
+	return false;
+}
+
+static uint32_t get_flags(const Bitu mask)
+{
+	uint32_t flags = 0;
+	for (const auto flag : Flags) {
+		if ((mask & flag) && get_flag(flag)) {
+			flags |= flag;
+		}
+	}
+	return flags;
+}
+
+template <typename T>
+static uint32_t call_single(void* func, const Step& step)
+{
+	return reinterpret_cast<T (*)(T)>(func)(static_cast<T>(step.op1));
+}
+
+template <typename T>
+static uint32_t call_dual(void* func, const Step& step)
+{
+	return reinterpret_cast<T (*)(T, T)>(func)(static_cast<T>(step.op1),
+	                                           static_cast<T>(step.op2));
+}
+
+template <typename T>
+static uint32_t call_shift(void* func, const Step& step)
+{
+	return reinterpret_cast<T (*)(T, uint8_t)>(func)(static_cast<T>(step.op1),
+	                                                 step.count);
+}
+
+template <typename T>
+static uint32_t call_double_shift(void* func, const Step& step)
+{
+	return reinterpret_cast<T (*)(T, T, uint8_t)>(
+	        func)(static_cast<T>(step.op1), static_cast<T>(step.op2), step.count);
+}
+
+template <typename T>
+static uint32_t call(void* func, const Step& step)
+{
+	switch (step.kind) {
+	case Kind::Single: return call_single<T>(func, step);
+	case Kind::Dual: return call_dual<T>(func, step);
+	case Kind::Shift: return call_shift<T>(func, step);
+	case Kind::DoubleShift: return call_double_shift<T>(func, step);
+	case Kind::Condition:
+		return reinterpret_cast<uint32_t (*)()>(func)() != 0;
+	case Kind::Read: break;
+	}
+	return 0;
+}
+
+static uint32_t call(void* func, const Step& step)
+{
+	switch (step.size) {
+	case 1: return call<uint8_t>(func, step);
+	case 2: return call<uint16_t>(func, step);
+	default: return call<uint32_t>(func, step);
+	}
+}
+
+// What a run of the block leaves behind: the result of every helper, the
+// conditions and flags the readers got, and all flags at the end of the
+// block
+using Trace = std::vector<uint32_t>;
+
+static Trace run(const bool patched, const LazyFlags& initial_lflags,
+                 const uint32_t initial_flags)
+{
+	lflags    = initial_lflags;
+	reg_flags = initial_flags;
+
+	Trace trace = {};
+	for (const auto& step : program) {
+		if (step.kind == Kind::Read) {
+			trace.push_back(get_flags(step.read_mask));
+		} else {
+			trace.push_back(call(patched ? step.called : step.emitted, step));
+		}
+	}
+	trace.push_back(get_flags(FMASK_TEST));
+	return trace;
+}
+
+static Bitu condition_flags(const BranchTypes btype)
+{
+	switch (btype) {
+	case BR_O:
+	case BR_NO: return FLAG_OF;
+	case BR_B:
+	case BR_NB: return FLAG_CF;
+	case BR_Z:
+	case BR_NZ: return FLAG_ZF;
+	case BR_BE:
+	case BR_NBE: return FLAG_CF | FLAG_ZF;
+	case BR_S:
+	case BR_NS: return FLAG_SF;
+	case BR_P:
+	case BR_NP: return FLAG_PF;
+	case BR_L:
+	case BR_NL: return FLAG_SF | FLAG_OF;
+	case BR_LE:
+	case BR_NLE: return FLAG_ZF | FLAG_SF | FLAG_OF;
+	}
+	return FMASK_TEST;
+}
+
+static void translate_random_instruction(std::mt19937& rng)
+{
+	auto pick = [&](const uint32_t last) {
+		return std::uniform_int_distribution<uint32_t>(0, last)(rng);
+	};
+
+	const std::array<int, 3> sizes = {1, 2, 4};
+	const auto size = sizes[pick(2)];
+
+	// Values near the sign and carry boundaries make the flags differ
+	// more often than uniformly random ones
+	auto pick_operand = [&]() -> uint32_t {
+		constexpr uint32_t special[] = {0,
+		                                0x1,
+		                                0x7f,
+		                                0x80,
+		                                0xff,
+		                                0x7fff,
+		                                0x8000,
+		                                0xffff,
+		                                0x7fffffff,
+		                                0x80000000,
+		                                0xffffffff};
+		if (pick(1)) {
+			return special[pick(std::size(special) - 1)];
+		}
+		return static_cast<uint32_t>(rng());
+	};
+
+	// A shift count of zero leaves all flags alone
+	auto pick_count = [&]() -> uint8_t {
+		return pick(2) == 0 ? 0 : static_cast<uint8_t>(pick(0x3f));
+	};
+
+	const auto kind = pick(5);
+	if (kind == 0) {
+		// A conditional jump that continues the block, reading the
+		// flags its condition is made of
+		const auto btype = static_cast<BranchTypes>(pick(BR_NLE));
+		AcquireFlags(condition_flags(btype));
+		dyn_branchflag_to_reg(btype);
+		program.back().kind = Kind::Condition;
+		return;
+	}
+	if (kind == 5) {
+		// PUSHF or LAHF, which read all of them
+		AcquireFlags(FMASK_TEST);
+		emit(nullptr);
+		program.back().kind      = Kind::Read;
+		program.back().read_mask = FMASK_TEST;
+		return;
+	}
+
+	if (kind == 1) {
+		const auto op = static_cast<SingleOps>(pick(SOP_NEG));
+		if (size == 1) {
+			dyn_sop_byte_gencall(op);
+		} else {
+			dyn_sop_word_gencall(op, size == 4);
+		}
+		program.back().kind = Kind::Single;
+	} else if (kind == 2) {
+		const auto op = static_cast<DualOps>(pick(DOP_TEST));
+		if (size == 1) {
+			dyn_dop_byte_gencall(op);
+		} else {
+			dyn_dop_word_gencall(op, size == 4);
+		}
+		program.back().kind = Kind::Dual;
+	} else if (kind == 3) {
+		const auto op = static_cast<ShiftOps>(pick(SHIFT_SAR));
+		if (size == 1) {
+			dyn_shift_byte_gencall(op);
+		} else {
+			dyn_shift_word_gencall(op, size == 4);
+		}
+		program.back().kind = Kind::Shift;
+	} else {
+		if (size == 1) {
+			return;
+		}
+		if (size == 2) {
+			dyn_dpshift_word_gencall(pick(1) != 0);
+		} else {
+			dyn_dpshift_dword_gencall(pick(1) != 0);
+		}
+		program.back().kind = Kind::DoubleShift;
+	}
+
+	auto& step = program.back();
+	step.size  = size;
+	step.op1   = pick_operand();
+	step.op2   = pick_operand();
+	step.count = pick_count();
+}
+
+static void translate_random_block(std::mt19937& rng, const size_t length)
+{
+	program.clear();
+	cache.pos = code.data();
+	InitFlagsOptimization();
+
+	while (program.size() < length) {
+		translate_random_instruction(rng);
+	}
+}
+
+TEST(DynFlags, MatchesUnoptimizedHelpers)
+{
+	std::mt19937 rng(41);
+
+	const auto skipped_before = perf_counters.dyn_flag_helpers_skipped;
+
+	for (auto i = 0; i < 5000; ++i) {
+		const auto length = std::uniform_int_distribution<size_t>(1, 60)(rng);
+		translate_random_block(rng, length);
+
+		// The block starts after an instruction that left lazy flags
+		std::uniform_int_distribution<int> pick_type(t_ADDb, t_SUBd);
+
+		LazyFlags initial_lflags = {};
+		initial_lflags.var1.dword[DW_INDEX] = static_cast<uint32_t>(rng());
+		initial_lflags.var2.dword[DW_INDEX] = static_cast<uint32_t>(rng());
+		initial_lflags.res.dword[DW_INDEX] = static_cast<uint32_t>(rng());
+		initial_lflags.type  = static_cast<uint_fast8_t>(pick_type(rng));
+		initial_lflags.oldcf = rng() & 1;
+		const auto initial_flags = static_cast<uint32_t>(rng()) & FMASK_TEST;
+
+		const auto expected = run(false, initial_lflags, initial_flags);
+		const auto actual   = run(true, initial_lflags, initial_flags);
+
+		ASSERT_EQ(actual.size(), expected.size());
+		for (size_t step = 0; step < expected.size(); ++step) {
+			ASSERT_EQ(actual[step], expected[step])
+			        << "Block " << i << ", step " << step << " of "
+			        << program.size();
+		}
+	}
+
+	// Not a vacuous comparison
+	EXPECT_GT(perf_counters.dyn_flag_helpers_skipped, skipped_before);
+}
+
+TEST(DynFlags, KeepsProducersOfReadFlags)
+{
+	program.clear();
+	cache.pos = code.data();
+	InitFlagsOptimization();
+
+	// ADD, INC, read of CF, SUB: the ADD produces the CF that is read, as
+	// INC leaves it alone, so it has to be kept even though the SUB
+	// overwrites all flags
+	dyn_dop_byte_gencall(DOP_ADD);
+	dyn_sop_byte_gencall(SOP_INC);
+	AcquireFlags(FLAG_CF);
+	dyn_dop_byte_gencall(DOP_SUB);
+
+	ASSERT_EQ(program.size(), 3u);
+	EXPECT_EQ(program[0].called, program[0].emitted);
+	EXPECT_NE(program[1].called, program[1].emitted);
+
+	// Only the block exit reads the flags of the SUB
+	EXPECT_EQ(program[2].called, program[2].emitted);
+}
+
+TEST(DynFlags, ZeroCountShiftKeepsEarlierProducer)
+{
+	program.clear();
+	cache.pos = code.data();
+	InitFlagsOptimization();
+
+	// The SHL might not change any flags, so the flags of the ADD stay
+	// live until the SUB
+	dyn_dop_byte_gencall(DOP_ADD);
+	dyn_shift_byte_gencall(SHIFT_SHL);
+	AcquireFlags(FLAG_ZF);
+	dyn_dop_byte_gencall(DOP_SUB);
+
+	ASSERT_EQ(program.size(), 3u);
+	EXPECT_EQ(program[0].called, program[0].emitted);
+	EXPECT_EQ(program[1].called, program[1].emitted);
+}
+
+TEST(DynFlags, FullQueueKeepsOldestProducers)
+{
+	program.clear();
+	cache.pos = code.data();
+	InitFlagsOptimization();
+
+	// Rotates don't overwrite any flags for sure, so they all stay queued
+	// until the SUB; the ones that don't fit in the queue anymore are kept
+	constexpr size_t NumRotates = 70;
+	constexpr size_t QueueSize  = std::size(mf_functions);
+	for (size_t i = 0; i < NumRotates; ++i) {
+		dyn_shift_byte_gencall(SHIFT_ROL);
+	}
+	dyn_dop_byte_gencall(DOP_SUB);
+
+	ASSERT_EQ(program.size(), NumRotates + 1);
+	for (size_t i = 0; i < NumRotates; ++i) {
+		if (i < NumRotates - QueueSize) {
+			EXPECT_EQ(program[i].called, program[i].emitted) << "Rotate " << i;
+		} else {
+			EXPECT_NE(program[i].called, program[i].emitted) << "Rotate " << i;
+		}
+	}
+}
+
+} // namespace
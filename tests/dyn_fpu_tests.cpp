@@ -0,0 +1,359 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "dosbox.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "cpu/cpu.h"
+#include "cpu/registers.h"
+#include "fpu/fpu.h"
+#include "hardware/memory.h"
+#include "misc/cross.h"
+#include "utils/math_utils.h"
+
+#if C_FPU
+
+// The FPU translation of the dynamic core is run against a backend that
+// performs every generated operation right away, so the result of the
+// translated code can be compared with the FPU of the normal core.
+
+namespace {
+
+enum HostReg : uint8_t { FC_OP1, FC_OP2, FC_ADDR, NumHostRegs };
+
+static Bitu host_regs[NumHostRegs] = {};
+static std::vector<Bitu> protected_regs = {};
+
+static struct {
+	struct {
+		uint8_t val, mod, rm, reg;
+	} modrm;
+	int fpu_top;
+} decode = {};
+
+static uint8_t next_modrm = 0;
+
+static void dyn_get_modrm()
+{
+	decode.modrm.val = next_modrm;
+	decode.modrm.mod = next_modrm >> 6;
+	decode.modrm.reg = (next_modrm >> 3) & 7;
+	decode.modrm.rm  = next_modrm & 7;
+}
+
+static void dyn_fill_ea(HostReg)
+{
+	ADD_FAILURE() << "Memory operands aren't covered";
+}
+
+static void gen_mov_word_to_reg(HostReg reg, void* data, bool dword)
+{
+	host_regs[reg] = dword ? *static_cast<uint32_t*>(data)
+	                       : *static_cast<uint16_t*>(data);
+}
+
+static void gen_mov_dword_to_reg_imm(HostReg reg, uint32_t imm)
+{
+	host_regs[reg] = imm;
+}
+
+static void gen_add_imm(HostReg reg, uint32_t imm)
+{
+	host_regs[reg] = static_cast<uint32_t>(host_regs[reg] + imm);
+}
+
+static void gen_and_imm(HostReg reg, uint32_t imm)
+{
+	host_regs[reg] &= imm;
+}
+
+static void gen_protect_reg(HostReg reg)
+{
+	protected_regs.push_back(host_regs[reg]);
+}
+
+static void gen_restore_reg(HostReg reg)
+{
+	host_regs[reg] = protected_regs.back();
+	protected_regs.pop_back();
+}
+
+static void gen_call_function_raw(void* func)
+{
+	reinterpret_cast<void (*)()>(func)();
+}
+
+static void gen_call_function_R(void* func, HostReg op)
+{
+	reinterpret_cast<void (*)(Bitu)>(func)(host_regs[op]);
+}
+
+static void gen_call_function_RR(void* func, HostReg op1, HostReg op2)
+{
+	reinterpret_cast<void (*)(Bitu, Bitu)>(func)(host_regs[op1],
+	                                             host_regs[op2]);
+}
+
+#define DRC_REG_EAX 0
+#define MOV_REG_WORD16_FROM_HOST_REG(reg, index) \
+	reg_ax = static_cast<uint16_t>(host_regs[reg])
+
+#include "cpu/core_dynrec/dyn_fpu.h"
+
+struct Instruction {
+	uint8_t escape;
+	uint8_t modrm;
+	// Number of stack registers pushed and popped
+	int pushes;
+	int pops;
+};
+
+std::vector<Instruction> make_instructions()
+{
+	std::vector<Instruction> instructions = {};
+	auto add = [&](const uint8_t escape, const uint8_t modrm,
+	               const int pushes = 0, const int pops = 0) {
+		instructions.push_back({escape, modrm, pushes, pops});
+	};
+
+	for (uint8_t i = 0; i < 8; ++i) {
+		// FADD/FMUL/FCOM/FCOMP/FSUB/FSUBR/FDIV/FDIVR ST,STi
+		for (uint8_t reg = 0; reg < 8; ++reg) {
+			add(0xd8, 0xc0 | (reg << 3) | i, 0, reg == 3 ? 1 : 0);
+		}
+		add(0xd9, 0xc0 | i, 1);    // FLD STi
+		add(0xd9, 0xc8 | i);       // FXCH STi
+		add(0xd9, 0xd8 | i, 0, 1); // FSTP STi
+
+		// FADD/FMUL/FSUBR/FSUB/FDIVR/FDIV STi,ST
+		for (const uint8_t reg : {0, 1, 4, 5, 6, 7}) {
+			add(0xdc, 0xc0 | (reg << 3) | i);
+		}
+		add(0xdd, 0xc0 | i);       // FFREE STi
+		add(0xdd, 0xd0 | i);       // FST STi
+		add(0xdd, 0xd8 | i, 0, 1); // FSTP STi
+		add(0xdd, 0xe0 | i);       // FUCOM STi
+		add(0xdd, 0xe8 | i, 0, 1); // FUCOMP STi
+
+		// FADDP/FMULP/FSUBRP/FSUBP/FDIVRP/FDIVP STi,ST
+		for (const uint8_t reg : {0, 1, 4, 5, 6, 7}) {
+			add(0xde, 0xc0 | (reg << 3) | i, 0, 1);
+		}
+	}
+
+	// FNOP, FCHS, FABS, FTST, FXAM
+	for (const uint8_t modrm : {0xd0, 0xe0, 0xe1, 0xe4, 0xe5}) {
+		add(0xd9, modrm);
+	}
+	// FLD1, FLDL2T, FLDL2E, FLDPI, FLDLG2, FLDLN2, FLDZ
+	for (uint8_t modrm = 0xe8; modrm <= 0xee; ++modrm) {
+		add(0xd9, modrm, 1);
+	}
+	add(0xd9, 0xf1, 0, 1); // FYL2X
+	add(0xd9, 0xf2, 1);    // FPTAN
+	add(0xd9, 0xf3, 0, 1); // FPATAN
+	add(0xd9, 0xf4, 1);    // FXTRACT
+	add(0xd9, 0xf6);       // FDECSTP
+	add(0xd9, 0xf7);       // FINCSTP
+	add(0xd9, 0xf8);       // FPREM
+	add(0xd9, 0xfa);       // FSQRT
+	add(0xd9, 0xfb, 1);    // FSINCOS
+	add(0xd9, 0xfc);       // FRNDINT
+	add(0xd9, 0xfd);       // FSCALE
+	add(0xd9, 0xfe);       // FSIN
+	add(0xd9, 0xff);       // FCOS
+	add(0xda, 0xe9, 0, 2); // FUCOMPP
+	add(0xdb, 0xe2);       // FCLEX
+	add(0xdb, 0xe3);       // FINIT
+	add(0xde, 0xd9, 0, 2); // FCOMPP
+
+	return instructions;
+}
+
+// Only instructions that don't overflow or underflow the stack are picked,
+// as the stack checks of debug builds would stop the emulator
+bool can_run(const Instruction& instruction)
+{
+	if (instruction.pushes && fpu.tags[STV(7)] != TAG_Empty) {
+		return false;
+	}
+	for (auto i = 0; i < instruction.pops; ++i) {
+		if (fpu.tags[STV(i)] == TAG_Empty) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void run_normal(const Instruction& instruction)
+{
+	using esc_t = void (*)(Bitu);
+	constexpr esc_t escapes[] = {FPU_ESC0_Normal,
+	                             FPU_ESC1_Normal,
+	                             FPU_ESC2_Normal,
+	                             FPU_ESC3_Normal,
+	                             FPU_ESC4_Normal,
+	                             FPU_ESC5_Normal,
+	                             FPU_ESC6_Normal,
+	                             FPU_ESC7_Normal};
+	escapes[instruction.escape - 0xd8](instruction.modrm);
+}
+
+void run_translated(const Instruction& instruction)
+{
+	using esc_t = void (*)();
+	constexpr esc_t escapes[] = {dyn_fpu_esc0,
+	                             dyn_fpu_esc1,
+	                             dyn_fpu_esc2,
+	                             dyn_fpu_esc3,
+	                             dyn_fpu_esc4,
+	                             dyn_fpu_esc5,
+	                             dyn_fpu_esc6,
+	                             dyn_fpu_esc7};
+	next_modrm = instruction.modrm;
+	escapes[instruction.escape - 0xd8]();
+}
+
+// FINIT leaves the register contents alone, so the previous run would
+// leak into the next one
+void reset_fpu()
+{
+	fpu = {};
+	FPU_FINIT();
+
+	// The condition codes after arithmetic instructions are undefined, and
+	// are taken from the host FPU with C_FPU_X86; a comparison brings them
+	// into a known state
+	FPU_FTST();
+	fpu.sw = 0;
+}
+
+struct FpuState {
+	FPU_rec fpu = {};
+
+	bool operator==(const FpuState& other) const
+	{
+		constexpr auto NumRegs = 8;
+		return std::memcmp(fpu.regs, other.fpu.regs, sizeof(FPU_Reg) * NumRegs) == 0 &&
+		       std::memcmp(fpu.p_regs, other.fpu.p_regs, sizeof(FPU_P_Reg) * NumRegs) == 0 &&
+		       std::memcmp(fpu.tags, other.fpu.tags, NumRegs) == 0 &&
+		       fpu.sw == other.fpu.sw && fpu.top == other.fpu.top;
+	}
+};
+
+// Picks a random sequence of instructions the normal core can run from the
+// initial stack top, and records the state after each of them
+std::vector<Instruction> make_sequence(std::mt19937& rng, const uint32_t initial_top,
+                                       const size_t length,
+                                       std::vector<FpuState>& states)
+{
+	static const auto instructions = make_instructions();
+	std::uniform_int_distribution<size_t> pick(0, instructions.size() - 1);
+
+	reset_fpu();
+	TOP = initial_top;
+
+	std::vector<Instruction> sequence = {};
+	states.clear();
+	while (sequence.size() < length) {
+		const auto& instruction = instructions[pick(rng)];
+		if (!can_run(instruction)) {
+			continue;
+		}
+		run_normal(instruction);
+		sequence.push_back(instruction);
+		states.push_back({fpu});
+	}
+	return sequence;
+}
+
+// Runs the translation of the sequence in blocks of block_length
+// instructions. Every block starts with the stack top known at translation
+// time, as it is after passing the check of the dynamic core.
+void run_translated_sequence(const std::vector<Instruction>& sequence,
+                             const std::vector<FpuState>& states,
+                             const uint32_t initial_top,
+                             const size_t block_length, const bool top_known)
+{
+	reset_fpu();
+	TOP = initial_top;
+
+	for (size_t i = 0; i < sequence.size(); ++i) {
+		if (i % block_length == 0) {
+			decode.fpu_top = top_known ? static_cast<int>(TOP)
+			                           : FpuTopUnknown;
+		}
+		run_translated(sequence[i]);
+
+		const auto& instruction = sequence[i];
+		ASSERT_EQ(FpuState{fpu}, states[i])
+		        << "Instruction " << i << ": " << std::hex
+		        << static_cast<int>(instruction.escape) << " "
+		        << static_cast<int>(instruction.modrm);
+		ASSERT_TRUE(protected_regs.empty());
+	}
+}
+
+TEST(DynFpu, MatchesNormalCoreWithKnownTop)
+{
+	std::mt19937 rng(45);
+	std::vector<FpuState> states = {};
+
+	for (uint32_t initial_top = 0; initial_top < 8; ++initial_top) {
+		for (const size_t block_length : {1, 7, 32, 1000}) {
+			const auto sequence = make_sequence(rng, initial_top, 1000, states);
+			run_translated_sequence(sequence, states, initial_top, block_length, true);
+		}
+	}
+}
+
+TEST(DynFpu, MatchesNormalCoreWithUnknownTop)
+{
+	std::mt19937 rng(46);
+	std::vector<FpuState> states = {};
+
+	for (uint32_t initial_top = 0; initial_top < 8; ++initial_top) {
+		const auto sequence = make_sequence(rng, initial_top, 1000, states);
+		run_translated_sequence(sequence, states, initial_top, 1000, false);
+	}
+}
+
+TEST(DynFpu, TracksTopAcrossStackChanges)
+{
+	reset_fpu();
+	decode.fpu_top = static_cast<int>(TOP);
+
+	// FLD1, FLDZ, FINCSTP, FDECSTP
+	for (const auto& [modrm, top] : {std::pair{0xe8, 7},
+	                                 std::pair{0xee, 6},
+	                                 std::pair{0xf7, 7},
+	                                 std::pair{0xf6, 6}}) {
+		run_translated({0xd9, static_cast<uint8_t>(modrm), 0, 0});
+		EXPECT_EQ(decode.fpu_top, top);
+		EXPECT_EQ(TOP, static_cast<uint32_t>(top));
+	}
+
+	// FCOMPP pops both
+	run_translated({0xde, 0xd9, 0, 2});
+	EXPECT_EQ(decode.fpu_top, 0);
+
+	// FPTAN only pushes for arguments in range, so TOP has to be read
+	// at runtime after it
+	run_translated({0xd9, 0xe8, 1, 0});
+	run_translated({0xd9, 0xf2, 1, 0});
+	EXPECT_EQ(decode.fpu_top, FpuTopUnknown);
+
+	// FINIT makes it known again
+	run_translated({0xdb, 0xe3, 0, 0});
+	EXPECT_EQ(decode.fpu_top, 0);
+}
+
+} // namespace
+
+#endif // C_FPU
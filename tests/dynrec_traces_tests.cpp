@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "dosbox.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "cpu/cpu.h"
+#include "cpu/registers.h"
+#include "hardware/memory.h"
+#include "misc/perf_counters.h"
+
+#include "dosbox_test_fixture.h"
+
+#if C_DYNREC
+
+void CPU_Core_Dynrec_Cache_Init(bool enable_cache);
+void CPU_Core_Dynrec_SetTraces(bool enabled);
+
+namespace {
+
+// Real mode code is run with the recompiling core, with traces that
+// continue the translation at the targets of direct jumps
+class DynrecTracesTest : public DOSBoxTestFixture {
+protected:
+	void SetUp() override
+	{
+		DOSBoxTestFixture::SetUp();
+
+		CPU_Core_Dynrec_Cache_Init(true);
+		CPU_Core_Dynrec_SetTraces(true);
+	}
+
+	static void Write(const PhysPt addr, const std::vector<uint8_t>& bytes)
+	{
+		for (size_t i = 0; i < bytes.size(); ++i) {
+			phys_writeb(addr + static_cast<PhysPt>(i), bytes[i]);
+		}
+	}
+
+	// Runs from cs:ip until the cycles are used up
+	static void Run(const uint16_t cs_value, const uint16_t ip)
+	{
+		SegSet16(cs, cs_value);
+		reg_eip = ip;
+		reg_ax  = 0;
+
+		CPU_Cycles = 200;
+		CPU_Core_Dynrec_Run();
+	}
+};
+
+// mov ax,imm16; jmp $
+std::vector<uint8_t> set_ax_and_loop(const uint16_t value)
+{
+	return {0xb8,
+	        static_cast<uint8_t>(value & 0xff),
+	        static_cast<uint8_t>(value >> 8),
+	        0xeb,
+	        0xfe};
+}
+
+TEST_F(DynrecTracesTest, FollowsJumpAhead)
+{
+	constexpr uint16_t Segment = 0x2000;
+	constexpr PhysPt Base      = Segment << 4;
+
+	// jmp short +0x20
+	Write(Base + 0x100, {0xeb, 0x20});
+	Write(Base + 0x122, set_ax_and_loop(0x1234));
+
+	const auto followed_before = perf_counters.dyn_trace_branches;
+
+	Run(Segment, 0x100);
+
+	EXPECT_EQ(reg_ax, 0x1234);
+	EXPECT_EQ(reg_ip, 0x125);
+	EXPECT_GT(perf_counters.dyn_trace_branches, followed_before);
+}
+
+TEST_F(DynrecTracesTest, DoesNotFollowJumpAcrossIpWrap)
+{
+	// The jump at ip 0xfff0 is in the middle of a page, so the bytes the
+	// unwrapped target would point to are in the same page
+	constexpr uint16_t Segment = 0x2080;
+	constexpr PhysPt Base      = Segment << 4;
+
+	// jmp short +0x20, to ip 0x0012
+	Write(Base + 0xfff0, {0xeb, 0x20});
+	Write(Base + 0x0012, set_ax_and_loop(0x1234));
+
+	// where the jump would land if ip didn't wrap
+	Write(Base + 0x10012, set_ax_and_loop(0x5678));
+
+	Run(Segment, 0xfff0);
+
+	EXPECT_EQ(reg_ax, 0x1234);
+	EXPECT_EQ(reg_ip, 0x0015);
+}
+
+TEST_F(DynrecTracesTest, DoesNotFollowCallAcrossIpWrap)
+{
+	constexpr uint16_t Segment = 0x2080;
+	constexpr PhysPt Base      = Segment << 4;
+
+	SegSet16(ss, 0x1000);
+	reg_esp = 0x100;
+
+	// call near +0x20, to ip 0x0013
+	Write(Base + 0xfff0, {0xe8, 0x20, 0x00});
+	Write(Base + 0x0013, set_ax_and_loop(0x1234));
+	Write(Base + 0x10013, set_ax_and_loop(0x5678));
+
+	Run(Segment, 0xfff0);
+
+	EXPECT_EQ(reg_ax, 0x1234);
+	EXPECT_EQ(reg_ip, 0x0016);
+	EXPECT_EQ(mem_readw(SegPhys(ss) + reg_sp), 0xfff3);
+}
+
+} // namespace
+
+#endif // C_DYNREC
@@ -0,0 +1,391 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "misc/ethernet.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#ifndef WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "dosbox_test_fixture.h"
+
+#ifndef WIN32
+
+namespace {
+
+using namespace std::chrono_literals;
+
+// The NE2000's default MAC address and the guest side of slirp's network
+constexpr std::array<uint8_t, 6> GuestMac = {0xac, 0xde, 0x48, 0x88, 0xbb, 0xaa};
+constexpr std::array<uint8_t, 4> GuestIp  = {10, 0, 2, 15};
+
+// slirp forwards the packets sent to its host address to the loopback
+// interface of the host
+constexpr std::array<uint8_t, 4> SlirpHostIp = {10, 0, 2, 2};
+
+constexpr uint16_t GuestPort = 4321;
+
+constexpr uint16_t EtherTypeIpv4 = 0x0800;
+constexpr uint16_t EtherTypeArp  = 0x0806;
+constexpr uint8_t ProtocolUdp    = 17;
+
+constexpr size_t EthernetHeaderSize = 14;
+constexpr size_t Ipv4HeaderSize     = 20;
+constexpr size_t UdpHeaderSize      = 8;
+
+using frame_t = std::vector<uint8_t>;
+
+void put_u16(frame_t& frame, const size_t pos, const uint16_t value)
+{
+	frame[pos]     = static_cast<uint8_t>(value >> 8);
+	frame[pos + 1] = static_cast<uint8_t>(value);
+}
+
+uint16_t get_u16(const uint8_t* data, const size_t pos)
+{
+	return static_cast<uint16_t>((data[pos] << 8) | data[pos + 1]);
+}
+
+template <size_t N>
+void put_bytes(frame_t& frame, const size_t pos, const std::array<uint8_t, N>& bytes)
+{
+	std::copy(bytes.begin(), bytes.end(), frame.begin() + pos);
+}
+
+frame_t make_ethernet_frame(const std::array<uint8_t, 6>& dest_mac,
+                            const uint16_t ether_type, const size_t payload_size)
+{
+	frame_t frame(EthernetHeaderSize + payload_size);
+	put_bytes(frame, 0, dest_mac);
+	put_bytes(frame, 6, GuestMac);
+	put_u16(frame, 12, ether_type);
+	return frame;
+}
+
+frame_t make_arp_frame(const std::array<uint8_t, 6>& dest_mac, const uint16_t operation,
+                       const std::array<uint8_t, 6>& target_mac,
+                       const std::array<uint8_t, 4>& target_ip)
+{
+	constexpr size_t ArpSize = 28;
+
+	auto frame = make_ethernet_frame(dest_mac, EtherTypeArp, ArpSize);
+
+	constexpr auto Arp = EthernetHeaderSize;
+	put_u16(frame, Arp + 0, 1); // Ethernet
+	put_u16(frame, Arp + 2, EtherTypeIpv4);
+	frame[Arp + 4] = 6;
+	frame[Arp + 5] = 4;
+	put_u16(frame, Arp + 6, operation);
+	put_bytes(frame, Arp + 8, GuestMac);
+	put_bytes(frame, Arp + 14, GuestIp);
+	put_bytes(frame, Arp + 18, target_mac);
+	put_bytes(frame, Arp + 24, target_ip);
+	return frame;
+}
+
+frame_t make_udp_frame(const std::array<uint8_t, 6>& dest_mac,
+                       const uint16_t dest_port, const std::vector<uint8_t>& payload)
+{
+	const auto udp_size = UdpHeaderSize + payload.size();
+	const auto ip_size  = Ipv4HeaderSize + udp_size;
+
+	auto frame = make_ethernet_frame(dest_mac, EtherTypeIpv4, ip_size);
+
+	constexpr auto Ip = EthernetHeaderSize;
+	frame[Ip + 0]     = 0x45; // IPv4 without options
+	put_u16(frame, Ip + 2, static_cast<uint16_t>(ip_size));
+	frame[Ip + 8] = 64; // TTL
+	frame[Ip + 9] = ProtocolUdp;
+	put_bytes(frame, Ip + 12, GuestIp);
+	put_bytes(frame, Ip + 16, SlirpHostIp);
+
+	uint32_t sum = 0;
+	for (size_t i = 0; i < Ipv4HeaderSize; i += 2) {
+		sum += get_u16(frame.data(), Ip + i);
+	}
+	while (sum >> 16) {
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+	put_u16(frame, Ip + 10, static_cast<uint16_t>(~sum));
+
+	// Without a UDP checksum
+	constexpr auto Udp = Ip + Ipv4HeaderSize;
+	put_u16(frame, Udp + 0, GuestPort);
+	put_u16(frame, Udp + 2, dest_port);
+	put_u16(frame, Udp + 4, static_cast<uint16_t>(udp_size));
+	std::copy(payload.begin(), payload.end(), frame.begin() + Udp + UdpHeaderSize);
+	return frame;
+}
+
+// Echoes every UDP datagram sent to it back to the sender
+class UdpEchoServer {
+public:
+	UdpEchoServer()
+	{
+		fd = socket(AF_INET, SOCK_DGRAM, 0);
+
+		sockaddr_in address     = {};
+		address.sin_family      = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		address.sin_port        = 0;
+		bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+
+		socklen_t size = sizeof(address);
+		getsockname(fd, reinterpret_cast<sockaddr*>(&address), &size);
+		port = ntohs(address.sin_port);
+
+		// So the thread notices when it's stopped
+		timeval timeout = {0, 100'000};
+		setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+		thread = std::thread([this] { Run(); });
+	}
+
+	~UdpEchoServer()
+	{
+		is_running = false;
+		thread.join();
+		close(fd);
+	}
+
+	uint16_t GetPort() const
+	{
+		return port;
+	}
+
+private:
+	void Run()
+	{
+		std::array<uint8_t, 2048> buffer = {};
+		while (is_running) {
+			sockaddr_in sender = {};
+			socklen_t size     = sizeof(sender);
+			const auto len = recvfrom(fd,
+			                          buffer.data(),
+			                          buffer.size(),
+			                          0,
+			                          reinterpret_cast<sockaddr*>(&sender),
+			                          &size);
+			if (len > 0) {
+				sendto(fd,
+				       buffer.data(),
+				       static_cast<size_t>(len),
+				       0,
+				       reinterpret_cast<sockaddr*>(&sender),
+				       size);
+			}
+		}
+	}
+
+	int fd                       = -1;
+	uint16_t port                = 0;
+	std::atomic<bool> is_running = true;
+	std::thread thread           = {};
+};
+
+class EthernetSlirpTest : public DOSBoxTestFixture {};
+
+// The guest side of the test, doing what the NE2000 does with the packets:
+// sending them, and passing on the received ones every emulated millisecond
+class Guest {
+public:
+	explicit Guest(EthernetConnection& connection) : connection(connection) {}
+
+	void Send(const frame_t& frame)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		connection.SendPacket(frame.data(), static_cast<int>(frame.size()));
+		emulation_thread_time += std::chrono::steady_clock::now() - start;
+	}
+
+	// Sends a UDP datagram numbered in its first four payload bytes, and
+	// waits for its echo
+	void SendNumbered(frame_t frame, const uint32_t number)
+	{
+		constexpr auto Payload = EthernetHeaderSize + Ipv4HeaderSize +
+		                         UdpHeaderSize;
+		put_u16(frame, Payload, static_cast<uint16_t>(number >> 16));
+		put_u16(frame, Payload + 2, static_cast<uint16_t>(number));
+
+		in_flight[number] = std::chrono::steady_clock::now();
+		Send(frame);
+	}
+
+	void Poll()
+	{
+		const auto start = std::chrono::steady_clock::now();
+		connection.GetPackets([this](const uint8_t* packet, const int len) {
+			Receive(packet, static_cast<size_t>(len));
+			return len;
+		});
+		emulation_thread_time += std::chrono::steady_clock::now() - start;
+	}
+
+	// UDP doesn't promise delivery, so datagrams whose echo hasn't come
+	// back in time are given up on and don't hold up the others
+	void ForgetLost(const std::chrono::steady_clock::duration timeout)
+	{
+		const auto now = std::chrono::steady_clock::now();
+		for (auto it = in_flight.begin(); it != in_flight.end();) {
+			if (now - it->second > timeout) {
+				it = in_flight.erase(it);
+				++num_lost;
+			} else {
+				++it;
+			}
+		}
+	}
+
+	std::array<uint8_t, 6> slirp_mac = {};
+	bool knows_slirp_mac             = false;
+	size_t expected_payload_size     = 0;
+	int num_echoes                   = 0;
+	int num_bad_echoes               = 0;
+	int num_lost                     = 0;
+
+	std::map<uint32_t, std::chrono::steady_clock::time_point> in_flight = {};
+
+	std::chrono::steady_clock::duration emulation_thread_time = {};
+
+private:
+	void Receive(const uint8_t* packet, const size_t len)
+	{
+		if (len < EthernetHeaderSize) {
+			return;
+		}
+		const auto ether_type = get_u16(packet, 12);
+
+		constexpr auto Arp = EthernetHeaderSize;
+		if (ether_type == EtherTypeArp && len >= Arp + 28) {
+			std::array<uint8_t, 6> sender_mac = {};
+			std::array<uint8_t, 4> sender_ip  = {};
+			std::copy_n(packet + Arp + 8, 6, sender_mac.begin());
+			std::copy_n(packet + Arp + 14, 4, sender_ip.begin());
+
+			const auto operation = get_u16(packet, Arp + 6);
+			if (operation == 1) {
+				// slirp asks for the guest's address
+				Send(make_arp_frame(sender_mac, 2, sender_mac, sender_ip));
+			} else if (operation == 2) {
+				slirp_mac       = sender_mac;
+				knows_slirp_mac = true;
+			}
+			return;
+		}
+
+		constexpr auto Ip  = EthernetHeaderSize;
+		constexpr auto Udp = Ip + Ipv4HeaderSize;
+		if (ether_type == EtherTypeIpv4 && len >= Udp + UdpHeaderSize &&
+		    packet[Ip + 9] == ProtocolUdp &&
+		    get_u16(packet, Udp + 2) == GuestPort) {
+			const auto payload_size = get_u16(packet, Udp + 4) - UdpHeaderSize;
+			if (payload_size != expected_payload_size) {
+				++num_bad_echoes;
+				return;
+			}
+			constexpr auto Payload = Udp + UdpHeaderSize;
+			const auto number = (get_u16(packet, Payload) << 16) |
+			                    get_u16(packet, Payload + 2);
+
+			// Late echoes of datagrams given up on are ignored
+			if (in_flight.erase(static_cast<uint32_t>(number))) {
+				++num_echoes;
+			}
+		}
+	}
+
+	EthernetConnection& connection;
+};
+
+TEST_F(EthernetSlirpTest, UdpEchoThroughLoopback)
+{
+	constexpr auto NumPackets    = 2000;
+	constexpr size_t MaxInFlight = 16;
+	constexpr size_t PayloadSize = 1024;
+	constexpr auto Timeout       = 10s;
+	constexpr auto LossTimeout   = 500ms;
+
+	// Stands in for the emulated millisecond between NE2000 polls
+	constexpr auto PollInterval = 1ms;
+
+	UdpEchoServer server;
+
+	std::unique_ptr<EthernetConnection> connection(
+	        ETHERNET_OpenConnection("slirp"));
+	if (!connection) {
+		GTEST_SKIP() << "libslirp isn't available";
+	}
+
+	Guest guest(*connection);
+	guest.expected_payload_size = PayloadSize;
+
+	const auto deadline = std::chrono::steady_clock::now() + Timeout;
+
+	// Resolve slirp's address first, which tells it the guest's as well
+	constexpr std::array<uint8_t, 6> Broadcast = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+	guest.Send(make_arp_frame(Broadcast, 1, {}, SlirpHostIp));
+	while (!guest.knows_slirp_mac && std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(PollInterval);
+		guest.Poll();
+	}
+	ASSERT_TRUE(guest.knows_slirp_mac);
+
+	const std::vector<uint8_t> payload(PayloadSize, 0x5a);
+	const auto frame = make_udp_frame(guest.slirp_mac, server.GetPort(), payload);
+
+	guest.emulation_thread_time = {};
+	const auto start            = std::chrono::steady_clock::now();
+
+	uint32_t num_sent = 0;
+	while ((num_sent < NumPackets || !guest.in_flight.empty()) &&
+	       std::chrono::steady_clock::now() < deadline) {
+		guest.ForgetLost(LossTimeout);
+		while (num_sent < NumPackets && guest.in_flight.size() < MaxInFlight) {
+			guest.SendNumbered(frame, num_sent);
+			++num_sent;
+		}
+		std::this_thread::sleep_for(PollInterval);
+		guest.Poll();
+	}
+
+	using ms_t = std::chrono::duration<double, std::milli>;
+
+	const auto elapsed_ms = ms_t(std::chrono::steady_clock::now() - start).count();
+	const auto emulation_thread_ms = ms_t(guest.emulation_thread_time).count();
+
+	EXPECT_EQ(num_sent, NumPackets);
+	EXPECT_EQ(guest.num_echoes + guest.num_lost, NumPackets);
+	EXPECT_EQ(guest.num_bad_echoes, 0);
+
+	// Even on a busy host, only a few datagrams get lost on the loopback
+	// interface
+	EXPECT_LE(guest.num_lost, NumPackets / 100);
+
+	printf("Echoed %d UDP packets of %zu bytes in %.1f ms (%.0f packets/s), "
+	       "%d lost, %.2f ms of it on the emulation thread\n",
+	       guest.num_echoes,
+	       PayloadSize,
+	       elapsed_ms,
+	       guest.num_echoes * 1000.0 / elapsed_ms,
+	       guest.num_lost,
+	       emulation_thread_ms);
+}
+
+} // namespace
+
+#endif // WIN32
@@ -0,0 +1,223 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "capture/image/golden_images.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "misc/std_filesystem.h"
+
+namespace {
+
+using Status = GoldenImages::Status;
+
+class GoldenImagesTest : public ::testing::Test {
+protected:
+	void SetUp() override
+	{
+		golden_dir = std_fs::temp_directory_path() / "dosbox_golden_images";
+		std_fs::remove_all(golden_dir);
+		std_fs::create_directories(golden_dir);
+
+		report_path = golden_dir / "report" / "report.json";
+	}
+
+	void TearDown() override
+	{
+		std::error_code ec = {};
+		std_fs::remove_all(golden_dir, ec);
+	}
+
+	void WriteHashes(const std::string& contents) const
+	{
+		std::ofstream(golden_dir / "hashes.txt") << contents;
+	}
+
+	std::string ReadFile(const std_fs::path& path) const
+	{
+		std::ifstream in(path);
+		std::stringstream contents;
+		contents << in.rdbuf();
+		return contents.str();
+	}
+
+	// The report is written when the comparison ends
+	std::string ReadReport() const
+	{
+		return ReadFile(report_path);
+	}
+
+	static bool Contains(const std::string& str, const std::string& part)
+	{
+		return str.find(part) != std::string::npos;
+	}
+
+	std_fs::path golden_dir  = {};
+	std_fs::path report_path = {};
+};
+
+TEST_F(GoldenImagesTest, LoadsTheHashes)
+{
+	WriteHashes("# Screenshot number and hash of the raw image\n"
+	            "1 00000000000000aa\n"
+	            "\n"
+	            "  2   bb  \n"
+	            "3 FEDCBA9876543210\n");
+	{
+		GoldenImages golden = {};
+		golden.Init(GoldenImageMode::Compare, golden_dir, report_path);
+
+		EXPECT_EQ(golden.AddImage(0xaa), Status::Pass);
+		EXPECT_EQ(golden.AddImage(0xbb), Status::Pass);
+		EXPECT_EQ(golden.AddImage(0xfedcba9876543210), Status::Pass);
+		EXPECT_EQ(golden.AddImage(0xcc), Status::Missing);
+	}
+}
+
+TEST_F(GoldenImagesTest, SkipsMalformedLines)
+{
+	WriteHashes("1 aa extra\n"
+	            "2\n"
+	            "x bb\n"
+	            "0 cc\n"
+	            "-4 dd\n"
+	            "3 not-a-hash\n"
+	            "5 ee\n");
+	{
+		GoldenImages golden = {};
+		golden.Init(GoldenImageMode::Compare, golden_dir, report_path);
+
+		// Without a valid line, a screenshot has no golden hash, not a
+		// hash of zero
+		for (auto i = 0; i < 4; ++i) {
+			EXPECT_EQ(golden.AddImage(0), Status::Missing) << "Image " << i + 1;
+		}
+		EXPECT_EQ(golden.AddImage(0xee), Status::Pass);
+	}
+	const auto report = ReadReport();
+	EXPECT_TRUE(Contains(report, "\"result\":\"fail\""));
+	EXPECT_TRUE(Contains(report, "\"passed\":1,"));
+	EXPECT_TRUE(Contains(report, "\"missing\":4,"));
+}
+
+TEST_F(GoldenImagesTest, LaterLinesOverrideEarlierOnes)
+{
+	WriteHashes("1 aa\n"
+	            "1 bb\n");
+	{
+		GoldenImages golden = {};
+		golden.Init(GoldenImageMode::Compare, golden_dir, report_path);
+
+		EXPECT_EQ(golden.AddImage(0xaa), Status::Fail);
+	}
+}
+
+TEST_F(GoldenImagesTest, PassesWhenAllImagesMatch)
+{
+	WriteHashes("1 aa\n"
+	            "2 bb\n");
+	{
+		GoldenImages golden = {};
+		golden.Init(GoldenImageMode::Compare, golden_dir, report_path);
+
+		golden.AddImage(0xaa);
+		golden.AddImage(0xbb);
+	}
+	const auto report = ReadReport();
+	EXPECT_TRUE(Contains(report, "\"result\":\"pass\""));
+	EXPECT_TRUE(Contains(report, "\"passed\":2,"));
+	EXPECT_TRUE(Contains(report, "\"failed\":0,"));
+	EXPECT_TRUE(Contains(report, "\"missing\":0,"));
+	EXPECT_TRUE(Contains(report, "\"not_captured\":0,"));
+}
+
+TEST_F(GoldenImagesTest, FailsOnMismatch)
+{
+	WriteHashes("1 aa\n"
+	            "2 bb\n");
+	{
+		GoldenImages golden = {};
+		golden.Init(GoldenImageMode::Compare, golden_dir, report_path);
+
+		EXPECT_EQ(golden.AddImage(0xaa), Status::Pass);
+		EXPECT_EQ(golden.AddImage(0xbc), Status::Fail);
+		golden.SetLastImageFilename("image0002.png");
+	}
+	const auto report = ReadReport();
+	EXPECT_TRUE(Contains(report, "\"result\":\"fail\""));
+	EXPECT_TRUE(Contains(report, "\"failed\":1,"));
+	EXPECT_TRUE(Contains(report,
+	                     "{\"number\":2,\"status\":\"fail\","
+	                     "\"actual\":\"00000000000000bc\","
+	                     "\"expected\":\"00000000000000bb\","
+	                     "\"file\":\"image0002.png\"}"));
+}
+
+TEST_F(GoldenImagesTest, FailsOnExtraImages)
+{
+	WriteHashes("1 aa\n");
+	{
+		GoldenImages golden = {};
+		golden.Init(GoldenImageMode::Compare, golden_dir, report_path);
+
+		golden.AddImage(0xaa);
+		EXPECT_EQ(golden.AddImage(0xbb), Status::Missing);
+	}
+	const auto report = ReadReport();
+	EXPECT_TRUE(Contains(report, "\"result\":\"fail\""));
+	EXPECT_TRUE(Contains(report, "\"missing\":1,"));
+}
+
+TEST_F(GoldenImagesTest, FailsOnImagesNotCaptured)
+{
+	WriteHashes("1 aa\n"
+	            "2 bb\n"
+	            "3 cc\n");
+	{
+		GoldenImages golden = {};
+		golden.Init(GoldenImageMode::Compare, golden_dir, report_path);
+
+		golden.AddImage(0xaa);
+	}
+	const auto report = ReadReport();
+	EXPECT_TRUE(Contains(report, "\"result\":\"fail\""));
+	EXPECT_TRUE(Contains(report, "\"passed\":1,"));
+	EXPECT_TRUE(Contains(report, "\"not_captured\":2,"));
+}
+
+TEST_F(GoldenImagesTest, FailsWithoutTheHashesFile)
+{
+	{
+		GoldenImages golden = {};
+		golden.Init(GoldenImageMode::Compare, golden_dir, report_path);
+
+		EXPECT_EQ(golden.AddImage(0xaa), Status::Missing);
+	}
+	EXPECT_TRUE(Contains(ReadReport(), "\"result\":\"fail\""));
+}
+
+TEST_F(GoldenImagesTest, ComparesAgainstRecordedHashes)
+{
+	{
+		GoldenImages golden = {};
+		golden.Init(GoldenImageMode::Record, golden_dir, report_path);
+
+		EXPECT_EQ(golden.AddImage(0x0123456789abcdef), Status::Missing);
+		EXPECT_EQ(golden.AddImage(0xaa), Status::Missing);
+	}
+	EXPECT_FALSE(std_fs::exists(report_path));
+	{
+		GoldenImages golden = {};
+		golden.Init(GoldenImageMode::Compare, golden_dir, report_path);
+
+		EXPECT_EQ(golden.AddImage(0x0123456789abcdef), Status::Pass);
+		EXPECT_EQ(golden.AddImage(0xaa), Status::Pass);
+	}
+	EXPECT_TRUE(Contains(ReadReport(), "\"result\":\"pass\""));
+}
+
+} // namespace
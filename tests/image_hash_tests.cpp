@@ -0,0 +1,155 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "capture/image/image_hash.h"
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr int Width  = 5;
+constexpr int Height = 3;
+
+constexpr auto BytesPerPixel = 3;
+constexpr auto RowSize       = Width * BytesPerPixel;
+
+// The pixel data of the test image, row by row without any padding
+std::vector<uint8_t> make_pixels()
+{
+	std::vector<uint8_t> pixels(RowSize * Height);
+	for (size_t i = 0; i < pixels.size(); ++i) {
+		pixels[i] = static_cast<uint8_t>(i * 7 + 1);
+	}
+	return pixels;
+}
+
+// Stores the pixels with the given pitch, and fills the padding at the end
+// of the rows with the given value
+std::vector<uint8_t> store_rows(const std::vector<uint8_t>& pixels,
+                                const uint16_t pitch, const uint8_t padding,
+                                const bool is_flipped_vertically = false)
+{
+	std::vector<uint8_t> data(static_cast<size_t>(pitch) * Height, padding);
+	for (auto y = 0; y < Height; ++y) {
+		const auto row = is_flipped_vertically ? (Height - 1 - y) : y;
+		std::copy_n(pixels.begin() + y * RowSize,
+		            RowSize,
+		            data.begin() + row * pitch);
+	}
+	return data;
+}
+
+RenderedImage make_image(std::vector<uint8_t>& data, const uint16_t pitch,
+                         const bool is_flipped_vertically = false)
+{
+	RenderedImage image         = {};
+	image.params.width          = Width;
+	image.params.height         = Height;
+	image.params.pixel_format   = PixelFormat::BGR24_ByteArray;
+	image.is_flipped_vertically = is_flipped_vertically;
+	image.pitch                 = pitch;
+	image.image_data            = data.data();
+	return image;
+}
+
+// The recorded golden image hashes would all go stale if the hash changed
+TEST(ImageHash, IsStable)
+{
+	if constexpr (std::endian::native != std::endian::little) {
+		GTEST_SKIP() << "The hash is only pinned on little-endian hosts";
+	}
+	auto data = make_pixels();
+	EXPECT_EQ(image_hash_to_string(hash_rendered_image(make_image(data, RowSize))),
+	          "57e8f4340ac9a2e0");
+}
+
+TEST(ImageHash, IgnoresRowPadding)
+{
+	const auto pixels = make_pixels();
+
+	auto unpadded  = store_rows(pixels, RowSize, 0);
+	auto padded    = store_rows(pixels, RowSize + 1, 0x00);
+	auto different = store_rows(pixels, RowSize + 17, 0xff);
+
+	const auto hash = hash_rendered_image(make_image(unpadded, RowSize));
+	EXPECT_EQ(hash_rendered_image(make_image(padded, RowSize + 1)), hash);
+	EXPECT_EQ(hash_rendered_image(make_image(different, RowSize + 17)), hash);
+}
+
+TEST(ImageHash, HashesFlippedImagesTopToBottom)
+{
+	const auto pixels = make_pixels();
+
+	auto upright = store_rows(pixels, RowSize + 3, 0);
+	auto flipped = store_rows(pixels, RowSize + 3, 0, true);
+
+	EXPECT_EQ(hash_rendered_image(make_image(flipped, RowSize + 3, true)),
+	          hash_rendered_image(make_image(upright, RowSize + 3)));
+}
+
+TEST(ImageHash, ChangesWithAnyPixel)
+{
+	auto data       = make_pixels();
+	const auto hash = hash_rendered_image(make_image(data, RowSize));
+
+	for (const size_t pos : {size_t{0}, data.size() / 2, data.size() - 1}) {
+		auto changed = data;
+		++changed[pos];
+		EXPECT_NE(hash_rendered_image(make_image(changed, RowSize)), hash)
+		        << "Byte " << pos;
+	}
+}
+
+TEST(ImageHash, IncludesTheDimensionsAndFormat)
+{
+	auto data = make_pixels();
+
+	const auto image = make_image(data, RowSize);
+	const auto hash  = hash_rendered_image(image);
+
+	// The same bytes read as a different image
+	auto transposed          = image;
+	transposed.params.width  = Height;
+	transposed.params.height = Width;
+	transposed.pitch         = Height * BytesPerPixel;
+	EXPECT_NE(hash_rendered_image(transposed), hash);
+
+	// The same rows read as paletted pixels
+	auto indexed                = image;
+	indexed.params.width        = RowSize;
+	indexed.params.pixel_format = PixelFormat::Indexed8;
+	EXPECT_NE(hash_rendered_image(indexed), hash);
+}
+
+TEST(ImageHash, IncludesThePaletteButNotItsPadding)
+{
+	std::vector<uint8_t> data(Width * Height, 1);
+
+	std::vector<uint8_t> palette(256 * 4);
+	for (size_t i = 0; i < palette.size(); ++i) {
+		palette[i] = static_cast<uint8_t>(i);
+	}
+
+	RenderedImage image       = {};
+	image.params.width        = Width;
+	image.params.height       = Height;
+	image.params.pixel_format = PixelFormat::Indexed8;
+	image.pitch               = Width;
+	image.image_data          = data.data();
+	image.palette_data        = palette.data();
+
+	const auto hash = hash_rendered_image(image);
+
+	palette[1 * 4 + 3] ^= 0xff;
+	EXPECT_EQ(hash_rendered_image(image), hash);
+
+	// Even colours none of the pixels use
+	palette[200 * 4 + 0] ^= 0xff;
+	EXPECT_NE(hash_rendered_image(image), hash);
+}
+
+} // namespace
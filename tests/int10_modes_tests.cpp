@@ -5,17 +5,25 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <array>
 #include <optional>
 #include <string>
 #include <vector>
 
+#include "dosbox_test_fixture.h"
+#include "hardware/memory.h"
+#include "hardware/port.h"
+#include "ints/int10.h"
+
 // declarations of private functions to test
 std::optional<Rgb888> parse_color_token(const std::string& token,
                                        const uint8_t color_index);
 
 std::optional<cga_colors_t> parse_cga_colors(const std::string& cga_colors_prefs);
 
+void INT10_Init(Section*);
+
 namespace {
 
 constexpr auto dummy_color_index = 0;
@@ -379,4 +387,227 @@ TEST(parse_cga_colors, invalid_empty_string)
 	EXPECT_FALSE(maybe_result.has_value());
 }
 
+/////////////////////////////////////////////////////////////////////////////
+
+// The scroll functions copy and fill the rows in bulk, which has to leave
+// the video memory, the planar pixel buffer, and the latches exactly as the
+// byte by byte access through the page handlers does
+
+class Int10ScrollTest : public DOSBoxTestFixture {
+protected:
+	void SetUp() override
+	{
+		DOSBoxTestFixture::SetUp();
+		INT10_Init(nullptr);
+	}
+
+	void SetModeWithPattern(const uint16_t mode)
+	{
+		INT10_SetVideoMode(mode);
+		FillWithPattern();
+	}
+
+	static void FillWithPattern()
+	{
+		for (uint32_t i = 0; i < vga.vmemsize; ++i) {
+			vga.mem.linear[i] = static_cast<uint8_t>(i * 13 + (i >> 9));
+		}
+		for (uint32_t i = 0; i < vga.vmemsize * 2; ++i) {
+			vga.fastmem[i] = static_cast<uint8_t>(i * 7 + (i >> 10));
+		}
+		vga.latch.d = 0x12345678;
+	}
+};
+
+struct VideoState {
+	std::vector<uint8_t> memory = {};
+	std::vector<uint8_t> pixels = {};
+	uint32_t latch              = 0;
+
+	bool operator==(const VideoState&) const = default;
+};
+
+VideoState save_video_state()
+{
+	VideoState state = {};
+	state.memory.assign(vga.mem.linear, vga.mem.linear + vga.vmemsize);
+	state.pixels.assign(vga.fastmem, vga.fastmem + vga.vmemsize * 2);
+	state.latch = vga.latch.d;
+	return state;
+}
+
+void restore_video_state(const VideoState& state)
+{
+	std::copy(state.memory.begin(), state.memory.end(), vga.mem.linear);
+	std::copy(state.pixels.begin(), state.pixels.end(), vga.fastmem);
+	vga.latch.d = state.latch;
+}
+
+void expect_same_as_bytewise_copy(const PhysPt dest, const PhysPt src, const Bitu len)
+{
+	const auto before = save_video_state();
+
+	VGA_BlockCopy(dest, src, len);
+	const auto bulk = save_video_state();
+
+	restore_video_state(before);
+	for (Bitu i = 0; i < len; ++i) {
+		mem_writeb(dest + i, mem_readb(src + i));
+	}
+	const auto bytewise = save_video_state();
+
+	EXPECT_NE(bytewise, before);
+	EXPECT_TRUE(bulk == bytewise);
+}
+
+void expect_same_as_bytewise_fill(const PhysPt dest, const uint8_t val, const Bitu len)
+{
+	const auto before = save_video_state();
+
+	VGA_BlockFill(dest, val, len);
+	const auto bulk = save_video_state();
+
+	restore_video_state(before);
+	for (Bitu i = 0; i < len; ++i) {
+		mem_writeb(dest + i, val);
+	}
+	const auto bytewise = save_video_state();
+
+	EXPECT_NE(bytewise, before);
+	EXPECT_TRUE(bulk == bytewise);
+}
+
+void write_gfx_register(const uint8_t index, const uint8_t val)
+{
+	IO_Write(0x3ce, index);
+	IO_Write(0x3cf, val);
+}
+
+void write_map_mask(const uint8_t val)
+{
+	IO_Write(0x3c4, 2);
+	IO_Write(0x3c5, val);
+}
+
+// Long enough to cross a page, like most rows of 640x480 do
+constexpr Bitu PlanarRowsize = 80 * 16;
+
+constexpr PhysPt PlanarDest = 0xa0000 + 80 * 30;
+constexpr PhysPt PlanarSrc  = 0xa0000 + 80 * 100;
+
+TEST_F(Int10ScrollTest, PlanarCopyInWriteMode1)
+{
+	SetModeWithPattern(0x12);
+
+	write_gfx_register(5, 1);
+	write_map_mask(0xf);
+	expect_same_as_bytewise_copy(PlanarDest, PlanarSrc, PlanarRowsize);
+
+	// The rows are the same after the first copy
+	FillWithPattern();
+
+	write_map_mask(0x5);
+	expect_same_as_bytewise_copy(PlanarDest, PlanarSrc, PlanarRowsize);
+}
+
+TEST_F(Int10ScrollTest, PlanarCopyOverlapping)
+{
+	SetModeWithPattern(0x10);
+
+	write_gfx_register(5, 1);
+	write_map_mask(0xf);
+	expect_same_as_bytewise_copy(PlanarSrc + 3, PlanarSrc, PlanarRowsize);
+}
+
+TEST_F(Int10ScrollTest, PlanarCopyInOtherWriteModes)
+{
+	SetModeWithPattern(0x12);
+
+	write_gfx_register(5, 0);
+	write_map_mask(0xf);
+	expect_same_as_bytewise_copy(PlanarDest, PlanarSrc, PlanarRowsize);
+}
+
+TEST_F(Int10ScrollTest, PlanarFillWithSetReset)
+{
+	SetModeWithPattern(0x12);
+
+	// As the scroll function fills the rows
+	write_gfx_register(8, 0xff);
+	write_gfx_register(0, 0x0c);
+	write_gfx_register(1, 0xf);
+	write_map_mask(0xf);
+	expect_same_as_bytewise_fill(PlanarDest, 0xff, PlanarRowsize);
+}
+
+TEST_F(Int10ScrollTest, PlanarFillWithLatchesAndMasks)
+{
+	SetModeWithPattern(0x0d);
+
+	// The latches and the raster operation take part in the result
+	mem_readb(PlanarSrc);
+	write_gfx_register(3, 0x18); // XOR
+	write_gfx_register(8, 0x3c);
+	write_map_mask(0x3);
+	expect_same_as_bytewise_fill(PlanarDest, 0xa5, PlanarRowsize);
+
+	write_gfx_register(5, 2);
+	expect_same_as_bytewise_fill(PlanarDest, 0x06, PlanarRowsize);
+}
+
+TEST_F(Int10ScrollTest, ChainedVgaCopyAndFill)
+{
+	SetModeWithPattern(0x13);
+
+	// The first rows are replicated in the pixel buffer
+	expect_same_as_bytewise_copy(0xa0000 + 100, 0xa0000 + 320 * 50, 320 * 20);
+	expect_same_as_bytewise_fill(0xa0000 + 320 * 8, 0x2a, 320 * 20);
+}
+
+TEST_F(Int10ScrollTest, TextCopyAndFill)
+{
+	SetModeWithPattern(0x03);
+
+	expect_same_as_bytewise_copy(0xb8000 + 160 * 2, 0xb8000 + 160 * 20, 160 * 4);
+	expect_same_as_bytewise_fill(0xb8000 + 160 * 10, 0x20, 160 * 30);
+}
+
+TEST_F(Int10ScrollTest, ScrollTextWindowUp)
+{
+	INT10_SetVideoMode(0x03);
+
+	constexpr uint16_t Columns = 80;
+	constexpr uint16_t Rows    = 25;
+
+	for (uint16_t row = 0; row < Rows; ++row) {
+		for (uint16_t col = 0; col < Columns; ++col) {
+			const uint16_t cell = static_cast<uint16_t>(0x1e00 + 'A' + row);
+			real_writew(0xb800, (row * Columns + col) * 2, cell);
+		}
+	}
+
+	// Scroll the middle of the screen up by two rows
+	INT10_ScrollWindow(5, 10, 20, 69, -2, 0x4f, 0xff);
+
+	auto cell_at = [&](const uint16_t row, const uint16_t col) {
+		return real_readw(0xb800, (row * Columns + col) * 2);
+	};
+
+	for (uint16_t row = 0; row < Rows; ++row) {
+		const uint16_t unchanged = static_cast<uint16_t>(0x1e00 + 'A' + row);
+
+		EXPECT_EQ(cell_at(row, 9), unchanged);
+		EXPECT_EQ(cell_at(row, 70), unchanged);
+
+		uint16_t expected = unchanged;
+		if (row >= 5 && row <= 18) {
+			expected = static_cast<uint16_t>(0x1e00 + 'A' + row + 2);
+		} else if (row >= 19 && row <= 20) {
+			expected = 0x4f00 + ' ';
+		}
+		EXPECT_EQ(cell_at(row, 10), expected);
+		EXPECT_EQ(cell_at(row, 69), expected);
+	}
+}
+
 } // namespace
@@ -0,0 +1,642 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "dosbox.h"
+
+#include <gtest/gtest.h>
+
+// Needed for std::isnan in simde
+#include <cmath>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "cpu/mmx.h"
+#include "cpu/paging.h"
+#include "hardware/memory.h"
+
+#include "simde/x86/mmx.h"
+
+// The MMX instructions of the dynrec core are translated into calls of the
+// helpers in dyn_mmx.h. Here the calls are made right away, and the results
+// are checked lane by lane against a plain scalar implementation, with an
+// emphasis on the values at the saturation boundaries and on shift counts at
+// or above the lane width.
+
+enum HostReg : uint8_t { FC_ADDR };
+
+static struct {
+	struct {
+		uint8_t val, mod, rm, reg;
+	} modrm;
+} decode = {};
+
+static uint8_t next_modrm = 0;
+static uint8_t next_imm   = 0;
+
+static void dyn_get_modrm()
+{
+	decode.modrm.val = next_modrm;
+	decode.modrm.mod = next_modrm >> 6;
+	decode.modrm.reg = (next_modrm >> 3) & 7;
+	decode.modrm.rm  = next_modrm & 7;
+}
+
+static uint8_t decode_fetchb()
+{
+	return next_imm;
+}
+
+static void dyn_fill_ea(HostReg)
+{
+	ADD_FAILURE() << "Memory operands aren't covered";
+}
+
+static void gen_call_function_raw(void* func)
+{
+	reinterpret_cast<void (*)()>(func)();
+}
+
+static void gen_call_function_I(void* func, Bitu imm)
+{
+	reinterpret_cast<void (*)(Bitu, PhysPt)>(func)(imm, 0);
+}
+
+static void gen_call_function_II(void* func, Bitu imm1, Bitu imm2)
+{
+	reinterpret_cast<void (*)(Bitu, Bitu)>(func)(imm1, imm2);
+}
+
+static void gen_call_function_IR(void*, Bitu, HostReg)
+{
+	ADD_FAILURE() << "Memory operands aren't covered";
+}
+
+#include "cpu/core_dynrec/dyn_mmx.h"
+
+namespace {
+
+template <typename T>
+T lane(const uint64_t value, const int index)
+{
+	using unsigned_t = std::make_unsigned_t<T>;
+	return static_cast<T>(
+	        static_cast<unsigned_t>(value >> (index * sizeof(T) * 8)));
+}
+
+template <typename T>
+uint64_t set_lane(const uint64_t value, const int index, const T lane_value)
+{
+	using unsigned_t         = std::make_unsigned_t<T>;
+	constexpr auto Bits      = sizeof(T) * 8;
+	const auto shift         = index * Bits;
+	const uint64_t lane_mask = static_cast<unsigned_t>(~unsigned_t{0});
+
+	return (value & ~(lane_mask << shift)) |
+	       (static_cast<uint64_t>(static_cast<unsigned_t>(lane_value)) << shift);
+}
+
+template <typename T>
+constexpr int num_lanes()
+{
+	return 8 / sizeof(T);
+}
+
+template <typename T>
+T saturate(const int64_t value)
+{
+	return static_cast<T>(std::clamp<int64_t>(value,
+	                                          std::numeric_limits<T>::min(),
+	                                          std::numeric_limits<T>::max()));
+}
+
+// Applies op(a_lane, b_lane) to every lane pair of type T
+template <typename T, typename Op>
+uint64_t map_lanes(const uint64_t a, const uint64_t b, Op op)
+{
+	uint64_t result = 0;
+	for (auto i = 0; i < num_lanes<T>(); ++i) {
+		result = set_lane<T>(result, i, op(lane<T>(a, i), lane<T>(b, i)));
+	}
+	return result;
+}
+
+template <typename T>
+uint64_t scalar_add(const uint64_t a, const uint64_t b)
+{
+	return map_lanes<T>(a, b, [](T x, T y) { return static_cast<T>(x + y); });
+}
+
+template <typename T>
+uint64_t scalar_sub(const uint64_t a, const uint64_t b)
+{
+	return map_lanes<T>(a, b, [](T x, T y) { return static_cast<T>(x - y); });
+}
+
+template <typename T>
+uint64_t scalar_add_saturated(const uint64_t a, const uint64_t b)
+{
+	return map_lanes<T>(a, b, [](T x, T y) {
+		return saturate<T>(int64_t{x} + int64_t{y});
+	});
+}
+
+template <typename T>
+uint64_t scalar_sub_saturated(const uint64_t a, const uint64_t b)
+{
+	return map_lanes<T>(a, b, [](T x, T y) {
+		return saturate<T>(int64_t{x} - int64_t{y});
+	});
+}
+
+template <typename T>
+uint64_t scalar_cmpeq(const uint64_t a, const uint64_t b)
+{
+	return map_lanes<T>(a, b, [](T x, T y) {
+		return static_cast<T>(x == y ? -1 : 0);
+	});
+}
+
+template <typename T>
+uint64_t scalar_cmpgt(const uint64_t a, const uint64_t b)
+{
+	return map_lanes<T>(a, b, [](T x, T y) {
+		return static_cast<T>(x > y ? -1 : 0);
+	});
+}
+
+uint64_t scalar_pmullw(const uint64_t a, const uint64_t b)
+{
+	return map_lanes<int16_t>(a, b, [](int16_t x, int16_t y) {
+		return static_cast<int16_t>(int32_t{x} * int32_t{y});
+	});
+}
+
+uint64_t scalar_pmulhw(const uint64_t a, const uint64_t b)
+{
+	return map_lanes<int16_t>(a, b, [](int16_t x, int16_t y) {
+		return static_cast<int16_t>((int32_t{x} * int32_t{y}) >> 16);
+	});
+}
+
+uint64_t scalar_pmaddwd(const uint64_t a, const uint64_t b)
+{
+	uint64_t result = 0;
+	for (auto i = 0; i < 2; ++i) {
+		const auto low = int64_t{lane<int16_t>(a, i * 2)} *
+		                 lane<int16_t>(b, i * 2);
+		const auto high = int64_t{lane<int16_t>(a, i * 2 + 1)} *
+		                  lane<int16_t>(b, i * 2 + 1);
+
+		// Only 0x8000 * 0x8000 twice overflows, and wraps around
+		result = set_lane<uint32_t>(result, i, static_cast<uint32_t>(low + high));
+	}
+	return result;
+}
+
+// Packs the lanes of a into the low half and those of b into the high half
+template <typename From, typename To>
+uint64_t scalar_pack(const uint64_t a, const uint64_t b)
+{
+	uint64_t result    = 0;
+	constexpr auto Num = num_lanes<From>();
+	for (auto i = 0; i < Num; ++i) {
+		result = set_lane<To>(result, i, saturate<To>(lane<From>(a, i)));
+		result = set_lane<To>(result, i + Num, saturate<To>(lane<From>(b, i)));
+	}
+	return result;
+}
+
+// Interleaves the lanes of the low (or high) halves of a and b
+template <typename T, bool High>
+uint64_t scalar_unpack(const uint64_t a, const uint64_t b)
+{
+	uint64_t result      = 0;
+	constexpr auto Half  = num_lanes<T>() / 2;
+	constexpr auto Start = High ? Half : 0;
+	for (auto i = 0; i < Half; ++i) {
+		result = set_lane<T>(result, i * 2, lane<T>(a, Start + i));
+		result = set_lane<T>(result, i * 2 + 1, lane<T>(b, Start + i));
+	}
+	return result;
+}
+
+template <typename T>
+uint64_t scalar_shift_left(const uint64_t a, const uint64_t count)
+{
+	return map_lanes<T>(a, 0, [count](T x, T) {
+		return count >= sizeof(T) * 8 ? T{0} : static_cast<T>(x << count);
+	});
+}
+
+template <typename T>
+uint64_t scalar_shift_right_logical(const uint64_t a, const uint64_t count)
+{
+	return map_lanes<T>(a, 0, [count](T x, T) {
+		return count >= sizeof(T) * 8 ? T{0} : static_cast<T>(x >> count);
+	});
+}
+
+template <typename T>
+uint64_t scalar_shift_right_arithmetic(const uint64_t a, const uint64_t count)
+{
+	using signed_t = std::make_signed_t<T>;
+	return map_lanes<signed_t>(a, 0, [count](signed_t x, signed_t) {
+		// Counts past the lane width fill it with the sign bit
+		const auto bits = std::min<uint64_t>(count, sizeof(T) * 8 - 1);
+		return static_cast<signed_t>(x >> bits);
+	});
+}
+
+
+using op_t = uint64_t (*)(uint64_t, uint64_t);
+
+struct Instruction {
+	const char* name;
+	void (*translate)();
+	op_t scalar;
+};
+
+// Runs 'op mm0,mm1' with a in mm0 and b in mm1, and returns mm0
+uint64_t run(const Instruction& instruction, const uint64_t a, const uint64_t b)
+{
+	reg_mmx[0]->q = a;
+	reg_mmx[1]->q = b;
+	next_modrm    = 0xc1;
+
+	instruction.translate();
+	return reg_mmx[0]->q;
+}
+
+const std::vector<Instruction> binary_ops = {
+        {"PADDB", dyn_mmx_paddb, scalar_add<uint8_t>},
+        {"PADDW", dyn_mmx_paddw, scalar_add<uint16_t>},
+        {"PADDD", dyn_mmx_paddd, scalar_add<uint32_t>},
+        {"PADDSB", dyn_mmx_paddsb, scalar_add_saturated<int8_t>},
+        {"PADDSW", dyn_mmx_paddsw, scalar_add_saturated<int16_t>},
+        {"PADDUSB", dyn_mmx_paddusb, scalar_add_saturated<uint8_t>},
+        {"PADDUSW", dyn_mmx_paddusw, scalar_add_saturated<uint16_t>},
+        {"PSUBB", dyn_mmx_psubb, scalar_sub<uint8_t>},
+        {"PSUBW", dyn_mmx_psubw, scalar_sub<uint16_t>},
+        {"PSUBD", dyn_mmx_psubd, scalar_sub<uint32_t>},
+        {"PSUBSB", dyn_mmx_psubsb, scalar_sub_saturated<int8_t>},
+        {"PSUBSW", dyn_mmx_psubsw, scalar_sub_saturated<int16_t>},
+        {"PSUBUSB", dyn_mmx_psubusb, scalar_sub_saturated<uint8_t>},
+        {"PSUBUSW", dyn_mmx_psubusw, scalar_sub_saturated<uint16_t>},
+        {"PMULLW", dyn_mmx_pmullw, scalar_pmullw},
+        {"PMULHW", dyn_mmx_pmulhw, scalar_pmulhw},
+        {"PMADDWD", dyn_mmx_pmaddwd, scalar_pmaddwd},
+        {"PCMPEQB", dyn_mmx_pcmpeqb, scalar_cmpeq<uint8_t>},
+        {"PCMPEQW", dyn_mmx_pcmpeqw, scalar_cmpeq<uint16_t>},
+        {"PCMPEQD", dyn_mmx_pcmpeqd, scalar_cmpeq<uint32_t>},
+        {"PCMPGTB", dyn_mmx_pcmpgtb, scalar_cmpgt<int8_t>},
+        {"PCMPGTW", dyn_mmx_pcmpgtw, scalar_cmpgt<int16_t>},
+        {"PCMPGTD", dyn_mmx_pcmpgtd, scalar_cmpgt<int32_t>},
+        {"PACKSSWB", dyn_mmx_packsswb, scalar_pack<int16_t, int8_t>},
+        {"PACKSSDW", dyn_mmx_packssdw, scalar_pack<int32_t, int16_t>},
+        {"PACKUSWB", dyn_mmx_packuswb, scalar_pack<int16_t, uint8_t>},
+        {"PUNPCKLBW", dyn_mmx_punpcklbw, scalar_unpack<uint8_t, false>},
+        {"PUNPCKHBW", dyn_mmx_punpckhbw, scalar_unpack<uint8_t, true>},
+        {"PUNPCKLWD", dyn_mmx_punpcklwd, scalar_unpack<uint16_t, false>},
+        {"PUNPCKHWD", dyn_mmx_punpckhwd, scalar_unpack<uint16_t, true>},
+        {"PUNPCKLDQ", dyn_mmx_punpckldq, scalar_unpack<uint32_t, false>},
+        {"PUNPCKHDQ", dyn_mmx_punpckhdq, scalar_unpack<uint32_t, true>},
+        {"PAND", dyn_mmx_pand, [](uint64_t a, uint64_t b) { return a & b; }},
+        {"PANDN", dyn_mmx_pandn, [](uint64_t a, uint64_t b) { return ~a & b; }},
+        {"POR", dyn_mmx_por, [](uint64_t a, uint64_t b) { return a | b; }},
+        {"PXOR", dyn_mmx_pxor, [](uint64_t a, uint64_t b) { return a ^ b; }},
+};
+
+// Shifts by the count in an MMX register or memory operand
+const std::vector<Instruction> shift_ops = {
+        {"PSLLW", dyn_mmx_psllw, scalar_shift_left<uint16_t>},
+        {"PSLLD", dyn_mmx_pslld, scalar_shift_left<uint32_t>},
+        {"PSLLQ", dyn_mmx_psllq, scalar_shift_left<uint64_t>},
+        {"PSRLW", dyn_mmx_psrlw, scalar_shift_right_logical<uint16_t>},
+        {"PSRLD", dyn_mmx_psrld, scalar_shift_right_logical<uint32_t>},
+        {"PSRLQ", dyn_mmx_psrlq, scalar_shift_right_logical<uint64_t>},
+        {"PSRAW", dyn_mmx_psraw, scalar_shift_right_arithmetic<uint16_t>},
+        {"PSRAD", dyn_mmx_psrad, scalar_shift_right_arithmetic<uint32_t>},
+};
+
+// Shifts by an 8-bit immediate; the reg field of the ModRM byte selects
+// the operation and the rm field the register
+struct ShiftImmediate {
+	const char* name;
+	void (*translate)();
+	uint8_t reg;
+	op_t scalar;
+};
+
+const std::vector<ShiftImmediate> shift_imm_ops = {
+        {"PSLLW imm", dyn_mmx_psllw_psrlw_psraw, 6, scalar_shift_left<uint16_t>},
+        {"PSRLW imm", dyn_mmx_psllw_psrlw_psraw, 2, scalar_shift_right_logical<uint16_t>},
+        {"PSRAW imm", dyn_mmx_psllw_psrlw_psraw, 4, scalar_shift_right_arithmetic<uint16_t>},
+        {"PSLLD imm", dyn_mmx_pslld_psrld_psrad, 6, scalar_shift_left<uint32_t>},
+        {"PSRLD imm", dyn_mmx_pslld_psrld_psrad, 2, scalar_shift_right_logical<uint32_t>},
+        {"PSRAD imm", dyn_mmx_pslld_psrld_psrad, 4, scalar_shift_right_arithmetic<uint32_t>},
+        {"PSLLQ imm", dyn_mmx_psllq_psrlq, 6, scalar_shift_left<uint64_t>},
+        {"PSRLQ imm", dyn_mmx_psllq_psrlq, 2, scalar_shift_right_logical<uint64_t>},
+};
+
+// Runs 'op mm2,count' with a in mm2, and returns mm2
+uint64_t run(const ShiftImmediate& instruction, const uint64_t a, const uint64_t count)
+{
+	reg_mmx[2]->q = a;
+	next_modrm    = static_cast<uint8_t>(0xc2 | (instruction.reg << 3));
+	next_imm      = static_cast<uint8_t>(count);
+
+	instruction.translate();
+	return reg_mmx[2]->q;
+}
+
+// Values at and around the signed and unsigned saturation boundaries
+template <typename T>
+std::vector<T> edge_values()
+{
+	using unsigned_t = std::make_unsigned_t<T>;
+	using signed_t   = std::make_signed_t<T>;
+
+	constexpr auto SignedMax = static_cast<unsigned_t>(
+	        std::numeric_limits<signed_t>::max());
+	constexpr auto UnsignedMax = std::numeric_limits<unsigned_t>::max();
+
+	std::vector<T> values = {};
+	for (const auto base : {unsigned_t{0}, SignedMax, UnsignedMax}) {
+		for (const auto delta : {-2, -1, 0, 1, 2}) {
+			values.push_back(static_cast<T>(base + delta));
+		}
+	}
+	// A few values from the middle of the range as well
+	for (const auto value : {0x12, 0x5a, 0xa5, 0xed}) {
+		values.push_back(static_cast<T>(value * (UnsignedMax / 0xff)));
+	}
+	return values;
+}
+
+// Operands with every lane picked from the edge values of type T
+template <typename T>
+uint64_t make_edge_operand(std::mt19937_64& rng)
+{
+	static const auto values = edge_values<T>();
+	std::uniform_int_distribution<size_t> pick(0, values.size() - 1);
+
+	uint64_t operand = 0;
+	for (auto i = 0; i < num_lanes<T>(); ++i) {
+		operand = set_lane<T>(operand, i, values[pick(rng)]);
+	}
+	return operand;
+}
+
+std::vector<uint64_t> make_operands(std::mt19937_64& rng, const size_t num_per_kind)
+{
+	std::vector<uint64_t> operands = {};
+	for (size_t i = 0; i < num_per_kind; ++i) {
+		operands.push_back(make_edge_operand<uint8_t>(rng));
+		operands.push_back(make_edge_operand<uint16_t>(rng));
+		operands.push_back(make_edge_operand<uint32_t>(rng));
+		operands.push_back(rng());
+	}
+	return operands;
+}
+
+template <typename Op>
+void expect_same_results(const Op& op, const uint64_t a, const uint64_t b,
+                         int& num_failures)
+{
+	// Don't flood the output if an operation is broken
+	constexpr auto MaxReportedFailures = 10;
+
+	const auto emulated = run(op, a, b);
+	const auto scalar   = op.scalar(a, b);
+	if (emulated != scalar && ++num_failures <= MaxReportedFailures) {
+		ADD_FAILURE() << op.name << std::hex << " 0x" << a << ", 0x" << b
+		              << ": emulated 0x" << emulated << ", scalar 0x" << scalar;
+	}
+}
+
+TEST(Mmx, AllBytePairs)
+{
+	// Every pair of byte values, in all lanes at once and in a single lane
+	for (const auto& op : binary_ops) {
+		auto num_failures = 0;
+		for (uint64_t x = 0; x < 256; ++x) {
+			for (uint64_t y = 0; y < 256; ++y) {
+				constexpr uint64_t Broadcast = 0x0101010101010101;
+				expect_same_results(op, x * Broadcast, y * Broadcast, num_failures);
+
+				const auto index = static_cast<int>((x ^ y) & 7);
+				expect_same_results(op,
+				                    set_lane<uint8_t>(0, index, static_cast<uint8_t>(x)),
+				                    set_lane<uint8_t>(0, index, static_cast<uint8_t>(y)),
+				                    num_failures);
+			}
+		}
+	}
+}
+
+TEST(Mmx, EdgeLaneValues)
+{
+	std::mt19937_64 rng(46);
+	const auto operands = make_operands(rng, 100);
+
+	for (const auto& op : binary_ops) {
+		auto num_failures = 0;
+		for (const auto a : operands) {
+			for (const auto b : operands) {
+				expect_same_results(op, a, b, num_failures);
+			}
+		}
+	}
+}
+
+TEST(Mmx, WordEdgePairs)
+{
+	// Every pair of word edge values, covering the PMULHW/PMADDWD extremes
+	const auto values = edge_values<uint16_t>();
+
+	for (const auto& op : binary_ops) {
+		auto num_failures = 0;
+		for (const uint64_t x : values) {
+			for (const uint64_t y : values) {
+				constexpr uint64_t Broadcast = 0x0001000100010001;
+				expect_same_results(op, x * Broadcast, y * Broadcast, num_failures);
+			}
+		}
+	}
+}
+
+TEST(Mmx, ShiftCounts)
+{
+	std::mt19937_64 rng(47);
+	const auto operands = make_operands(rng, 25);
+
+	// The whole 64-bit count is used, so counts only differing in the
+	// upper bits must not wrap around into small shifts
+	std::vector<uint64_t> counts = {};
+	for (uint64_t count = 0; count <= 72; ++count) {
+		counts.push_back(count);
+	}
+	for (const uint64_t count : {0xffull,
+	                             0x100ull,
+	                             0x1'0000'0000ull,
+	                             0x1'0000'0001ull,
+	                             0x8000'0000'0000'0004ull,
+	                             ~0ull}) {
+		counts.push_back(count);
+	}
+
+	for (const auto& op : shift_ops) {
+		auto num_failures = 0;
+		for (const auto a : operands) {
+			for (const auto count : counts) {
+				expect_same_results(op, a, count, num_failures);
+			}
+		}
+	}
+}
+
+TEST(Mmx, ShiftImmediates)
+{
+	std::mt19937_64 rng(48);
+	const auto operands = make_operands(rng, 25);
+
+	for (const auto& op : shift_imm_ops) {
+		auto num_failures = 0;
+		for (const auto a : operands) {
+			for (uint64_t count = 0; count < 256; ++count) {
+				expect_same_results(op, a, count, num_failures);
+			}
+		}
+	}
+}
+
+TEST(Mmx, SameSourceAndDestination)
+{
+	// 'op mm3,mm3' reads the source after the destination is fetched
+	std::mt19937_64 rng(50);
+	const auto operands = make_operands(rng, 25);
+
+	for (const auto& op : binary_ops) {
+		auto num_failures = 0;
+		for (const auto a : operands) {
+			reg_mmx[3]->q = a;
+			next_modrm    = 0xdb;
+			op.translate();
+
+			const auto scalar = op.scalar(a, a);
+			if (reg_mmx[3]->q != scalar && ++num_failures <= 10) {
+				ADD_FAILURE() << op.name << std::hex << " 0x" << a
+				              << ": emulated 0x" << reg_mmx[3]->q
+				              << ", scalar 0x" << scalar;
+			}
+		}
+	}
+}
+
+// A loop in the style of MMX audio and video code: saturated adds of
+// pixels and a multiply-accumulate of samples
+std::vector<uint64_t> make_mix_data()
+{
+	constexpr size_t NumValues = 4096;
+
+	std::mt19937_64 rng(49);
+	std::vector<uint64_t> data(NumValues);
+	std::generate(data.begin(), data.end(), [&] { return rng(); });
+	return data;
+}
+
+// Runs the loop through the dynrec handlers; mm0 holds the pixels, mm1 the
+// sum and mm2 the products
+void emulate_mix_loop(const std::vector<uint64_t>& data)
+{
+	for (size_t i = 0; i + 1 < data.size(); i += 2) {
+		// PADDUSB mm0,mm3; PXOR mm0,mm4
+		reg_mmx[3]->q = data[i];
+		reg_mmx[4]->q = data[i + 1];
+		next_modrm    = 0xc3;
+		dyn_mmx_paddusb();
+		next_modrm = 0xc4;
+		dyn_mmx_pxor();
+
+		// MOVQ mm2,mm3; PMADDWD mm2,mm4; PADDD mm1,mm2
+		next_modrm = 0xd3;
+		dyn_mmx_movq_pqqq();
+		next_modrm = 0xd4;
+		dyn_mmx_pmaddwd();
+		next_modrm = 0xca;
+		dyn_mmx_paddd();
+	}
+}
+
+void scalar_mix_loop(const std::vector<uint64_t>& data, uint64_t& pixels,
+                     uint64_t& sum)
+{
+	for (size_t i = 0; i + 1 < data.size(); i += 2) {
+		pixels = scalar_add_saturated<uint8_t>(pixels, data[i]) ^ data[i + 1];
+		sum = scalar_add<uint32_t>(sum, scalar_pmaddwd(data[i], data[i + 1]));
+	}
+}
+
+TEST(Mmx, PaddusbPmaddwdLoop)
+{
+	const auto data = make_mix_data();
+
+	reg_mmx[0]->q = 0;
+	reg_mmx[1]->q = 0;
+	emulate_mix_loop(data);
+
+	uint64_t pixels = 0;
+	uint64_t sum    = 0;
+	scalar_mix_loop(data, pixels, sum);
+
+	EXPECT_EQ(reg_mmx[0]->q, pixels);
+	EXPECT_EQ(reg_mmx[1]->q, sum);
+}
+
+// The timings depend too much on the host to be asserted, so this only
+// prints them; run it with --gtest_also_run_disabled_tests
+TEST(Mmx, DISABLED_PaddusbPmaddwdLoopBenchmark)
+{
+	constexpr auto NumPasses = 500;
+
+	const auto data = make_mix_data();
+
+	using ms_t = std::chrono::duration<double, std::milli>;
+
+	reg_mmx[0]->q = 0;
+	reg_mmx[1]->q = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (auto pass = 0; pass < NumPasses; ++pass) {
+		emulate_mix_loop(data);
+	}
+	const auto emulated_ms = ms_t(std::chrono::steady_clock::now() - start).count();
+
+	uint64_t pixels = 0;
+	uint64_t sum    = 0;
+
+	start = std::chrono::steady_clock::now();
+	for (auto pass = 0; pass < NumPasses; ++pass) {
+		scalar_mix_loop(data, pixels, sum);
+	}
+	const auto scalar_ms = ms_t(std::chrono::steady_clock::now() - start).count();
+
+	EXPECT_EQ(reg_mmx[0]->q, pixels);
+	EXPECT_EQ(reg_mmx[1]->q, sum);
+
+	printf("PADDUSB/PMADDWD loop over %zu operands x %d: emulated %.2f ms, "
+	       "scalar %.2f ms\n",
+	       data.size() / 2,
+	       NumPasses,
+	       emulated_ms,
+	       scalar_ms);
+}
+
+} // namespace
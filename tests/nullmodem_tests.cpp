@@ -0,0 +1,333 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "hardware/serialport/nullmodem.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "dosbox_test_fixture.h"
+#include "hardware/pic.h"
+#include "hardware/timer.h"
+#include "shell/command_line.h"
+
+#if C_MODEM && !defined(WIN32)
+
+namespace {
+
+using namespace std::chrono_literals;
+
+constexpr auto Timeout = 10s;
+
+// The emulated COM3 and COM4, which aren't set up by default
+constexpr uint8_t FirstPort  = 2;
+constexpr uint8_t SecondPort = 3;
+
+// Asks the host for a free TCP port on the loopback interface
+uint16_t find_free_port()
+{
+	const auto fd = socket(AF_INET, SOCK_STREAM, 0);
+
+	sockaddr_in address     = {};
+	address.sin_family      = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port        = 0;
+	bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+
+	socklen_t size = sizeof(address);
+	getsockname(fd, reinterpret_cast<sockaddr*>(&address), &size);
+	close(fd);
+
+	return ntohs(address.sin_port);
+}
+
+class NullModemTest : public DOSBoxTestFixture {
+protected:
+	void TearDown() override
+	{
+		for (const auto port_idx : {FirstPort, SecondPort}) {
+			delete serialports[port_idx];
+			serialports[port_idx] = nullptr;
+		}
+		DOSBoxTestFixture::TearDown();
+	}
+
+	static CSerial* OpenPort(const uint8_t port_idx, const std::string& options)
+	{
+		CommandLine cmd("nullmodem", options);
+
+		auto port = std::make_unique<CNullModem>(port_idx, &cmd);
+		if (!port->InstallationSuccessful) {
+			return nullptr;
+		}
+		serialports[port_idx] = port.release();
+
+		// 115200 baud, 8N1, with DTR and RTS on and the FIFOs enabled
+		auto serial = serialports[port_idx];
+		serial->Write_LCR(LCR_DIVISOR_Enable_MASK);
+		serial->Write_THR(1);
+		serial->Write_IER(0);
+		serial->Write_LCR(LCR_DATABITS_8);
+		serial->Write_FCR(0x07);
+		serial->Write_MCR(MCR_DTR_MASK | MCR_RTS_MASK);
+		return serial;
+	}
+
+	// Runs the PIC events of an emulated millisecond, giving the host
+	// sockets the time the millisecond takes
+	static void RunMillisecond(const std::function<void()>& between_events = {})
+	{
+		std::this_thread::sleep_for(1ms);
+		TIMER_AddTick();
+		while (PIC_RunQueue()) {
+			// The cycles up to the next event are used up right away
+			CPU_Cycles = 0;
+			if (between_events) {
+				between_events();
+			}
+		}
+	}
+
+	static bool RunUntil(const std::function<bool()>& condition,
+	                     const std::function<void()>& between_events = {})
+	{
+		const auto deadline = std::chrono::steady_clock::now() + Timeout;
+		while (!condition()) {
+			if (std::chrono::steady_clock::now() > deadline) {
+				return false;
+			}
+			RunMillisecond(between_events);
+		}
+		return true;
+	}
+
+	// Reading the line status clears its error bits, so they're collected
+	// in line_errors
+	static void ReceiveAll(CSerial& port, std::vector<uint8_t>& received,
+	                       uint32_t& line_errors)
+	{
+		auto line_status = port.Read_LSR();
+		while (line_status & LSR_RX_DATA_READY_MASK) {
+			line_errors |= line_status & LSR_ERROR_MASK;
+			received.push_back(static_cast<uint8_t>(port.Read_RHR()));
+			line_status = port.Read_LSR();
+		}
+		line_errors |= line_status & LSR_ERROR_MASK;
+	}
+
+	// Fills the transmit FIFO once it has run empty
+	static void TransmitSome(CSerial& port, std::deque<uint8_t>& pending)
+	{
+		if (!(port.Read_LSR() & LSR_TX_HOLDING_EMPTY_MASK)) {
+			return;
+		}
+		constexpr auto FifoSize = 16;
+		for (auto i = 0; i < FifoSize && !pending.empty(); ++i) {
+			port.Write_THR(pending.front());
+			pending.pop_front();
+		}
+	}
+};
+
+TEST_F(NullModemTest, TransfersBytesExactlyAt115200Baud)
+{
+	const auto tcp_port = find_free_port();
+	const auto options  = "port:" + std::to_string(tcp_port);
+
+	auto server = OpenPort(FirstPort, options);
+	ASSERT_NE(server, nullptr);
+	auto client = OpenPort(SecondPort, "server:127.0.0.1 " + options);
+	ASSERT_NE(client, nullptr);
+
+	// Until the server has accepted the connection and received the
+	// client's line state
+	ASSERT_TRUE(RunUntil([&] { return server->getCTS() && server->getDSR(); }));
+
+	// Every byte value, including the 0xff escape char, several times
+	std::vector<uint8_t> sent = {};
+	for (auto i = 0; i < 4096; ++i) {
+		sent.push_back(static_cast<uint8_t>(i * 7 + i / 256));
+	}
+
+	std::deque<uint8_t> to_client(sent.begin(), sent.end());
+	std::deque<uint8_t> to_server = {};
+
+	std::vector<uint8_t> received_by_client = {};
+	std::vector<uint8_t> received_by_server = {};
+
+	uint32_t client_errors = 0;
+	uint32_t server_errors = 0;
+
+	// Both directions at once, the client sending back what it receives
+	const auto transfer = [&] {
+		TransmitSome(*server, to_client);
+
+		const auto num_received = received_by_client.size();
+		ReceiveAll(*client, received_by_client, client_errors);
+		to_server.insert(to_server.end(),
+		                 received_by_client.begin() + num_received,
+		                 received_by_client.end());
+		TransmitSome(*client, to_server);
+
+		ReceiveAll(*server, received_by_server, server_errors);
+	};
+	ASSERT_TRUE(RunUntil(
+	        [&] {
+		        return received_by_client.size() >= sent.size() &&
+		               received_by_server.size() >= sent.size();
+	        },
+	        transfer));
+
+	EXPECT_EQ(received_by_client, sent);
+	EXPECT_EQ(received_by_server, sent);
+	EXPECT_EQ(client_errors, 0u);
+	EXPECT_EQ(server_errors, 0u);
+
+	// The line states of the other side got through the escapes as well
+	EXPECT_TRUE(server->getCTS());
+	EXPECT_TRUE(server->getDSR());
+	EXPECT_TRUE(client->getCTS());
+	EXPECT_TRUE(client->getDSR());
+}
+
+// Connects a plain host socket to an emulated server port
+class RemotePeer {
+public:
+	explicit RemotePeer(const uint16_t tcp_port)
+	{
+		fd = socket(AF_INET, SOCK_STREAM, 0);
+
+		sockaddr_in address     = {};
+		address.sin_family      = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		address.sin_port        = htons(tcp_port);
+		is_connected = connect(fd,
+		                       reinterpret_cast<sockaddr*>(&address),
+		                       sizeof(address)) == 0;
+	}
+
+	~RemotePeer()
+	{
+		close(fd);
+	}
+
+	void Send(const std::vector<uint8_t>& bytes) const
+	{
+		send(fd, bytes.data(), bytes.size(), 0);
+	}
+
+	// Returns how many bytes the emulated port has sent so far
+	size_t Receive()
+	{
+		std::array<uint8_t, 256> buffer = {};
+
+		const auto len = recv(fd, buffer.data(), buffer.size(), MSG_DONTWAIT);
+		if (len > 0) {
+			num_received += static_cast<size_t>(len);
+		}
+		return num_received;
+	}
+
+	bool is_connected = false;
+
+private:
+	int fd              = -1;
+	size_t num_received = 0;
+};
+
+TEST_F(NullModemTest, EscapeSequenceSplitAcrossReads)
+{
+	const auto tcp_port = find_free_port();
+
+	auto port = OpenPort(FirstPort, "port:" + std::to_string(tcp_port));
+	ASSERT_NE(port, nullptr);
+
+	RemotePeer peer(tcp_port);
+	ASSERT_TRUE(peer.is_connected);
+
+	// The port sends its line state once it has accepted the connection
+	ASSERT_TRUE(RunUntil([&] { return peer.Receive() >= 2; }));
+
+	std::vector<uint8_t> received = {};
+	uint32_t line_errors          = 0;
+
+	// Each part is read on its own, with emulated time passing in between
+	const auto send_split = [&](const std::vector<std::vector<uint8_t>>& parts) {
+		for (const auto& part : parts) {
+			peer.Send(part);
+			for (auto ms = 0; ms < 20; ++ms) {
+				RunMillisecond([&] { ReceiveAll(*port, received, line_errors); });
+			}
+		}
+	};
+
+	// Line state changes to CTS and DSR on, then off again
+	send_split({{'a', 0xff}, {0x03, 'b'}});
+	EXPECT_TRUE(port->getCTS());
+	EXPECT_TRUE(port->getDSR());
+
+	send_split({{0xff}, {0x00}, {'c'}});
+	EXPECT_FALSE(port->getCTS());
+	EXPECT_FALSE(port->getDSR());
+
+	// An escaped 0xff data byte
+	send_split({{0xff}, {0xff, 'd'}});
+
+	// A break
+	send_split({{0xff}, {0x04, 'e'}});
+
+	const std::vector<uint8_t> expected = {'a', 'b', 'c', 0xff, 'd', 0x00, 'e'};
+	EXPECT_EQ(received, expected);
+	EXPECT_EQ(line_errors, static_cast<uint32_t>(LSR_RX_BREAK_MASK));
+}
+
+TEST_F(NullModemTest, TelnetCommandSplitAcrossReads)
+{
+	const auto tcp_port = find_free_port();
+
+	auto port = OpenPort(FirstPort,
+	                     "port:" + std::to_string(tcp_port) + " telnet:1");
+	ASSERT_NE(port, nullptr);
+
+	RemotePeer peer(tcp_port);
+	ASSERT_TRUE(peer.is_connected);
+	ASSERT_TRUE(RunUntil([&] { return port->getCD(); }));
+
+	std::vector<uint8_t> received = {};
+	uint32_t line_errors          = 0;
+
+	// IAC WILL ECHO, IAC GA and IAC WILL BINARY, each split in two
+	for (const auto& part : std::vector<std::vector<uint8_t>>{{'a', 0xff},
+	                                                          {251, 1, 'b'},
+	                                                          {0xff},
+	                                                          {249, 'c', 0xff, 251},
+	                                                          {0, 'd'}}) {
+		peer.Send(part);
+		for (auto ms = 0; ms < 20; ++ms) {
+			RunMillisecond([&] { ReceiveAll(*port, received, line_errors); });
+		}
+	}
+
+	const std::vector<uint8_t> expected = {'a', 'b', 'c', 'd'};
+	EXPECT_EQ(received, expected);
+	EXPECT_EQ(line_errors, 0u);
+}
+
+} // namespace
+
+#endif // C_MODEM && !WIN32
@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "cpu/paging.h"
+
+#include <gtest/gtest.h>
+
+#include "cpu/cpu.h"
+#include "hardware/memory.h"
+
+#include "dosbox_test_fixture.h"
+
+namespace {
+
+// A page directory and one page table in conventional memory
+constexpr PhysPt DirectoryBase = 0x80000;
+constexpr PhysPt TableBase     = 0x81000;
+
+// Present, writable, user
+constexpr uint32_t EntryFlags = 0x007;
+
+// The PS bit of a page directory entry
+constexpr uint32_t LargePage = 0x080;
+
+class PagingTest : public DOSBoxTestFixture {
+protected:
+	void SetUp() override
+	{
+		DOSBoxTestFixture::SetUp();
+
+		for (PhysPt addr = DirectoryBase; addr < TableBase + 4096; addr += 4) {
+			phys_writed(addr, 0);
+		}
+
+		// Linear 0x00000000-0x003fffff through the page table, with
+		// linear page 5 mapped to frame 0x123
+		phys_writed(DirectoryBase, TableBase | EntryFlags);
+		phys_writed(TableBase + 5 * 4, 0x00123000 | EntryFlags);
+
+		// Linear 0x00400000-0x007fffff as a read-only 4 MiB page at
+		// physical 0x00c00000
+		phys_writed(DirectoryBase + 1 * 4, 0x00c00000 | LargePage | 0x005);
+
+		PAGING_SetDirBase(DirectoryBase);
+	}
+
+	void TearDown() override
+	{
+		PAGING_SetCR4(0);
+		PAGING_SetDirBase(0);
+		DOSBoxTestFixture::TearDown();
+	}
+};
+
+TEST_F(PagingTest, SmallPage)
+{
+	PAGING_SetCR4(CR4_PSE);
+
+	X86PageEntry table = {};
+	X86PageEntry entry = {};
+	ASSERT_TRUE(PAGING_GetPageEntries(5, table, entry));
+	EXPECT_TRUE(entry.p);
+	EXPECT_EQ(entry.base, 0x123u);
+
+	// Present table, absent page
+	ASSERT_TRUE(PAGING_GetPageEntries(6, table, entry));
+	EXPECT_FALSE(entry.p);
+
+	// Absent table
+	EXPECT_FALSE(PAGING_GetPageEntries(2 << 10, table, entry));
+}
+
+TEST_F(PagingTest, LargePage)
+{
+	PAGING_SetCR4(CR4_PSE);
+
+	X86PageEntry table = {};
+	X86PageEntry entry = {};
+
+	for (const uint32_t offset : {0u, 1u, 0x155u, 0x3ffu}) {
+		const auto lin_page = (1u << 10) + offset;
+		ASSERT_TRUE(PAGING_GetPageEntries(lin_page, table, entry));
+
+		// The frame is picked from within the large page, and the
+		// flags are the directory entry's
+		EXPECT_TRUE(entry.p);
+		EXPECT_EQ(entry.base, 0xc00u + offset);
+		EXPECT_FALSE(entry.wr);
+		EXPECT_TRUE(entry.us);
+	}
+}
+
+TEST_F(PagingTest, LargePageBitIgnoredWithoutPse)
+{
+	// Without CR4.PSE the PS bit means nothing, so the directory entry's
+	// frame is read as a page table
+	PAGING_SetCR4(0);
+
+	constexpr PhysPt BogusTable = 0x00c00000;
+	phys_writed(BogusTable + 7 * 4, 0x00456000 | EntryFlags);
+
+	X86PageEntry table = {};
+	X86PageEntry entry = {};
+	ASSERT_TRUE(PAGING_GetPageEntries((1u << 10) + 7, table, entry));
+	EXPECT_TRUE(entry.p);
+	EXPECT_EQ(entry.base, 0x456u);
+
+	phys_writed(BogusTable + 7 * 4, 0);
+}
+
+} // namespace
@@ -0,0 +1,219 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "capture/image/png_writer.h"
+
+#include <cstdio>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <png.h>
+
+namespace {
+
+struct DecodedPng {
+	uint32_t width  = 0;
+	uint32_t height = 0;
+	int color_type  = 0;
+
+	std::vector<png_color> palette = {};
+	std::vector<uint8_t> pixels    = {};
+};
+
+// Half of the rows are smooth gradients and half are noise, so the filter
+// selection and the compression both get some variety
+std::vector<uint8_t> make_image(const uint16_t width, const uint16_t height,
+                                const uint8_t bytes_per_pixel)
+{
+	std::vector<uint8_t> image(static_cast<size_t>(width) * height * bytes_per_pixel);
+
+	uint32_t noise = 0x12345678;
+	auto it        = image.begin();
+
+	for (auto y = 0; y < height; ++y) {
+		for (auto x = 0; x < width * bytes_per_pixel; ++x) {
+			if ((y / 16) % 2 == 0) {
+				*it++ = static_cast<uint8_t>(x + y * 3);
+			} else {
+				noise ^= noise << 13;
+				noise ^= noise >> 17;
+				noise ^= noise << 5;
+				*it++ = static_cast<uint8_t>(noise);
+			}
+		}
+	}
+	return image;
+}
+
+std::vector<uint8_t> make_palette()
+{
+	std::vector<uint8_t> palette(256 * 4);
+	for (size_t i = 0; i < 256; ++i) {
+		palette[i * 4 + 0] = static_cast<uint8_t>(i);
+		palette[i * 4 + 1] = static_cast<uint8_t>(255 - i);
+		palette[i * 4 + 2] = static_cast<uint8_t>(i * 7);
+	}
+	return palette;
+}
+
+DecodedPng decode_png(FILE* fp)
+{
+	DecodedPng decoded = {};
+
+	rewind(fp);
+
+	auto png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING,
+	                                      nullptr,
+	                                      nullptr,
+	                                      nullptr);
+	auto info_ptr = png_create_info_struct(png_ptr);
+
+	if (setjmp(png_jmpbuf(png_ptr))) {
+		png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
+		ADD_FAILURE() << "libpng couldn't decode the image";
+		return {};
+	}
+
+	png_init_io(png_ptr, fp);
+	png_read_png(png_ptr, info_ptr, PNG_TRANSFORM_IDENTITY, nullptr);
+
+	decoded.width      = png_get_image_width(png_ptr, info_ptr);
+	decoded.height     = png_get_image_height(png_ptr, info_ptr);
+	decoded.color_type = png_get_color_type(png_ptr, info_ptr);
+
+	png_colorp palette = nullptr;
+	int num_palette    = 0;
+	if (png_get_PLTE(png_ptr, info_ptr, &palette, &num_palette)) {
+		decoded.palette.assign(palette, palette + num_palette);
+	}
+
+	const auto row_bytes = png_get_rowbytes(png_ptr, info_ptr);
+	const auto rows      = png_get_rows(png_ptr, info_ptr);
+	for (uint32_t y = 0; y < decoded.height; ++y) {
+		decoded.pixels.insert(decoded.pixels.end(), rows[y], rows[y] + row_bytes);
+	}
+
+	png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
+	return decoded;
+}
+
+DecodedPng round_trip_rgb(const std::vector<uint8_t>& image, const uint16_t width,
+                          const uint16_t height, const int compression_level)
+{
+	const auto fp = tmpfile();
+	EXPECT_NE(fp, nullptr);
+
+	VideoMode video_mode          = {};
+	video_mode.pixel_aspect_ratio = Fraction(1);
+	{
+		PngWriter writer(compression_level);
+		EXPECT_TRUE(writer.InitRgb888(fp, width, height, Fraction(1), video_mode));
+
+		const auto row_size = static_cast<size_t>(width) * 3;
+		for (size_t y = 0; y < height; ++y) {
+			writer.WriteRow(image.begin() + y * row_size);
+		}
+	}
+
+	const auto decoded = decode_png(fp);
+	fclose(fp);
+	return decoded;
+}
+
+// Large enough to be deflated in several stripes
+TEST(PngWriter, RoundTripsMultipleStripes)
+{
+	constexpr uint16_t Width  = 640;
+	constexpr uint16_t Height = 480;
+
+	const auto image   = make_image(Width, Height, 3);
+	const auto decoded = round_trip_rgb(image, Width, Height, Z_DEFAULT_COMPRESSION);
+
+	EXPECT_EQ(decoded.width, Width);
+	EXPECT_EQ(decoded.height, Height);
+	EXPECT_EQ(decoded.color_type, PNG_COLOR_TYPE_RGB);
+	EXPECT_TRUE(decoded.pixels == image);
+}
+
+TEST(PngWriter, RoundTripsWithoutCompression)
+{
+	constexpr uint16_t Width  = 640;
+	constexpr uint16_t Height = 480;
+
+	const auto image   = make_image(Width, Height, 3);
+	const auto decoded = round_trip_rgb(image, Width, Height, Z_NO_COMPRESSION);
+
+	EXPECT_EQ(decoded.width, Width);
+	EXPECT_EQ(decoded.height, Height);
+	EXPECT_TRUE(decoded.pixels == image);
+}
+
+// The rows don't divide evenly between the stripes
+TEST(PngWriter, RoundTripsUnevenStripes)
+{
+	constexpr uint16_t Width  = 331;
+	constexpr uint16_t Height = 509;
+
+	for (const auto level : {Z_NO_COMPRESSION, Z_BEST_SPEED, Z_BEST_COMPRESSION}) {
+		const auto image   = make_image(Width, Height, 3);
+		const auto decoded = round_trip_rgb(image, Width, Height, level);
+
+		EXPECT_EQ(decoded.width, Width);
+		EXPECT_EQ(decoded.height, Height);
+		EXPECT_TRUE(decoded.pixels == image) << "Compression level " << level;
+	}
+}
+
+TEST(PngWriter, RoundTripsSingleStripe)
+{
+	constexpr uint16_t Width  = 7;
+	constexpr uint16_t Height = 3;
+
+	const auto image   = make_image(Width, Height, 3);
+	const auto decoded = round_trip_rgb(image, Width, Height, Z_DEFAULT_COMPRESSION);
+
+	EXPECT_EQ(decoded.width, Width);
+	EXPECT_EQ(decoded.height, Height);
+	EXPECT_TRUE(decoded.pixels == image);
+}
+
+TEST(PngWriter, RoundTripsIndexed)
+{
+	constexpr uint16_t Width  = 720;
+	constexpr uint16_t Height = 400;
+
+	const auto image   = make_image(Width, Height, 1);
+	const auto palette = make_palette();
+
+	const auto fp = tmpfile();
+	ASSERT_NE(fp, nullptr);
+
+	VideoMode video_mode          = {};
+	video_mode.pixel_aspect_ratio = Fraction(1);
+	{
+		PngWriter writer(Z_DEFAULT_COMPRESSION);
+		ASSERT_TRUE(writer.InitIndexed8(
+		        fp, Width, Height, Fraction(1), video_mode, palette.data()));
+
+		for (size_t y = 0; y < Height; ++y) {
+			writer.WriteRow(image.begin() + y * Width);
+		}
+	}
+
+	const auto decoded = decode_png(fp);
+	fclose(fp);
+
+	EXPECT_EQ(decoded.width, Width);
+	EXPECT_EQ(decoded.height, Height);
+	EXPECT_EQ(decoded.color_type, PNG_COLOR_TYPE_PALETTE);
+	EXPECT_TRUE(decoded.pixels == image);
+
+	ASSERT_EQ(decoded.palette.size(), 256);
+	for (size_t i = 0; i < 256; ++i) {
+		EXPECT_EQ(decoded.palette[i].red, palette[i * 4 + 0]);
+		EXPECT_EQ(decoded.palette[i].green, palette[i * 4 + 1]);
+		EXPECT_EQ(decoded.palette[i].blue, palette[i * 4 + 2]);
+	}
+}
+
+} // namespace
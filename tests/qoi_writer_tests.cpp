@@ -0,0 +1,251 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "capture/image/qoi_writer.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+struct DecodedQoi {
+	uint32_t width       = 0;
+	uint32_t height      = 0;
+	uint8_t num_channels = 0;
+
+	// RGB888 pixels
+	std::vector<uint8_t> pixels = {};
+};
+
+std::vector<uint8_t> read_file(FILE* fp)
+{
+	std::vector<uint8_t> data = {};
+
+	rewind(fp);
+	for (int c = fgetc(fp); c != EOF; c = fgetc(fp)) {
+		data.push_back(static_cast<uint8_t>(c));
+	}
+	return data;
+}
+
+// A straightforward decoder following the specification
+DecodedQoi decode_qoi(const std::vector<uint8_t>& data)
+{
+	constexpr size_t HeaderSize = 14;
+	constexpr std::array<uint8_t, 8> EndMarker = {0, 0, 0, 0, 0, 0, 0, 1};
+
+	if (data.size() < HeaderSize + EndMarker.size() ||
+	    data[0] != 'q' || data[1] != 'o' || data[2] != 'i' || data[3] != 'f') {
+		ADD_FAILURE() << "Not a QOI file";
+		return {};
+	}
+
+	auto read_u32_be = [&](const size_t pos) {
+		return static_cast<uint32_t>(data[pos] << 24 | data[pos + 1] << 16 |
+		                             data[pos + 2] << 8 | data[pos + 3]);
+	};
+
+	DecodedQoi decoded   = {};
+	decoded.width        = read_u32_be(4);
+	decoded.height       = read_u32_be(8);
+	decoded.num_channels = data[12];
+
+	struct Rgba {
+		uint8_t r, g, b, a;
+	};
+	std::array<Rgba, 64> index = {};
+	Rgba pixel                 = {0, 0, 0, 255};
+
+	const auto num_pixels = static_cast<size_t>(decoded.width) * decoded.height;
+	const auto data_end   = data.size() - EndMarker.size();
+
+	size_t pos = HeaderSize;
+	int run    = 0;
+
+	for (size_t i = 0; i < num_pixels; ++i) {
+		if (run > 0) {
+			--run;
+		} else if (pos < data_end) {
+			const auto op = data[pos++];
+
+			if (op == 0xfe) {
+				pixel.r = data[pos++];
+				pixel.g = data[pos++];
+				pixel.b = data[pos++];
+			} else if (op == 0xff) {
+				pixel = {data[pos], data[pos + 1], data[pos + 2], data[pos + 3]};
+				pos += 4;
+			} else if ((op & 0xc0) == 0x00) {
+				pixel = index[op];
+			} else if ((op & 0xc0) == 0x40) {
+				pixel.r = static_cast<uint8_t>(pixel.r + ((op >> 4) & 3) - 2);
+				pixel.g = static_cast<uint8_t>(pixel.g + ((op >> 2) & 3) - 2);
+				pixel.b = static_cast<uint8_t>(pixel.b + (op & 3) - 2);
+			} else if ((op & 0xc0) == 0x80) {
+				const auto next = data[pos++];
+				const auto dg   = (op & 0x3f) - 32;
+				pixel.r = static_cast<uint8_t>(pixel.r + dg - 8 + (next >> 4));
+				pixel.g = static_cast<uint8_t>(pixel.g + dg);
+				pixel.b = static_cast<uint8_t>(pixel.b + dg - 8 + (next & 0xf));
+			} else {
+				run = op & 0x3f;
+			}
+			const auto hash = (pixel.r * 3 + pixel.g * 5 + pixel.b * 7 +
+			                   pixel.a * 11) % 64;
+			index[hash] = pixel;
+		} else {
+			ADD_FAILURE() << "Image data ends early";
+			return {};
+		}
+		decoded.pixels.insert(decoded.pixels.end(), {pixel.r, pixel.g, pixel.b});
+	}
+
+	EXPECT_EQ(pos, data_end) << "Unused image data";
+	EXPECT_TRUE(std::equal(EndMarker.begin(), EndMarker.end(), data.begin() + data_end));
+
+	return decoded;
+}
+
+// Covers all the opcodes: runs (including ones longer than a single run
+// opcode can hold), repeats of earlier colours, small and large differences
+std::vector<uint8_t> make_image(const uint16_t width, const uint16_t height)
+{
+	std::vector<uint8_t> image = {};
+	image.reserve(static_cast<size_t>(width) * height * 3);
+
+	uint32_t noise = 0x2468ace0;
+
+	for (auto y = 0; y < height; ++y) {
+		for (auto x = 0; x < width; ++x) {
+			uint8_t r = 0, g = 0, b = 0;
+			switch (y % 4) {
+			case 0: // runs
+				r = g = b = static_cast<uint8_t>(x / 100);
+				break;
+			case 1: // small differences
+				r = static_cast<uint8_t>(x);
+				g = static_cast<uint8_t>(x * 2);
+				b = static_cast<uint8_t>(x + y);
+				break;
+			case 2: // a few repeating colours
+				r = static_cast<uint8_t>((x % 5) * 50);
+				g = static_cast<uint8_t>((x % 3) * 80);
+				b = 200;
+				break;
+			default: // noise
+				noise ^= noise << 13;
+				noise ^= noise >> 17;
+				noise ^= noise << 5;
+				r = static_cast<uint8_t>(noise);
+				g = static_cast<uint8_t>(noise >> 8);
+				b = static_cast<uint8_t>(noise >> 16);
+				break;
+			}
+			image.insert(image.end(), {r, g, b});
+		}
+	}
+	return image;
+}
+
+TEST(QoiWriter, RoundTripsRgb)
+{
+	constexpr uint16_t Width  = 321;
+	constexpr uint16_t Height = 203;
+
+	const auto image = make_image(Width, Height);
+
+	const auto fp = tmpfile();
+	ASSERT_NE(fp, nullptr);
+	{
+		QoiWriter writer = {};
+		ASSERT_TRUE(writer.InitRgb888(fp, Width, Height, Fraction(1), VideoMode{}));
+
+		const auto row_size = static_cast<size_t>(Width) * 3;
+		for (size_t y = 0; y < Height; ++y) {
+			writer.WriteRow(image.begin() + y * row_size);
+		}
+	}
+	const auto decoded = decode_qoi(read_file(fp));
+	fclose(fp);
+
+	EXPECT_EQ(decoded.width, Width);
+	EXPECT_EQ(decoded.height, Height);
+	EXPECT_EQ(decoded.num_channels, 3);
+	EXPECT_TRUE(decoded.pixels == image);
+}
+
+// Paletted images are written as RGB888
+TEST(QoiWriter, RoundTripsIndexed)
+{
+	constexpr uint16_t Width  = 320;
+	constexpr uint16_t Height = 200;
+
+	std::vector<uint8_t> palette(256 * 4);
+	for (size_t i = 0; i < 256; ++i) {
+		palette[i * 4 + 0] = static_cast<uint8_t>(i);
+		palette[i * 4 + 1] = static_cast<uint8_t>(i * 3);
+		palette[i * 4 + 2] = static_cast<uint8_t>(255 - i);
+	}
+
+	std::vector<uint8_t> image    = {};
+	std::vector<uint8_t> expected = {};
+	for (auto y = 0; y < Height; ++y) {
+		for (auto x = 0; x < Width; ++x) {
+			const auto index = static_cast<uint8_t>((y % 2) ? x * 7 + y : x / 64);
+			image.push_back(index);
+			expected.insert(expected.end(),
+			                {palette[index * 4 + 0],
+			                 palette[index * 4 + 1],
+			                 palette[index * 4 + 2]});
+		}
+	}
+
+	const auto fp = tmpfile();
+	ASSERT_NE(fp, nullptr);
+	{
+		QoiWriter writer = {};
+		ASSERT_TRUE(writer.InitIndexed8(
+		        fp, Width, Height, Fraction(1), VideoMode{}, palette.data()));
+
+		for (size_t y = 0; y < Height; ++y) {
+			writer.WriteRow(image.begin() + y * Width);
+		}
+	}
+	const auto decoded = decode_qoi(read_file(fp));
+	fclose(fp);
+
+	EXPECT_EQ(decoded.width, Width);
+	EXPECT_EQ(decoded.height, Height);
+	EXPECT_TRUE(decoded.pixels == expected);
+}
+
+// A black image starts with a run of the decoder's initial pixel, which
+// mustn't be encoded as a reference to the empty colour index
+TEST(QoiWriter, RoundTripsBlack)
+{
+	constexpr uint16_t Width  = 100;
+	constexpr uint16_t Height = 10;
+
+	const std::vector<uint8_t> image(Width * Height * 3, 0);
+
+	const auto fp = tmpfile();
+	ASSERT_NE(fp, nullptr);
+	{
+		QoiWriter writer = {};
+		ASSERT_TRUE(writer.InitRgb888(fp, Width, Height, Fraction(1), VideoMode{}));
+
+		for (size_t y = 0; y < Height; ++y) {
+			writer.WriteRow(image.begin() + y * Width * 3);
+		}
+	}
+	const auto decoded = decode_qoi(read_file(fp));
+	fclose(fp);
+
+	EXPECT_TRUE(decoded.pixels == image);
+}
+
+} // namespace
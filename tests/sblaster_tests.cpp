@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "hardware/audio/sblaster.cpp"
+
+#include <algorithm>
+#include <array>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+// Full-scale samples, so none of them convert to silence. These are 16-bit
+// as the 8-bit lookup tables are only filled in when the mixer starts.
+constexpr std::array<int16_t, 8> LoudSamples = {
+        INT16_MAX, INT16_MIN, INT16_MAX, INT16_MIN,
+        INT16_MAX, INT16_MIN, INT16_MAX, INT16_MIN};
+
+// The ADPCM decoders produce this many samples per DMA byte
+constexpr uint32_t SamplesPerDmaByte = 2;
+
+size_t count_silent_frames(const std::vector<AudioFrame>& frames)
+{
+	return std::count_if(frames.begin(), frames.end(), [](const AudioFrame& f) {
+		return f.left == 0.0f && f.right == 0.0f;
+	});
+}
+
+class SblasterTest : public ::testing::Test {
+protected:
+	void SetUp() override
+	{
+		sb = {};
+	}
+
+	void TearDown() override
+	{
+		sb = {};
+	}
+
+	static std::vector<AudioFrame>& Convert(const uint32_t frames_per_warmup_step = 0)
+	{
+		return maybe_silence<FrameType::Mono>(LoudSamples.data(),
+		                                      LoudSamples.size(),
+		                                      frames_per_warmup_step);
+	}
+};
+
+TEST_F(SblasterTest, PlaysWithTheSpeakerOn)
+{
+	sb.speaker_enabled = true;
+
+	EXPECT_EQ(count_silent_frames(Convert()), 0);
+	EXPECT_EQ(count_silent_frames(Convert(SamplesPerDmaByte)), 0);
+}
+
+TEST_F(SblasterTest, SilentWithTheSpeakerOff)
+{
+	sb.speaker_enabled = false;
+
+	EXPECT_EQ(count_silent_frames(Convert()), LoudSamples.size());
+	EXPECT_EQ(count_silent_frames(Convert(SamplesPerDmaByte)),
+	          LoudSamples.size());
+}
+
+TEST_F(SblasterTest, WarmupSilencesTheWholeRun)
+{
+	sb.speaker_enabled         = true;
+	sb.dsp.warmup_remaining_ms = 2;
+
+	EXPECT_EQ(count_silent_frames(Convert()), LoudSamples.size());
+	EXPECT_EQ(sb.dsp.warmup_remaining_ms, 1);
+}
+
+TEST_F(SblasterTest, WarmupEndsPartWayThroughBatchedRun)
+{
+	sb.speaker_enabled         = true;
+	sb.dsp.warmup_remaining_ms = 1;
+
+	const auto& frames = Convert(SamplesPerDmaByte);
+	EXPECT_EQ(count_silent_frames(frames), SamplesPerDmaByte);
+	EXPECT_EQ(frames[SamplesPerDmaByte - 1].left, 0.0f);
+	EXPECT_NE(frames[SamplesPerDmaByte].left, 0.0f);
+	EXPECT_EQ(sb.dsp.warmup_remaining_ms, 0);
+}
+
+TEST_F(SblasterTest, SpeakerOffSilencesBatchedRunPastTheWarmup)
+{
+	sb.speaker_enabled         = false;
+	sb.dsp.warmup_remaining_ms = 1;
+
+	EXPECT_EQ(count_silent_frames(Convert(SamplesPerDmaByte)),
+	          LoudSamples.size());
+	EXPECT_EQ(sb.dsp.warmup_remaining_ms, 0);
+}
+
+} // namespace
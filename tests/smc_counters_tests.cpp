@@ -0,0 +1,161 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "cpu/smc_counters.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <vector>
+
+namespace {
+
+constexpr size_t PageSize = 4096;
+
+using counters_t = std::array<uint8_t, PageSize>;
+
+TEST(SmcCounters, CountWrite)
+{
+	counters_t counters = {};
+
+	smc_count_write(counters.data(), 10, 1);
+	smc_count_write(counters.data(), 10, 2);
+	smc_count_write(counters.data(), 9, 4);
+
+	EXPECT_EQ(counters[8], 0);
+	EXPECT_EQ(counters[9], 1);
+	EXPECT_EQ(counters[10], 3);
+	EXPECT_EQ(counters[11], 2);
+	EXPECT_EQ(counters[12], 1);
+	EXPECT_EQ(counters[13], 0);
+}
+
+TEST(SmcCounters, CountWriteSaturates)
+{
+	counters_t counters = {};
+
+	for (auto i = 0; i < 300; ++i) {
+		smc_count_write(counters.data(), 100, 2);
+	}
+
+	// The counters don't wrap around or carry into their neighbours
+	EXPECT_EQ(counters[100], UINT8_MAX);
+	EXPECT_EQ(counters[101], UINT8_MAX);
+	EXPECT_EQ(counters[102], 0);
+	EXPECT_TRUE(smc_is_hot(counters.data(), 100));
+}
+
+TEST(SmcCounters, IsHot)
+{
+	counters_t counters = {};
+
+	EXPECT_FALSE(smc_is_hot(nullptr, 0));
+
+	for (auto i = 1; i < SmcFallbackThreshold; ++i) {
+		smc_count_write(counters.data(), 0, 1);
+		EXPECT_FALSE(smc_is_hot(counters.data(), 0));
+	}
+	smc_count_write(counters.data(), 0, 1);
+	EXPECT_TRUE(smc_is_hot(counters.data(), 0));
+}
+
+TEST(SmcCounters, DecayHalvesPerInterval)
+{
+	counters_t counters = {};
+	counters[0]         = 64;
+	counters[1]         = 1;
+
+	uint32_t last_decay_ms = 0;
+	auto no_op             = [](size_t) {};
+
+	// Not a full interval yet
+	smc_decay(counters.data(), PageSize, last_decay_ms, SmcDecayIntervalMs - 1, no_op);
+	EXPECT_EQ(counters[0], 64);
+	EXPECT_EQ(last_decay_ms, 0);
+
+	smc_decay(counters.data(), PageSize, last_decay_ms, SmcDecayIntervalMs, no_op);
+	EXPECT_EQ(counters[0], 32);
+	EXPECT_EQ(counters[1], 0);
+	EXPECT_EQ(last_decay_ms, SmcDecayIntervalMs);
+
+	// Multiple intervals at once, the remainder is kept
+	smc_decay(counters.data(), PageSize, last_decay_ms, SmcDecayIntervalMs * 4 + 1, no_op);
+	EXPECT_EQ(counters[0], 4);
+	EXPECT_EQ(last_decay_ms, SmcDecayIntervalMs * 4);
+}
+
+TEST(SmcCounters, DecayClearsAfterLongIdle)
+{
+	counters_t counters = {};
+	counters[7]         = UINT8_MAX;
+
+	uint32_t last_decay_ms = 0;
+	smc_decay(counters.data(), PageSize, last_decay_ms, 100000, [](size_t) {});
+
+	EXPECT_EQ(counters[7], 0);
+}
+
+TEST(SmcCounters, DecayReportsCooledDownCounters)
+{
+	counters_t counters = {};
+	counters[1]         = SmcFallbackThreshold;
+	counters[2]         = SmcFallbackThreshold * 2;
+	counters[3]         = SmcFallbackThreshold - 1;
+
+	std::vector<size_t> cooled_down = {};
+	uint32_t last_decay_ms          = 0;
+
+	smc_decay(counters.data(),
+	          PageSize,
+	          last_decay_ms,
+	          SmcDecayIntervalMs,
+	          [&](const size_t index) { cooled_down.push_back(index); });
+
+	// Only counters crossing the threshold are reported
+	const std::vector<size_t> expected = {1};
+	EXPECT_EQ(cooled_down, expected);
+}
+
+// A synthetic self-patching loop: an inner loop instruction is executed
+// ExecutionsPerMs times every emulated millisecond, and its opcode byte is
+// patched once per millisecond during the first PatchingMs. Returns the
+// number of executions that fall back to the normal core.
+int run_self_patching_loop(const bool use_decay)
+{
+	constexpr size_t Index         = 0x123;
+	constexpr auto ExecutionsPerMs = 1000;
+	constexpr uint32_t PatchingMs  = 20;
+	constexpr uint32_t TotalMs     = 1000;
+
+	counters_t counters    = {};
+	uint32_t last_decay_ms = 0;
+
+	auto fallbacks = 0;
+	for (uint32_t now_ms = 0; now_ms < TotalMs; ++now_ms) {
+		if (now_ms < PatchingMs) {
+			smc_count_write(counters.data(), Index, 1);
+		}
+		if (use_decay) {
+			smc_decay(counters.data(), PageSize, last_decay_ms, now_ms, [](size_t) {});
+		}
+		if (smc_is_hot(counters.data(), Index)) {
+			fallbacks += ExecutionsPerMs;
+		}
+	}
+	return fallbacks;
+}
+
+TEST(SmcCounters, SelfPatchingLoopRecovers)
+{
+	const auto fallbacks_without_decay = run_self_patching_loop(false);
+	const auto fallbacks_with_decay    = run_self_patching_loop(true);
+
+	// Without decaying, the instruction stays in the normal core for the
+	// rest of the run after the fourth patch
+	EXPECT_EQ(fallbacks_without_decay, (1000 - (SmcFallbackThreshold - 1)) * 1000);
+
+	// With decaying, it's translated again shortly after the patching stops
+	EXPECT_LT(fallbacks_with_decay, 100 * 1000);
+}
+
+} // namespace
@@ -0,0 +1,210 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "hardware/socket_reactor.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#ifndef WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "dosbox_test_fixture.h"
+#include "hardware/timer.h"
+#include "misc/perf_counters.h"
+
+#ifndef WIN32
+
+namespace {
+
+using namespace std::chrono_literals;
+
+constexpr auto Timeout = 10s;
+
+// Stands in for the emulated millisecond between timer ticks
+constexpr auto TickInterval = 1ms;
+
+class SocketReactorTest : public DOSBoxTestFixture {};
+
+std::vector<uint8_t> make_pattern(const size_t size)
+{
+	std::vector<uint8_t> pattern(size);
+	for (size_t i = 0; i < size; ++i) {
+		pattern[i] = static_cast<uint8_t>(i * 7 + i / 256);
+	}
+	return pattern;
+}
+
+TEST_F(SocketReactorTest, StreamDeliversAllBytesInOrder)
+{
+	// More than the reactor queues per socket, so it has to pause reading
+	// until the emulation thread catches up
+	constexpr size_t NumBytes = 512 * 1024;
+
+	int fds[2] = {-1, -1};
+	ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+	const auto sent = make_pattern(NumBytes);
+	std::vector<uint8_t> received = {};
+
+	auto num_callbacks = 0;
+	auto is_closed     = false;
+	{
+		ReactorSocket socket(fds[0], ReactorSocketType::Stream, [&] {
+			++num_callbacks;
+		});
+		ASSERT_TRUE(socket.IsWatched());
+
+		std::thread writer([&] {
+			size_t pos = 0;
+			while (pos < sent.size()) {
+				const auto len = write(fds[1],
+				                       sent.data() + pos,
+				                       sent.size() - pos);
+				if (len <= 0) {
+					break;
+				}
+				pos += static_cast<size_t>(len);
+			}
+			close(fds[1]);
+		});
+
+		std::array<uint8_t, 4096> buffer = {};
+
+		const auto deadline = std::chrono::steady_clock::now() + Timeout;
+		while (!socket.IsClosed() &&
+		       std::chrono::steady_clock::now() < deadline) {
+			std::this_thread::sleep_for(TickInterval);
+			TIMER_AddTick();
+
+			// Collect a few kilobytes per tick at most
+			const auto len = socket.ReceiveBytes(buffer.data(),
+			                                     buffer.size());
+			received.insert(received.end(),
+			                buffer.begin(),
+			                buffer.begin() + len);
+		}
+		writer.join();
+		is_closed = socket.IsClosed();
+	}
+	close(fds[0]);
+
+	EXPECT_TRUE(is_closed);
+	EXPECT_GT(num_callbacks, 0);
+	EXPECT_EQ(received, sent);
+}
+
+TEST_F(SocketReactorTest, IdleSocketsCostNoCallbacks)
+{
+	constexpr auto NumTicks = 200;
+
+	int fds[2] = {-1, -1};
+	ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+	auto num_callbacks = 0;
+	{
+		ReactorSocket socket(fds[0], ReactorSocketType::Stream, [&] {
+			++num_callbacks;
+		});
+		ASSERT_TRUE(socket.IsWatched());
+
+		const auto syscalls_before = perf_counters.socket_reactor_syscalls.load();
+		for (auto i = 0; i < NumTicks; ++i) {
+			std::this_thread::sleep_for(TickInterval);
+			TIMER_AddTick();
+		}
+		const auto syscalls = perf_counters.socket_reactor_syscalls.load() -
+		                      syscalls_before;
+
+		EXPECT_EQ(num_callbacks, 0);
+		EXPECT_LT(syscalls, static_cast<uint64_t>(NumTicks));
+	}
+	close(fds[0]);
+	close(fds[1]);
+}
+
+TEST_F(SocketReactorTest, DatagramsKeepTheirSender)
+{
+	constexpr auto NumPackets = 100;
+
+	auto make_udp_socket = [](uint16_t& port) {
+		const auto fd = socket(AF_INET, SOCK_DGRAM, 0);
+
+		sockaddr_in address     = {};
+		address.sin_family      = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		address.sin_port        = 0;
+		bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+
+		socklen_t size = sizeof(address);
+		getsockname(fd, reinterpret_cast<sockaddr*>(&address), &size);
+		port = address.sin_port;
+		return fd;
+	};
+
+	uint16_t receiver_port = 0;
+	uint16_t sender_port   = 0;
+
+	const auto receiver_fd = make_udp_socket(receiver_port);
+	const auto sender_fd   = make_udp_socket(sender_port);
+
+	auto num_callbacks = 0;
+	auto socket        = std::make_unique<ReactorSocket>(receiver_fd,
+                                                      ReactorSocketType::Datagram,
+                                                      [&] { ++num_callbacks; });
+	ASSERT_TRUE(socket->IsWatched());
+
+	sockaddr_in destination     = {};
+	destination.sin_family      = AF_INET;
+	destination.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	destination.sin_port        = receiver_port;
+
+	for (auto i = 0; i < NumPackets; ++i) {
+		const auto payload = make_pattern(static_cast<size_t>(i + 1));
+		sendto(sender_fd,
+		       payload.data(),
+		       payload.size(),
+		       0,
+		       reinterpret_cast<sockaddr*>(&destination),
+		       sizeof(destination));
+	}
+
+	auto num_received   = 0;
+	auto num_bad        = 0;
+	const auto deadline = std::chrono::steady_clock::now() + Timeout;
+	while (num_received < NumPackets && std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(TickInterval);
+		TIMER_AddTick();
+
+		while (const auto packet = socket->ReceivePacket()) {
+			const auto expected = make_pattern(
+			        static_cast<size_t>(num_received + 1));
+			if (packet->data != expected ||
+			    packet->host != htonl(INADDR_LOOPBACK) ||
+			    packet->port != sender_port) {
+				++num_bad;
+			}
+			++num_received;
+		}
+	}
+	socket.reset();
+	close(sender_fd);
+	close(receiver_fd);
+
+	EXPECT_EQ(num_received, NumPackets);
+	EXPECT_EQ(num_bad, 0);
+	EXPECT_GT(num_callbacks, 0);
+}
+
+} // namespace
+
+#endif // WIN32
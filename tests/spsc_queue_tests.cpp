@@ -0,0 +1,327 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "utils/spsc_queue.h"
+#include "utils/rwqueue.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+constexpr auto iterations = 10000;
+
+TEST(SpscQueue, TrivialSerial)
+{
+	SpscQueue<int> q(65);
+	for (int iteration = 0; iteration != 128; ++iteration) {
+		EXPECT_EQ(q.MaxCapacity(), 65);
+		EXPECT_EQ(q.Size(), 0);
+		EXPECT_TRUE(q.IsEmpty());
+
+		for (int i = 0; i != 65; ++i) {
+			EXPECT_TRUE(q.NonblockingEnqueue(std::move(i)));
+		}
+		EXPECT_EQ(q.Size(), 65);
+		EXPECT_TRUE(q.IsFull());
+
+		// The nominal capacity is enforced, not the allocated one
+		EXPECT_FALSE(q.NonblockingEnqueue(65));
+
+		for (int i = 0; i != 65; ++i) {
+			const auto item = q.Dequeue();
+			EXPECT_EQ(*item, i);
+		}
+		EXPECT_TRUE(q.IsEmpty());
+	}
+}
+
+TEST(SpscQueue, TrivialZeroCapacity)
+{
+	EXPECT_DEBUG_DEATH({ SpscQueue<int> q(0); }, "");
+}
+
+TEST(SpscQueue, SpanWrapAround)
+{
+	SpscQueue<int> q(5);
+
+	std::vector<int> out(5);
+
+	int next_in  = 0;
+	int next_out = 0;
+
+	for (int iteration = 0; iteration != 50; ++iteration) {
+		const std::vector<int> in = {next_in, next_in + 1, next_in + 2};
+		EXPECT_EQ(q.NonblockingBulkEnqueue(std::span<const int>(in)), 3);
+		next_in += 3;
+
+		const auto num_dequeued = q.NonblockingBulkDequeue(
+		        std::span<int>(out.data(), 2 + iteration % 2));
+
+		for (size_t i = 0; i < num_dequeued; ++i) {
+			EXPECT_EQ(out[i], next_out++);
+		}
+
+		// Keep the queue from overflowing
+		if (q.Size() > 2) {
+			const auto n = q.NonblockingBulkDequeue(out);
+			for (size_t i = 0; i < n; ++i) {
+				EXPECT_EQ(out[i], next_out++);
+			}
+		}
+	}
+}
+
+TEST(SpscQueue, NonblockingBulkEnqueuePartial)
+{
+	SpscQueue<int> q(4);
+
+	std::vector<int> items = {1, 2, 3, 4, 5, 6};
+	EXPECT_EQ(q.NonblockingBulkEnqueue(items), 4);
+
+	// Items that didn't fit are left in the source
+	const std::vector<int> expected_remaining = {5, 6};
+	EXPECT_EQ(items, expected_remaining);
+
+	EXPECT_EQ(q.NonblockingBulkEnqueue(items), 0);
+}
+
+TEST(SpscQueue, Clear)
+{
+	SpscQueue<int> q(8);
+
+	std::vector<int> items = {1, 2, 3, 4, 5};
+	q.BulkEnqueue(items);
+	EXPECT_EQ(q.Size(), 5);
+
+	q.Clear();
+	EXPECT_EQ(q.Size(), 0);
+	EXPECT_TRUE(q.IsEmpty());
+
+	// Items enqueued after the clear are kept
+	q.Enqueue(6);
+	EXPECT_EQ(q.Size(), 1);
+
+	const auto value = q.Dequeue();
+	EXPECT_EQ(*value, 6);
+	EXPECT_TRUE(q.IsEmpty());
+}
+
+using container_t = std::vector<int16_t>;
+
+TEST(SpscQueue, ContainerMove)
+{
+	SpscQueue<container_t> q(3);
+
+	container_t v = {1, 2, 3};
+	q.Enqueue(std::move(v));
+	EXPECT_TRUE(v.empty());
+
+	const auto item = q.Dequeue();
+	const container_t expected = {1, 2, 3};
+	EXPECT_EQ(*item, expected);
+}
+
+template <typename Queue>
+void bulk_enqueue(Queue& q, const size_t total_to_enqueue,
+                  const size_t num_per_bulk_enqueue)
+{
+	int i = 0;
+
+	auto remaining_items = total_to_enqueue;
+
+	std::vector<int> items = {};
+	while (remaining_items > 0) {
+		const auto num_to_enqueue = std::min(remaining_items,
+		                                     num_per_bulk_enqueue);
+		for (size_t n = 0; n < num_to_enqueue; ++n) {
+			items.push_back(i++);
+		}
+		q.BulkEnqueue(items, num_to_enqueue);
+		EXPECT_TRUE(items.empty());
+
+		remaining_items -= num_to_enqueue;
+	}
+}
+
+template <typename Queue>
+void bulk_dequeue(Queue& q, const size_t total_to_dequeue,
+                  const size_t num_per_bulk_dequeue)
+{
+	int expected_val = 0;
+
+	auto remaining_items = total_to_dequeue;
+
+	std::vector<int> items = {};
+	while (remaining_items > 0) {
+		const auto num_to_dequeue = std::min(remaining_items,
+		                                     num_per_bulk_dequeue);
+
+		EXPECT_EQ(q.BulkDequeue(items, num_to_dequeue), num_to_dequeue);
+		for (const auto item : items) {
+			if (item != expected_val++) {
+				ADD_FAILURE() << "Unexpected item " << item;
+				return;
+			}
+		}
+		remaining_items -= num_to_dequeue;
+	}
+}
+
+template <typename Queue>
+void run_bulk_async_test(const size_t queue_capacity,
+                         const size_t num_per_bulk_enqueue,
+                         const size_t num_per_bulk_dequeue, size_t total_to_queue)
+{
+	Queue q(queue_capacity);
+
+	std::thread writer(bulk_enqueue<Queue>, std::ref(q), total_to_queue, num_per_bulk_enqueue);
+	std::thread reader(bulk_dequeue<Queue>, std::ref(q), total_to_queue, num_per_bulk_dequeue);
+
+	writer.join();
+	reader.join();
+
+	EXPECT_EQ(q.Size(), 0);
+}
+
+using bulk_params_t = typename std::tuple<size_t, size_t, size_t, size_t>;
+
+TEST(SpscQueue, AsyncBulkIO)
+{
+	for (const auto& [queue_capacity,
+	                  num_per_bulk_enqueue,
+	                  num_per_bulk_dequeue,
+	                  total_to_queue] : {
+
+	             bulk_params_t{1, 1, 1, 50},
+	             bulk_params_t{50, 1, 1, 242},
+	             bulk_params_t{10, 10, 10, 50},
+	             bulk_params_t{10, 3, 10, 50},
+	             bulk_params_t{10, 10, 3, 50},
+	             bulk_params_t{7, 50, 2, 57},
+	             bulk_params_t{9, 5, 20, 53},
+	             bulk_params_t{100, 64, 48, iterations},
+
+	     }) {
+		run_bulk_async_test<SpscQueue<int>>(queue_capacity,
+		                                    num_per_bulk_enqueue,
+		                                    num_per_bulk_dequeue,
+		                                    total_to_queue);
+	}
+}
+
+TEST(SpscQueue, AsyncSingles)
+{
+	SpscQueue<int> q(8);
+
+	std::thread writer([&] {
+		for (int i = 0; i != iterations; ++i) {
+			q.Enqueue(std::move(i));
+		}
+	});
+	for (int i = 0; i != iterations; ++i) {
+		const auto item = q.Dequeue();
+		ASSERT_EQ(*item, i);
+	}
+	writer.join();
+
+	EXPECT_TRUE(q.IsEmpty());
+}
+
+TEST(SpscQueue, StopWakesBlockedConsumer)
+{
+	SpscQueue<int> q(4);
+
+	std::thread reader([&] {
+		const auto value = q.Dequeue();
+		EXPECT_FALSE(value.has_value());
+	});
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	q.Stop();
+	reader.join();
+}
+
+TEST(SpscQueue, StopWakesBlockedProducer)
+{
+	SpscQueue<int> q(2);
+
+	std::thread writer([&] {
+		std::vector<int> items = {1, 2, 3, 4};
+		EXPECT_EQ(q.BulkEnqueue(items), 2);
+	});
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	q.Stop();
+	writer.join();
+}
+
+TEST(SpscQueue, StopMidway)
+{
+	SpscQueue<int> q(8);
+
+	std::vector<int> items = {1, 2, 3, 4, 5};
+	EXPECT_EQ(q.BulkEnqueue(items), 5);
+
+	q.Stop();
+
+	// Enqueuing fails after being stopped
+	items = {6, 7};
+	EXPECT_EQ(q.BulkEnqueue(items), 0);
+	EXPECT_FALSE(q.Enqueue(8));
+	EXPECT_EQ(q.Size(), 5);
+
+	// The queued items can still be drained
+	EXPECT_EQ(q.BulkDequeue(items, 2), 2);
+	EXPECT_EQ(*q.Dequeue(), 3);
+	EXPECT_EQ(q.BulkDequeue(items, 10), 2);
+
+	const std::vector<int> expected_items = {4, 5};
+	EXPECT_EQ(items, expected_items);
+
+	EXPECT_FALSE(q.Dequeue().has_value());
+}
+
+// Streams audio-sized blocks through both queue implementations, like the
+// mixer thread feeding the SDL audio callback. This is a benchmark rather
+// than a test, as the timings depend too much on the host to be asserted, so
+// it's disabled by default; run it with --gtest_also_run_disabled_tests.
+template <typename Queue>
+double time_streaming(const size_t block_size, const size_t num_blocks)
+{
+	Queue q(block_size * 4);
+
+	const auto start = std::chrono::steady_clock::now();
+
+	std::thread writer(bulk_enqueue<Queue>, std::ref(q), block_size * num_blocks, block_size);
+	bulk_dequeue(q, block_size * num_blocks, block_size);
+	writer.join();
+
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+	return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+TEST(SpscQueue, DISABLED_StreamingComparedToRWQueue)
+{
+	constexpr size_t NumBlocks = 2000;
+
+	for (const size_t block_size : {16, 256, 1024}) {
+		const auto rwqueue_ms = time_streaming<RWQueue<int>>(block_size,
+		                                                     NumBlocks);
+		const auto spsc_ms = time_streaming<SpscQueue<int>>(block_size,
+		                                                    NumBlocks);
+
+		printf("Streaming %zu blocks of %zu items: RWQueue %.2f ms, SpscQueue %.2f ms\n",
+		       NumBlocks,
+		       block_size,
+		       rwqueue_ms,
+		       spsc_ms);
+	}
+}
+
+} // namespace
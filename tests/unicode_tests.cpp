@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "misc/unicode.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "dosbox_test_fixture.h"
+
+namespace {
+
+class UnicodeTest : public DOSBoxTestFixture {};
+
+// All the characters above 7-bit ASCII
+std::string make_non_ascii_characters()
+{
+	std::string str = {};
+	for (auto character = 0x80; character <= 0xff; ++character) {
+		str.push_back(static_cast<char>(character));
+	}
+	return str;
+}
+
+TEST_F(UnicodeTest, DecodesCodePage437)
+{
+	constexpr auto Mode = DosStringConvertMode::NoSpecialCharacters;
+
+	EXPECT_EQ(dos_to_utf8("\x80", Mode, 437), "Ç");
+	EXPECT_EQ(dos_to_utf8("\xb0\xc9\xdb", Mode, 437), "░╔█");
+	EXPECT_EQ(dos_to_utf8("A\xe1" "B", Mode, 437), "AßB");
+	EXPECT_EQ(dos_to_utf8("\xff", Mode, 437), " ");
+}
+
+TEST_F(UnicodeTest, RoundTripsCodePage437)
+{
+	constexpr auto Mode = DosStringConvertMode::NoSpecialCharacters;
+
+	const auto dos  = make_non_ascii_characters();
+	const auto utf8 = dos_to_utf8(dos, Mode, 437);
+
+	EXPECT_EQ(utf8_to_dos(utf8, Mode, UnicodeFallback::EmptyString, 437), dos);
+}
+
+TEST_F(UnicodeTest, RoundTripsCodePage437ForFilesystem)
+{
+	const auto dos = make_non_ascii_characters();
+
+	// Code page 437 has a character for 0xff, but it's not valid in file
+	// names
+	const auto name = dos.substr(0, dos.size() - 1);
+
+	EXPECT_EQ(fs_utf8_to_dos_437(dos_437_to_fs_utf8(name)), name);
+}
+
+TEST_F(UnicodeTest, DecodesWithoutCodePageMapping)
+{
+	constexpr auto Mode = DosStringConvertMode::NoSpecialCharacters;
+
+	// Code page 0 is pure 7-bit ASCII
+	const auto utf8 = dos_to_utf8("A\x80\xff", Mode, 0);
+	ASSERT_EQ(length_utf8(utf8), 3);
+	EXPECT_EQ(utf8.front(), 'A');
+	EXPECT_NE(utf8, dos_to_utf8("A\x80\xff", Mode, 437));
+}
+
+} // namespace
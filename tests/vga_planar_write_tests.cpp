@@ -0,0 +1,459 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "hardware/video/vga.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "cpu/cpu.h"
+#include "cpu/paging.h"
+#include "cpu/registers.h"
+#include "dosbox_test_fixture.h"
+#include "hardware/memory.h"
+#include "hardware/port.h"
+#include "ints/int10.h"
+
+void INT10_Init(Section*);
+
+namespace {
+
+// Starts mid-page so the block writes cross into the next page, and the odd
+// length leaves a tail shorter than a vector
+constexpr PhysPt BlockStart = 0xa0000 + MemPageSize - 301;
+constexpr Bitu BlockSize    = 601;
+
+// The planar bytes the latches are loaded from
+constexpr PhysPt LatchSource = 0xa0000 + 80 * 200 + 7;
+
+struct RegisterSet {
+	uint8_t map_mask         = 0;
+	uint8_t bit_mask         = 0;
+	uint8_t set_reset        = 0;
+	uint8_t enable_set_reset = 0;
+};
+
+constexpr std::array<RegisterSet, 4> RegisterSets = {{
+        {0xf, 0xff, 0x0, 0x0},
+        {0x5, 0x3c, 0xa, 0x6},
+        {0xe, 0x81, 0xf, 0xf},
+        {0x9, 0x00, 0x3, 0xc},
+}};
+
+class VgaPlanarWriteTest : public DOSBoxTestFixture {
+protected:
+	void SetUp() override
+	{
+		DOSBoxTestFixture::SetUp();
+		INT10_Init(nullptr);
+	}
+
+	void SetModeWithPattern(const uint16_t mode)
+	{
+		INT10_SetVideoMode(mode);
+
+		for (uint32_t i = 0; i < vga.vmemsize; ++i) {
+			vga.mem.linear[i] = static_cast<uint8_t>(i * 13 + (i >> 9));
+		}
+		for (uint32_t i = 0; i < vga.vmemsize * 2; ++i) {
+			vga.fastmem[i] = static_cast<uint8_t>(i * 7 + (i >> 10));
+		}
+	}
+
+	// Writes the same bytes once through the block write and once byte by
+	// byte, under every combination of write mode, rotate count, function
+	// select, and a few sets of masks and set/reset values
+	void ExpectBlockWritesMatchByteWrites(const PhysPt planar_start)
+	{
+		std::vector<uint8_t> data(BlockSize);
+		for (size_t i = 0; i < data.size(); ++i) {
+			data[i] = static_cast<uint8_t>(i * 37 + (i >> 8));
+		}
+
+		for (uint8_t write_mode = 0; write_mode < 4; ++write_mode) {
+			for (uint8_t rotate = 0; rotate < 8; ++rotate) {
+				for (uint8_t function = 0; function < 4; ++function) {
+					for (const auto& registers : RegisterSets) {
+						SetRegisters(write_mode, rotate, function, registers);
+
+						SCOPED_TRACE(testing::Message()
+						             << "write mode " << int(write_mode)
+						             << ", rotate " << int(rotate)
+						             << ", function " << int(function)
+						             << ", map mask " << int(registers.map_mask)
+						             << ", bit mask " << int(registers.bit_mask));
+
+						ExpectSameAsByteWrites(planar_start, data);
+					}
+				}
+			}
+		}
+	}
+
+private:
+	static void SetRegisters(const uint8_t write_mode, const uint8_t rotate,
+	                         const uint8_t function, const RegisterSet& registers)
+	{
+		write_gfx_register(0, registers.set_reset);
+		write_gfx_register(1, registers.enable_set_reset);
+		write_gfx_register(3, static_cast<uint8_t>((function << 3) | rotate));
+		write_gfx_register(5, write_mode);
+		write_gfx_register(8, registers.bit_mask);
+
+		IO_Write(0x3c4, 2);
+		IO_Write(0x3c5, registers.map_mask);
+	}
+
+	static void write_gfx_register(const uint8_t index, const uint8_t val)
+	{
+		IO_Write(0x3ce, index);
+		IO_Write(0x3cf, val);
+	}
+
+	// Only the planes and pixels around the written block, which is
+	// much quicker to compare than all of video memory
+	struct Window {
+		std::vector<uint32_t> planes = {};
+		std::vector<uint8_t> pixels  = {};
+
+		bool operator==(const Window&) const = default;
+	};
+
+	static constexpr Bitu Margin = 8;
+
+	static Window SaveWindow(const PhysPt planar_start)
+	{
+		const auto first = planar_start - Margin;
+		const auto last  = planar_start + BlockSize + Margin;
+
+		const auto planes = reinterpret_cast<const uint32_t*>(vga.mem.linear);
+
+		Window window = {};
+		window.planes.assign(planes + first, planes + last);
+		window.pixels.assign(vga.fastmem + (first << 3), vga.fastmem + (last << 3));
+		return window;
+	}
+
+	static void RestoreWindow(const PhysPt planar_start, const Window& window)
+	{
+		const auto first = planar_start - Margin;
+
+		const auto planes = reinterpret_cast<uint32_t*>(vga.mem.linear);
+
+		std::copy(window.planes.begin(), window.planes.end(), planes + first);
+		std::copy(window.pixels.begin(), window.pixels.end(), vga.fastmem + (first << 3));
+	}
+
+	static void ExpectSameAsByteWrites(const PhysPt planar_start,
+	                                   const std::vector<uint8_t>& data)
+	{
+		const auto before = SaveWindow(planar_start);
+
+		mem_readb(LatchSource);
+		const auto latch = vga.latch.d;
+
+		MEM_BlockWrite(BlockStart, data.data(), data.size());
+		const auto block = SaveWindow(planar_start);
+		EXPECT_EQ(vga.latch.d, latch);
+
+		RestoreWindow(planar_start, before);
+		mem_readb(LatchSource);
+		for (Bitu i = 0; i < data.size(); ++i) {
+			mem_writeb(BlockStart + i, data[i]);
+		}
+		const auto bytewise = SaveWindow(planar_start);
+
+		RestoreWindow(planar_start, before);
+		mem_readb(LatchSource);
+		for (Bitu i = 0; i + 4 <= data.size(); i += 4) {
+			mem_writed(BlockStart + i, host_readd(&data[i]));
+		}
+		for (Bitu i = data.size() & ~Bitu(3); i < data.size(); ++i) {
+			mem_writeb(BlockStart + i, data[i]);
+		}
+		const auto dwordwise = SaveWindow(planar_start);
+
+		RestoreWindow(planar_start, before);
+
+		EXPECT_TRUE(block == bytewise);
+		EXPECT_TRUE(dwordwise == bytewise);
+	}
+};
+
+TEST_F(VgaPlanarWriteTest, UsesBlockWrites)
+{
+	SetModeWithPattern(0x12);
+	const auto handler = MEM_GetPageHandler(BlockStart / MemPageSize);
+	EXPECT_TRUE(handler->flags & PFLAG_BLOCKWRITE);
+}
+
+TEST_F(VgaPlanarWriteTest, EgaBlockWritesMatchByteWrites)
+{
+	SetModeWithPattern(0x12);
+	ExpectBlockWritesMatchByteWrites(BlockStart - 0xa0000);
+}
+
+TEST_F(VgaPlanarWriteTest, Lin4BlockWritesMatchByteWrites)
+{
+	SetModeWithPattern(0x102);
+	ExpectBlockWritesMatchByteWrites(BlockStart - 0xa0000);
+}
+
+TEST_F(VgaPlanarWriteTest, ModeXBlockWritesMatchByteWrites)
+{
+	SetModeWithPattern(0x13);
+
+	// Unchained, as the Mode X games set it up
+	IO_Write(0x3c4, 4);
+	IO_Write(0x3c5, 0x06);
+	ASSERT_FALSE(vga.config.chained);
+
+	ExpectBlockWritesMatchByteWrites(BlockStart - 0xa0000);
+}
+
+// Forward REP STOS and MOVS runs into planar memory are handed to the block
+// writes a page at a time, which has to give the same result as running
+// them element by element
+
+constexpr uint16_t CodeSegment  = 0x3000;
+constexpr uint16_t VideoSegment = 0xa000;
+
+struct VideoState {
+	std::vector<uint8_t> memory = {};
+	std::vector<uint8_t> pixels = {};
+	uint32_t latch              = 0;
+
+	bool operator==(const VideoState&) const = default;
+};
+
+VideoState save_video_state()
+{
+	VideoState state = {};
+	state.memory.assign(vga.mem.linear, vga.mem.linear + vga.vmemsize);
+	state.pixels.assign(vga.fastmem, vga.fastmem + vga.vmemsize * 2);
+	state.latch = vga.latch.d;
+	return state;
+}
+
+void restore_video_state(const VideoState& state)
+{
+	std::copy(state.memory.begin(), state.memory.end(), vga.mem.linear);
+	std::copy(state.pixels.begin(), state.pixels.end(), vga.fastmem);
+	vga.latch.d = state.latch;
+}
+
+struct StringRun {
+	// The instruction, with its prefixes
+	std::vector<uint8_t> code = {};
+
+	uint8_t size = 1;
+	bool is_movs = false;
+
+	uint16_t src_segment = 0;
+	uint16_t si          = 0;
+	uint16_t di          = 0;
+	uint16_t count       = 0;
+};
+
+constexpr uint32_t StoredValue = 0x5aa5c33c;
+
+void set_string_registers(const StringRun& run)
+{
+	SegSet16(ds, run.src_segment);
+	SegSet16(es, VideoSegment);
+	reg_esi = run.si;
+	reg_edi = run.di;
+	reg_ecx = run.count;
+	reg_eax = StoredValue;
+
+	SETFLAGBIT(DF, false);
+	cpu.direction = 1;
+}
+
+// Runs the instruction with the normal core, followed by a jmp $ that uses
+// up the rest of the cycles
+void run_with_normal_core(const StringRun& run)
+{
+	auto code = run.code;
+	code.push_back(0xeb);
+	code.push_back(0xfe);
+	for (size_t i = 0; i < code.size(); ++i) {
+		phys_writeb((CodeSegment << 4) + static_cast<PhysPt>(i), code[i]);
+	}
+
+	set_string_registers(run);
+	SegSet16(cs, CodeSegment);
+	reg_eip = 0;
+
+	CPU_Cycles = 0x20000;
+	CPU_Core_Normal_Run();
+}
+
+// The same loop with the 16-bit index wrap, through the memory functions
+void run_element_by_element(const StringRun& run)
+{
+	set_string_registers(run);
+
+	const auto src_base  = SegPhys(ds);
+	const auto dest_base = SegPhys(es);
+
+	uint16_t si = run.si;
+	uint16_t di = run.di;
+	for (auto count = run.count; count > 0; --count) {
+		const auto src  = src_base + si;
+		const auto dest = dest_base + di;
+		switch (run.size) {
+		case 1:
+			mem_writeb(dest,
+			           run.is_movs ? mem_readb(src)
+			                       : static_cast<uint8_t>(StoredValue));
+			break;
+		case 2:
+			mem_writew(dest,
+			           run.is_movs ? mem_readw(src)
+			                       : static_cast<uint16_t>(StoredValue));
+			break;
+		default:
+			mem_writed(dest, run.is_movs ? mem_readd(src) : StoredValue);
+			break;
+		}
+		if (run.is_movs) {
+			si = static_cast<uint16_t>(si + run.size);
+		}
+		di = static_cast<uint16_t>(di + run.size);
+	}
+	reg_esi = si;
+	reg_edi = di;
+	reg_ecx = 0;
+}
+
+// Returns the page handler calls of the run with the normal core
+uint64_t expect_same_as_element_by_element(const StringRun& run)
+{
+	// Map the pages, so the handlers are in place from the first element
+	for (PhysPt page = 0xa0000; page < 0xb0000; page += MemPageSize) {
+		mem_readb(page);
+	}
+	mem_readb(run.src_segment << 4);
+	mem_readb((run.src_segment << 4) + run.si);
+
+	const auto before = save_video_state();
+
+	const auto calls_before = perf_counters.page_handler_calls;
+	run_with_normal_core(run);
+	const auto handler_calls = perf_counters.page_handler_calls - calls_before;
+
+	const auto blocks    = save_video_state();
+	const auto blocks_si = reg_esi;
+	const auto blocks_di = reg_edi;
+	const auto blocks_cx = reg_ecx;
+
+	restore_video_state(before);
+	run_element_by_element(run);
+	const auto elements = save_video_state();
+
+	EXPECT_NE(elements, before);
+	EXPECT_TRUE(blocks == elements);
+	EXPECT_EQ(blocks_si, reg_esi);
+	EXPECT_EQ(blocks_di, reg_edi);
+	EXPECT_EQ(blocks_cx, reg_ecx);
+
+	return handler_calls;
+}
+
+TEST_F(VgaPlanarWriteTest, StringWritesWrapAroundTheSegment)
+{
+	SetModeWithPattern(0x12);
+
+	// rep stosb from es:ff00 on to es:00ff
+	StringRun run = {};
+	run.code      = {0xf3, 0xaa};
+	run.di        = 0xff00;
+	run.count     = 0x200;
+	EXPECT_LT(expect_same_as_element_by_element(run), 8u);
+
+	// rep stosw with a word that straddles the wrap
+	run.code  = {0xf3, 0xab};
+	run.size  = 2;
+	run.di    = 0xfff1;
+	run.count = 0x100;
+	expect_same_as_element_by_element(run);
+
+	// rep movsb with a source segment that doesn't start at a page
+	// boundary, so its index wraps around in the middle of a page. The
+	// planes wrap around at 64 KB, so for the destination the wrap can't
+	// be told apart from going on past the end of the segment.
+	constexpr uint16_t SrcSegment = 0x1080;
+	for (PhysPt i = 0; i < 0x11000; ++i) {
+		phys_writeb((SrcSegment << 4) + i,
+		            static_cast<uint8_t>(i * 11 + (i >> 8) + (i >> 16) * 0x55));
+	}
+	run.code        = {0xf3, 0xa4};
+	run.size        = 1;
+	run.is_movs     = true;
+	run.src_segment = SrcSegment;
+	run.si          = 0xff00;
+	run.di          = 0x0700;
+	run.count       = 0x200;
+	EXPECT_LT(expect_same_as_element_by_element(run), 8u);
+}
+
+TEST_F(VgaPlanarWriteTest, StringWritesWithLastElementAcrossPages)
+{
+	SetModeWithPattern(0x12);
+
+	// rep stosd up to a dword that starts 2 bytes before the end of planar
+	// memory, at a000:fffe, and goes on into unmapped memory
+	StringRun run = {};
+	run.code      = {0x66, 0xf3, 0xab};
+	run.size      = 4;
+	run.di        = 0xf002;
+	run.count     = 0x400;
+	EXPECT_LT(expect_same_as_element_by_element(run), 8u);
+
+	// rep movsd from the last page of conventional memory, with the last
+	// dword read partly from planar memory
+	constexpr uint16_t SrcSegment = 0x9f00;
+	for (PhysPt i = 0; i < 0x1000; ++i) {
+		phys_writeb((SrcSegment << 4) + i, static_cast<uint8_t>(i * 11));
+	}
+	run.code        = {0x66, 0xf3, 0xa5};
+	run.is_movs     = true;
+	run.src_segment = SrcSegment;
+	run.si          = 0x0002;
+	run.di          = 0x0002;
+	EXPECT_LT(expect_same_as_element_by_element(run), 16u);
+}
+
+TEST_F(VgaPlanarWriteTest, StringMoveFromSourceWithoutHostPointer)
+{
+	SetModeWithPattern(0x12);
+
+	// The source runs from conventional memory into planar memory, which
+	// can only be read through its page handler
+	constexpr uint16_t SrcSegment = 0x9ff0;
+	for (PhysPt i = 0; i < 0x100; ++i) {
+		phys_writeb((SrcSegment << 4) + i, static_cast<uint8_t>(i * 11));
+	}
+
+	// rep movsb of 0x300 bytes, the first 0x100 from conventional memory
+	StringRun run   = {};
+	run.code        = {0xf3, 0xa4};
+	run.is_movs     = true;
+	run.src_segment = SrcSegment;
+	run.di          = 0x2000;
+	run.count       = 0x300;
+
+	mem_readb(SrcSegment << 4);
+	ASSERT_NE(get_tlb_read(SrcSegment << 4), nullptr);
+	ASSERT_EQ(get_tlb_read(0xa0000), nullptr);
+
+	// Only the elements read from planar memory took two handler calls
+	EXPECT_LT(expect_same_as_element_by_element(run), 2u * run.count);
+}
+
+} // namespace